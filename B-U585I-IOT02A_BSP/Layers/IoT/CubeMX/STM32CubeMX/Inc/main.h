@@ -64,8 +64,9 @@ extern "C" {
 void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
-extern int stdio_init (void);
-extern int app_main   (void);
+extern int stdio_init    (void);
+extern int ospi_ram_init (void);
+extern int app_main      (void);
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
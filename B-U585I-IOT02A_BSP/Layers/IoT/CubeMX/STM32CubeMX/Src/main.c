@@ -131,6 +131,8 @@ int main(void)
 
   stdio_init();                         /* Initialize STDIO */
 
+  ospi_ram_init();                      /* Initialize external PSRAM */
+
   vioInit();                            /* Initialize Virtual I/O */  
                                   
   app_main();                           /* Application */
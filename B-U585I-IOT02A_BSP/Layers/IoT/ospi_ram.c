@@ -0,0 +1,591 @@
+/*---------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *      Name:    ospi_ram.c
+ *      Purpose: Octal-SPI PSRAM (APS6408) external memory and allocator
+ *
+ *---------------------------------------------------------------------------*/
+
+#include <stddef.h>
+
+#include "stm32u5xx_hal.h"
+#include "ospi_ram.h"
+
+// Compile-time configuration
+#ifndef OSPI_RAM_CACHEABLE
+#define OSPI_RAM_CACHEABLE      0       // 1 = Write-back cacheable (DCACHE1), 0 = Non-cacheable
+#endif
+#ifndef OSPI_RAM_MPU_REGION
+#define OSPI_RAM_MPU_REGION     7       // MPU region number used for the PSRAM window
+#endif
+#ifndef OSPI_RAM_MPU_ATTR
+#define OSPI_RAM_MPU_ATTR       7       // MPU attribute index used for the PSRAM window
+#endif
+#ifndef OSPI_RAM_BENCH_SIZE
+#define OSPI_RAM_BENCH_SIZE     0x10000 // Benchmark window size in bytes (power of 2)
+#endif
+
+// APS6408 commands
+#define PSRAM_CMD_READ          0x20U   // Linear burst read
+#define PSRAM_CMD_WRITE         0xA0U   // Linear burst write
+#define PSRAM_CMD_READ_REG      0x40U   // Mode register read
+#define PSRAM_CMD_WRITE_REG     0xC0U   // Mode register write
+#define PSRAM_CMD_RESET         0xFFU   // Global reset
+
+// APS6408 mode registers
+#define PSRAM_MR0               0x00U   // Drive strength, read latency
+#define PSRAM_MR4               0x04U   // Write latency
+#define PSRAM_MR8               0x08U   // Burst length
+
+#define PSRAM_MR0_DS_Msk        0x03U
+#define PSRAM_MR0_DS_HALF       0x01U
+#define PSRAM_MR0_RLC_Msk       0x1CU
+#define PSRAM_MR0_RLC_5         0x08U
+#define PSRAM_MR0_LT_FIXED      0x20U
+#define PSRAM_MR4_WLC_Msk       0xE0U
+#define PSRAM_MR4_WLC_4         0x80U
+#define PSRAM_MR8_BL_Msk        0x03U
+#define PSRAM_MR8_BL_2K         0x03U
+
+// Latency (in clock cycles) matching the mode register settings
+#define PSRAM_READ_LATENCY      5U
+#define PSRAM_WRITE_LATENCY     4U
+
+extern OSPI_HandleTypeDef hospi1;
+
+static uint8_t  ram_ready;              // PSRAM memory-mapped and usable
+static uint32_t arena_top;              // Arena offset of first free byte
+
+/**
+  Enter critical section
+
+  \return          PRIMASK value to be restored
+*/
+static uint32_t critical_enter (void) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+
+  return primask;
+}
+
+/**
+  Leave critical section
+
+  \param[in]   primask  PRIMASK value returned by critical_enter
+*/
+static void critical_leave (uint32_t primask) {
+  if (primask == 0U) {
+    __enable_irq();
+  }
+}
+
+/**
+  Prepare octal DTR command common to all PSRAM accesses
+
+  \param[out]  cmd          Command structure
+  \param[in]   instruction  Instruction code
+*/
+static void psram_cmd_init (OSPI_RegularCmdTypeDef *cmd, uint32_t instruction) {
+  cmd->OperationType         = HAL_OSPI_OPTYPE_COMMON_CFG;
+  cmd->FlashId               = HAL_OSPI_FLASH_ID_1;
+  cmd->Instruction           = instruction;
+  cmd->InstructionMode       = HAL_OSPI_INSTRUCTION_8_LINES;
+  cmd->InstructionSize       = HAL_OSPI_INSTRUCTION_8_BITS;
+  cmd->InstructionDtrMode    = HAL_OSPI_INSTRUCTION_DTR_DISABLE;
+  cmd->Address               = 0U;
+  cmd->AddressMode           = HAL_OSPI_ADDRESS_8_LINES;
+  cmd->AddressSize           = HAL_OSPI_ADDRESS_32_BITS;
+  cmd->AddressDtrMode        = HAL_OSPI_ADDRESS_DTR_ENABLE;
+  cmd->AlternateBytes        = 0U;
+  cmd->AlternateBytesMode    = HAL_OSPI_ALTERNATE_BYTES_NONE;
+  cmd->AlternateBytesSize    = HAL_OSPI_ALTERNATE_BYTES_8_BITS;
+  cmd->AlternateBytesDtrMode = HAL_OSPI_ALTERNATE_BYTES_DTR_DISABLE;
+  cmd->DataMode              = HAL_OSPI_DATA_8_LINES;
+  cmd->DataDtrMode           = HAL_OSPI_DATA_DTR_ENABLE;
+  cmd->NbData                = 2U;
+  cmd->DummyCycles           = 0U;
+  cmd->DQSMode               = HAL_OSPI_DQS_DISABLE;
+  cmd->SIOOMode              = HAL_OSPI_SIOO_INST_EVERY_CMD;
+}
+
+/**
+  Read PSRAM mode register
+
+  \param[in]   addr   Mode register address
+  \param[out]  value  Register value
+  \return          0 on success, or -1 on error.
+*/
+static int psram_read_reg (uint32_t addr, uint8_t *value) {
+  OSPI_RegularCmdTypeDef cmd;
+  uint8_t                reg[2];
+
+  psram_cmd_init(&cmd, PSRAM_CMD_READ_REG);
+  cmd.Address     = addr;
+  cmd.DummyCycles = PSRAM_READ_LATENCY;
+  cmd.DQSMode     = HAL_OSPI_DQS_ENABLE;
+
+  if (HAL_OSPI_Command(&hospi1, &cmd, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+    return -1;
+  }
+  if (HAL_OSPI_Receive(&hospi1, reg, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+    return -1;
+  }
+
+  *value = reg[0];
+
+  return 0;
+}
+
+/**
+  Write PSRAM mode register
+
+  \param[in]   addr   Mode register address
+  \param[in]   value  Register value
+  \return          0 on success, or -1 on error.
+*/
+static int psram_write_reg (uint32_t addr, uint8_t value) {
+  OSPI_RegularCmdTypeDef cmd;
+  uint8_t                reg[2];
+
+  psram_cmd_init(&cmd, PSRAM_CMD_WRITE_REG);
+  cmd.Address = addr;
+
+  reg[0] = value;
+  reg[1] = value;
+
+  if (HAL_OSPI_Command(&hospi1, &cmd, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+    return -1;
+  }
+  if (HAL_OSPI_Transmit(&hospi1, reg, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  Read-modify-write PSRAM mode register
+
+  \param[in]   addr   Mode register address
+  \param[in]   mask   Bits to be modified
+  \param[in]   value  New value of the modified bits
+  \return          0 on success, or -1 on error.
+*/
+static int psram_modify_reg (uint32_t addr, uint8_t mask, uint8_t value) {
+  uint8_t reg;
+
+  if (psram_read_reg(addr, &reg) != 0) {
+    return -1;
+  }
+
+  reg = (uint8_t)((reg & ~mask) | value);
+
+  return psram_write_reg(addr, reg);
+}
+
+/**
+  Reset PSRAM
+
+  \return          0 on success, or -1 on error.
+*/
+static int psram_reset (void) {
+  OSPI_RegularCmdTypeDef cmd;
+
+  psram_cmd_init(&cmd, PSRAM_CMD_RESET);
+  cmd.AddressSize    = HAL_OSPI_ADDRESS_24_BITS;
+  cmd.AddressDtrMode = HAL_OSPI_ADDRESS_DTR_DISABLE;
+  cmd.DataMode       = HAL_OSPI_DATA_NONE;
+  cmd.DataDtrMode    = HAL_OSPI_DATA_DTR_DISABLE;
+  cmd.NbData         = 0U;
+
+  if (HAL_OSPI_Command(&hospi1, &cmd, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+    return -1;
+  }
+
+  // Wait tRST
+  HAL_Delay(1U);
+
+  return 0;
+}
+
+/**
+  Calibrate OCTOSPI1 delay block for DTR sampling
+
+  \return          0 on success, or -1 on error.
+*/
+static int psram_dlyb_calibrate (void) {
+  HAL_OSPI_DLYB_CfgTypeDef cfg;
+
+  if (HAL_OSPI_DLYB_GetClockPeriod(&hospi1, &cfg) != HAL_OK) {
+    return -1;
+  }
+
+  // In DTR mode data is sampled on both edges: use a quarter of the period
+  cfg.PhaseSel /= 4U;
+
+  if (HAL_OSPI_DLYB_SetConfig(&hospi1, &cfg) != HAL_OK) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  Switch OCTOSPI1 into memory-mapped octal DTR mode
+
+  \return          0 on success, or -1 on error.
+*/
+static int psram_memory_mapped (void) {
+  OSPI_RegularCmdTypeDef   cmd;
+  OSPI_MemoryMappedTypeDef cfg;
+
+  psram_cmd_init(&cmd, PSRAM_CMD_WRITE);
+  cmd.OperationType = HAL_OSPI_OPTYPE_WRITE_CFG;
+  cmd.DummyCycles   = PSRAM_WRITE_LATENCY;
+  cmd.DQSMode       = HAL_OSPI_DQS_ENABLE;        // DQS acts as data mask on writes
+  if (HAL_OSPI_Command(&hospi1, &cmd, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+    return -1;
+  }
+
+  cmd.OperationType = HAL_OSPI_OPTYPE_READ_CFG;
+  cmd.Instruction   = PSRAM_CMD_READ;
+  cmd.DummyCycles   = PSRAM_READ_LATENCY;
+  if (HAL_OSPI_Command(&hospi1, &cmd, HAL_OSPI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+    return -1;
+  }
+
+  // Release nCS after a short idle period so that PSRAM can self-refresh
+  cfg.TimeOutActivation = HAL_OSPI_TIMEOUT_COUNTER_ENABLE;
+  cfg.TimeOutPeriod     = 0x34U;
+  if (HAL_OSPI_MemoryMapped(&hospi1, &cfg) != HAL_OK) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  Configure MPU region covering the PSRAM window
+*/
+static void psram_mpu_config (void) {
+  uint32_t ctrl;
+  uint8_t  attr;
+
+#if (OSPI_RAM_CACHEABLE != 0)
+  attr = ARM_MPU_ATTR(ARM_MPU_ATTR_MEMORY_(1U, 1U, 1U, 1U), ARM_MPU_ATTR_MEMORY_(1U, 1U, 1U, 1U));
+#else
+  attr = ARM_MPU_ATTR(ARM_MPU_ATTR_NON_CACHEABLE, ARM_MPU_ATTR_NON_CACHEABLE);
+#endif
+
+  ctrl = MPU->CTRL;
+  ARM_MPU_Disable();
+
+  ARM_MPU_SetMemAttr(OSPI_RAM_MPU_ATTR, attr);
+
+  // Normal memory, non-shareable, read/write, any privilege, execute never
+  ARM_MPU_SetRegion(OSPI_RAM_MPU_REGION,
+                    ARM_MPU_RBAR(OSPI_RAM_BASE, ARM_MPU_SH_NON, 0U, 1U, 1U),
+                    ARM_MPU_RLAR((OSPI_RAM_BASE + OSPI_RAM_SIZE) - 1U, OSPI_RAM_MPU_ATTR));
+
+  // Keep default memory map for all other regions
+  ARM_MPU_Enable((ctrl & ~MPU_CTRL_ENABLE_Msk) | MPU_CTRL_PRIVDEFENA_Msk);
+}
+
+/**
+  Initialize PSRAM and map it at OSPI_RAM_BASE
+
+  \return          0 on success, or -1 on error.
+*/
+int ospi_ram_init (void) {
+
+  if (ram_ready != 0U) {
+    return 0;
+  }
+
+  if (HAL_OSPI_GetState(&hospi1) != HAL_OSPI_STATE_READY) {
+    return -1;
+  }
+
+  if (psram_dlyb_calibrate() != 0) {
+    return -1;
+  }
+
+  if (psram_reset() != 0) {
+    return -1;
+  }
+
+  // Variable read latency 5, half drive strength
+  if (psram_modify_reg(PSRAM_MR0, PSRAM_MR0_DS_Msk | PSRAM_MR0_RLC_Msk | PSRAM_MR0_LT_FIXED,
+                                  PSRAM_MR0_DS_HALF | PSRAM_MR0_RLC_5) != 0) {
+    return -1;
+  }
+
+  // Write latency 4
+  if (psram_modify_reg(PSRAM_MR4, PSRAM_MR4_WLC_Msk, PSRAM_MR4_WLC_4) != 0) {
+    return -1;
+  }
+
+  // 2 kB (row) linear burst
+  if (psram_modify_reg(PSRAM_MR8, PSRAM_MR8_BL_Msk, PSRAM_MR8_BL_2K) != 0) {
+    return -1;
+  }
+
+  if (psram_memory_mapped() != 0) {
+    return -1;
+  }
+
+  psram_mpu_config();
+
+  arena_top = 0U;
+  ram_ready = 1U;
+
+  return 0;
+}
+
+/**
+  Allocate memory from the PSRAM arena
+
+  Arena memory is never freed individually, which avoids fragmentation.
+  Memory is returned in bulk with ospi_ram_release.
+
+  \param[in]   size  Number of bytes to allocate
+  \return          Pointer to OSPI_RAM_ALIGNMENT aligned memory, or NULL when out of memory.
+*/
+void *ospi_ram_alloc (uint32_t size) {
+  uint32_t primask;
+  void    *mem = NULL;
+
+  if ((ram_ready == 0U) || (size == 0U) || (size > OSPI_RAM_SIZE)) {
+    return NULL;
+  }
+
+  size = (size + (OSPI_RAM_ALIGNMENT - 1U)) & ~(OSPI_RAM_ALIGNMENT - 1U);
+
+  primask = critical_enter();
+  if (size <= (OSPI_RAM_SIZE - arena_top)) {
+    mem        = (void *)(OSPI_RAM_BASE + arena_top);
+    arena_top += size;
+  }
+  critical_leave(primask);
+
+  return mem;
+}
+
+/**
+  Get current arena position
+
+  \return          Mark to be passed to ospi_ram_release.
+*/
+uint32_t ospi_ram_mark (void) {
+  return arena_top;
+}
+
+/**
+  Release all arena memory allocated after the mark
+
+  Pools created after the mark are released as well and must not be used anymore.
+
+  \param[in]   mark  Arena position returned by ospi_ram_mark
+*/
+void ospi_ram_release (uint32_t mark) {
+  uint32_t primask;
+
+  primask = critical_enter();
+  if (mark < arena_top) {
+    arena_top = mark;
+  }
+  critical_leave(primask);
+}
+
+/**
+  Get free arena size
+
+  \return          Number of bytes available for allocation.
+*/
+uint32_t ospi_ram_available (void) {
+  if (ram_ready == 0U) {
+    return 0U;
+  }
+  return (OSPI_RAM_SIZE - arena_top);
+}
+
+/**
+  Create pool of fixed-size blocks in the PSRAM arena
+
+  \param[out]  pool         Pool control block
+  \param[in]   block_size   Block size in bytes
+  \param[in]   block_count  Number of blocks
+  \return          0 on success, or -1 on error.
+*/
+int ospi_ram_pool_init (ospi_ram_pool_t *pool, uint32_t block_size, uint32_t block_count) {
+  uint8_t  *block;
+  uint32_t  i;
+
+  if ((pool == NULL) || (block_size == 0U) || (block_count == 0U)) {
+    return -1;
+  }
+
+  block_size = (block_size + (OSPI_RAM_ALIGNMENT - 1U)) & ~(OSPI_RAM_ALIGNMENT - 1U);
+  if (block_count > (OSPI_RAM_SIZE / block_size)) {
+    return -1;
+  }
+
+  pool->base = ospi_ram_alloc(block_size * block_count);
+  if (pool->base == NULL) {
+    return -1;
+  }
+
+  // Link all blocks into the free-list
+  block = pool->base;
+  for (i = 0U; i < (block_count - 1U); i++) {
+    *(void **)block = block + block_size;
+    block += block_size;
+  }
+  *(void **)block = NULL;
+
+  pool->free        = pool->base;
+  pool->block_size  = block_size;
+  pool->block_count = block_count;
+  pool->used        = 0U;
+
+  return 0;
+}
+
+/**
+  Allocate block from pool
+
+  \param[in]   pool  Pool control block
+  \return          Pointer to block, or NULL when pool is exhausted.
+*/
+void *ospi_ram_pool_alloc (ospi_ram_pool_t *pool) {
+  uint32_t primask;
+  void    *block;
+
+  primask = critical_enter();
+  block = pool->free;
+  if (block != NULL) {
+    pool->free = *(void **)block;
+    pool->used++;
+  }
+  critical_leave(primask);
+
+  return block;
+}
+
+/**
+  Return block to pool
+
+  \param[in]   pool   Pool control block
+  \param[in]   block  Block returned by ospi_ram_pool_alloc
+*/
+void ospi_ram_pool_free (ospi_ram_pool_t *pool, void *block) {
+  uint32_t primask;
+
+  if (block == NULL) {
+    return;
+  }
+
+  primask = critical_enter();
+  *(void **)block = pool->free;
+  pool->free = block;
+  pool->used--;
+  critical_leave(primask);
+}
+
+/**
+  Convert number of bytes transferred in given cycles to kB/s
+
+  \param[in]   bytes   Number of bytes
+  \param[in]   cycles  Number of CPU cycles
+  \return          Throughput in kB/s.
+*/
+static uint32_t bench_rate (uint32_t bytes, uint32_t cycles) {
+  if (cycles == 0U) {
+    return 0U;
+  }
+  return (uint32_t)(((uint64_t)bytes * SystemCoreClock) / ((uint64_t)cycles * 1024U));
+}
+
+/**
+  Measure PSRAM throughput for sequential and random 32-bit accesses
+
+  Uses OSPI_RAM_BENCH_SIZE bytes of free arena memory (content is destroyed).
+
+  \param[out]  result  Benchmark result
+  \return          0 on success, or -1 on error.
+*/
+int ospi_ram_benchmark (ospi_ram_bench_t *result) {
+  volatile uint32_t *buf;
+  volatile uint32_t  sink;
+  uint32_t           mark, start, i, idx, acc;
+  const uint32_t     words = OSPI_RAM_BENCH_SIZE / 4U;
+
+  if (result == NULL) {
+    return -1;
+  }
+
+  mark = ospi_ram_mark();
+  buf  = ospi_ram_alloc(OSPI_RAM_BENCH_SIZE);
+  if (buf == NULL) {
+    return -1;
+  }
+
+  // Enable cycle counter
+  DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+
+  start = DWT->CYCCNT;
+  for (i = 0U; i < words; i++) {
+    buf[i] = i;
+  }
+  result->seq_write = bench_rate(OSPI_RAM_BENCH_SIZE, DWT->CYCCNT - start);
+
+  acc   = 0U;
+  start = DWT->CYCCNT;
+  for (i = 0U; i < words; i++) {
+    acc += buf[i];
+  }
+  result->seq_read = bench_rate(OSPI_RAM_BENCH_SIZE, DWT->CYCCNT - start);
+  sink = acc;
+
+  // Random accesses use a linear congruential sequence over the window
+  idx   = 1U;
+  start = DWT->CYCCNT;
+  for (i = 0U; i < words; i++) {
+    idx = (idx * 1664525U) + 1013904223U;
+    buf[(idx >> 8) & (words - 1U)] = i;
+  }
+  result->rnd_write = bench_rate(OSPI_RAM_BENCH_SIZE, DWT->CYCCNT - start);
+
+  acc   = 0U;
+  idx   = 1U;
+  start = DWT->CYCCNT;
+  for (i = 0U; i < words; i++) {
+    idx = (idx * 1664525U) + 1013904223U;
+    acc += buf[(idx >> 8) & (words - 1U)];
+  }
+  result->rnd_read = bench_rate(OSPI_RAM_BENCH_SIZE, DWT->CYCCNT - start);
+  sink = acc;
+  (void)sink;
+
+  ospi_ram_release(mark);
+
+  return 0;
+}
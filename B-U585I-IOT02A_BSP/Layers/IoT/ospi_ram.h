@@ -0,0 +1,71 @@
+/*---------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *      Name:    ospi_ram.h
+ *      Purpose: Octal-SPI PSRAM (APS6408) external memory and allocator
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef OSPI_RAM_H
+#define OSPI_RAM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Memory-mapped PSRAM window (OCTOSPI1)
+#define OSPI_RAM_BASE           0x90000000U
+#define OSPI_RAM_SIZE           0x00800000U
+
+// Allocation granularity (cache line size, suitable for DMA)
+#define OSPI_RAM_ALIGNMENT      32U
+
+// Fixed-size block pool
+typedef struct {
+  void                 *free;           // Free-list head
+  uint8_t              *base;           // First block
+  uint32_t              block_size;     // Block size in bytes
+  uint32_t              block_count;    // Number of blocks
+  uint32_t              used;           // Number of allocated blocks
+} ospi_ram_pool_t;
+
+// Throughput benchmark result (in kB/s)
+typedef struct {
+  uint32_t              seq_write;      // Sequential 32-bit writes
+  uint32_t              seq_read;       // Sequential 32-bit reads
+  uint32_t              rnd_write;      // Random 32-bit writes
+  uint32_t              rnd_read;       // Random 32-bit reads
+} ospi_ram_bench_t;
+
+extern int       ospi_ram_init          (void);
+extern void     *ospi_ram_alloc         (uint32_t size);
+extern uint32_t  ospi_ram_mark          (void);
+extern void      ospi_ram_release       (uint32_t mark);
+extern uint32_t  ospi_ram_available     (void);
+extern int       ospi_ram_pool_init     (ospi_ram_pool_t *pool, uint32_t block_size, uint32_t block_count);
+extern void     *ospi_ram_pool_alloc    (ospi_ram_pool_t *pool);
+extern void      ospi_ram_pool_free     (ospi_ram_pool_t *pool, void *block);
+extern int       ospi_ram_benchmark     (ospi_ram_bench_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSPI_RAM_H */
@@ -22,20 +22,162 @@
  *---------------------------------------------------------------------------*/
 
 #include "Driver_USART.h"
+#include "UART_STM32U5xx_Ext.h"                 // UART_CONTROL_RX_RING
+
+#include "RTE_Components.h"                     // Component selection
+#include CMSIS_device_header
 
 // Compile-time configuration
 #define USART_DRV_NUM           1
 #define USART_BAUDRATE          115200
 
+// Output buffering (stdout and stderr share one transmit ring)
+#define STDIO_TX_BUF_SIZE       1024    // Transmit ring size in bytes (power of 2)
+#define STDIO_FLUSH_LINE        1       // Flush on new line character: 1 = enabled, 0 = disabled
+#define STDIO_FLUSH_SIZE        64      // Flush when this number of bytes is buffered
+#define STDIO_FLUSH_TIMEOUT     10      // Flush buffered bytes older than this (in ms, checked on output, input and stdio_poll, 0 = disabled)
+#define STDIO_OVERFLOW_DROP     1       // Ring full: 1 = drop and count characters, 0 = wait for space (thread mode with interrupts enabled only)
+
+// Input buffering (continuous reception into a receive ring)
+#define STDIO_RX_BUF_SIZE       4096    // Receive ring size in bytes (power of 2, max 32768)
+
+#if ((STDIO_TX_BUF_SIZE & (STDIO_TX_BUF_SIZE - 1)) != 0)
+#error "STDIO_TX_BUF_SIZE must be a power of 2!"
+#endif
+#if ((STDIO_RX_BUF_SIZE & (STDIO_RX_BUF_SIZE - 1)) != 0) || (STDIO_RX_BUF_SIZE > 32768)
+#error "STDIO_RX_BUF_SIZE must be a power of 2 and at most 32768!"
+#endif
+
 // Exported functions
-extern int stdio_init     (void);
-extern int stderr_putchar (int ch);
-extern int stdout_putchar (int ch);
-extern int stdin_getchar  (void);
+extern int      stdio_init       (void);
+extern int      stderr_putchar   (int ch);
+extern int      stdout_putchar   (int ch);
+extern int      stdin_getchar    (void);
+extern int      stdin_getchar_nonblock (void);
+extern int      stdin_getline    (char *line, int size);
+extern void     stdio_flush      (void);
+extern void     stdio_poll       (void);
+extern uint32_t stdio_get_dropped (void);
+
+// HAL time base (ms)
+extern uint32_t HAL_GetTick (void);
 
 extern ARM_DRIVER_USART     ARM_Driver_USART_(USART_DRV_NUM);
 #define ptrUSART          (&ARM_Driver_USART_(USART_DRV_NUM))
 
+// Transmit ring (indexes are free-running)
+static uint8_t           tx_buf[STDIO_TX_BUF_SIZE] __ALIGNED(32);
+static volatile uint32_t tx_head;       // Bytes written by stdout/stderr
+static volatile uint32_t tx_tail;       // Bytes sent by the driver
+static volatile uint32_t tx_flush;      // Bytes requested to be sent
+static volatile uint32_t tx_len;        // Bytes of transfer in progress
+static volatile uint32_t tx_dropped;    // Bytes dropped on ring overflow
+static          uint32_t tx_time;       // Time of oldest unflushed byte
+
+// Receive ring (filled by the driver in the background)
+static uint8_t           rx_buf[STDIO_RX_BUF_SIZE] __ALIGNED(32);
+static UART_RX_RING      rx_ring = { rx_buf, STDIO_RX_BUF_SIZE, 0U, 0U };
+static uint8_t           rx_ring_active;        // Receive ring running
+static int               rx_line_len;           // Length of line being assembled
+static uint8_t           rx_line_cr;            // Last line terminated by CR
+
+/**
+  Start sending flushed part of the ring (called with interrupts disabled or from the driver event)
+*/
+static void tx_start (void) {
+  uint32_t pos, num;
+
+  if (tx_len != 0U) {
+    // Transfer in progress, continued from the send complete event
+    return;
+  }
+
+  num = tx_flush - tx_tail;
+  if (num == 0U) {
+    return;
+  }
+
+  // Send contiguous part up to the ring end
+  pos = tx_tail & (STDIO_TX_BUF_SIZE - 1U);
+  if (num > (STDIO_TX_BUF_SIZE - pos)) {
+    num = STDIO_TX_BUF_SIZE - pos;
+  }
+
+  tx_len = num;
+  if (ptrUSART->Send(&tx_buf[pos], num) != ARM_DRIVER_OK) {
+    tx_len = 0U;
+  }
+}
+
+/**
+  USART event callback
+
+  \param[in]   event  USART events
+*/
+static void stdio_event (uint32_t event) {
+
+  if ((event & ARM_USART_EVENT_SEND_COMPLETE) != 0U) {
+    tx_tail += tx_len;
+    tx_len   = 0U;
+    tx_start();
+  }
+}
+
+/**
+  Write a character to the transmit ring and apply the flush policy
+
+  \param[in]   ch     Character to output
+  \param[in]   flush  Flush unconditionally
+*/
+static void tx_put (uint8_t ch, uint32_t flush) {
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  while ((tx_head - tx_tail) >= STDIO_TX_BUF_SIZE) {
+    // Ring full: make sure it is being drained
+    tx_flush = tx_head;
+    tx_start();
+#if (STDIO_OVERFLOW_DROP == 0)
+    if ((__get_IPSR() == 0U) && ((primask & 1U) == 0U)) {
+      // Thread mode with interrupts enabled: wait until the driver frees space
+      __set_PRIMASK(primask);
+      __disable_irq();
+      continue;
+    }
+#endif
+    // Drop (always in handler mode or with interrupts disabled, the ring cannot drain there)
+    tx_dropped++;
+    __set_PRIMASK(primask);
+    return;
+  }
+
+  if (tx_head == tx_flush) {
+    tx_time = HAL_GetTick();
+  }
+
+  tx_buf[tx_head & (STDIO_TX_BUF_SIZE - 1U)] = ch;
+  tx_head++;
+
+#if (STDIO_FLUSH_LINE != 0)
+  if (ch == '\n') {
+    flush = 1U;
+  }
+#endif
+#if (STDIO_FLUSH_TIMEOUT != 0)
+  if ((HAL_GetTick() - tx_time) >= STDIO_FLUSH_TIMEOUT) {
+    flush = 1U;
+  }
+#endif
+  if ((flush != 0U) || ((tx_head - tx_flush) >= STDIO_FLUSH_SIZE)) {
+    tx_flush = tx_head;
+    tx_start();
+  }
+
+  __set_PRIMASK(primask);
+}
+
 /**
   Initialize stdio
 
@@ -43,7 +185,7 @@ extern ARM_DRIVER_USART     ARM_Driver_USART_(USART_DRV_NUM);
 */
 int stdio_init (void) {
 
-  if (ptrUSART->Initialize(NULL) != ARM_DRIVER_OK) {
+  if (ptrUSART->Initialize(stdio_event) != ARM_DRIVER_OK) {
     return -1;
   }
 
@@ -60,13 +202,69 @@ int stdio_init (void) {
     return -1;
   }
 
+  if (ptrUSART->Control(ARM_USART_CONTROL_TX, 1U) != ARM_DRIVER_OK) {
+    return -1;
+  }
+
   if (ptrUSART->Control(ARM_USART_CONTROL_RX, 1U) != ARM_DRIVER_OK) {
     return -1;
   }
 
+  // Start continuous reception (stdin falls back to single character receive)
+  if (ptrUSART->Control(UART_CONTROL_RX_RING, (uint32_t)&rx_ring) == ARM_DRIVER_OK) {
+    rx_ring_active = 1U;
+  }
+
   return 0;
 }
 
+/**
+  Flush buffered stdout/stderr output (sent in the background)
+*/
+void stdio_flush (void) {
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  tx_flush = tx_head;
+  tx_start();
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  Flush buffered stdout output older than STDIO_FLUSH_TIMEOUT
+
+  Output is otherwise only checked for the timeout when the next character is
+  written or input is read: call periodically (for example from the idle loop)
+  when the program may stop writing without reading input.
+*/
+void stdio_poll (void) {
+#if (STDIO_FLUSH_TIMEOUT != 0)
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  if ((tx_head != tx_flush) && ((HAL_GetTick() - tx_time) >= STDIO_FLUSH_TIMEOUT)) {
+    tx_flush = tx_head;
+    tx_start();
+  }
+
+  __set_PRIMASK(primask);
+#endif
+}
+
+/**
+  Get number of characters dropped on transmit ring overflow
+
+  \return          number of dropped characters
+*/
+uint32_t stdio_get_dropped (void) {
+  return tx_dropped;
+}
+
 /**
   Put a character to the stderr
 
@@ -74,15 +272,9 @@ int stdio_init (void) {
   \return          The character written, or -1 on write error.
 */
 int stderr_putchar (int ch) {
-  uint8_t buf[1];
-
-  buf[0] = (uint8_t)ch;
 
-  if (ptrUSART->Send(buf, 1U) != ARM_DRIVER_OK) {
-    return -1;
-  }
-
-  while (ptrUSART->GetTxCount() != 1U);
+  // Unbuffered: flushed immediately, in order with stdout
+  tx_put((uint8_t)ch, 1U);
 
   return ch;
 }
@@ -94,17 +286,32 @@ int stderr_putchar (int ch) {
   \return          The character written, or -1 on write error.
 */
 int stdout_putchar (int ch) {
+
+  tx_put((uint8_t)ch, 0U);
+
+  return ch;
+}
+
+/**
+  Get a character from the stdio without waiting
+
+  \return     The next character from the input, or -1 if no character is available.
+*/
+int stdin_getchar_nonblock (void) {
   uint8_t buf[1];
 
-  buf[0] = (uint8_t)ch;
+  // Input polling: send output that waits for the flush timeout
+  stdio_poll();
 
-  if (ptrUSART->Send(buf, 1U) != ARM_DRIVER_OK) {
+  if (rx_ring_active == 0U) {
     return -1;
   }
 
-  while (ptrUSART->GetStatus().tx_busy != 0U);
+  if (UART_RxRingRead(&rx_ring, buf, 1U) == 0U) {
+    return -1;
+  }
 
-  return ch;
+  return (int)buf[0];
 }
 
 /**
@@ -114,6 +321,17 @@ int stdout_putchar (int ch) {
 */
 int stdin_getchar (void) {
   uint8_t buf[1];
+  int     ch;
+
+  // Show pending output (prompt) before waiting for input
+  stdio_flush();
+
+  if (rx_ring_active != 0U) {
+    do {
+      ch = stdin_getchar_nonblock();
+    } while (ch < 0);
+    return ch;
+  }
 
   if (ptrUSART->Receive(buf, 1U) != ARM_DRIVER_OK) {
     return -1;
@@ -123,3 +341,59 @@ int stdin_getchar (void) {
 
   return (int)buf[0];
 }
+
+/**
+  Assemble a line from the stdio without waiting
+
+  Call repeatedly with the same buffer until a line is complete. CR, LF and
+  CR LF terminate a line; backspace and DEL remove the last character.
+
+  \param[out]  line  Buffer for the line (null-terminated, without line terminator)
+  \param[in]   size  Size of the buffer (at least 1)
+  \return            Length of the completed line, or -1 if the line is not complete yet.
+*/
+int stdin_getline (char *line, int size) {
+  int ch;
+
+  if (size < 1) {
+    return -1;
+  }
+
+  while ((ch = stdin_getchar_nonblock()) >= 0) {
+    if ((ch == '\n') && (rx_line_cr != 0U)) {
+      // LF of CR LF: line already completed
+      rx_line_cr = 0U;
+      continue;
+    }
+    rx_line_cr = 0U;
+
+    if ((ch == '\r') || (ch == '\n')) {
+      rx_line_cr = (ch == '\r') ? 1U : 0U;
+      break;
+    }
+    if ((ch == '\b') || (ch == 0x7F)) {
+      if (rx_line_len > 0) {
+        rx_line_len--;
+      }
+      continue;
+    }
+
+    if ((rx_line_len + 1) < size) {
+      line[rx_line_len++] = (char)ch;
+    }
+    if ((rx_line_len + 1) >= size) {
+      // Buffer full: return line as is
+      break;
+    }
+  }
+
+  if (ch < 0) {
+    return -1;
+  }
+
+  line[rx_line_len] = '\0';
+  ch = rx_line_len;
+  rx_line_len = 0;
+
+  return ch;
+}
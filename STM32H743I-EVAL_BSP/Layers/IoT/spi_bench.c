@@ -0,0 +1,210 @@
+/*---------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *      Name:    spi_bench.c
+ *      Purpose: SPI transfer latency benchmark (interrupt, DMA and fast path)
+ *
+ *---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+
+#include "Driver_SPI.h"
+#include "SPI_STM32H7xx_Ext.h"                  // SPI_SET_PATH, SPI_GET_STATISTICS
+
+#include "RTE_Components.h"                     // Component selection
+#include CMSIS_device_header
+
+#include "spi_bench.h"
+
+// Compile-time configuration
+#ifndef SPI_BENCH_DRV_NUM
+#define SPI_BENCH_DRV_NUM       1       // SPI driver instance (Tx and Rx DMA configured in STM32CubeMX)
+#endif
+#ifndef SPI_BENCH_BUS_SPEED
+#define SPI_BENCH_BUS_SPEED     10000000 // Bus speed in bps
+#endif
+#ifndef SPI_BENCH_REPEAT
+#define SPI_BENCH_REPEAT        16      // Transfers measured per size and path (minimum latency is reported)
+#endif
+#ifndef SPI_BENCH_TIMEOUT
+#define SPI_BENCH_TIMEOUT       100     // Transfer timeout in ms
+#endif
+
+extern ARM_DRIVER_SPI     ARM_Driver_SPI_(SPI_BENCH_DRV_NUM);
+#define ptrSPI          (&ARM_Driver_SPI_(SPI_BENCH_DRV_NUM))
+
+// Transfer buffers (cache line aligned, DMA capable)
+static uint8_t           tx_buf[SPI_BENCH_SIZE_MAX] __ALIGNED(32);
+static uint8_t           rx_buf[SPI_BENCH_SIZE_MAX] __ALIGNED(32);
+
+static volatile uint32_t bench_event;   // Events of the transfer in progress
+static volatile uint32_t bench_end;     // Cycle counter at the first event
+
+/**
+  SPI driver event callback: capture the cycle counter at transfer end
+
+  \param[in]   event   SPI events (ARM_SPI_EVENT_xxx)
+*/
+static void bench_callback (uint32_t event) {
+  if (bench_event == 0U) {
+    bench_end = DWT->CYCCNT;
+  }
+  bench_event |= event;
+}
+
+/**
+  Check if the measured transfer used the requested path
+
+  \param[in]   path    Transfer path (SPI_PATH_xxx)
+  \param[in]   before  Statistics before the transfer
+  \param[in]   after   Statistics after the transfer
+  \return          1 if the requested path was used, 0 otherwise.
+*/
+static uint32_t bench_path_used (uint32_t path, const SPI_STATISTICS *before, const SPI_STATISTICS *after) {
+  switch (path) {
+    case SPI_PATH_AUTO:
+      return (after->fast != before->fast) ? 1U : 0U;
+    case SPI_PATH_DMA:
+      return ((after->dma != before->dma) || (after->dma_bounce != before->dma_bounce)) ? 1U : 0U;
+    default:
+      return (after->irq != before->irq) ? 1U : 0U;
+  }
+}
+
+/**
+  Measure transfer latency of one transfer path for all transfer sizes
+
+  Latency is measured from the Transfer call to the transfer complete event.
+
+  \param[in]   path    Transfer path (SPI_PATH_xxx)
+  \param[out]  cycles  Minimum latency in CPU cycles per transfer size (0 = path not used)
+  \return          0 on success, or -1 on error.
+*/
+static int bench_path (uint32_t path, uint32_t *cycles) {
+  SPI_STATISTICS before, after;
+  uint32_t       size, n, start, timeout, lat, min, used;
+
+  if (ptrSPI->Control(SPI_SET_PATH, path) != ARM_DRIVER_OK) {
+    return -1;
+  }
+  timeout = (SystemCoreClock / 1000U) * SPI_BENCH_TIMEOUT;
+
+  for (size = 1U; size <= SPI_BENCH_SIZE_MAX; size++) {
+    min  = UINT32_MAX;
+    used = 1U;
+    for (n = 0U; n < SPI_BENCH_REPEAT; n++) {
+      (void)ptrSPI->Control(SPI_GET_STATISTICS, (uint32_t)&before);
+      bench_event = 0U;
+      start = DWT->CYCCNT;
+      if (ptrSPI->Transfer(tx_buf, rx_buf, size) != ARM_DRIVER_OK) {
+        return -1;
+      }
+      while ((bench_event == 0U) && ((DWT->CYCCNT - start) < timeout));
+      if (bench_event != ARM_SPI_EVENT_TRANSFER_COMPLETE) {
+        (void)ptrSPI->Control(ARM_SPI_ABORT_TRANSFER, 0U);
+        return -1;
+      }
+      lat = bench_end - start;
+      (void)ptrSPI->Control(SPI_GET_STATISTICS, (uint32_t)&after);
+
+      if (bench_path_used(path, &before, &after) == 0U) {
+        used = 0U;
+      }
+      if (lat < min) {
+        min = lat;
+      }
+    }
+    cycles[size - 1U] = (used != 0U) ? min : 0U;
+  }
+
+  return 0;
+}
+
+/**
+  Measure SPI transfer latency for 1 .. SPI_BENCH_SIZE_MAX byte transfers
+
+  Compares HAL interrupt mode, DMA and the FIFO packed fast path of the
+  SPI driver (the fast path requires SPI_FAST_XFER_MAX >= SPI_BENCH_SIZE_MAX).
+  The SPI is used as bus master with 8-bit frames, no slave device is needed.
+
+  \param[out]  result  Benchmark result
+  \return          0 on success, or -1 on error.
+*/
+int spi_bench_run (spi_bench_t *result) {
+  uint32_t i;
+  int      err;
+
+  if (result == NULL) {
+    return -1;
+  }
+
+  for (i = 0U; i < SPI_BENCH_SIZE_MAX; i++) {
+    tx_buf[i] = (uint8_t)i;
+  }
+
+  // Enable cycle counter
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+  if (ptrSPI->Initialize(bench_callback) != ARM_DRIVER_OK) {
+    return -1;
+  }
+  err = -1;
+  if ((ptrSPI->PowerControl(ARM_POWER_FULL) == ARM_DRIVER_OK) &&
+      (ptrSPI->Control(ARM_SPI_MODE_MASTER | ARM_SPI_CPOL0_CPHA0 | ARM_SPI_MSB_LSB |
+                       ARM_SPI_DATA_BITS(8) | ARM_SPI_SS_MASTER_UNUSED, SPI_BENCH_BUS_SPEED) == ARM_DRIVER_OK)) {
+    if ((bench_path(SPI_PATH_IRQ,  result->irq)  == 0) &&
+        (bench_path(SPI_PATH_DMA,  result->dma)  == 0) &&
+        (bench_path(SPI_PATH_AUTO, result->fast) == 0)) {
+      err = 0;
+    }
+    (void)ptrSPI->Control(SPI_SET_PATH, SPI_PATH_AUTO);
+  }
+  (void)ptrSPI->PowerControl(ARM_POWER_OFF);
+  (void)ptrSPI->Uninitialize();
+
+  return err;
+}
+
+/**
+  Print benchmark result as a table (latency in us, - = path not used)
+
+  \param[in]   result  Benchmark result
+*/
+void spi_bench_print (const spi_bench_t *result) {
+  const uint32_t *col[3];
+  uint32_t        size, i, ns;
+
+  col[0] = result->irq;
+  col[1] = result->dma;
+  col[2] = result->fast;
+
+  printf("Bytes    IRQ [us]    DMA [us]   Fast [us]\n");
+  for (size = 1U; size <= SPI_BENCH_SIZE_MAX; size++) {
+    printf("%5u", (unsigned int)size);
+    for (i = 0U; i < 3U; i++) {
+      if (col[i][size - 1U] == 0U) {
+        printf("%12s", "-");
+      } else {
+        ns = (uint32_t)(((uint64_t)col[i][size - 1U] * 1000000000U) / SystemCoreClock);
+        printf("%8u.%03u", (unsigned int)(ns / 1000U), (unsigned int)(ns % 1000U));
+      }
+    }
+    printf("\n");
+  }
+}
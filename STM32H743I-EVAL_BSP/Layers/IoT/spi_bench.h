@@ -0,0 +1,50 @@
+/*---------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *      Name:    spi_bench.h
+ *      Purpose: SPI transfer latency benchmark (interrupt, DMA and fast path)
+ *
+ *---------------------------------------------------------------------------*/
+
+#ifndef SPI_BENCH_H
+#define SPI_BENCH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Transfers of 1 .. SPI_BENCH_SIZE_MAX bytes are measured
+#define SPI_BENCH_SIZE_MAX      64U
+
+// Transfer latency benchmark result (in CPU cycles, index = transfer size - 1, 0 = path not used)
+typedef struct {
+  uint32_t              irq [SPI_BENCH_SIZE_MAX];   // HAL interrupt mode
+  uint32_t              dma [SPI_BENCH_SIZE_MAX];   // DMA (unaligned reception through bounce buffer)
+  uint32_t              fast[SPI_BENCH_SIZE_MAX];   // FIFO packed fast path
+} spi_bench_t;
+
+extern int       spi_bench_run          (spi_bench_t *result);
+extern void      spi_bench_print        (const spi_bench_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPI_BENCH_H */
@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        10. July 2023
- * $Revision:    V1.7
+ * $Date:        18. October 2024
+ * $Revision:    V1.9
  *
  * Driver:       Driver_I2C1/2/3/4/5
  *
@@ -30,6 +30,11 @@
 
 # Revision History
 
+- Version 1.9
+  - Added master transaction lists (I2C_CONTROL_XFER_LIST) executed from interrupt context
+- Version 1.8
+  - Replaced exhaustive TIMING register search with a closed-form solver
+  - Added cache of computed TIMING register values (I2C_TIMING_CACHE_SIZE)
 - Version 1.7
   - Updated PowerControl function (added check if Instance is valid)
   - Updated Control function implementation for transfer abort (added check for master mode)
@@ -76,6 +81,33 @@ Hardware limitations:
  - I2C4 with BDMA can access only SRAM4 memory.
    If BDMA is used on I2C4 ensure that Tx and Rx buffers are be positioned in SRAM4 memory.
 
+# Transaction Lists
+
+Vendor specific control code **I2C_CONTROL_XFER_LIST** starts a list of master transfer segments
+(arg = pointer to **I2C_XFER_LIST**). Each segment (**I2C_XFER_SEG**) specifies slave address,
+direction (**I2C_XFER_SEG_READ**) and data buffer. A segment with **I2C_XFER_SEG_NO_STOP** is
+followed by a repeated START, otherwise by a STOP condition. Segments may address different slaves.
+
+The driver starts each segment from the transfer complete interrupt of the previous one (using DMA
+when configured) and signals \ref ARM_I2C_EVENT_TRANSFER_DONE once, when the whole list is done.
+On error the list is terminated (a STOP condition is generated when the previous segment ended
+without STOP), the event is signaled with \ref ARM_I2C_EVENT_TRANSFER_INCOMPLETE and list member
+**idx** holds the index of the failed segment. \ref ARM_I2C_ABORT_TRANSFER stops the list.
+GetDataCount returns the number of bytes transferred in the current segment.
+
+Typical register read (write register address, repeated START, read data):
+\code
+static uint8_t reg_addr = 0x0FU;
+static uint8_t reg_data[6];
+static I2C_XFER_SEG  seg[2] = {
+  { 0x1EU, I2C_XFER_SEG_NO_STOP, &reg_addr, 1U },
+  { 0x1EU, I2C_XFER_SEG_READ,    reg_data,  6U }
+};
+static I2C_XFER_LIST list = { seg, 2U, 0U };
+
+Driver_I2C1.Control(I2C_CONTROL_XFER_LIST, (uint32_t)&list);
+\endcode
+
 # Configuration
 
 ## Compile-time
@@ -114,6 +146,8 @@ I2C4_DNF_COEFFICIENT               |     **0**     |   0   | I2C4 digital noise
 ^                                  |       ^       | 1..15 | I2C4 digital noise filter coefficient number
 I2C5_DNF_COEFFICIENT               |     **0**     |   0   | I2C5 digital noise filter coefficient: **disabled**
 ^                                  |       ^       | 1..15 | I2C5 digital noise filter coefficient number
+I2C_TIMING_CACHE_SIZE              |     **4**     |   0   | TIMING register cache: **disabled**
+^                                  |       ^       | 1..32 | Number of cached TIMING register values (kernel clock, bus speed, filters)
 
 
 ## STM32CubeMX
@@ -229,7 +263,7 @@ Generate source code by clicking on the **GENERATE CODE** button on the toolbar.
 
 #ifdef  I2C_CUBE_MX_ENABLED
 
-#define ARM_I2C_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,7)    /* driver version */
+#define ARM_I2C_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,9)    /* driver version */
 
 /* Analog noise filter state: 0 - disable, 1 - enable */
 #ifndef I2C1_ANF_ENABLE
@@ -265,6 +299,13 @@ Generate source code by clicking on the **GENERATE CODE** button on the toolbar.
 #define I2C5_DNF_COEFFICIENT            0
 #endif
 
+#ifndef I2C_TIMING_CACHE_SIZE
+#define I2C_TIMING_CACHE_SIZE           (4U)
+#endif
+#if    (I2C_TIMING_CACHE_SIZE > 32U)
+#error  "I2C_TIMING_CACHE_SIZE value invalid (must be 0..32)!!!"
+#endif
+
 #ifndef I2C_DCACHE_MAINTENANCE
 #define I2C_DCACHE_MAINTENANCE          (1U)
 #endif
@@ -310,7 +351,7 @@ static const ARM_I2C_CAPABILITIES DriverCapabilities = {
 extern I2C_HandleTypeDef hi2c1;
 
 /* I2C1 Information (Run-Time) */
-static I2C_INFO I2C1_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U };
+static I2C_INFO I2C1_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U, NULL };
 
 /* I2C1 Resources */
 static I2C_RESOURCES I2C1_Resources = {
@@ -337,7 +378,7 @@ static I2C_RESOURCES I2C1_Resources = {
 extern I2C_HandleTypeDef hi2c2;
 
 /* I2C2 Information (Run-Time) */
-static I2C_INFO I2C2_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U };
+static I2C_INFO I2C2_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U, NULL };
 
 /* I2C2 Resources */
 static I2C_RESOURCES I2C2_Resources = {
@@ -364,7 +405,7 @@ static I2C_RESOURCES I2C2_Resources = {
 extern I2C_HandleTypeDef hi2c3;
 
 /* I2C3 Information (Run-Time) */
-static I2C_INFO I2C3_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U };
+static I2C_INFO I2C3_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U, NULL };
 
 /* I2C3 Resources */
 static I2C_RESOURCES I2C3_Resources = {
@@ -391,7 +432,7 @@ static I2C_RESOURCES I2C3_Resources = {
 extern I2C_HandleTypeDef hi2c4;
 
 /* I2C4 Information (Run-Time) */
-static I2C_INFO I2C4_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U };
+static I2C_INFO I2C4_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U, NULL };
 
 /* I2C4 Resources */
 static I2C_RESOURCES I2C4_Resources = {
@@ -418,7 +459,7 @@ static I2C_RESOURCES I2C4_Resources = {
 extern I2C_HandleTypeDef hi2c5;
 
 /* I2C5 Information (Run-Time) */
-static I2C_INFO I2C5_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U };
+static I2C_INFO I2C5_Info = { NULL, { 0U, 0U, 0U, 0U, 0U, 0U, 0U }, 0U, 0U, 0U, 0U, NULL, 0U, NULL };
 
 /* I2C5 Resources */
 static I2C_RESOURCES I2C5_Resources = {
@@ -480,6 +521,13 @@ static I2C_RESOURCES *I2C_GetResources   (I2C_HandleTypeDef *hi2c);
 static uint32_t       I2C_GetPeriClock   (I2C_TypeDef *i2c);
 static int32_t        I2C_GetSCLRatio    (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec, I2C_TIMING *cfg);
 static uint32_t       I2C_GetTimingValue (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec);
+static uint32_t       I2C_GetTiming      (I2C_RESOURCES *i2c, uint32_t fpclk, uint32_t fscl, I2C_STD_TIME *spec);
+
+#if (I2C_TIMING_CACHE_SIZE > 0U)
+/* TIMING register cache (shared by all instances) */
+static I2C_TIMING_CACHE I2C_TimingCache[I2C_TIMING_CACHE_SIZE];
+static uint32_t         I2C_TimingCacheNext;
+#endif
 
 /* Retrieve pointer to I2C instance resources */
 static I2C_RESOURCES *I2C_GetResources (I2C_HandleTypeDef *hi2c) {
@@ -564,9 +612,8 @@ static uint32_t I2C_GetPeriClock (I2C_TypeDef *i2c) {
 static int32_t I2C_GetSCLRatio (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec, I2C_TIMING *cfg) {
   uint32_t clk_max, clk_min;
   uint32_t tpresc, tsync;
-  uint32_t tscl, tscll, tsclh;
-  uint32_t scll, sclh;
-  int32_t  err;
+  uint32_t tscl, tmin;
+  uint32_t scll, sclh, n;
 
   /* Set minimum bus clock frequency to 80% of max */
   clk_min = (spec->clk_max * 80) / 100;
@@ -577,38 +624,53 @@ static int32_t I2C_GetSCLRatio (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec, I2C_TI
   tsync   = setup->afd_min + setup->dfd + (2 * setup->i2cclk);
   tpresc = (cfg->presc + 1) * setup->i2cclk;
 
-  err = 0;
-
-  /* Evaluate all values of SCLL and SCLH */
-  for (scll = 0; scll < I2C_TIMINGR_SCLL_MAX; scll++) {
-    tscll = ((scll + 1) * tpresc) + tsync;
-
-    if ((tscll >= spec->scll_min) && (setup->i2cclk < ((tscll - setup->afd_min - setup->dfd) / 4))) {
-      /* SCL low meets specification */
+  /* tSCLL = (SCLL + 1) * tPRESC + tSYNC: lowest SCLL meeting SCL low specification */
+  tmin = (uint32_t)setup->afd_min + setup->dfd + (4U * (setup->i2cclk + 1U));
+  if (tmin < spec->scll_min) {
+    tmin = spec->scll_min;
+  }
+  scll = (tmin > (tpresc + tsync)) ? (((tmin - tsync) + tpresc - 1) / tpresc) - 1 : 0;
 
-      for (sclh = 0; sclh < I2C_TIMINGR_SCLH_MAX; sclh++) {
-        tsclh = ((sclh + 1) * tpresc) + tsync;
+  /* tSCLH = (SCLH + 1) * tPRESC + tSYNC: lowest SCLH meeting SCL high specification */
+  tmin = spec->sclh_min;
+  if (tmin < (setup->i2cclk + 1U)) {
+    tmin = setup->i2cclk + 1U;
+  }
+  sclh = (tmin > (tpresc + tsync)) ? (((tmin - tsync) + tpresc - 1) / tpresc) - 1 : 0;
 
-        if ((tsclh >= spec->sclh_min) && (tsclh > setup->i2cclk)) {
-          /* SCL high meets specification */
-          tscl = tscll + tsclh;
+  if ((scll >= I2C_TIMINGR_SCLL_MAX) || (sclh >= I2C_TIMINGR_SCLH_MAX)) {
+    /* No solution */
+    return (-1);
+  }
 
-          if ((tscl >= clk_min) && (tscl <= clk_max)) {
-            /* Evaluate SCL period error */
-            err = (int32_t)(tscl - setup->busclk);
+  /* tSCL = (SCLL + SCLH + 2) * tPRESC + 2 * tSYNC: lowest sum not below bus clock period */
+  tmin = (setup->busclk > clk_min) ? setup->busclk : clk_min;
+  n    = (tmin > ((2 * tpresc) + (2 * tsync))) ? (((tmin - (2 * tsync)) + tpresc - 1) / tpresc) - 2 : 0;
+  if (n < (scll + sclh)) {
+    n = scll + sclh;
+  }
 
-            if (err >= 0) {
-              cfg->sclh = (uint8_t)sclh;
-              cfg->scll = (uint8_t)scll;
-              return (err);
-            }
-          }
-        }
-      }
+  /* Extend SCL low when SCL high alone cannot cover the period */
+  if ((n - scll) >= I2C_TIMINGR_SCLH_MAX) {
+    scll = n - (I2C_TIMINGR_SCLH_MAX - 1);
+    if (scll >= I2C_TIMINGR_SCLL_MAX) {
+      /* No solution */
+      return (-1);
     }
   }
-  /* No solution */
-  return (-1);
+  sclh = n - scll;
+
+  tscl = ((n + 2) * tpresc) + (2 * tsync);
+  if (tscl > clk_max) {
+    /* No solution */
+    return (-1);
+  }
+
+  cfg->sclh = (uint8_t)sclh;
+  cfg->scll = (uint8_t)scll;
+
+  /* SCL period error */
+  return ((int32_t)(tscl - setup->busclk));
 }
 
 /* TIMING setup: Determine TIMING register settings based on input structures */
@@ -616,8 +678,8 @@ static uint32_t I2C_GetTimingValue (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec) {
   I2C_TIMING time;
   uint32_t dnf_en;
   uint32_t presc;
-  uint32_t sdadel, sdadel_min, sdadel_max;
-  uint32_t scldel, scldel_min;
+  uint32_t sdadel_min, sdadel_max;
+  uint32_t scldel_min;
   uint32_t p, l, a;
   uint32_t timing;
   int32_t  val, err;
@@ -653,50 +715,114 @@ static uint32_t I2C_GetTimingValue (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec) {
   /* Set timing register max value */
   timing = 0xF0FFFFFF;
 
-  /* Evaluate all values of PRESC, SCLDEL and SDADEL */
+  /* SCL low/high ratio depends on PRESC only: evaluate each PRESC once, with
+     the lowest SCLDEL and SDADEL within limits (lowest PRESC wins on equal error) */
   for (p = 0; p < I2C_TIMINGR_PRESC_MAX; p++) {
     presc = (p + 1) * setup->i2cclk;
 
-    for (l = 0; l < I2C_TIMINGR_SCLDEL_MAX; l++) {
-      /* tSCLDEL = (SCLDEL + 1) * ((PRESC + 1) * tI2CCLK) */
-      scldel = (l + 1) * presc;
-
-      if (scldel >= scldel_min) {
-        /* SCLDEL is above low limit, evaluate SDADEL */
-        for (a = 0; a < I2C_TIMINGR_SDADEL_MAX; a++) {
-          /* tSDADEL = SDADEL * ((PRESC + 1) * tI2CCLK) */
-          sdadel = a * presc;
-
-          if ((sdadel >= sdadel_min) && (sdadel <= sdadel_max)) {
-            /* Valid presc (p), scldel (l) and sdadel (a) */
-            time.presc  = (uint8_t)p;
-            time.scldel = (uint8_t)l;
-            time.sdadel = (uint8_t)a;
-
-            /* Determine SCLL and SCLH values */
-            err = I2C_GetSCLRatio (setup, spec, &time);
-
-            if (err >= 0) {
-              if (err < setup->error) {
-                /* Truncate error since it will never be bigger than 16-bit */
-                setup->error = (uint16_t)err;
-
-                /* Save timing settings */
-                timing  = (time.scll   & 0xFFU);
-                timing |= (time.sclh   & 0xFFU) <<  8;
-                timing |= (time.sdadel & 0x0FU) << 16;
-                timing |= (time.scldel & 0x0FU) << 20;
-                timing |= (time.presc  & 0x0FU) << 28;
-              }
-            }
-          }
-        }
+    /* tSCLDEL = (SCLDEL + 1) * ((PRESC + 1) * tI2CCLK) */
+    l = (scldel_min + presc - 1) / presc;
+    l = (l > 0U) ? (l - 1U) : 0U;
+
+    /* tSDADEL = SDADEL * ((PRESC + 1) * tI2CCLK) */
+    a = (sdadel_min + presc - 1) / presc;
+
+    if ((l >= I2C_TIMINGR_SCLDEL_MAX) || (a >= I2C_TIMINGR_SDADEL_MAX) || ((a * presc) > sdadel_max)) {
+      /* No valid SCLDEL or SDADEL for this PRESC */
+      continue;
+    }
+
+    time.presc  = (uint8_t)p;
+    time.scldel = (uint8_t)l;
+    time.sdadel = (uint8_t)a;
+
+    /* Determine SCLL and SCLH values */
+    err = I2C_GetSCLRatio (setup, spec, &time);
+
+    if ((err >= 0) && (err < setup->error)) {
+      /* Truncate error since it will never be bigger than 16-bit */
+      setup->error = (uint16_t)err;
+
+      /* Save timing settings */
+      timing  = (time.scll   & 0xFFU);
+      timing |= (time.sclh   & 0xFFU) <<  8;
+      timing |= (time.sdadel & 0x0FU) << 16;
+      timing |= (time.scldel & 0x0FU) << 20;
+      timing |= (time.presc  & 0x0FU) << 28;
+
+      if (err == 0) {
+        /* Exact bus clock */
+        break;
       }
     }
   }
 
   return (timing);
 }
+/* TIMING setup: end of solver (host cross-check in Tools/I2CTiming) */
+
+/* TIMING setup: Get TIMING register value for kernel and bus clock (cached) */
+static uint32_t I2C_GetTiming (I2C_RESOURCES *i2c, uint32_t fpclk, uint32_t fscl, I2C_STD_TIME *spec) {
+  I2C_CLK_SETUP clk_setup;
+  uint32_t timing;
+#if (I2C_TIMING_CACHE_SIZE > 0U)
+  I2C_TIMING_CACHE *entry;
+  uint32_t primask;
+  uint32_t i;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  for (i = 0U; i < I2C_TIMING_CACHE_SIZE; i++) {
+    entry = &I2C_TimingCache[i];
+
+    if ((entry->fpclk == fpclk) && (entry->fscl == fscl) &&
+        (entry->dnf   == i2c->dnf_coef) && (entry->anf == i2c->anf_enable)) {
+      timing = entry->timing;
+      __set_PRIMASK(primask);
+      return (timing);
+    }
+  }
+
+  __set_PRIMASK(primask);
+#endif
+
+  /* Determine peripheral and bus clock period (ns) */
+  clk_setup.i2cclk = (uint16_t)((1000000000 + (fpclk / 2)) / fpclk);
+  clk_setup.busclk = (uint16_t)((1000000000 + (fscl  / 2)) / fscl);
+
+  /* Determine digital filter delay (ns) */
+  clk_setup.dfd = clk_setup.i2cclk * i2c->dnf_coef;
+
+  /* Set analog filter delay (ns) */
+  clk_setup.afd_min = ((i2c->anf_enable != 0U) ? (I2C_ANALOG_FILTER_DELAY_MIN) : (0));
+  clk_setup.afd_max = ((i2c->anf_enable != 0U) ? (I2C_ANALOG_FILTER_DELAY_MAX) : (0));
+
+  /* Set max iteration error */
+  clk_setup.error  = 0xFFFF;
+
+  /* Get TIMING register values */
+  timing = I2C_GetTimingValue (&clk_setup, spec);
+
+#if (I2C_TIMING_CACHE_SIZE > 0U)
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  /* Replace entries in round-robin order */
+  entry = &I2C_TimingCache[I2C_TimingCacheNext];
+  I2C_TimingCacheNext = (I2C_TimingCacheNext + 1U) % I2C_TIMING_CACHE_SIZE;
+
+  entry->fpclk  = fpclk;
+  entry->fscl   = fscl;
+  entry->dnf    = (uint8_t)i2c->dnf_coef;
+  entry->anf    = (uint8_t)i2c->anf_enable;
+  entry->timing = timing;
+
+  __set_PRIMASK(primask);
+#endif
+
+  return (timing);
+}
 
 /**
   Calculate number of bytes for provided number of items, for selected DMA.
@@ -914,6 +1040,8 @@ static int32_t I2C_PowerControl (ARM_POWER_STATE state, I2C_RESOURCES *i2c) {
       i2c->info->status.arbitration_lost = 0U;
       i2c->info->status.bus_error        = 0U;
 
+      i2c->info->xfer_list = NULL;
+
       i2c->info->flags &= ~I2C_POWER;
       break;
 
@@ -965,57 +1093,40 @@ static int32_t I2C_PowerControl (ARM_POWER_STATE state, I2C_RESOURCES *i2c) {
 
 
 /**
-  \fn          int32_t I2C_MasterTransmit (uint32_t       addr,
-                                           const uint8_t *data,
-                                           uint32_t       num,
-                                           bool           xfer_pending,
-                                           I2C_RESOURCES *i2c)
-  \brief       Start transmitting data as I2C Master.
+  \fn          int32_t I2C_MasterStart (uint32_t       addr,
+                                        uint8_t       *data,
+                                        uint16_t       cnt,
+                                        uint8_t        read,
+                                        bool           xfer_pending,
+                                        I2C_RESOURCES *i2c)
+  \brief       Start master transfer (also used to start transaction list segments from interrupt context).
   \param[in]   addr          Slave address (7-bit or 10-bit)
-  \param[in]   data          Pointer to buffer with data to send to I2C Slave
-  \param[in]   num           Number of data bytes to send
+  \param[in]   data          Pointer to data buffer
+  \param[in]   cnt           Number of data bytes to transfer
+  \param[in]   read          Transfer direction: 0 = transmit, 1 = receive
   \param[in]   xfer_pending  Transfer operation is pending - Stop condition will not be generated
   \param[in]   i2c           Pointer to I2C resources
   \return      \ref execution_status
 */
-static int32_t I2C_MasterTransmit (uint32_t       addr,
-                                   const uint8_t *data,
-                                   uint32_t       num,
-                                   bool           xfer_pending,
-                                   I2C_RESOURCES *i2c) {
+static int32_t I2C_MasterStart (uint32_t       addr,
+                                uint8_t       *data,
+                                uint16_t       cnt,
+                                uint8_t        read,
+                                bool           xfer_pending,
+                                I2C_RESOURCES *i2c) {
   HAL_StatusTypeDef status;
-  uint32_t buf = (uint32_t)data;
-  uint16_t cnt, saddr;
+  uint16_t saddr;
   uint32_t opt;
   uint8_t  tx_dma;
 
-  if ((data == NULL) || (num == 0U)) {
-    return ARM_DRIVER_ERROR_PARAMETER;
-  }
-
-  if ((addr & ~((uint32_t)ARM_I2C_ADDRESS_10BIT | (uint32_t)ARM_I2C_ADDRESS_GC)) > 0x3FFU) {
-    return ARM_DRIVER_ERROR_PARAMETER;
-  }
-
-  if (num > UINT16_MAX) {
-    /* HAL does not handle 32-bit count in transfer */
-    return ARM_DRIVER_ERROR;
-  }
-
-  cnt = (uint16_t)num;
-
-  if (i2c->info->status.busy) {
-    return (ARM_DRIVER_ERROR_BUSY);
-  }
-
-  saddr = (addr & 0x3FFU);
+  saddr = (uint16_t)(addr & 0x3FFU);
   if (i2c->h->Init.AddressingMode == I2C_ADDRESSINGMODE_7BIT) {
     saddr <<= 1;
   }
 
   i2c->info->status.busy             = 1U;
   i2c->info->status.mode             = 1U;
-  i2c->info->status.direction        = 0U;
+  i2c->info->status.direction        = read;
   i2c->info->status.bus_error        = 0U;
   i2c->info->status.arbitration_lost = 0U;
 
@@ -1038,16 +1149,32 @@ static int32_t I2C_MasterTransmit (uint32_t       addr,
     }
   }
 
-  tx_dma = 0U;
-  if (i2c->h->hdmatx != NULL) {
-    // Determine if DMA should be used for the transfer
-    tx_dma = CheckDmaForTx(i2c->h->hdmatx, data, num);
-  }
+  if (read != 0U) {
+    i2c->info->rx_data = data;
 
-  if (tx_dma != 0U) {
-    status = HAL_I2C_Master_Seq_Transmit_DMA(i2c->h, saddr, (uint8_t *)buf, cnt, opt);
+    i2c->info->rx_dma  = 0U;
+    if (i2c->h->hdmarx != NULL) {
+      // Determine if DMA should be used for the transfer
+      i2c->info->rx_dma = CheckDmaForRx(i2c->h->hdmarx, data, cnt);
+    }
+
+    if (i2c->info->rx_dma != 0U) {
+      status = HAL_I2C_Master_Seq_Receive_DMA(i2c->h, saddr, data, cnt, opt);
+    } else {
+      status = HAL_I2C_Master_Seq_Receive_IT (i2c->h, saddr, data, cnt, opt);
+    }
   } else {
-    status = HAL_I2C_Master_Seq_Transmit_IT (i2c->h, saddr, (uint8_t *)buf, cnt, opt);
+    tx_dma = 0U;
+    if (i2c->h->hdmatx != NULL) {
+      // Determine if DMA should be used for the transfer
+      tx_dma = CheckDmaForTx(i2c->h->hdmatx, data, cnt);
+    }
+
+    if (tx_dma != 0U) {
+      status = HAL_I2C_Master_Seq_Transmit_DMA(i2c->h, saddr, data, cnt, opt);
+    } else {
+      status = HAL_I2C_Master_Seq_Transmit_IT (i2c->h, saddr, data, cnt, opt);
+    }
   }
 
   if (status != HAL_OK) {
@@ -1058,6 +1185,47 @@ static int32_t I2C_MasterTransmit (uint32_t       addr,
   return ARM_DRIVER_OK;
 }
 
+/**
+  \fn          int32_t I2C_MasterTransmit (uint32_t       addr,
+                                           const uint8_t *data,
+                                           uint32_t       num,
+                                           bool           xfer_pending,
+                                           I2C_RESOURCES *i2c)
+  \brief       Start transmitting data as I2C Master.
+  \param[in]   addr          Slave address (7-bit or 10-bit)
+  \param[in]   data          Pointer to buffer with data to send to I2C Slave
+  \param[in]   num           Number of data bytes to send
+  \param[in]   xfer_pending  Transfer operation is pending - Stop condition will not be generated
+  \param[in]   i2c           Pointer to I2C resources
+  \return      \ref execution_status
+*/
+static int32_t I2C_MasterTransmit (uint32_t       addr,
+                                   const uint8_t *data,
+                                   uint32_t       num,
+                                   bool           xfer_pending,
+                                   I2C_RESOURCES *i2c) {
+  uint32_t buf = (uint32_t)data;
+
+  if ((data == NULL) || (num == 0U)) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  if ((addr & ~((uint32_t)ARM_I2C_ADDRESS_10BIT | (uint32_t)ARM_I2C_ADDRESS_GC)) > 0x3FFU) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  if (num > UINT16_MAX) {
+    /* HAL does not handle 32-bit count in transfer */
+    return ARM_DRIVER_ERROR;
+  }
+
+  if (i2c->info->status.busy) {
+    return (ARM_DRIVER_ERROR_BUSY);
+  }
+
+  return I2C_MasterStart(addr, (uint8_t *)buf, (uint16_t)num, 0U, xfer_pending, i2c);
+}
+
 /**
   \fn          int32_t I2C_MasterReceive (uint32_t       addr,
                                           uint8_t       *data,
@@ -1077,9 +1245,6 @@ static int32_t I2C_MasterReceive (uint32_t       addr,
                                   uint32_t       num,
                                   bool           xfer_pending,
                                   I2C_RESOURCES *i2c) {
-  HAL_StatusTypeDef status;
-  uint16_t cnt, saddr;
-  uint32_t opt;
 
   if ((data == NULL) || (num == 0U)) {
     return ARM_DRIVER_ERROR_PARAMETER;
@@ -1094,67 +1259,105 @@ static int32_t I2C_MasterReceive (uint32_t       addr,
     return ARM_DRIVER_ERROR;
   }
 
-  cnt = (uint16_t)num;
-
   if (i2c->info->status.busy) {
     return (ARM_DRIVER_ERROR_BUSY);
   }
 
-  saddr = (addr & 0x3FFU);
-  if (i2c->h->Init.AddressingMode == I2C_ADDRESSINGMODE_7BIT) {
-    saddr <<= 1;
-  }
+  return I2C_MasterStart(addr, data, (uint16_t)num, 1U, xfer_pending, i2c);
+}
 
-  i2c->info->status.busy             = 1U;
-  i2c->info->status.mode             = 1U;
-  i2c->info->status.direction        = 1U;
-  i2c->info->status.bus_error        = 0U;
-  i2c->info->status.arbitration_lost = 0U;
+/**
+  \fn          int32_t I2C_XferSegStart (I2C_RESOURCES *i2c)
+  \brief       Start transaction list segment selected by list index.
+  \param[in]   i2c           Pointer to I2C resources
+  \return      \ref execution_status
+*/
+static int32_t I2C_XferSegStart (I2C_RESOURCES *i2c) {
+  I2C_XFER_LIST *list = i2c->info->xfer_list;
+  I2C_XFER_SEG  *seg  = &list->seg[list->idx];
 
-  addr = (addr & 0x3FFU);
+  return I2C_MasterStart(seg->addr,
+                         seg->data,
+                         (uint16_t)seg->num,
+                         ((seg->flags & I2C_XFER_SEG_READ) != 0U) ? 1U : 0U,
+                         ((seg->flags & I2C_XFER_SEG_NO_STOP) != 0U),
+                         i2c);
+}
 
-  if (i2c->h->Init.AddressingMode == I2C_ADDRESSINGMODE_7BIT) {
-    addr <<= 1;
-  }
+/**
+  \fn          int32_t I2C_XferListStart (I2C_XFER_LIST *list, I2C_RESOURCES *i2c)
+  \brief       Start executing master transaction list.
+  \param[in]   list          Pointer to transaction list
+  \param[in]   i2c           Pointer to I2C resources
+  \return      \ref execution_status
+*/
+static int32_t I2C_XferListStart (I2C_XFER_LIST *list, I2C_RESOURCES *i2c) {
+  uint32_t i;
+  int32_t  status;
 
-  i2c->info->xfer_sz = cnt;
-  i2c->info->rx_data = data;
+  if ((list == NULL) || (list->seg == NULL) || (list->cnt == 0U)) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
 
-  if (xfer_pending == true) {           // If transfer should not generate STOP at the end
-    if ((i2c->info->flags & I2C_XFER_NO_STOP) == 0U) {  // First transfer without STOP generation
-      i2c->info->flags |= I2C_XFER_NO_STOP;
-      opt = I2C_FIRST_FRAME;
-    } else {                                            // Any further transfer without STOP generation
-      opt = I2C_OTHER_FRAME;
+  for (i = 0U; i < list->cnt; i++) {
+    if ((list->seg[i].data == NULL) || (list->seg[i].num == 0U) || (list->seg[i].num > UINT16_MAX)) {
+      return ARM_DRIVER_ERROR_PARAMETER;
     }
-  } else {                              // If transfer should generate STOP at the end
-    if ((i2c->info->flags & I2C_XFER_NO_STOP) != 0U) {
-      // If previous request did not generate STOP after transfer, terminate sequence
-      i2c->info->flags &= ~I2C_XFER_NO_STOP;
-      opt = I2C_OTHER_AND_LAST_FRAME;
-    } else {
-      opt = I2C_LAST_FRAME;
+    if ((list->seg[i].addr & ~((uint32_t)ARM_I2C_ADDRESS_10BIT | (uint32_t)ARM_I2C_ADDRESS_GC)) > 0x3FFU) {
+      return ARM_DRIVER_ERROR_PARAMETER;
     }
   }
 
-  i2c->info->rx_dma  = 0U;
-  if (i2c->h->hdmarx != NULL) {
-    // Determine if DMA should be used for the transfer
-    i2c->info->rx_dma = CheckDmaForRx(i2c->h->hdmarx, data, num);
+  if (i2c->info->status.busy) {
+    return (ARM_DRIVER_ERROR_BUSY);
   }
 
-  if (i2c->info->rx_dma != 0U) {
-    status = HAL_I2C_Master_Seq_Receive_DMA(i2c->h, saddr, data, cnt, opt);
-  } else {
-    status = HAL_I2C_Master_Seq_Receive_IT (i2c->h, saddr, data, cnt, opt);
+  list->idx = 0U;
+  i2c->info->xfer_list = list;
+
+  status = I2C_XferSegStart(i2c);
+  if (status != ARM_DRIVER_OK) {
+    i2c->info->xfer_list = NULL;
   }
 
-  if (status != HAL_OK) {
-    i2c->info->status.busy = 0U;
-    return ARM_DRIVER_ERROR;
+  return status;
+}
+
+/**
+  \fn          uint32_t I2C_XferListNext (I2C_RESOURCES *i2c)
+  \brief       Continue transaction list after segment completed (called from interrupt context).
+  \param[in]   i2c           Pointer to I2C resources
+  \return      event to signal (0 = next segment started)
+*/
+static uint32_t I2C_XferListNext (I2C_RESOURCES *i2c) {
+  I2C_XFER_LIST *list = i2c->info->xfer_list;
+  uint32_t       no_stop, tout;
+
+  list->idx++;
+
+  if (list->idx < list->cnt) {
+    no_stop = i2c->info->flags & I2C_XFER_NO_STOP;
+    if (I2C_XferSegStart(i2c) == ARM_DRIVER_OK) {
+      return 0U;
+    }
+    /* Segment could not be started, terminate sequence */
+    if (no_stop != 0U) {
+      /* Previous segment ended without STOP (bus is held), generate STOP to release the bus */
+      i2c->reg->CR2 |= I2C_CR2_STOP;
+      for (tout = SystemCoreClock / 1000U; tout != 0U; tout--) {
+        if ((i2c->reg->ISR & I2C_ISR_STOPF) != 0U) {
+          break;
+        }
+      }
+      __HAL_I2C_CLEAR_FLAG(i2c->h, I2C_FLAG_STOPF);
+    }
+    i2c->info->flags &= ~I2C_XFER_NO_STOP;
+    i2c->info->xfer_list = NULL;
+    return (ARM_I2C_EVENT_TRANSFER_DONE | ARM_I2C_EVENT_TRANSFER_INCOMPLETE);
   }
 
-  return ARM_DRIVER_OK;
+  i2c->info->xfer_list = NULL;
+  return ARM_I2C_EVENT_TRANSFER_DONE;
 }
 
 /**
@@ -1326,7 +1529,6 @@ static int32_t I2C_Control (uint32_t control, uint32_t arg, I2C_RESOURCES *i2c)
   uint32_t i, val;
   uint32_t fpclk, fscl;
 
-  I2C_CLK_SETUP  clk_setup;
   I2C_STD_TIME  *clk_spec;
 
   if ((i2c->info->flags & I2C_POWER) == 0U) {
@@ -1389,22 +1591,8 @@ static int32_t I2C_Control (uint32_t control, uint32_t arg, I2C_RESOURCES *i2c)
           return ARM_DRIVER_ERROR_UNSUPPORTED;
       }
 
-      /* Determine peripheral and bus clock period (ns) */
-      clk_setup.i2cclk = (uint16_t)((1000000000 + (fpclk / 2)) / fpclk);
-      clk_setup.busclk = (uint16_t)((1000000000 + (fscl  / 2)) / fscl);
-
-      /* Determine digital filter delay (ns) */
-      clk_setup.dfd = clk_setup.i2cclk * i2c->dnf_coef;
-
-      /* Set analog filter delay (ns) */
-      clk_setup.afd_min = ((i2c->anf_enable != 0U) ? (I2C_ANALOG_FILTER_DELAY_MIN) : (0));
-      clk_setup.afd_max = ((i2c->anf_enable != 0U) ? (I2C_ANALOG_FILTER_DELAY_MAX) : (0));
-
-      /* Set max iteration error */
-      clk_setup.error  = 0xFFFF;
-
       /* Get TIMING register values */
-      val = I2C_GetTimingValue (&clk_setup, clk_spec);
+      val = I2C_GetTiming (i2c, fpclk, fscl, clk_spec);
 
       /* Set register values */
       i2c->reg->CR1    &= ~I2C_CR1_PE;
@@ -1473,6 +1661,9 @@ static int32_t I2C_Control (uint32_t control, uint32_t arg, I2C_RESOURCES *i2c)
         /* Generate NACK when in slave mode */
         __HAL_I2C_GENERATE_NACK (i2c->h);
       } else if (HAL_I2C_GetMode (i2c->h) == HAL_I2C_MODE_MASTER) {
+        /* Do not continue transaction list */
+        i2c->info->xfer_list = NULL;
+
         /* Get slave address */
         i2c->info->abort = 0U;
         val = i2c->reg->CR2 & 0x3FFU;
@@ -1491,6 +1682,9 @@ static int32_t I2C_Control (uint32_t control, uint32_t arg, I2C_RESOURCES *i2c)
       i2c->info->status.bus_error        = 0U;
       break;
 
+    case I2C_CONTROL_XFER_LIST:
+      return I2C_XferListStart ((I2C_XFER_LIST *)arg, i2c);
+
     default: return ARM_DRIVER_ERROR;
   }
   return ARM_DRIVER_OK;
@@ -1511,14 +1705,25 @@ static ARM_I2C_STATUS I2C_GetStatus (I2C_RESOURCES *i2c) {
 /* Master tx transfer completed */
 void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
   I2C_RESOURCES *i2c;
+  uint32_t event;
 
   i2c = I2C_GetResources (hi2c);
 
   if (i2c != NULL) {
+    event = ARM_I2C_EVENT_TRANSFER_DONE;
+
+    if (i2c->info->xfer_list != NULL) {
+      /* Start next segment of transaction list */
+      event = I2C_XferListNext (i2c);
+      if (event == 0U) {
+        return;
+      }
+    }
+
     i2c->info->status.busy = 0U;
 
     if (i2c->info->cb_event != NULL) {
-      i2c->info->cb_event (ARM_I2C_EVENT_TRANSFER_DONE);
+      i2c->info->cb_event (event);
     }
   }
 }
@@ -1526,6 +1731,7 @@ void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
 /* Master Rx transfer completed */
 void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
   I2C_RESOURCES *i2c;
+  uint32_t event;
 
   i2c = I2C_GetResources (hi2c);
 
@@ -1534,10 +1740,20 @@ void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
   }
 
   if (i2c != NULL) {
+    event = ARM_I2C_EVENT_TRANSFER_DONE;
+
+    if (i2c->info->xfer_list != NULL) {
+      /* Start next segment of transaction list */
+      event = I2C_XferListNext (i2c);
+      if (event == 0U) {
+        return;
+      }
+    }
+
     i2c->info->status.busy = 0U;
 
     if (i2c->info->cb_event != NULL) {
-      i2c->info->cb_event (ARM_I2C_EVENT_TRANSFER_DONE);
+      i2c->info->cb_event (event);
     }
   }
 }
@@ -1672,6 +1888,9 @@ void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
       }
     }
 
+    /* Terminate transaction list (list index identifies failed segment) */
+    i2c->info->xfer_list = NULL;
+
     i2c->info->status.busy = 0U;
 
     if (i2c->info->cb_event != NULL) {
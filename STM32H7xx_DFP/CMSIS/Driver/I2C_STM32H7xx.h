@@ -1,5 +1,5 @@
 /* -----------------------------------------------------------------------------
- * Copyright (c) 2013-2023 Arm Limited (or its affiliates).
+ * Copyright (c) 2013-2024 Arm Limited (or its affiliates).
  * All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        16. March 2023
- * $Revision:    V1.5
+ * $Date:        18. October 2024
+ * $Revision:    V1.6
  *
  * Project:      I2C Driver definitions for STMicroelectronics STM32H7xx
  * -------------------------------------------------------------------------- */
@@ -46,6 +46,28 @@
 
 #ifdef  I2C_CUBE_MX_ENABLED
 
+/* Vendor specific Control codes */
+#define I2C_CONTROL_XFER_LIST           (0x80UL)        // Start master transaction list; arg = pointer to I2C_XFER_LIST
+
+/* Transaction list segment flags */
+#define I2C_XFER_SEG_READ               (1U << 0)       // Read segment (write segment if not set)
+#define I2C_XFER_SEG_NO_STOP            (1U << 1)       // No STOP after segment: next segment starts with repeated START
+
+/* Transaction list segment */
+typedef struct {
+  uint16_t                addr;                 // Slave address (7-bit or 10-bit)
+  uint16_t                flags;                // Segment flags (I2C_XFER_SEG_xxx)
+  uint8_t                *data;                 // Data buffer (data to send for write segment)
+  uint32_t                num;                  // Number of data bytes (1..65535)
+} I2C_XFER_SEG;
+
+/* Transaction list */
+typedef struct {
+  I2C_XFER_SEG           *seg;                  // Array of segments
+  uint32_t                cnt;                  // Number of segments
+  uint32_t       volatile idx;                  // Segments completed (written by driver, index of failed segment on error)
+} I2C_XFER_LIST;
+
 /* Bus Clear clock period definition */
 #define I2C_BUS_CLEAR_CLOCK_PERIOD      (2)     // I2C bus clock period (ms)
 
@@ -107,6 +129,16 @@ typedef struct {
   uint8_t                 scll;                 // Timing register value SCLL[7:0]
 } I2C_TIMING;
 
+/* I2C TIMING register cache entry */
+typedef struct {
+  uint32_t                fpclk;                // Kernel clock frequency (Hz), 0 = unused entry
+  uint32_t                fscl;                 // Bus clock frequency (Hz)
+  uint8_t                 dnf;                  // Digital noise filter coefficient
+  uint8_t                 anf;                  // Analog noise filter enabled
+  uint16_t                reserved;
+  uint32_t                timing;               // TIMING register value
+} I2C_TIMING_CACHE;
+
 /* I2C Input/Output Configuration */
 typedef const struct {
   GPIO_TypeDef           *scl_port;             // SCL IO Port
@@ -129,6 +161,7 @@ typedef struct {
   uint8_t                 reserved;
   uint8_t                *rx_data;              // Pointer to receive data buffer
   uint32_t       volatile xfer_sz;              // Transfer size (bytes)
+  I2C_XFER_LIST * volatile xfer_list;           // Transaction list in progress
 } I2C_INFO;
 
 /* I2C Resources definition */
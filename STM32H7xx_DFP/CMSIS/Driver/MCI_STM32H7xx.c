@@ -1,5 +1,5 @@
 /* -----------------------------------------------------------------------------
- * Copyright (c) 2013-2023 Arm Limited (or its affiliates).
+ * Copyright (c) 2013-2024 Arm Limited (or its affiliates).
  * All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        27. February 2023
- * $Revision:    V1.8
+ * $Date:        18. October 2024
+ * $Revision:    V1.12
  *
  * Driver:       Driver_MCI0/1
  *
@@ -30,6 +30,14 @@
 
 # Revision History
 
+- Version 1.12
+  - Added SDR50/SDR104 and MMC HS200 bus modes with delay block sampling clock tuning
+- Version 1.11
+  - Added pre-defined block count (CMD23) for multiple block transfers (MCI_CONTROL_SET_BLOCK_COUNT)
+- Version 1.10
+  - Added bounce buffering of transfers not aligned to DCache lines (MCI_BOUNCE_BUF_SIZE)
+- Version 1.9
+  - Added IDMA double buffer mode for continuous multi-block streaming (MCI_CONTROL_DOUBLE_BUFFER)
 - Version 1.8
   - Improved PowerControl and Control functions
   - Made variable status volatile (solved potential LTO problems)
@@ -69,6 +77,81 @@ DMA usage limitations:
  - The size of DCache line on Cortex M7 is 32 Bytes. To safely perform
    DCache maintenance operations, MCI DMA transfers data must be aligned
    to a 32 Byte boundary and data size must be n*32 Bytes.
+   Other buffers are handled through a bounce buffer when DCache is enabled
+   (see Unaligned Buffers).
+ - IDMA requires a 4 Byte aligned buffer address. Buffers not aligned to
+   4 Bytes are only supported for transfers up to MCI_BOUNCE_BUF_SIZE.
+
+# Unaligned Buffers
+
+With DCache enabled, buffers that are not aligned to a 32 Byte DCache line or whose size is not n*32 Bytes
+(for example sector buffers passed in by a file system) are handled by the driver as follows:
+ - Transfers up to **MCI_BOUNCE_BUF_SIZE** Bytes are performed through the driver's 32 Byte aligned bounce buffer.
+   Data is copied into it before a write and out of it when a read completes.
+ - Larger writes are transferred directly from the application buffer, the covering DCache lines are cleaned.
+ - Larger reads are transferred directly into the application buffer. Only the partially covered first and
+   last DCache line are routed through the bounce area: memory sharing these lines with the buffer is saved
+   there before the lines are invalidated and restored afterwards. Such memory must not be written by the
+   application while the read is in progress.
+
+The bounce buffers (MCI0_BounceBuf, MCI1_BounceBuf) must be located in memory accessible by the SDMMC IDMA.
+
+# Double Buffer Streaming
+
+Vendor specific control code **MCI_CONTROL_DOUBLE_BUFFER** enables the SDMMC IDMA double buffer mode
+for subsequent transfers (arg = pointer to **MCI_DOUBLE_BUFFER**, 0 disables it). Both buffers must be
+32 Byte aligned and of equal size, which must be a multiple of 32 Bytes and of the block size
+(max 8160 Bytes, i.e. 15 blocks of 512 Bytes).
+
+SetupTransfer must then be called with **data** pointing to buffer 0 and may specify a block count
+spanning any number of buffers. The IDMA alternates between the buffers and the driver signals
+**MCI_EVENT_BUFFER_COMPLETE** each time a buffer is transferred. The completed buffer index is
+(**cnt** - 1) & 1. The application processes (read) or refills (write) that buffer while the other one
+is transferred, and may replace its address in **buf** from the event callback.
+
+With DCache enabled the driver invalidates each completed buffer on read. On write it cleans the
+completed buffer after the event callback returns, so buffers refilled outside the callback must be
+cleaned by the application or placed in non-cacheable memory.
+
+# Pre-defined Block Count
+
+Vendor specific control code **MCI_CONTROL_SET_BLOCK_COUNT** (arg = 1 enables, 0 disables) makes the driver
+precede each READ_MULTIPLE_BLOCK (CMD18) and WRITE_MULTIPLE_BLOCK (CMD25) data command with SET_BLOCK_COUNT
+(CMD23) specifying the block count of the transfer set up by SetupTransfer (max 65535 blocks). The data
+command is queued and sent from the interrupt handler as soon as the CMD23 response is received, so the
+application issues a single SendCommand and receives a single command event for both commands. A CMD23
+response reporting a card error is signaled as **ARM_MCI_EVENT_COMMAND_ERROR**.
+
+The card stops the transfer after the specified number of blocks, therefore STOP_TRANSMISSION (CMD12) must not
+be sent. Enable it only for cards supporting CMD23 (SD cards indicating CMD23 support in the SCR register,
+MMC devices).
+
+# UHS-I and HS200 Bus Modes
+
+Bus speed modes **ARM_MCI_BUS_UHS_SDR50**, **ARM_MCI_BUS_UHS_SDR104** and **MCI_BUS_MMC_HS200** (MMC HS200,
+equivalent to SDR104 on the controller side) sample received data with the SDMMC feedback clock routed through
+the delay block (DLYB). The delay block is calibrated to the bus clock when the mode is selected and again when
+tuning is reset, therefore ARM_MCI_BUS_SPEED must be set before.
+
+The sampling point is tuned with **ARM_MCI_UHS_TUNING_OPERATION** and **ARM_MCI_UHS_TUNING_RESULT**:
+  1. Control(ARM_MCI_UHS_TUNING_OPERATION, 0): reset, calibrate the delay line and select the first phase
+  2. Send tuning command SEND_TUNING_BLOCK (CMD19, SD) or SEND_TUNING_BLOCK_HS200 (CMD21, MMC) with
+     the tuning block read and wait for the transfer to finish
+  3. Control(ARM_MCI_UHS_TUNING_OPERATION, 1): evaluate the tuning block (no CRC error nor timeout)
+     and select the next phase
+  4. Control(ARM_MCI_UHS_TUNING_RESULT, 0) returns 1 while phases remain (continue with step 2),
+     0 when tuning is done or -1 when no phase received the tuning block correctly
+
+When all phases are tested the centre of the longest window of passing phases is selected. A short data
+timeout (ARM_MCI_DATA_TIMEOUT) speeds up tuning as failing phases may not receive the tuning block at all.
+
+UHS-I SD cards require 1.8V signaling. Define **MemoryCard_UHS0** (SDMMC1) or **MemoryCard_UHS1** (SDMMC2)
+when the board transceiver supports it and implement function **MCI_DriveTransceiver_1V8** in the application.
+CardPower with ARM_MCI_POWER_VCCQ_1V8 after VOLTAGE_SWITCH (CMD11) then completes the voltage switch sequence
+and calls MCI_DriveTransceiver_1V8 to switch the transceiver to 1.8V. The definition also enables the UHS-I
+capabilities (uhs_signaling, uhs_tuning, uhs_sdr50, uhs_sdr104, vccq_1v8) and the delay block. Without
+MemoryCard_UHS0/1 the delay block code is not compiled, stm32h7xx_ll_delayblock.c is not required and
+ARM_MCI_UHS_TUNING_OPERATION returns ARM_DRIVER_ERROR_UNSUPPORTED.
 
 # Configuration
 
@@ -80,6 +163,8 @@ Definition                         | Default value | Value         | Description
 :----------------------------------|:-------------:|:--------------:|:-----------
 MCI_DCACHE_MAINTENANCE             |     **1**     |   1            | MCI DCache maintenance operations: **enabled**
 ^                                  |       ^       |   0            | MCI DCache maintenance operations: **disabled**
+MCI_BOUNCE_BUF_SIZE                |    **512**    |   n*32         | Bounce buffer size in Bytes for unaligned transfers (min 64)
+^                                  |       ^       |   0            | Unaligned transfers with DCache enabled: **not supported**
 MemoryCard_CD0_Pin_Active          | GPIO_PIN_RESET| GPIO_PIN_RESET | Card Detect pin active state: **low**
 ^                                  | ^             | GPIO_PIN_SET   | Card Detect pin active state: **high**
 MemoryCard_WP0_Pin_Active          | GPIO_PIN_SET  | GPIO_PIN_RESET | Write Protect pin active state: **low**
@@ -100,6 +185,10 @@ MemoryCard_MMC0                    | not defined   | not defined    | SDMMC1 is
 ^                                  | ^             | defined        | SDMMC1 is configured for MMC device
 MemoryCard_MMC1                    | not defined   | not defined    | SDMMC2 is configured for SD device
 ^                                  | ^             | defined        | SDMMC2 is configured for MMC device
+MemoryCard_UHS0                    | not defined   | not defined    | SDMMC1 1.8V signaling (UHS-I): **not supported**
+^                                  | ^             | defined        | SDMMC1 1.8V signaling (UHS-I): **supported**, external MCI_DriveTransceiver_1V8() function
+MemoryCard_UHS1                    | not defined   | not defined    | SDMMC2 1.8V signaling (UHS-I): **not supported**
+^                                  | ^             | defined        | SDMMC2 1.8V signaling (UHS-I): **supported**, external MCI_DriveTransceiver_1V8() function
 
 ## STM32CubeMX
 
@@ -111,6 +200,8 @@ The MCI driver requires:
   - When using MMC devices:
     - Define **MemoryCard_MMC0** if SDMMC1 uses MMC device (otherwise define is not required)
     - Define **MemoryCard_MMC1** if SDMMC2 uses MMC device (otherwise define is not required)
+  - When using SDR50, SDR104 or HS200 bus modes (MemoryCard_UHS0/1 defined):
+    - **stm32h7xx_ll_delayblock.c** HAL driver source added to the project
 
 Optional configuration:
   - Card Detect Pin:
@@ -228,7 +319,16 @@ Generate source code by clicking on the **GENERATE CODE** button on the toolbar.
 
 #include "MCI_STM32H7xx.h"
 
-#define ARM_MCI_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,8)  /* driver version */
+#define ARM_MCI_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,12)  /* driver version */
+
+/* Bounce buffer size for transfers not aligned to DCache lines */
+#ifndef MCI_BOUNCE_BUF_SIZE
+#define MCI_BOUNCE_BUF_SIZE       (512U)
+#endif
+
+#if ((MCI_BOUNCE_BUF_SIZE % 32U) != 0U) || ((MCI_BOUNCE_BUF_SIZE != 0U) && (MCI_BOUNCE_BUF_SIZE < 64U))
+#error "MCI_BOUNCE_BUF_SIZE must be 0 or a multiple of 32 and at least 64!"
+#endif
 
 /* MCI0: Define Card Detect pin active state */
 #if !defined(MemoryCard_CD0_Pin_Active)
@@ -292,6 +392,23 @@ Generate source code by clicking on the **GENERATE CODE** button on the toolbar.
   #define MCI1_HANDLE_TYPE      1U
 #endif
 
+/* MCI0: Define MemoryCard_UHS0 if SDMMC1 supports 1.8V signaling */
+#if defined(MemoryCard_UHS0) && defined(DLYB_SDMMC1)
+  #define MCI0_UHS              1U
+#else
+  #define MCI0_UHS              0U
+#endif
+
+/* MCI1: Define MemoryCard_UHS1 if SDMMC2 supports 1.8V signaling */
+#if defined(MemoryCard_UHS1) && defined(DLYB_SDMMC2)
+  #define MCI1_UHS              1U
+#else
+  #define MCI1_UHS              0U
+#endif
+
+/* Voltage switch sequence timeout in ms */
+#define MCI_VSWITCH_TIMEOUT     (20U)
+
 #if defined(MX_SDMMC1)
 #if (MCI0_HANDLE_TYPE == 0)
 #define MCI0_HANDLE      hsd1
@@ -329,9 +446,23 @@ static MCI_INFO MCI0_Info = {
   0U,
   0U,
   0U,
+  0U,
+  NULL,
+  NULL,
+  0U,
+  0U,
+  0U,
+  0U,
+  0U,
+  0U,
   0U
 };
 
+#if (MCI_DCACHE_MAINTENANCE == 1U) && (MCI_BOUNCE_BUF_SIZE != 0U)
+/* MCI0 Bounce buffer */
+static uint8_t MCI0_BounceBuf[MCI_BOUNCE_BUF_SIZE] __ALIGNED(32);
+#endif
+
 /* MCI0 Resources */
 static MCI_RESOURCES MCI0_Resources = {
   &MCI0_HANDLE,
@@ -346,7 +477,17 @@ static MCI_RESOURCES MCI0_Resources = {
   #else
   NULL,
   #endif
-  &MCI0_Info
+  &MCI0_Info,
+  #if (MCI_DCACHE_MAINTENANCE == 1U) && (MCI_BOUNCE_BUF_SIZE != 0U)
+  MCI0_BounceBuf,
+  #else
+  NULL,
+  #endif
+  #if (MCI0_UHS != 0U)
+  DLYB_SDMMC1
+  #else
+  NULL
+  #endif
 };
 
 /* MCI0 Driver Capabilities */
@@ -357,17 +498,17 @@ static const ARM_MCI_CAPABILITIES MCI0_DriverCapabilities = {
   0U,                                             /* vdd               */
   0U,                                             /* vdd_1v8           */
   0U,                                             /* vccq              */
-  0U,                                             /* vccq_1v8          */
+  MCI0_UHS,                                       /* vccq_1v8          */
   0U,                                             /* vccq_1v2          */
   MCI0_BUS_WIDTH_4,                               /* data_width_4      */
   MCI0_BUS_WIDTH_8,                               /* data_width_8      */
   0U,                                             /* data_width_4_ddr  */
   0U,                                             /* data_width_8_ddr  */
   1U,                                             /* high_speed        */
-  0U,                                             /* uhs_signaling     */
-  0U,                                             /* uhs_tuning        */
-  0U,                                             /* uhs_sdr50         */
-  0U,                                             /* uhs_sdr104        */
+  MCI0_UHS,                                       /* uhs_signaling     */
+  MCI0_UHS,                                       /* uhs_tuning        */
+  MCI0_UHS,                                       /* uhs_sdr50         */
+  MCI0_UHS,                                       /* uhs_sdr104        */
   0U,                                             /* uhs_ddr50         */
   0U,                                             /* uhs_driver_type_a */
   0U,                                             /* uhs_driver_type_c */
@@ -420,9 +561,23 @@ static MCI_INFO MCI1_Info = {
   0U,
   0U,
   0U,
+  0U,
+  NULL,
+  NULL,
+  0U,
+  0U,
+  0U,
+  0U,
+  0U,
+  0U,
   0U
 };
 
+#if (MCI_DCACHE_MAINTENANCE == 1U) && (MCI_BOUNCE_BUF_SIZE != 0U)
+/* MCI1 Bounce buffer */
+static uint8_t MCI1_BounceBuf[MCI_BOUNCE_BUF_SIZE] __ALIGNED(32);
+#endif
+
 /* MCI1 Resources */
 static MCI_RESOURCES MCI1_Resources = {
   &MCI1_HANDLE,
@@ -437,7 +592,17 @@ static MCI_RESOURCES MCI1_Resources = {
   #else
   NULL,
   #endif
-  &MCI1_Info
+  &MCI1_Info,
+  #if (MCI_DCACHE_MAINTENANCE == 1U) && (MCI_BOUNCE_BUF_SIZE != 0U)
+  MCI1_BounceBuf,
+  #else
+  NULL,
+  #endif
+  #if (MCI1_UHS != 0U)
+  DLYB_SDMMC2
+  #else
+  NULL
+  #endif
 };
 
 /* MCI1 Driver Capabilities */
@@ -448,17 +613,17 @@ static const ARM_MCI_CAPABILITIES MCI1_DriverCapabilities = {
   0U,                                             /* vdd               */
   0U,                                             /* vdd_1v8           */
   0U,                                             /* vccq              */
-  0U,                                             /* vccq_1v8          */
+  MCI1_UHS,                                       /* vccq_1v8          */
   0U,                                             /* vccq_1v2          */
   MCI1_BUS_WIDTH_4,                               /* data_width_4      */
   MCI1_BUS_WIDTH_8,                               /* data_width_8      */
   0U,                                             /* data_width_4_ddr  */
   0U,                                             /* data_width_8_ddr  */
   1U,                                             /* high_speed        */
-  0U,                                             /* uhs_signaling     */
-  0U,                                             /* uhs_tuning        */
-  0U,                                             /* uhs_sdr50         */
-  0U,                                             /* uhs_sdr104        */
+  MCI1_UHS,                                       /* uhs_signaling     */
+  MCI1_UHS,                                       /* uhs_tuning        */
+  MCI1_UHS,                                       /* uhs_sdr50         */
+  MCI1_UHS,                                       /* uhs_sdr104        */
   0U,                                             /* uhs_ddr50         */
   0U,                                             /* uhs_driver_type_a */
   0U,                                             /* uhs_driver_type_c */
@@ -731,6 +896,13 @@ static int32_t PowerControl (ARM_POWER_STATE state, MCI_RESOURCES *mci) {
 
   switch (state) {
     case ARM_POWER_OFF:
+#if (MCI_DLYB != 0U)
+      if (mci->dlyb != NULL) {
+        /* Disable delay block */
+        DelayBlock_Disable ((DLYB_TypeDef *)mci->dlyb);
+      }
+#endif
+
       /* Reset/Dereset SDMMC peripheral */
       Control_SDMMC_Reset (mci->reg);
 
@@ -746,7 +918,7 @@ static int32_t PowerControl (ARM_POWER_STATE state, MCI_RESOURCES *mci) {
       mci->info->status.sdio_interrupt   = 0U;
       mci->info->status.ccs              = 0U;
 
-      mci->info->flags &= ~MCI_POWER;
+      mci->info->flags &= ~(MCI_POWER | MCI_TUNING);
       break;
 
     case ARM_POWER_FULL:
@@ -797,6 +969,58 @@ static int32_t PowerControl (ARM_POWER_STATE state, MCI_RESOURCES *mci) {
 }
 
 
+#if (MCI0_UHS != 0U) || (MCI1_UHS != 0U)
+/**
+  \fn            int32_t VoltageSwitch (MCI_RESOURCES *mci)
+  \brief         Complete voltage switch sequence started by VOLTAGE_SWITCH (CMD11).
+  \param[in]     mci   Pointer to MCI resources
+  \return        \ref execution_status
+*/
+static int32_t VoltageSwitch (MCI_RESOURCES *mci) {
+  uint32_t instance, tick;
+
+  instance = (mci->reg == SDMMC1) ? 0U : 1U;
+
+  /* Wait until SDMMC_CK is stopped after CMD11 response */
+  tick = HAL_GetTick();
+  while ((mci->reg->STA & SDMMC_STA_CKSTOP) == 0U) {
+    if ((HAL_GetTick() - tick) >= MCI_VSWITCH_TIMEOUT) {
+      return ARM_DRIVER_ERROR_TIMEOUT;
+    }
+  }
+  mci->reg->ICR = SDMMC_ICR_CKSTOPC;
+
+  /* Card must drive D0 low */
+  if ((mci->reg->STA & SDMMC_STA_BUSYD0) == 0U) {
+    mci->reg->POWER &= ~SDMMC_POWER_VSWITCHEN;
+    return ARM_DRIVER_ERROR;
+  }
+
+  /* Switch transceiver to 1.8V and start voltage switch timing */
+  MCI_DriveTransceiver_1V8 (instance, 1U);
+  mci->reg->POWER |= SDMMC_POWER_VSWITCH;
+
+  /* Wait until SDMMC_CK is restarted and D0 is released */
+  tick = HAL_GetTick();
+  while ((mci->reg->STA & SDMMC_STA_VSWEND) == 0U) {
+    if ((HAL_GetTick() - tick) >= MCI_VSWITCH_TIMEOUT) {
+      return ARM_DRIVER_ERROR_TIMEOUT;
+    }
+  }
+  mci->reg->ICR = SDMMC_ICR_VSWENDC;
+
+  mci->reg->POWER &= ~(SDMMC_POWER_VSWITCH | SDMMC_POWER_VSWITCHEN);
+
+  if ((mci->reg->STA & SDMMC_STA_BUSYD0) != 0U) {
+    /* Card did not switch to 1.8V */
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+#endif
+
+
 /**
   \fn            int32_t CardPower (uint32_t voltage)
   \brief         Set Memory Card supply voltage.
@@ -804,9 +1028,23 @@ static int32_t PowerControl (ARM_POWER_STATE state, MCI_RESOURCES *mci) {
   \return        \ref execution_status
 */
 static int32_t CardPower (uint32_t voltage, MCI_RESOURCES *mci) {
-  (void)voltage;
 
   if ((mci->info->flags & MCI_POWER) == 0U) { return ARM_DRIVER_ERROR; }
+
+#if (MCI0_UHS != 0U) || (MCI1_UHS != 0U)
+  if ((voltage & ARM_MCI_POWER_VCCQ_Msk) == ARM_MCI_POWER_VCCQ_1V8) {
+    if ((mci->reg->POWER & SDMMC_POWER_VSWITCHEN) != 0U) {
+      /* VOLTAGE_SWITCH (CMD11) sent */
+      return VoltageSwitch (mci);
+    }
+  }
+  else if ((voltage & ARM_MCI_POWER_VCCQ_Msk) == ARM_MCI_POWER_VCCQ_3V3) {
+    MCI_DriveTransceiver_1V8 ((mci->reg == SDMMC1) ? 0U : 1U, 0U);
+  }
+#else
+  (void)voltage;
+#endif
+
   return ARM_DRIVER_OK;
 }
 
@@ -904,7 +1142,7 @@ static int32_t ReadWP (MCI_RESOURCES *mci) {
   \return        \ref execution_status
 */
 static int32_t SendCommand (uint32_t cmd, uint32_t arg, uint32_t flags, uint32_t *response, MCI_RESOURCES *mci) {
-  uint32_t i, clkcr;
+  uint32_t i, clkcr, blk_cnt;
 
   if (((flags & MCI_RESPONSE_EXPECTED_Msk) != 0U) && (response == NULL)) {
     return ARM_DRIVER_ERROR_PARAMETER;
@@ -915,6 +1153,19 @@ static int32_t SendCommand (uint32_t cmd, uint32_t arg, uint32_t flags, uint32_t
   if (mci->info->status.command_active) {
     return ARM_DRIVER_ERROR_BUSY;
   }
+
+  blk_cnt = 0U;
+
+  if (((mci->info->flags & MCI_BLK_CNT) != 0U) && ((flags & ARM_MCI_TRANSFER_DATA) != 0U)) {
+    if ((cmd == 18U) || (cmd == 25U)) {
+      /* Multiple block transfer: send SET_BLOCK_COUNT first */
+      blk_cnt = mci->info->blk_cnt;
+
+      if (blk_cnt > 0xFFFFU) {
+        return ARM_DRIVER_ERROR_UNSUPPORTED;
+      }
+    }
+  }
   mci->info->status.command_active   = 1U;
   mci->info->status.command_timeout  = 0U;
   mci->info->status.command_error    = 0U;
@@ -979,6 +1230,19 @@ static int32_t SendCommand (uint32_t cmd, uint32_t arg, uint32_t flags, uint32_t
     mci->info->flags |= MCI_DATA_XFER;
   }
 
+  if (blk_cnt != 0U) {
+    /* Queue data command, it is sent from the interrupt handler after CMD23 response */
+    mci->info->cmd_next = cmd;
+    mci->info->arg_next = arg;
+    mci->info->flags   |= MCI_CMD_PEND;
+
+    cmd = SDMMC_CMD_CPSMEN | SDMMC_CMD_WAITRESP_0 | 23U;
+    arg = blk_cnt;
+  }
+  else {
+    mci->info->flags &= ~MCI_CMD_PEND;
+  }
+
   /* Clear all interrupt flags */
   mci->reg->ICR = SDMMC_ICR_BIT_Msk;
 
@@ -1003,7 +1267,8 @@ static int32_t SendCommand (uint32_t cmd, uint32_t arg, uint32_t flags, uint32_t
   \return        \ref execution_status
 */
 static int32_t SetupTransfer (uint8_t *data, uint32_t block_count, uint32_t block_size, uint32_t mode, MCI_RESOURCES *mci) {
-  uint32_t sz, dctrl, daddr;
+  MCI_DOUBLE_BUFFER *dbuf;
+  uint32_t sz, dctrl, daddr, len;
 
   if ((data == NULL) || (block_count == 0U) || (block_size == 0U)) { return ARM_DRIVER_ERROR_PARAMETER; }
 
@@ -1014,20 +1279,61 @@ static int32_t SetupTransfer (uint8_t *data, uint32_t block_count, uint32_t bloc
     return ARM_DRIVER_ERROR_BUSY;
   }
 
+  len   = block_count * block_size;
+  daddr = (uint32_t)data;
+  dbuf  = mci->info->dbuf;
+
+  mci->info->flags &= ~(MCI_DATA_BNC | MCI_DATA_UNAL);
+
 #if (MCI_DCACHE_MAINTENANCE == 1U)
     /* Is DCache enabled */
     if ((SCB->CCR & SCB_CCR_DC_Msk) != 0U) {
-      /* Data buffer must be 32 Byte aligned and size is n *32 */
-      if (((((uint32_t)data)& 0x1FU) != 0) || (((block_count * block_size) & 0x1FU) != 0)) {
-        return ARM_DRIVER_ERROR_UNSUPPORTED;
+      /* Data buffer not 32 Byte aligned or size not n*32 */
+      if ((((uint32_t)data & 0x1FU) != 0U) || ((len & 0x1FU) != 0U)) {
+        if ((dbuf != NULL) || (mci->bounce == NULL)) {
+          return ARM_DRIVER_ERROR_UNSUPPORTED;
+        }
+        if (len <= MCI_BOUNCE_BUF_SIZE) {
+          /* Transfer whole data via bounce buffer */
+          mci->info->flags |= MCI_DATA_BNC;
+          daddr = (uint32_t)mci->bounce;
+        }
+        else if (((uint32_t)data & 0x03U) == 0U) {
+          /* Transfer directly, first and last DCache line are maintained via bounce buffer */
+          mci->info->flags |= MCI_DATA_UNAL;
+        }
+        else {
+          /* IDMA requires word aligned buffer */
+          return ARM_DRIVER_ERROR_UNSUPPORTED;
+        }
+        mci->info->xfer_data = data;
       }
     }
 #endif
 
-  daddr = (uint32_t)data;
+  if (dbuf != NULL) {
+    /* Double buffer mode: data must point to buffer 0, buffer must hold whole blocks */
+    if ((data != dbuf->buf[0]) || ((dbuf->size % block_size) != 0U)) {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    dbuf->cnt = 0U;
+
+    mci->reg->IDMABASE0 = (uint32_t)dbuf->buf[0];
+    mci->reg->IDMABASE1 = (uint32_t)dbuf->buf[1];
+    mci->reg->IDMABSIZE = dbuf->size;
+    mci->reg->IDMACTRL  =  SDMMC_IDMA_IDMABMODE | SDMMC_IDMA_IDMAEN;
 
-  mci->reg->IDMABASE0 = daddr;
-  mci->reg->IDMACTRL  =  SDMMC_IDMA_IDMAEN;
+    /* Enable IDMA buffer transfer complete interrupt */
+    mci->reg->MASK   |=  SDMMC_MASK_IDMABTCIE;
+    mci->info->flags |=  MCI_DATA_DBUF;
+  }
+  else {
+    mci->reg->IDMABASE0 = daddr;
+    mci->reg->IDMACTRL  =  SDMMC_IDMA_IDMAEN;
+
+    mci->reg->MASK   &= ~SDMMC_MASK_IDMABTCIE;
+    mci->info->flags &= ~MCI_DATA_DBUF;
+  }
 
   dctrl = 0U;
 
@@ -1035,6 +1341,17 @@ static int32_t SetupTransfer (uint8_t *data, uint32_t block_count, uint32_t bloc
     /* Direction: From card to controller */
     mci->info->flags |= MCI_DATA_READ;
     dctrl |= SDMMC_DCTRL_DTDIR;
+
+#if (MCI_DCACHE_MAINTENANCE == 1U)
+    if ((mci->info->flags & MCI_DATA_BNC) != 0U) {
+      /* Discard bounce buffer lines: no write-back may overwrite received data */
+      SCB_InvalidateDCache_by_Addr ((uint32_t *)daddr, (int32_t)len);
+    }
+    else if ((mci->info->flags & MCI_DATA_UNAL) != 0U) {
+      /* Write back and discard lines, first and last line are shared with other data */
+      SCB_CleanInvalidateDCache_by_Addr ((uint32_t *)daddr, (int32_t)len);
+    }
+#endif
   }
   else {
     /* Direction: From controller to card */
@@ -1044,7 +1361,16 @@ static int32_t SetupTransfer (uint8_t *data, uint32_t block_count, uint32_t bloc
     /* Is DCache enabled */
     if ((SCB->CCR & SCB_CCR_DC_Msk) != 0U) {
       /* Clean data cache:ensure data coherency between DMA and CPU */
-      SCB_CleanDCache_by_Addr ((uint32_t *)daddr, (int32_t)(block_count * block_size));
+      if (dbuf != NULL) {
+        SCB_CleanDCache_by_Addr ((uint32_t *)dbuf->buf[0], (int32_t)dbuf->size);
+        SCB_CleanDCache_by_Addr ((uint32_t *)dbuf->buf[1], (int32_t)dbuf->size);
+      }
+      else {
+        if ((mci->info->flags & MCI_DATA_BNC) != 0U) {
+          memcpy ((void *)daddr, data, len);
+        }
+        SCB_CleanDCache_by_Addr ((uint32_t *)daddr, (int32_t)len);
+      }
     }
 #endif
   }
@@ -1069,8 +1395,9 @@ static int32_t SetupTransfer (uint8_t *data, uint32_t block_count, uint32_t bloc
     }
   }
 
-  mci->info->dlen   = block_count * block_size;
-  mci->info->dctrl  = dctrl | (sz << 4);
+  mci->info->dlen    = len;
+  mci->info->dctrl   = dctrl | (sz << 4);
+  mci->info->blk_cnt = block_count;
 
   return (ARM_DRIVER_OK);
 }
@@ -1095,6 +1422,7 @@ static int32_t AbortTransfer (MCI_RESOURCES *mci) {
 
   /* Disable IDMA */
   mci->reg->IDMACTRL &= ~(SDMMC_IDMA_IDMAEN);
+  mci->info->flags   &= ~(MCI_DATA_DBUF | MCI_DATA_BNC | MCI_DATA_UNAL | MCI_CMD_PEND);
 
   /* Flush FIFO */
   mci->reg->DCTRL |= SDMMC_DCTRL_FIFORST;
@@ -1117,6 +1445,77 @@ static int32_t AbortTransfer (MCI_RESOURCES *mci) {
 }
 
 
+#if (MCI_DLYB != 0U)
+/**
+  \fn            uint32_t DelayBlockCalibrate (MCI_RESOURCES *mci)
+  \brief         Enable delay block and determine unit delay and phases per bus clock period.
+  \param[in]     mci   Pointer to MCI resources
+  \return        0 on success, 1 on error
+*/
+static uint32_t DelayBlockCalibrate (MCI_RESOURCES *mci) {
+  DLYB_TypeDef *dlyb = (DLYB_TypeDef *)mci->dlyb;
+
+  if (DelayBlock_Enable (dlyb) != HAL_OK) {
+    return 1U;
+  }
+
+  /* Delay line is configured to one bus clock period */
+  mci->info->dlyb_sel  =  dlyb->CFGR & DLYB_CFGR_SEL;
+  mci->info->dlyb_unit = (dlyb->CFGR & DLYB_CFGR_UNIT) >> DLYB_CFGR_UNIT_Pos;
+
+  if ((mci->info->dlyb_sel == 0U) || (mci->info->dlyb_sel > DLYB_MAX_SELECT)) {
+    return 1U;
+  }
+  return 0U;
+}
+
+/**
+  \fn            void TuningStep (MCI_RESOURCES *mci)
+  \brief         Evaluate tuning block received with current phase and select next phase.
+  \param[in]     mci   Pointer to MCI resources
+*/
+static void TuningStep (MCI_RESOURCES *mci) {
+  uint32_t i, cnt, best, best_cnt;
+
+  if ((mci->info->status.transfer_error   == 0U) &&
+      (mci->info->status.transfer_timeout == 0U) &&
+      (mci->info->status.command_error    == 0U) &&
+      (mci->info->status.command_timeout  == 0U)) {
+    /* Tuning block received correctly */
+    mci->info->tune_pass |= 1UL << mci->info->tune_phase;
+  }
+
+  mci->info->tune_phase++;
+
+  if (mci->info->tune_phase < mci->info->dlyb_sel) {
+    /* Test next phase */
+    DelayBlock_Configure ((DLYB_TypeDef *)mci->dlyb, mci->info->tune_phase, mci->info->dlyb_unit);
+    return;
+  }
+
+  /* All phases tested: select centre of the longest window of passing phases */
+  best     = 0U;
+  best_cnt = 0U;
+  cnt      = 0U;
+  for (i = 0U; i < mci->info->dlyb_sel; i++) {
+    if ((mci->info->tune_pass & (1UL << i)) != 0U) {
+      cnt++;
+      if (cnt > best_cnt) {
+        best_cnt = cnt;
+        best     = i - (cnt / 2U);
+      }
+    }
+    else {
+      cnt = 0U;
+    }
+  }
+  DelayBlock_Configure ((DLYB_TypeDef *)mci->dlyb, best, mci->info->dlyb_unit);
+
+  mci->info->flags &= ~MCI_TUNING;
+}
+#endif
+
+
 /**
   \fn            int32_t Control (uint32_t control, uint32_t arg)
   \brief         Control MCI Interface.
@@ -1127,6 +1526,7 @@ static int32_t AbortTransfer (MCI_RESOURCES *mci) {
 static int32_t Control (uint32_t control, uint32_t arg, MCI_RESOURCES *mci) {
   GPIO_InitTypeDef GPIO_InitStruct;
   GPIO_TypeDef *port;
+  MCI_DOUBLE_BUFFER *dbuf;
   uint32_t val, clkdiv, bps;
 
   if ((mci->info->flags & MCI_POWER) == 0U) { return ARM_DRIVER_ERROR; }
@@ -1175,11 +1575,31 @@ static int32_t Control (uint32_t control, uint32_t arg, MCI_RESOURCES *mci) {
           /* SDR50:  up to 100MHz,  50  MB/s: UHS-I 1.8V signaling */
         case ARM_MCI_BUS_UHS_SDR104:
           /* SDR104: up to 208MHz, 104  MB/s: UHS-I 1.8V signaling */
+          /* HS200:  up to 200MHz, 200  MB/s: MMC 1.8V signaling   */
           val |= SDMMC_CLKCR_BUSSPEED;
           break;
 
         default: return ARM_DRIVER_ERROR_UNSUPPORTED;
       }
+
+      /* Receive clock: feedback clock through delay block in SDR50/SDR104 modes */
+      val &= ~SDMMC_CLKCR_SELCLKRX;
+      mci->info->flags &= ~MCI_TUNING;
+
+#if (MCI_DLYB != 0U)
+      if (mci->dlyb != NULL) {
+        if ((arg == ARM_MCI_BUS_UHS_SDR50) || (arg == ARM_MCI_BUS_UHS_SDR104)) {
+          if (DelayBlockCalibrate (mci) != 0U) {
+            return ARM_DRIVER_ERROR;
+          }
+          val |= SDMMC_CLKCR_SELCLKRX_1;
+        }
+        else {
+          DelayBlock_Disable ((DLYB_TypeDef *)mci->dlyb);
+        }
+      }
+#endif
+
       /* Set new register value */
       mci->reg->CLKCR = val;
       break;
@@ -1273,6 +1693,74 @@ static int32_t Control (uint32_t control, uint32_t arg, MCI_RESOURCES *mci) {
       }
       break;
 
+    case ARM_MCI_UHS_TUNING_OPERATION:
+#if (MCI_DLYB != 0U)
+      if ((mci->dlyb == NULL) || ((mci->reg->CLKCR & SDMMC_CLKCR_SELCLKRX) != SDMMC_CLKCR_SELCLKRX_1)) {
+        /* Not in SDR50/SDR104 mode */
+        return ARM_DRIVER_ERROR;
+      }
+      if (mci->info->status.transfer_active) {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      if (arg == 0U) {
+        /* Reset: calibrate delay line to current bus clock, test first phase */
+        if (DelayBlockCalibrate (mci) != 0U) {
+          return ARM_DRIVER_ERROR;
+        }
+        mci->info->tune_phase = 0U;
+        mci->info->tune_pass  = 0U;
+        DelayBlock_Configure ((DLYB_TypeDef *)mci->dlyb, 0U, mci->info->dlyb_unit);
+
+        mci->info->flags |= MCI_TUNING;
+      }
+      else {
+        if ((mci->info->flags & MCI_TUNING) == 0U) {
+          return ARM_DRIVER_ERROR;
+        }
+        TuningStep (mci);
+      }
+      break;
+#else
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+#endif
+
+    case ARM_MCI_UHS_TUNING_RESULT:
+      if ((mci->info->flags & MCI_TUNING) != 0U) {
+        /* Tuning in progress */
+        return 1;
+      }
+      if (mci->info->tune_pass == 0U) {
+        return ARM_DRIVER_ERROR;
+      }
+      break;
+
+    case MCI_CONTROL_DOUBLE_BUFFER:
+      if (mci->info->status.transfer_active) {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      dbuf = (MCI_DOUBLE_BUFFER *)arg;
+
+      if (dbuf != NULL) {
+        /* Buffers must be 32 Byte aligned, size is n*32 and fits IDMABSIZE */
+        if ((dbuf->buf[0] == NULL) || (dbuf->buf[1] == NULL) ||
+            ((((uint32_t)dbuf->buf[0] | (uint32_t)dbuf->buf[1]) & 0x1FU) != 0U) ||
+            (dbuf->size == 0U) || ((dbuf->size & 0x1FU) != 0U) ||
+            (dbuf->size > MCI_DOUBLE_BUFFER_SIZE_MAX)) {
+          return ARM_DRIVER_ERROR_PARAMETER;
+        }
+      }
+      mci->info->dbuf = dbuf;
+      break;
+
+    case MCI_CONTROL_SET_BLOCK_COUNT:
+      if (arg != 0U) {
+        mci->info->flags |=  MCI_BLK_CNT;
+      }
+      else {
+        mci->info->flags &= ~MCI_BLK_CNT;
+      }
+      break;
+
     default: return ARM_DRIVER_ERROR_UNSUPPORTED;
   }
 
@@ -1290,6 +1778,82 @@ static ARM_MCI_STATUS GetStatus (MCI_RESOURCES *mci) {
 }
 
 
+/**
+  \fn            void DoubleBufferDone (MCI_RESOURCES *mci, uint32_t num)
+  \brief         Complete IDMA double buffer: maintain DCache, signal event and reload buffer address.
+  \param[in]     mci   Pointer to MCI resources
+  \param[in]     num   Number of bytes transferred to/from the buffer
+*/
+static void DoubleBufferDone (MCI_RESOURCES *mci, uint32_t num) {
+  MCI_DOUBLE_BUFFER *dbuf = mci->info->dbuf;
+  uint32_t idx;
+
+  idx = dbuf->cnt & 1U;
+
+#if (MCI_DCACHE_MAINTENANCE == 1U)
+  /* Is DCache enabled */
+  if (((SCB->CCR & SCB_CCR_DC_Msk) != 0U) && ((mci->info->flags & MCI_DATA_READ) != 0U)) {
+    /* Invalidate data cache: ensure data coherency between DMA and CPU */
+    SCB_InvalidateDCache_by_Addr ((uint32_t *)dbuf->buf[idx], (int32_t)num);
+  }
+#else
+  (void)num;
+#endif
+
+  dbuf->cnt++;
+
+  if (mci->info->cb_event) {
+    (mci->info->cb_event)(MCI_EVENT_BUFFER_COMPLETE);
+  }
+
+#if (MCI_DCACHE_MAINTENANCE == 1U)
+  /* Is DCache enabled */
+  if (((SCB->CCR & SCB_CCR_DC_Msk) != 0U) && ((mci->info->flags & MCI_DATA_READ) == 0U)) {
+    /* Clean data cache: buffer may have been refilled in the event callback */
+    SCB_CleanDCache_by_Addr ((uint32_t *)dbuf->buf[idx], (int32_t)dbuf->size);
+  }
+#endif
+
+  /* Reload address of the idle buffer (may have been changed in the event callback) */
+  if (idx == 0U) {
+    mci->reg->IDMABASE0 = (uint32_t)dbuf->buf[0];
+  }
+  else {
+    mci->reg->IDMABASE1 = (uint32_t)dbuf->buf[1];
+  }
+}
+
+
+#if (MCI_DCACHE_MAINTENANCE == 1U)
+/**
+  \fn            void InvalidateUnaligned (uint8_t *data, uint32_t len, uint8_t *save)
+  \brief         Invalidate DCache for received data not aligned to DCache lines.
+  \param[in]     data  Pointer to received data
+  \param[in]     len   Number of bytes received
+  \param[in]     save  Pointer to 64 Byte bounce area
+  \note          Bytes outside the buffer that share the first and last DCache line
+                 are saved before and restored after the invalidation.
+*/
+static void InvalidateUnaligned (uint8_t *data, uint32_t len, uint8_t *save) {
+  uint32_t head, tail, end;
+
+  end  = (uint32_t)data + len;
+  head = (uint32_t)data & 0x1FU;
+  tail = (32U - (end & 0x1FU)) & 0x1FU;
+
+  /* Save bytes preceding and following the buffer */
+  memcpy (&save[0],  data - head,  head);
+  memcpy (&save[32], (void *)end,  tail);
+
+  SCB_InvalidateDCache_by_Addr ((uint32_t *)((uint32_t)data - head), (int32_t)(head + len + tail));
+
+  /* Restore bytes preceding and following the buffer */
+  memcpy (data - head,  &save[0],  head);
+  memcpy ((void *)end,  &save[32], tail);
+}
+#endif
+
+
 /* SDMMC interrupt handler */
 static void SDMMC_IRQHandler (MCI_RESOURCES *mci) {
   uint32_t sta, icr, event, mask;
@@ -1353,6 +1917,28 @@ static void SDMMC_IRQHandler (MCI_RESOURCES *mci) {
     event |= ARM_MCI_EVENT_COMMAND_COMPLETE;
   }
 
+  if ((event & ARM_MCI_EVENT_COMMAND_COMPLETE) && (mci->info->flags & MCI_CMD_PEND)) {
+    /* SET_BLOCK_COUNT response received */
+    mci->info->flags &= ~MCI_CMD_PEND;
+    event &= ~ARM_MCI_EVENT_COMMAND_COMPLETE;
+
+    if (mci->reg->RESP1 & SDMMC_OCR_ERRORBITS) {
+      /* Card reported an error, data command is not sent */
+      mci->info->flags &= ~MCI_DATA_XFER;
+      mci->info->status.command_error = 1U;
+
+      event |= ARM_MCI_EVENT_COMMAND_ERROR;
+    }
+    else {
+      /* Clear response flags before the queued command is sent */
+      mci->reg->ICR = icr;
+      icr = 0U;
+
+      /* Send queued data command */
+      mci->reg->ARG = mci->info->arg_next;
+      mci->reg->CMD = mci->info->cmd_next;
+    }
+  }
   if (event & ARM_MCI_EVENT_COMMAND_COMPLETE) {
     if (mci->info->response) {
       /* Read response registers */
@@ -1385,16 +1971,40 @@ static void SDMMC_IRQHandler (MCI_RESOURCES *mci) {
     /* Command sent (no response required) */
     event |= ARM_MCI_EVENT_COMMAND_COMPLETE;
   }
+  if (sta & SDMMC_STA_IDMABTC) {
+    icr |= SDMMC_ICR_IDMABTCC;
+    /* IDMA buffer transfer complete (double buffer mode) */
+    if (mci->info->flags & MCI_DATA_DBUF) {
+      if (((mci->info->dbuf->cnt + 1U) * mci->info->dbuf->size) <= mci->info->dlen) {
+        DoubleBufferDone (mci, mci->info->dbuf->size);
+      }
+    }
+  }
   if (sta & SDMMC_STA_DATAEND) {
     icr |= SDMMC_ICR_DATAENDC;
     /* Data end (DCOUNT is zero) */
     event |= ARM_MCI_EVENT_TRANSFER_COMPLETE;
 
+    if (mci->info->flags & MCI_DATA_DBUF) {
+      /* Complete last (partially filled) buffer */
+      if ((mci->info->dbuf->cnt * mci->info->dbuf->size) < mci->info->dlen) {
+        DoubleBufferDone (mci, mci->info->dlen - (mci->info->dbuf->cnt * mci->info->dbuf->size));
+      }
+    }
 #if (MCI_DCACHE_MAINTENANCE == 1U)
     /* Is DCache enabled */
-    if ((SCB->CCR & SCB_CCR_DC_Msk) != 0U) {
+    else if (((SCB->CCR & SCB_CCR_DC_Msk) != 0U) && ((mci->info->flags & MCI_DATA_READ) != 0U)) {
       /* Invalidate data cache: ensure data coherency between DMA and CPU */
-      SCB_InvalidateDCache_by_Addr ((uint32_t *)mci->reg->IDMABASE0, (int32_t)mci->info->dlen);
+      if ((mci->info->flags & MCI_DATA_UNAL) != 0U) {
+        InvalidateUnaligned (mci->info->xfer_data, mci->info->dlen, mci->bounce);
+      }
+      else {
+        SCB_InvalidateDCache_by_Addr ((uint32_t *)mci->reg->IDMABASE0, (int32_t)mci->info->dlen);
+
+        if ((mci->info->flags & MCI_DATA_BNC) != 0U) {
+          memcpy (mci->info->xfer_data, mci->bounce, mci->info->dlen);
+        }
+      }
     }
 #endif
   }
@@ -1440,6 +2050,11 @@ static void SDMMC_IRQHandler (MCI_RESOURCES *mci) {
     if (event & mask) {
       mci->info->status.command_active = 0U;
 
+      if (mci->info->flags & MCI_CMD_PEND) {
+        /* SET_BLOCK_COUNT failed, queued data command is discarded */
+        mci->info->flags &= ~(MCI_CMD_PEND | MCI_DATA_XFER);
+      }
+
       if (mci->info->cb_event) {
         if (event & ARM_MCI_EVENT_COMMAND_ERROR) {
           (mci->info->cb_event)(ARM_MCI_EVENT_COMMAND_ERROR);
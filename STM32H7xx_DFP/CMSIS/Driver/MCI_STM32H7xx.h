@@ -1,5 +1,5 @@
 /* -----------------------------------------------------------------------------
- * Copyright (c) 2013-2023 Arm Limited (or its affiliates).
+ * Copyright (c) 2013-2024 Arm Limited (or its affiliates).
  * All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        15. February 2023
- * $Revision:    V1.6
+ * $Date:        18. October 2024
+ * $Revision:    V1.10
  *
  * Project:      MCI Driver Definitions for STMicroelectronics STM32H7xx
  * -------------------------------------------------------------------------- */
@@ -34,6 +34,14 @@
 
 #include <string.h>
 
+/* MCI: Delay block for receive clock tuning (stm32h7xx_ll_delayblock.c), used with 1.8V signaling (MemoryCard_UHSx) */
+#if (defined(MemoryCard_UHS0) && defined(DLYB_SDMMC1)) || (defined(MemoryCard_UHS1) && defined(DLYB_SDMMC2))
+#include "stm32h7xx_ll_delayblock.h"
+#define MCI_DLYB            1U
+#else
+#define MCI_DLYB            0U
+#endif
+
 #if ((defined(RTE_Drivers_MCI0) || \
       defined(RTE_Drivers_MCI1))   \
       && (!defined (MX_SDMMC1))    \
@@ -131,6 +139,26 @@
 #endif
 
 
+/* Vendor specific Control codes */
+#define MCI_CONTROL_DOUBLE_BUFFER     (0x80UL)        /* IDMA double buffer mode for transfers; arg = pointer to MCI_DOUBLE_BUFFER (0 = disable) */
+#define MCI_CONTROL_SET_BLOCK_COUNT   (0x81UL)        /* Send SET_BLOCK_COUNT (CMD23) ahead of CMD18/CMD25; arg: 0=disabled, 1=enabled */
+
+/* Vendor specific bus speed modes (ARM_MCI_BUS_SPEED_MODE) */
+#define MCI_BUS_MMC_HS200             (ARM_MCI_BUS_UHS_SDR104) /* MMC HS200: up to 200MHz, 1.8V signaling, tuned sampling clock */
+
+/* Vendor specific events */
+#define MCI_EVENT_BUFFER_COMPLETE     (1UL << 31)     /* IDMA double buffer mode: buffer transferred */
+
+/* IDMA double buffer size limit */
+#define MCI_DOUBLE_BUFFER_SIZE_MAX    (SDMMC_IDMABSIZE_IDMABNDT_Msk)
+
+/* IDMA double buffer mode definition */
+typedef struct {
+  uint8_t                  *buf[2];     /* Buffers 0 and 1 (32 Byte aligned)  */
+  uint32_t                  size;       /* Size of each buffer (n*32 Bytes)   */
+  uint32_t volatile         cnt;        /* Buffers completed (buffer cnt & 1) */
+} MCI_DOUBLE_BUFFER;
+
 /* Interrupt clear mask */
 #define SDMMC_ICR_BIT_Msk     (SDMMC_IT_CCRCFAIL   | \
                                SDMMC_IT_DCRCFAIL   | \
@@ -176,6 +204,12 @@
 #define MCI_READ_WAIT ((uint32_t)0x0080)  /* Read wait operation start     */
 #define MCI_BUS_HS    ((uint32_t)0x0100)  /* High speed bus mode is active */
 #define MCI_BUS_SDR12 ((uint32_t)0x0200)  /* SDR12 bus mode is active      */
+#define MCI_DATA_DBUF ((uint32_t)0x0400)  /* Double buffer transfer        */
+#define MCI_DATA_BNC  ((uint32_t)0x0800)  /* Transfer via bounce buffer    */
+#define MCI_DATA_UNAL ((uint32_t)0x1000)  /* Cache line unaligned transfer */
+#define MCI_BLK_CNT   ((uint32_t)0x2000)  /* Pre-defined block count (CMD23)*/
+#define MCI_CMD_PEND  ((uint32_t)0x4000)  /* Data command queued after CMD23*/
+#define MCI_TUNING    ((uint32_t)0x8000)  /* Sampling clock tuning active  */
 
 #define MCI_RESPONSE_EXPECTED_Msk (ARM_MCI_RESPONSE_SHORT      | \
                                    ARM_MCI_RESPONSE_SHORT_BUSY | \
@@ -199,6 +233,15 @@ typedef struct {
   uint32_t                  dlen;       /* Data length register value         */
   uint32_t                  ker_clk;    /* SDMMC kernel clock frequency       */
   uint32_t volatile         flags;      /* Driver state flags                 */
+  MCI_DOUBLE_BUFFER        *dbuf;       /* IDMA double buffer configuration   */
+  uint8_t                  *xfer_data;  /* Application data buffer (unaligned)*/
+  uint32_t                  blk_cnt;    /* Number of blocks to transfer       */
+  uint32_t                  cmd_next;   /* Queued command register value      */
+  uint32_t                  arg_next;   /* Queued command argument            */
+  uint32_t                  dlyb_unit;  /* Delay block unit delay             */
+  uint32_t                  dlyb_sel;   /* Delay block phases per clock period*/
+  uint32_t                  tune_phase; /* Tuning: phase being tested         */
+  uint32_t                  tune_pass;  /* Tuning: passed phases bit mask     */
 } MCI_INFO;
 
 /* MCI Resources Definition */
@@ -208,6 +251,8 @@ typedef struct {
   MCI_IO        *io_cd;                 /* I/O config: card detect            */
   MCI_IO        *io_wp;                 /* I/O config: write protect line     */
   MCI_INFO      *info;                  /* Run-Time information               */
+  uint8_t       *bounce;                /* Bounce buffer (32 Byte aligned)    */
+  void          *dlyb;                  /* DLYB_TypeDef: delay block          */
 } const MCI_RESOURCES;
 
 /* Global functions and variables */
@@ -229,5 +274,6 @@ extern ARM_DRIVER_MCI Driver_MCI1;
 
 extern int32_t MCI_ReadCD (uint32_t instance);
 extern int32_t MCI_ReadWP (uint32_t instance);
+extern void    MCI_DriveTransceiver_1V8 (uint32_t instance, uint32_t enable);
 
 #endif /* __MCI_STM32H7XX_H */
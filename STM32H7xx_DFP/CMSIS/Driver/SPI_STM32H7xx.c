@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        27. February 2023
- * $Revision:    V1.6
+ * $Date:        18. October 2024
+ * $Revision:    V1.9
  *
  * Driver:       Driver_SPI1/2/3/4/5/6
  *
@@ -30,6 +30,16 @@
 
 # Revision History
 
+- Version 1.9
+  - Added FIFO packed fast path for short Master mode transfers (bypasses HAL, no DMA setup)
+  - Added transfer path selection (SPI_SET_PATH control code)
+- Version 1.8
+  - Added transaction scheduler: transfers to several devices with different bus configurations
+    and slave selects are queued and chained from the transfer complete interrupt (SPI_SCHED_SUBMIT)
+- Version 1.7
+  - Added bounce buffer pool: DMA is used also for receive buffers that are not cache line aligned
+  - Added transfer path statistics (SPI_GET_STATISTICS and SPI_CLEAR_STATISTICS control codes)
+  - Added support for transfers of more than 65535 items (performed in segments)
 - Version 1.6
   - Updated DMA and Data Cache handling (improved code readability and maintainability)
 - Version 1.5
@@ -73,6 +83,13 @@ Hardware limitations:
  - SPI6 with BDMA can access only SRAM4 memory.
    If BDMA is used on SPI6 ensure that Tx and Rx buffers are be positioned in SRAM4 memory.
 
+STM32 HAL limitations:
+ - Number of items of a HAL transfer is limited to 65535. Larger transfers are performed
+   in segments of up to 65504 items, the next segment is started from the transfer
+   complete interrupt of the previous one. Between segments the SPI is briefly idle:
+   - In Master mode with Hardware NSS output the NSS signal is deactivated between segments.
+   - In Slave mode the master must not clock data before the next segment is started.
+
 DMA usage limitations:
  - The size of DCache line on Cortex M7 is 32 Bytes. To safely perform
    DCache maintenance operations, data must be aligned to a 32 Byte boundary
@@ -86,6 +103,75 @@ DMA usage limitations:
    data that is not aligned to a 32 Byte boundary or that is not n*32 Bytes
    in size can be dangerous and can corrupt other data that is also maintained
    by the same 32 Byte DCache line.
+ - If the bounce buffer pool is enabled (SPI_BOUNCE_BUF_NUM > 0), DMA is also
+   used for buffers that are not aligned to a 32 Byte boundary or not n*32 Bytes
+   in size (data must only be aligned to the data item size):
+   - Transmit data is never copied, as cleaning DCache lines that are shared
+     with other data does not discard any data.
+   - Received items that share a DCache line with other data (head and tail of
+     the buffer) are received into a bounce buffer and copied to the receive
+     buffer, the cache line aligned middle part is received directly.
+   - In Master mode without Hardware NSS output the head, middle and tail are
+     transferred as consecutive DMA transfers. In other modes the whole transfer
+     is received into the bounce buffer if it fits (SPI_BOUNCE_BUF_SIZE),
+     otherwise IRQ transfer is performed.
+   - If no bounce buffer is free, IRQ transfer is performed.
+   - Bounce buffers can be placed into a non-cacheable MPU region by defining
+     SPI_BOUNCE_BUF_SECTION and setting SPI_BOUNCE_BUF_NON_CACHEABLE to 1.
+ - The number of transfers performed by DMA, by DMA with bounce buffer and in
+   IRQ mode can be read with Control(SPI_GET_STATISTICS, (uint32_t)&stat).
+
+# Fast Path
+
+The fast path is disabled by default (SPI_FAST_XFER_MAX = 0). When enabled, short Master mode transfers
+(up to SPI_FAST_XFER_MAX bytes) do not use DMA or the HAL interrupt transfer functions. Data is written
+to and read from the FIFO with 32-bit accesses, which pack four 8-bit or two 16-bit frames:
+ - Interrupt mode (SPI_FAST_POLL = 0): transfers that fit into the FIFO (16 bytes on SPI1..3, 8 bytes
+   on SPI4..6, at most 16 frames) are preloaded into the transmit FIFO and completed by a single
+   RXP interrupt. Longer transfers are received in packets of half the FIFO size, the transmit FIFO
+   is refilled from the RXP interrupt of each packet (a 32-byte transfer on SPI1..3 takes 4 interrupts).
+   Frames after the last full packet are read by the EOT interrupt, the interrupt handler never waits
+   for the end of transfer.
+ - Polled mode (SPI_FAST_POLL = 1): the transfer is performed in the calling function and
+   ARM_SPI_EVENT_TRANSFER_COMPLETE is signaled before Send, Receive or Transfer returns.
+   A mode fault stops the transfer and is signaled before the function returns.
+   Scheduled transactions use interrupt mode.
+
+The number of fast path transfers is reported in the fast member of SPI_STATISTICS.
+
+# Transfer Path Selection
+
+Control(SPI_SET_PATH, arg) restricts the transfer path chosen for following Send, Receive and Transfer
+calls (for example to compare the latency of the paths):
+ - SPI_PATH_AUTO (default): fast path, DMA or interrupt mode
+ - SPI_PATH_DMA: DMA or interrupt mode, the fast path is not used
+ - SPI_PATH_IRQ: interrupt mode only
+
+Vendor specific control codes and their types are declared in the public header **SPI_STM32H7xx_Ext.h**.
+
+# Transaction Scheduler
+
+Transfers to several devices on one bus can be queued with Control(SPI_SCHED_SUBMIT, (uint32_t)&xfer).
+Each transaction (SPI_SCHED_XFER) refers to a device (SPI_SCHED_DEVICE) that specifies the frame format,
+data bits, bit order, bus speed and slave select of the device:
+ - SPI_SCHED_SS_GPIO: a GPIO pin (configured as output by the application) is driven low
+   during the transaction
+ - SPI_SCHED_SS_HW and SPI_SCHED_SS_HW_PULSE: the SPI NSS output is active during the transaction
+   (or pulsed between data frames), with optional idle cycles after NSS activation (ss_idle).
+   The bus must be configured with ARM_SPI_SS_MASTER_HW_OUTPUT, only the device connected to the
+   NSS pin can use hardware NSS. The NSS line should have a pull-up, as it is not driven during
+   transactions of other devices.
+
+The bus must be configured in **Full-Duplex Master** mode (ARM_SPI_MODE_MASTER) before transactions
+are submitted. Transactions are executed in submission order. When a transaction completes, the next one
+is configured and started from the transfer complete interrupt before the completion callback of the
+transaction (cb_event) is called. Only the configuration register fields that differ between consecutive
+devices are written, DMA is reconfigured only if the data item size changes.
+
+While scheduled transactions are pending, Control returns ARM_DRIVER_ERROR_BUSY (except abort, statistics and
+submit), transactions submitted during a Send, Receive or Transfer start when it completes. ARM_SPI_ABORT_TRANSFER
+aborts the active transaction and discards all queued transactions without calling their callbacks. After the
+scheduler has run, the bus keeps the configuration of the last device.
 
 # Configuration
 
@@ -105,6 +191,14 @@ SPI_DCACHE_DATA_TX_ALIGNMENT       |     **1**     |   1   | SPI DCache data Tx
 ^                                  |       ^       |   0   | SPI DCache data Tx alignment check: **disabled**
 SPI_DCACHE_DATA_TX_SIZE            |     **1**     |   1   | SPI DCache data Tx size check: **enabled**
 ^                                  |       ^       |   0   | SPI DCache data Tx size check: **disabled**
+SPI_BOUNCE_BUF_NUM                 |     **2**     | 0..32 | Number of bounce buffers shared by all SPI instances (0 = bounce buffering disabled)
+SPI_BOUNCE_BUF_SIZE                |    **64**     | n*32  | Size of a bounce buffer in bytes (minimum 64)
+SPI_BOUNCE_BUF_SECTION             | not defined   | name  | Linker section of the bounce buffers (for example a non-cacheable MPU region)
+SPI_BOUNCE_BUF_NON_CACHEABLE       |     **0**     |   0   | Bounce buffers are cacheable: DCache maintenance is performed
+^                                  |       ^       |   1   | Bounce buffers are in non-cacheable memory: no DCache maintenance
+SPI_FAST_XFER_MAX                  |     **0**     | 0..256| Maximum size of a fast path transfer in bytes (0 = fast path disabled)
+SPI_FAST_POLL                      |     **0**     |   0   | Fast path transfers are completed by interrupts (single interrupt for transfers that fit into the FIFO)
+^                                  |       ^       |   1   | Fast path transfers are completed by polling in the calling function
 
 ## STM32CubeMX
 
@@ -227,7 +321,7 @@ Results of the **CMSIS-Driver Validation** for this driver can be found in the [
 #include "SPI_STM32H7xx.h"
 #include "DCache_STM32H7xx.h"
 
-#define ARM_SPI_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,6)
+#define ARM_SPI_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,9)
 
 #ifndef SPI_DCACHE_MAINTENANCE
 #define SPI_DCACHE_MAINTENANCE                 (1U)
@@ -244,6 +338,41 @@ Results of the **CMSIS-Driver Validation** for this driver can be found in the [
 #ifndef SPI_DCACHE_DATA_TX_SIZE
 #define SPI_DCACHE_DATA_TX_SIZE                (1U)
 #endif
+#define SPI_SEGMENT_MAX                        (0xFFE0U)   // Maximum number of items in a segment (n*32: keeps segments cache line aligned)
+#define SPI_FAST_EOT_TIMEOUT                   (1000U)     // Number of polls for end of transfer after all data of a fast path transfer is received
+
+// Register fields reprogrammed by the transaction scheduler
+#define SPI_SCHED_CFG1_Msk                     (SPI_CFG1_MBR | SPI_CFG1_DSIZE)
+#define SPI_SCHED_CFG2_Msk                     (SPI_CFG2_CPOL | SPI_CFG2_CPHA | SPI_CFG2_LSBFRST | SPI_CFG2_SP   | \
+                                                SPI_CFG2_SSM  | SPI_CFG2_SSOE | SPI_CFG2_SSOM    | SPI_CFG2_MSSI | \
+                                                SPI_CFG2_MIDI)
+
+#ifndef SPI_BOUNCE_BUF_NUM
+#define SPI_BOUNCE_BUF_NUM                     (2U)
+#endif
+#ifndef SPI_BOUNCE_BUF_SIZE
+#define SPI_BOUNCE_BUF_SIZE                    (64U)
+#endif
+#ifndef SPI_BOUNCE_BUF_NON_CACHEABLE
+#define SPI_BOUNCE_BUF_NON_CACHEABLE           (0U)
+#endif
+
+#ifndef SPI_FAST_XFER_MAX
+#define SPI_FAST_XFER_MAX                      (0U)
+#endif
+#ifndef SPI_FAST_POLL
+#define SPI_FAST_POLL                          (0U)
+#endif
+
+#if (SPI_BOUNCE_BUF_NUM > 32U)
+#error  Too many bounce buffers defined, maximum value of SPI_BOUNCE_BUF_NUM is 32 !!!
+#endif
+#if ((SPI_BOUNCE_BUF_SIZE < 64U) || ((SPI_BOUNCE_BUF_SIZE & 0x1FU) != 0U))
+#error  SPI_BOUNCE_BUF_SIZE must be a multiple of 32 and at least 64 !!!
+#endif
+#if (SPI_FAST_XFER_MAX > 256U)
+#error  Too large fast path transfer size defined, maximum value of SPI_FAST_XFER_MAX is 256 !!!
+#endif
 
 #define DRIVER_DCACHE_MAINTENANCE              (SPI_DCACHE_MAINTENANCE)
 #if    (DRIVER_DCACHE_MAINTENANCE == 1U) && ((SPI_DCACHE_DATA_RX_ALIGNMENT == 0U) || (SPI_DCACHE_DATA_RX_SIZE == 0U))
@@ -256,6 +385,23 @@ Results of the **CMSIS-Driver Validation** for this driver can be found in the [
 #else
 #define DRIVER_DCACHE_TX_USER_GUARANTEED       (0U)
 #endif
+#if    (DRIVER_DCACHE_MAINTENANCE == 1U) && (DRIVER_DCACHE_RX_USER_GUARANTEED == 0U) && (SPI_BOUNCE_BUF_NUM > 0U)
+#define DRIVER_BOUNCE_BUF                      (1U)
+#else
+#define DRIVER_BOUNCE_BUF                      (0U)
+#endif
+
+#if (DRIVER_BOUNCE_BUF == 1U)
+#ifdef  SPI_BOUNCE_BUF_SECTION
+#define SPI_BOUNCE_BUF_ATTR                    __attribute__((section(SPI_BOUNCE_BUF_SECTION)))
+#else
+#define SPI_BOUNCE_BUF_ATTR
+#endif
+
+// Bounce buffer pool (shared by all instances, cache line aligned)
+static uint8_t  BounceBuf[SPI_BOUNCE_BUF_NUM][SPI_BOUNCE_BUF_SIZE] SPI_BOUNCE_BUF_ATTR __ALIGNED(32);
+static uint32_t BounceBufUsed;                  // Bit n set: bounce buffer n is in use
+#endif
 
 // Driver Version
 static const ARM_DRIVER_VERSION DriverVersion = { ARM_SPI_API_VERSION, ARM_SPI_DRV_VERSION };
@@ -281,6 +427,7 @@ static int32_t              SPI_Transfer         (const void *data_out, void *da
 static uint32_t             SPI_GetDataCount     (const SPI_RESOURCES *spi);
 static int32_t              SPI_Control          (uint32_t control, uint32_t arg, const SPI_RESOURCES *spi);
 static ARM_SPI_STATUS       SPI_GetStatus        (const SPI_RESOURCES *spi);
+static void                 SPI_TransferComplete (SPI_HandleTypeDef *hspi);
 
 // SPI1
 #ifdef MX_SPI1
@@ -549,31 +696,37 @@ __STATIC_INLINE uint32_t CalcNumOfBytes (DMA_HandleTypeDef *hdma, uint32_t num)
   \param[in]    data   Pointer to data for transmission
   \param[in]    num    Number of items for transmission
   \return       result of the determination
-                0 = DMA cannot be used for transmission
-                1 = DMA can be used for transmission
+                SPI_DMA_FLAG_NONE    = DMA cannot be used for transmission
+                SPI_DMA_FLAG_DMA     = DMA can be used for transmission
 */
 __STATIC_INLINE uint8_t CheckDmaForTx (DMA_HandleTypeDef *hdma, const void *data, uint32_t num) {
-  uint8_t dma_can_be_used = 0U;
+  uint8_t dma_can_be_used = SPI_DMA_FLAG_NONE;
 
   (void)hdma;
   (void)data;
   (void)num;
 
 #if (DRIVER_DCACHE_MAINTENANCE == 0U)           // If Data Cache maintenance is not enabled in the driver
-  dma_can_be_used = 1U;                         // can use DMA for Tx
+  dma_can_be_used = SPI_DMA_FLAG_DMA;           // can use DMA for Tx
 #else                                           // Else if Data Cache maintenance is enabled in the driver
   if (DCache_IsEnabled() == 0U) {               // If Data Cache is not enabled in the MCU
-    dma_can_be_used = 1U;                       // can use DMA for Tx
+    dma_can_be_used = SPI_DMA_FLAG_DMA;         // can use DMA for Tx
   } else {                                      // Else if Data Cache is enabled in the MCU
     uint32_t num_of_bytes = CalcNumOfBytes(hdma, num);
   #if (DRIVER_DCACHE_TX_USER_GUARANTEED == 1U)  // If the user guarantees that Data Cache operations can be performed on the buffer
-    dma_can_be_used = 1U;                       // can use DMA for Tx
+    dma_can_be_used = SPI_DMA_FLAG_DMA;         // can use DMA for Tx
     DCache_Flush(data, num_of_bytes);           // Flush the Data Cache to Memory
   #else                                         // Else if the user does not guarantee that Data Cache operations can be performed on the buffer
     if (DCache_IsAligned(data, num_of_bytes) != 0U) {   // If cache operations can be performed on the requested memory area
-      dma_can_be_used = 1U;                     // can use DMA for Tx
+      dma_can_be_used = SPI_DMA_FLAG_DMA;       // can use DMA for Tx
+      DCache_Flush(data, num_of_bytes);         // Flush the Data Cache to Memory
+    }
+    #if (DRIVER_BOUNCE_BUF == 1U)               // If bounce buffers are used for unaligned data
+    else if ((((uint32_t)data) & (CalcNumOfBytes(hdma, 1U) - 1U)) == 0U) {  // If data is aligned to the item size
+      dma_can_be_used = SPI_DMA_FLAG_DMA;       // can use DMA for Tx, flushing shared cache lines does not discard data
       DCache_Flush(data, num_of_bytes);         // Flush the Data Cache to Memory
     }
+    #endif
   #endif
   }
 #endif
@@ -587,29 +740,29 @@ __STATIC_INLINE uint8_t CheckDmaForTx (DMA_HandleTypeDef *hdma, const void *data
   \param[in]    data   Pointer to where data should be received
   \param[in]    num    Number of items expected in reception
   \return       result of the determination
-                0 = DMA cannot be used for reception
-                1 = DMA can be used for reception
-                3 = DMA can be used for reception but Data Cache needs to be Refreshed after reception
+                SPI_DMA_FLAG_NONE    = DMA cannot be used for reception
+                SPI_DMA_FLAG_DMA     = DMA can be used for reception
+                SPI_DMA_FLAG_REFRESH = DMA can be used for reception but Data Cache needs to be Refreshed after reception
 */
 __STATIC_INLINE uint8_t CheckDmaForRx (DMA_HandleTypeDef *hdma, const void *data, uint32_t num) {
-  uint8_t dma_can_be_used = 0U;
+  uint8_t dma_can_be_used = SPI_DMA_FLAG_NONE;
 
   (void)hdma;
   (void)data;
   (void)num;
 
 #if (DRIVER_DCACHE_MAINTENANCE == 0U)           // If Data Cache maintenance is not enabled in the driver
-  dma_can_be_used = 1U;                         // can use DMA for Rx
+  dma_can_be_used = SPI_DMA_FLAG_DMA;           // can use DMA for Rx
 #else                                           // Else if Data Cache maintenance is enabled in the driver
   if (DCache_IsEnabled() == 0U) {               // If Data Cache is not enabled in the MCU
-    dma_can_be_used = 1U;                       // can use DMA for Rx
+    dma_can_be_used = SPI_DMA_FLAG_DMA;         // can use DMA for Rx
   } else {                                      // Else if Data Cache is enabled in the MCU
   #if (DRIVER_DCACHE_RX_USER_GUARANTEED == 1U)  // If the user guarantees that Data Cache operations can be performed on the buffer
-    dma_can_be_used = 3U;                       // can use DMA for Rx but cache needs to be Refreshed after reception
+    dma_can_be_used = SPI_DMA_FLAG_REFRESH;     // can use DMA for Rx but cache needs to be Refreshed after reception
   #else                                         // Else if the user does not guarantee that Data Cache operations can be performed on the buffer
     uint32_t num_of_bytes = CalcNumOfBytes(hdma, num);
     if (DCache_IsAligned(data, num_of_bytes) != 0U) {   // If cache operations can be performed on the requested memory area
-      dma_can_be_used = 3U;                     // can use DMA for Rx but cache needs to be Refreshed after reception
+      dma_can_be_used = SPI_DMA_FLAG_REFRESH;   // can use DMA for Rx but cache needs to be Refreshed after reception
     }
   #endif
   }
@@ -644,6 +797,865 @@ __STATIC_INLINE void RefreshDCacheAfterDmaRx (DMA_HandleTypeDef *hdma, void *dat
 #endif
 }
 
+/**
+  Allocate a bounce buffer from the pool.
+  \return       pointer to bounce buffer, or NULL if all bounce buffers are in use
+*/
+__STATIC_INLINE uint8_t *BounceBufAlloc (void) {
+  uint8_t *buf = NULL;
+#if (DRIVER_BOUNCE_BUF == 1U)
+  uint32_t primask, n;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  for (n = 0U; n < SPI_BOUNCE_BUF_NUM; n++) {
+    if ((BounceBufUsed & (1UL << n)) == 0U) {
+      BounceBufUsed |= (1UL << n);
+      buf = BounceBuf[n];
+      break;
+    }
+  }
+  __set_PRIMASK(primask);
+#endif
+
+  return buf;
+}
+
+/**
+  Return the bounce buffer of a transfer to the pool.
+  \param[in]    spi    Pointer to SPI resources
+*/
+__STATIC_INLINE void BounceBufFree (const SPI_RESOURCES *spi) {
+
+  (void)spi;
+
+#if (DRIVER_BOUNCE_BUF == 1U)
+  uint32_t primask, n;
+
+  if (spi->xfer->bounce != NULL) {
+    n = (uint32_t)(spi->xfer->bounce - &BounceBuf[0][0]) / SPI_BOUNCE_BUF_SIZE;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    BounceBufUsed &= ~(1UL << n);
+    __set_PRIMASK(primask);
+    spi->xfer->bounce = NULL;
+  }
+#endif
+}
+
+/**
+  Check if DMA can be used for reception through a bounce buffer, and split the transfer.
+  Items that share a Data Cache line with other data (head and tail) are received
+  into the bounce buffer, the cache line aligned middle part directly.
+  \param[in]    spi       Pointer to SPI resources
+  \param[in]    data      Pointer to where data should be received
+  \param[in]    num       Number of items to transfer
+  \return       result of the determination
+                SPI_DMA_FLAG_NONE    = DMA cannot be used for reception
+                SPI_DMA_FLAG_BOUNCE  = DMA can be used for reception with head and tail through bounce buffer
+*/
+static uint8_t CheckBounceForRx (const SPI_RESOURCES *spi, void *data, uint32_t num) {
+  uint8_t dma_can_be_used = SPI_DMA_FLAG_NONE;
+
+  (void)spi;
+  (void)data;
+  (void)num;
+
+#if (DRIVER_BOUNCE_BUF == 1U)
+  uint32_t addr, num_of_bytes, head, tail, size;
+  uint8_t *buf;
+
+  addr         = (uint32_t)data;
+  size         = CalcNumOfBytes(spi->h->hdmarx, 1U);
+  num_of_bytes = CalcNumOfBytes(spi->h->hdmarx, num);
+
+  if ((addr & (size - 1U)) == 0U) {             // If data is aligned to the item size
+    head = (32U - (addr & 0x1FU)) & 0x1FU;      // Bytes up to the first cache line boundary
+    if (head >= num_of_bytes) {
+      head = num_of_bytes;
+      tail = 0U;
+    } else {
+      tail = (addr + num_of_bytes) & 0x1FU;     // Bytes after the last cache line boundary
+    }
+
+    if ((head + tail == num_of_bytes)                ||
+        (spi->h->Init.Mode != SPI_MODE_MASTER)       ||
+        (spi->h->Init.NSS  == SPI_NSS_HARD_OUTPUT)) {
+      // No aligned middle part, or consecutive DMA transfers are not possible:
+      // receive everything into the bounce buffer if it fits
+      if ((num_of_bytes <= SPI_BOUNCE_BUF_SIZE) && (num <= SPI_SEGMENT_MAX)) {
+        head = num_of_bytes;
+        tail = 0U;
+      } else {
+        size = 0U;
+      }
+    }
+
+    if (size != 0U) {
+      buf = BounceBufAlloc();
+      if (buf != NULL) {
+        spi->xfer->bounce     = buf;
+        spi->xfer->seg_num[0] =  head / size;
+        spi->xfer->seg_num[1] = (num_of_bytes - head - tail) / size;
+        spi->xfer->seg_num[2] =  tail / size;
+        dma_can_be_used = SPI_DMA_FLAG_BOUNCE;
+      } else {
+        spi->xfer->stat.pool_empty++;
+      }
+    }
+  }
+#endif
+
+  return dma_can_be_used;
+}
+
+/**
+  Get part of a bounce buffered transfer the active segment belongs to.
+  \param[in]    xfer   Pointer to transfer information
+  \return       part (0 = head, 1 = middle, 2 = tail)
+*/
+__STATIC_INLINE uint32_t BouncePart (const SPI_TRANSFER_INFO *xfer) {
+  uint32_t part = 2U;
+
+  if (xfer->seg_cnt < xfer->seg_num[0]) {
+    part = 0U;
+  } else if (xfer->seg_cnt < (xfer->seg_num[0] + xfer->seg_num[1])) {
+    part = 1U;
+  }
+
+  return part;
+}
+
+/**
+  Configure DMA data alignment for the data item size.
+  \param[in]    spi        Pointer to SPI resources
+  \param[in]    data_size  Data item size in bytes (1, 2 or 4)
+*/
+static void DmaSetDataSize (const SPI_RESOURCES *spi, uint32_t data_size) {
+
+  (void)spi;
+  (void)data_size;
+
+#ifdef __SPI_DMA_RX
+  if (((spi->dma_use & SPI_DMA_USE_RX) != 0U) && (spi->h->hdmarx != NULL)) {
+    if (data_size == 4U) {
+      spi->h->hdmarx->Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+      spi->h->hdmarx->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    } else if (data_size == 2U) {
+      spi->h->hdmarx->Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+      spi->h->hdmarx->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    } else {
+      spi->h->hdmarx->Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+      spi->h->hdmarx->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    }
+    HAL_DMA_Init(spi->h->hdmarx);
+  }
+#endif
+
+#ifdef __SPI_DMA_TX
+  if (((spi->dma_use & SPI_DMA_USE_TX) != 0U) && (spi->h->hdmatx != NULL)) {
+    if (data_size == 4U) {
+      spi->h->hdmatx->Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+      spi->h->hdmatx->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    } else if (data_size == 2U) {
+      spi->h->hdmatx->Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+      spi->h->hdmatx->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    } else {
+      spi->h->hdmatx->Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+      spi->h->hdmatx->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    }
+    HAL_DMA_Init(spi->h->hdmatx);
+  }
+#endif
+}
+
+/**
+  Calculate CFG1 and CFG2 register values of a scheduler device.
+  \param[in]    spi    Pointer to SPI resources
+  \param[in]    dev    Pointer to scheduler device
+  \return       \ref execution_status
+*/
+static int32_t SchedDevicePrepare (const SPI_RESOURCES *spi, SPI_SCHED_DEVICE *dev) {
+  uint32_t cfg1, cfg2, bits, pclk, val;
+
+  // Frame format
+  switch (dev->mode & ARM_SPI_FRAME_FORMAT_Msk) {
+    case ARM_SPI_CPOL0_CPHA0: cfg2 = 0U;                                    break;
+    case ARM_SPI_CPOL0_CPHA1: cfg2 = SPI_PHASE_2EDGE;                       break;
+    case ARM_SPI_CPOL1_CPHA0: cfg2 = SPI_POLARITY_HIGH;                     break;
+    case ARM_SPI_CPOL1_CPHA1: cfg2 = SPI_POLARITY_HIGH | SPI_PHASE_2EDGE;   break;
+    case ARM_SPI_TI_SSI:      cfg2 = SPI_TIMODE_ENABLE;                     break;
+    default: return ARM_SPI_ERROR_FRAME_FORMAT;
+  }
+
+  // Data bits
+  bits = (dev->mode & ARM_SPI_DATA_BITS_Msk) >> ARM_SPI_DATA_BITS_Pos;
+  if ((bits < 4U) || (bits > 32U)) {
+    return ARM_SPI_ERROR_DATA_BITS;
+  }
+  cfg1 = _VAL2FLD(SPI_CFG1_DSIZE, bits - 1U);
+
+  // Bit order
+  if ((dev->mode & ARM_SPI_BIT_ORDER_Msk) == ARM_SPI_LSB_MSB) {
+    cfg2 |= SPI_FIRSTBIT_LSB;
+  }
+
+  // Slave select
+  if ((dev->ss_idle > 15U) || (dev->data_idle > 15U)) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  switch (dev->ss) {
+    case SPI_SCHED_SS_NONE:
+      cfg2 |= SPI_NSS_SOFT;
+      break;
+
+    case SPI_SCHED_SS_GPIO:
+      if (dev->ss_port == NULL) {
+        return ARM_SPI_ERROR_SS_MODE;
+      }
+      cfg2 |= SPI_NSS_SOFT;
+      break;
+
+    case SPI_SCHED_SS_HW:
+    case SPI_SCHED_SS_HW_PULSE:
+      // NSS pin must be configured as SPI NSS output (ARM_SPI_SS_MASTER_HW_OUTPUT)
+      if ((spi->info->mode & ARM_SPI_SS_MASTER_MODE_Msk) != ARM_SPI_SS_MASTER_HW_OUTPUT) {
+        return ARM_SPI_ERROR_SS_MODE;
+      }
+      cfg2 |= SPI_NSS_HARD_OUTPUT | _VAL2FLD(SPI_CFG2_MSSI, dev->ss_idle);
+      if (dev->ss == SPI_SCHED_SS_HW_PULSE) {
+        cfg2 |= SPI_NSS_PULSE_ENABLE;
+      }
+      break;
+
+    default:
+      return ARM_SPI_ERROR_SS_MODE;
+  }
+  cfg2 |= _VAL2FLD(SPI_CFG2_MIDI, dev->data_idle);
+
+  // Bus speed
+  pclk = SPI_GetClk(spi);
+  for (val = 0U; val < 8U; val++) {
+    if (dev->bus_speed >= (pclk >> (val + 1U))) { break; }
+  }
+  if ((val == 8U) || (dev->bus_speed < (pclk >> (val + 1U)))) {
+    // Requested Bus Speed can not be configured
+    return ARM_DRIVER_ERROR;
+  }
+  cfg1 |= _VAL2FLD(SPI_CFG1_MBR, val);
+
+  dev->cfg1 = cfg1;
+  dev->cfg2 = cfg2;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  Configure SPI for a scheduler device.
+  Only registers that differ from the current configuration are written (SPI is disabled
+  between transfers). DMA is reconfigured only if the data item size changes.
+  \param[in]    spi    Pointer to SPI resources
+  \param[in]    dev    Pointer to scheduler device
+*/
+static void SchedDeviceConfig (const SPI_RESOURCES *spi, const SPI_SCHED_DEVICE *dev) {
+  SPI_TypeDef *reg = spi->reg;
+  uint32_t     cfg, bits, size;
+
+  cfg = (reg->CFG1 & ~SPI_SCHED_CFG1_Msk) | dev->cfg1;
+  if (cfg != reg->CFG1) {
+    reg->CFG1 = cfg;
+  }
+  cfg = (reg->CFG2 & ~SPI_SCHED_CFG2_Msk) | dev->cfg2;
+  if (cfg != reg->CFG2) {
+    reg->CFG2 = cfg;
+  }
+  if (((dev->cfg2 & SPI_CFG2_SSM) != 0U) && ((reg->CR1 & SPI_CR1_SSI) == 0U)) {
+    reg->CR1 |= SPI_CR1_SSI;                    // Software NSS: keep internal slave select inactive
+  }
+
+  // Keep HAL handle consistent with the registers (used by HAL transfer functions)
+  spi->h->Init.DataSize                = dev->cfg1 & SPI_CFG1_DSIZE;
+  spi->h->Init.BaudRatePrescaler       = dev->cfg1 & SPI_CFG1_MBR;
+  spi->h->Init.CLKPolarity             = dev->cfg2 & SPI_CFG2_CPOL;
+  spi->h->Init.CLKPhase                = dev->cfg2 & SPI_CFG2_CPHA;
+  spi->h->Init.FirstBit                = dev->cfg2 & SPI_CFG2_LSBFRST;
+  spi->h->Init.TIMode                  = dev->cfg2 & SPI_CFG2_SP;
+  spi->h->Init.NSS                     = dev->cfg2 & (SPI_CFG2_SSM | SPI_CFG2_SSOE);
+  spi->h->Init.NSSPMode                = dev->cfg2 & SPI_CFG2_SSOM;
+  spi->h->Init.MasterSSIdleness        = dev->cfg2 & SPI_CFG2_MSSI;
+  spi->h->Init.MasterInterDataIdleness = dev->cfg2 & SPI_CFG2_MIDI;
+
+  bits = _FLD2VAL(SPI_CFG1_DSIZE, dev->cfg1) + 1U;
+  if      (bits > 16U) { size = 4U; }
+  else if (bits > 8U)  { size = 2U; }
+  else                 { size = 1U; }
+  if (size != spi->xfer->dataSize) {
+    spi->xfer->dataSize = size;
+    DmaSetDataSize(spi, size);
+  }
+}
+
+/**
+  Start the next queued scheduled transaction if the bus is idle.
+  Transactions that can not be started are completed with ARM_SPI_EVENT_DATA_LOST.
+  \param[in]    spi    Pointer to SPI resources
+*/
+static void SchedNext (const SPI_RESOURCES *spi) {
+  SPI_TRANSFER_INFO *xfer = spi->xfer;
+  SPI_SCHED_XFER    *t;
+  uint32_t           primask;
+  int32_t            status;
+
+  while (xfer->sched_head != NULL) {
+    t = NULL;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if ((xfer->sched_cur == NULL) && (xfer->sched_head != NULL) &&
+        (HAL_SPI_GetState(spi->h) == HAL_SPI_STATE_READY)) {
+      t = xfer->sched_head;
+      xfer->sched_head = t->next;
+      if (xfer->sched_head == NULL) {
+        xfer->sched_tail = NULL;
+      }
+      xfer->sched_cur = t;
+    }
+    __set_PRIMASK(primask);
+
+    if (t == NULL) {
+      break;                                    // Bus is busy or queue is empty
+    }
+
+    SchedDeviceConfig(spi, t->dev);
+    if (t->dev->ss == SPI_SCHED_SS_GPIO) {
+      HAL_GPIO_WritePin(t->dev->ss_port, t->dev->ss_pin, GPIO_PIN_RESET);
+    }
+    if (t->data_out == NULL) {
+      status = SPI_Receive(t->data_in, t->num, spi);
+    } else if (t->data_in == NULL) {
+      status = SPI_Send(t->data_out, t->num, spi);
+    } else {
+      status = SPI_Transfer(t->data_out, t->data_in, t->num, spi);
+    }
+    if (status == ARM_DRIVER_OK) {
+      break;
+    }
+
+    // Transaction could not be started
+    if (t->dev->ss == SPI_SCHED_SS_GPIO) {
+      HAL_GPIO_WritePin(t->dev->ss_port, t->dev->ss_pin, GPIO_PIN_SET);
+    }
+    xfer->sched_cur = NULL;
+    if (t->cb_event != NULL) {
+      t->cb_event(ARM_SPI_EVENT_DATA_LOST, t);
+    }
+  }
+}
+
+/**
+  Complete the active scheduled transaction and start the next one.
+  The next transaction is started before the completion callback is called.
+  \param[in]    spi    Pointer to SPI resources
+  \param[in]    event  Completion event (ARM_SPI_EVENT_xxx)
+*/
+static void SchedDone (const SPI_RESOURCES *spi, uint32_t event) {
+  SPI_SCHED_XFER *t = spi->xfer->sched_cur;
+
+  if (t->dev->ss == SPI_SCHED_SS_GPIO) {
+    HAL_GPIO_WritePin(t->dev->ss_port, t->dev->ss_pin, GPIO_PIN_SET);
+  }
+  spi->xfer->sched_cur = NULL;
+
+  SchedNext(spi);
+
+  if (t->cb_event != NULL) {
+    t->cb_event(event, t);
+  }
+}
+
+/**
+  Queue a scheduled transaction.
+  \param[in]    spi    Pointer to SPI resources
+  \param[in]    t      Pointer to transaction
+  \return       \ref execution_status
+*/
+static int32_t SchedSubmit (const SPI_RESOURCES *spi, SPI_SCHED_XFER *t) {
+  SPI_TRANSFER_INFO *xfer = spi->xfer;
+  uint32_t           primask;
+  int32_t            status;
+
+  if ((t == NULL) || (t->dev == NULL) || (t->num == 0U) ||
+      ((t->data_out == NULL) && (t->data_in == NULL))) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  // Scheduler requires Full-Duplex Master mode
+  if (((spi->info->state & SPI_CONFIGURED) == 0U) ||
+      ((spi->info->mode & ARM_SPI_CONTROL_Msk) != ARM_SPI_MODE_MASTER)) {
+    return ARM_DRIVER_ERROR;
+  }
+
+  status = SchedDevicePrepare(spi, t->dev);
+  if (status != ARM_DRIVER_OK) {
+    return status;
+  }
+
+  t->next = NULL;
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if (xfer->sched_tail == NULL) {
+    xfer->sched_head = t;
+  } else {
+    xfer->sched_tail->next = t;
+  }
+  xfer->sched_tail = t;
+  __set_PRIMASK(primask);
+
+  SchedNext(spi);
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  Discard the active and all queued scheduled transactions.
+  \param[in]    spi    Pointer to SPI resources
+*/
+static void SchedFlush (const SPI_RESOURCES *spi) {
+  SPI_SCHED_XFER *t;
+  uint32_t        primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  t = spi->xfer->sched_cur;
+  spi->xfer->sched_cur  = NULL;
+  spi->xfer->sched_head = NULL;
+  spi->xfer->sched_tail = NULL;
+  __set_PRIMASK(primask);
+
+  if ((t != NULL) && (t->dev->ss == SPI_SCHED_SS_GPIO)) {
+    HAL_GPIO_WritePin(t->dev->ss_port, t->dev->ss_pin, GPIO_PIN_SET);
+  }
+}
+
+/**
+  Get FIFO size of SPI instance.
+  \param[in]    spi    Pointer to SPI resources
+  \return       FIFO size in bytes
+*/
+__STATIC_INLINE uint32_t FifoSize (const SPI_RESOURCES *spi) {
+
+  if (IS_SPI_HIGHEND_INSTANCE(spi->reg)) {
+    return SPI_HIGHEND_FIFO_SIZE;
+  }
+  return SPI_LOWEND_FIFO_SIZE;
+}
+
+/**
+  Check if a transfer is performed by the FIFO packed fast path.
+  \param[in]    spi    Pointer to SPI resources
+  \param[in]    num    Number of data items
+  \return       fast path
+                0 = not used
+                1 = interrupt (RXP interrupt per packet, transmit FIFO is refilled)
+                2 = polled (completed in the calling function)
+*/
+__STATIC_INLINE uint32_t FastCheck (const SPI_RESOURCES *spi, uint32_t num) {
+  uint32_t fast = 0U;
+#if (SPI_FAST_XFER_MAX > 0U)
+  uint32_t num_of_bytes = num * spi->xfer->dataSize;
+
+  if ((spi->info->path == SPI_PATH_AUTO) &&
+      (spi->h->Init.Mode == SPI_MODE_MASTER) && (spi->h->Init.Direction == SPI_DIRECTION_2LINES) &&
+      (num <= SPI_FAST_XFER_MAX) && (num_of_bytes <= SPI_FAST_XFER_MAX)) {
+#if (SPI_FAST_POLL == 1U)
+    if (spi->xfer->sched_cur == NULL) {         // Scheduled transactions are chained from interrupt
+      fast = 2U;
+    } else
+#endif
+    {
+      fast = 1U;
+    }
+  }
+#else
+  (void)spi;
+  (void)num;
+#endif
+
+  return fast;
+}
+
+/**
+  Get packet size of a fast path transfer in interrupt mode (data received per RXP interrupt).
+  Transfers that fit into the FIFO are one packet, longer transfers are received in packets
+  of half the FIFO size while the transmit FIFO is refilled.
+  \param[in]    spi    Pointer to SPI resources
+  \return       packet size in bytes
+*/
+__STATIC_INLINE uint32_t FastPacket (const SPI_RESOURCES *spi) {
+  uint32_t num_of_bytes = spi->xfer->num * spi->xfer->dataSize;
+
+  if ((spi->xfer->num <= 16U) && (num_of_bytes <= FifoSize(spi))) {
+    return num_of_bytes;
+  }
+  return (FifoSize(spi) / 2U);
+}
+
+/**
+  Write one FIFO access of transmit data (32-bit access packs 8-bit and 16-bit frames).
+  \param[in]    reg           Pointer to SPI peripheral
+  \param[in]    data          Pointer to transmit data
+  \param[in]    num_of_bytes  Number of bytes remaining
+  \param[in]    data_size     Data item size in bytes
+  \return       number of bytes written
+*/
+__STATIC_INLINE uint32_t FifoWrite (SPI_TypeDef *reg, const uint8_t *data, uint32_t num_of_bytes, uint32_t data_size) {
+
+  if (num_of_bytes >= 4U) {
+    *((__IO uint32_t *)&reg->TXDR) = __UNALIGNED_UINT32_READ(data);
+    return 4U;
+  }
+  if (data_size == 2U) {
+    *((__IO uint16_t *)&reg->TXDR) = __UNALIGNED_UINT16_READ(data);
+    return 2U;
+  }
+  *((__IO uint8_t *)&reg->TXDR) = *data;
+  return 1U;
+}
+
+/**
+  Read one FIFO access of received data (32-bit access unpacks 8-bit and 16-bit frames).
+  \param[in]    reg           Pointer to SPI peripheral
+  \param[out]   data          Pointer to receive buffer (NULL: data is discarded)
+  \param[in]    num_of_bytes  Number of bytes remaining
+  \param[in]    data_size     Data item size in bytes
+  \return       number of bytes read
+*/
+__STATIC_INLINE uint32_t FifoRead (SPI_TypeDef *reg, uint8_t *data, uint32_t num_of_bytes, uint32_t data_size) {
+  uint32_t val;
+
+  if (num_of_bytes >= 4U) {
+    val = *((__IO uint32_t *)&reg->RXDR);
+    if (data != NULL) { __UNALIGNED_UINT32_WRITE(data, val); }
+    return 4U;
+  }
+  if (data_size == 2U) {
+    val = *((__IO uint16_t *)&reg->RXDR);
+    if (data != NULL) { __UNALIGNED_UINT16_WRITE(data, (uint16_t)val); }
+    return 2U;
+  }
+  val = *((__IO uint8_t *)&reg->RXDR);
+  if (data != NULL) { *data = (uint8_t)val; }
+  return 1U;
+}
+
+/**
+  Close a fast path transfer: disable SPI and restore FIFO threshold of the HAL configuration.
+  \param[in]    spi    Pointer to SPI resources
+*/
+static void FastClose (const SPI_RESOURCES *spi) {
+  SPI_TypeDef *reg = spi->reg;
+
+  reg->IER &= ~(SPI_IER_RXPIE | SPI_IER_EOTIE | SPI_IER_OVRIE | SPI_IER_MODFIE);
+  reg->IFCR = SPI_IFCR_EOTC | SPI_IFCR_TXTFC;
+  __HAL_SPI_DISABLE(spi->h);
+  MODIFY_REG(reg->CFG1, SPI_CFG1_FTHLV, spi->h->Init.FifoThreshold);
+  spi->h->State = HAL_SPI_STATE_READY;
+}
+
+/**
+  Fast path receive interrupt (called by HAL_SPI_IRQHandler when a packet is received).
+  Read the received packets and refill the transmit FIFO (transmit data leads received data
+  by at most the FIFO size). After the last packet the transfer is completed on end of transfer:
+  immediately if it already ended, otherwise by the EOT interrupt handled by HAL_SPI_IRQHandler.
+  \param[in]    hspi   Pointer to SPI handle
+*/
+static void FastRxISR (SPI_HandleTypeDef *hspi) {
+  const SPI_RESOURCES *spi  = SPI_Resources(hspi);
+  SPI_TypeDef         *reg  = spi->reg;
+  SPI_TRANSFER_INFO   *xfer = spi->xfer;
+  uint32_t             num_of_bytes, packet, fifo, rx_cnt, end, n;
+
+  num_of_bytes = xfer->num * xfer->dataSize;
+  packet       = FastPacket(spi);
+  fifo         = FifoSize(spi);
+  rx_cnt       = num_of_bytes - (hspi->RxXferCount * xfer->dataSize);
+
+  // Received packets
+  while (((num_of_bytes - rx_cnt) >= packet) && ((reg->SR & SPI_SR_RXP) != 0U)) {
+    for (end = rx_cnt + packet; rx_cnt < end; ) {
+      rx_cnt += FifoRead(reg, (xfer->rx_data != NULL) ? &xfer->rx_data[rx_cnt] : NULL, end - rx_cnt, xfer->dataSize);
+    }
+  }
+  hspi->RxXferCount = (uint16_t)((num_of_bytes - rx_cnt) / xfer->dataSize);
+
+  // Refill transmit FIFO
+  while ((xfer->fast_tx < num_of_bytes) && (((xfer->fast_tx - rx_cnt) + 4U) <= fifo)) {
+    xfer->fast_tx += FifoWrite(reg, &xfer->tx_data[xfer->fast_tx], num_of_bytes - xfer->fast_tx, xfer->dataSize);
+  }
+
+  if ((num_of_bytes - rx_cnt) >= packet) {
+    return;                                     // Wait for next packet
+  }
+
+  reg->IER &= ~SPI_IER_RXPIE;
+  if (rx_cnt < num_of_bytes) {
+    // Tail frames (less than a packet) are in the FIFO at end of transfer
+    if ((reg->SR & SPI_SR_EOT) == 0U) {
+      // HAL_SPI_IRQHandler reads the tail frames, closes the transfer and calls HAL_SPI_TxRxCpltCallback
+      hspi->pRxBuffPtr = (xfer->rx_data != NULL) ? &xfer->rx_data[rx_cnt] : (uint8_t *)xfer->fast_dummy;
+      reg->IER |= SPI_IER_EOTIE;
+      return;
+    }
+    while (rx_cnt < num_of_bytes) {
+      rx_cnt += FifoRead(reg, (xfer->rx_data != NULL) ? &xfer->rx_data[rx_cnt] : NULL, num_of_bytes - rx_cnt, xfer->dataSize);
+    }
+    hspi->RxXferCount = 0U;
+  } else {
+    // All data is received: end of transfer follows within a few SPI kernel clock cycles
+    for (n = 0U; (n < SPI_FAST_EOT_TIMEOUT) && ((reg->SR & SPI_SR_EOT) == 0U); n++);
+  }
+
+  SPI_TransferComplete(hspi);
+}
+
+/**
+  Perform a fast path transfer by polling (transmit data leads received data by at most the FIFO size).
+  A mode fault or overrun stops the transfer and is reported by the error callback.
+  \param[in]    spi    Pointer to SPI resources
+*/
+static void FastPoll (const SPI_RESOURCES *spi) {
+  SPI_TypeDef       *reg  = spi->reg;
+  SPI_TRANSFER_INFO *xfer = spi->xfer;
+  uint32_t           num_of_bytes, fifo, tx_cnt, rx_cnt, sr, n;
+
+  num_of_bytes = xfer->num * xfer->dataSize;
+  fifo         = FifoSize(spi);
+  tx_cnt       = 0U;
+  rx_cnt       = 0U;
+
+  while (rx_cnt < num_of_bytes) {
+    sr = reg->SR;
+    if ((sr & (SPI_SR_MODF | SPI_SR_OVR)) != 0U) {
+      if ((sr & SPI_SR_MODF) != 0U) { spi->h->ErrorCode |= HAL_SPI_ERROR_MODF; }
+      if ((sr & SPI_SR_OVR)  != 0U) { spi->h->ErrorCode |= HAL_SPI_ERROR_OVR;  }
+      spi->h->RxXferCount = (uint16_t)((num_of_bytes - rx_cnt) / xfer->dataSize);
+      reg->IFCR = SPI_IFCR_MODFC | SPI_IFCR_OVRC;
+      FastClose(spi);
+      HAL_SPI_ErrorCallback(spi->h);
+      return;
+    }
+    if ((tx_cnt < num_of_bytes) && ((sr & SPI_SR_TXP) != 0U) && (((tx_cnt - rx_cnt) + 4U) <= fifo)) {
+      tx_cnt += FifoWrite(reg, &xfer->tx_data[tx_cnt], num_of_bytes - tx_cnt, xfer->dataSize);
+    }
+    if ((num_of_bytes - rx_cnt) >= 4U) {
+      if ((sr & SPI_SR_RXP) != 0U) {            // Packet is one 32-bit FIFO word
+        rx_cnt += FifoRead(reg, (xfer->rx_data != NULL) ? &xfer->rx_data[rx_cnt] : NULL, num_of_bytes - rx_cnt, xfer->dataSize);
+      }
+    } else if ((sr & (SPI_SR_RXPLVL | SPI_SR_RXWNE)) != 0U) {
+      // Tail frames (less than a packet)
+      rx_cnt += FifoRead(reg, (xfer->rx_data != NULL) ? &xfer->rx_data[rx_cnt] : NULL, num_of_bytes - rx_cnt, xfer->dataSize);
+    }
+  }
+  spi->h->RxXferCount = 0U;
+
+  // All data is received: end of transfer follows within a few SPI kernel clock cycles
+  for (n = 0U; (n < SPI_FAST_EOT_TIMEOUT) && ((reg->SR & SPI_SR_EOT) == 0U); n++);
+
+  SPI_TransferComplete(spi->h);
+}
+
+/**
+  Start a fast path transfer, bypassing the HAL transfer functions.
+  \param[in]    spi    Pointer to SPI resources
+  \return       \ref HAL_StatusTypeDef
+*/
+static HAL_StatusTypeDef FastStart (const SPI_RESOURCES *spi) {
+  SPI_TypeDef       *reg  = spi->reg;
+  SPI_TRANSFER_INFO *xfer = spi->xfer;
+  uint32_t           num_of_bytes, packet, fifo, cnt;
+
+  num_of_bytes  = xfer->num * xfer->dataSize;
+  xfer->seg_len = xfer->num;
+
+  // HAL handle: busy state and data count (GetStatus, GetDataCount, Abort)
+  spi->h->ErrorCode   = HAL_SPI_ERROR_NONE;
+  spi->h->State       = HAL_SPI_STATE_BUSY_TX_RX;
+  spi->h->TxXferSize  = 0U;
+  spi->h->TxXferCount = 0U;
+  spi->h->RxXferSize  = (uint16_t)xfer->num;
+  spi->h->RxXferCount = (uint16_t)xfer->num;
+
+  if (xfer->fast == 1U) {
+    packet = FastPacket(spi) / xfer->dataSize;
+  } else {
+    packet = 4U / xfer->dataSize;               // Packet is one 32-bit FIFO word
+  }
+  MODIFY_REG(reg->CFG1, SPI_CFG1_FTHLV, (packet - 1U) << SPI_CFG1_FTHLV_Pos);
+  MODIFY_REG(reg->CR2,  SPI_CR2_TSIZE,  xfer->num);
+  __HAL_SPI_ENABLE(spi->h);
+
+  if (xfer->fast == 1U) {
+    // Preload transmit data up to the FIFO size, packets are received by the RXP interrupt
+    fifo = FifoSize(spi);
+    for (cnt = 0U; (cnt < num_of_bytes) && (cnt < fifo); ) {
+      cnt += FifoWrite(reg, &xfer->tx_data[cnt], num_of_bytes - cnt, xfer->dataSize);
+    }
+    xfer->fast_tx = cnt;
+    spi->h->RxISR = FastRxISR;
+    reg->CR1 |= SPI_CR1_CSTART;
+    reg->IER |= SPI_IER_RXPIE | SPI_IER_OVRIE | SPI_IER_MODFIE;
+  } else {
+    reg->CR1 |= SPI_CR1_CSTART;
+    FastPoll(spi);
+  }
+
+  return HAL_OK;
+}
+
+/**
+  Start the next segment of a transfer.
+  Transfers are split into segments of at most SPI_SEGMENT_MAX items (HAL transfer
+  size is 16-bit) and, for bounce buffered transfers, at the head and tail boundaries.
+  \param[in]    spi    Pointer to SPI resources
+  \return       \ref HAL_StatusTypeDef
+*/
+static HAL_StatusTypeDef SegmentStart (const SPI_RESOURCES *spi) {
+  SPI_TRANSFER_INFO *xfer = spi->xfer;
+  HAL_StatusTypeDef  stat;
+  uint32_t           offset, end;
+  uint8_t           *tx, *rx;
+
+  if (xfer->fast != 0U) {
+    return FastStart(spi);
+  }
+
+  end = xfer->num;
+  if (xfer->dma_flag == SPI_DMA_FLAG_BOUNCE) {
+    // Segments do not cross head, middle and tail boundaries
+    switch (BouncePart(xfer)) {
+      case 0U:  end = xfer->seg_num[0];                     break;
+      case 1U:  end = xfer->seg_num[0] + xfer->seg_num[1];  break;
+      default:                                              break;
+    }
+  }
+  xfer->seg_len = end - xfer->seg_cnt;
+  if (xfer->seg_len > SPI_SEGMENT_MAX) {
+    xfer->seg_len = SPI_SEGMENT_MAX;
+  }
+
+  offset = xfer->seg_cnt * xfer->dataSize;
+  tx     = (uint8_t *)(uint32_t)&xfer->tx_data[offset];
+  rx     = NULL;
+  if (xfer->rx_data != NULL) {
+    rx = &xfer->rx_data[offset];
+  }
+
+  if (xfer->dma_flag == SPI_DMA_FLAG_BOUNCE) {
+    switch (BouncePart(xfer)) {
+      case 0U:                                  // Head: into bounce buffer
+        rx = xfer->bounce;
+        break;
+      case 1U:                                  // Middle: directly, discard cache lines before reception
+        DCache_Refresh(rx, xfer->seg_len * xfer->dataSize);
+        break;
+      default:                                  // Tail: into second cache line of bounce buffer
+        rx = &xfer->bounce[32];
+        break;
+    }
+  }
+
+  if (rx == NULL) {
+    if (xfer->dma_flag != SPI_DMA_FLAG_NONE) {
+      // DMA mode
+      stat = HAL_SPI_Transmit_DMA(spi->h, tx, (uint16_t)xfer->seg_len);
+    } else {
+      // Interrupt mode
+      stat = HAL_SPI_Transmit_IT (spi->h, tx, (uint16_t)xfer->seg_len);
+    }
+  } else {
+    if (xfer->dma_flag != SPI_DMA_FLAG_NONE) {
+      // DMA mode
+      stat = HAL_SPI_TransmitReceive_DMA(spi->h, tx, rx, (uint16_t)xfer->seg_len);
+    } else {
+      // Interrupt mode
+      stat = HAL_SPI_TransmitReceive_IT (spi->h, tx, rx, (uint16_t)xfer->seg_len);
+    }
+  }
+
+  return stat;
+}
+
+/**
+  Complete the active segment of a transfer and start the next segment.
+  \param[in]    spi    Pointer to SPI resources
+  \return       result
+                0 = transfer is completed
+                1 = transfer is not completed (next segment started, or transfer failed)
+*/
+static uint8_t SegmentDone (const SPI_RESOURCES *spi) {
+  SPI_TRANSFER_INFO *xfer    = spi->xfer;
+  uint8_t            pending = 0U;
+  uint32_t           offset, num_of_bytes;
+  const uint8_t     *src;
+
+  offset       = xfer->seg_cnt * xfer->dataSize;
+  num_of_bytes = xfer->seg_len * xfer->dataSize;
+
+  if (xfer->dma_flag == SPI_DMA_FLAG_REFRESH) { // If DMA was used for Rx and cache Refresh should be performed
+    RefreshDCacheAfterDmaRx(spi->h->hdmarx, &xfer->rx_data[offset], xfer->seg_len);
+  }
+
+  if (xfer->dma_flag == SPI_DMA_FLAG_BOUNCE) {  // If head and tail of Rx are received through bounce buffer
+    src = NULL;
+    switch (BouncePart(xfer)) {
+      case 0U:  src = xfer->bounce;                                     break;
+      case 1U:  DCache_Refresh(&xfer->rx_data[offset], num_of_bytes);   break;
+      default:  src = &xfer->bounce[32];                                break;
+    }
+    if (src != NULL) {
+#if (SPI_BOUNCE_BUF_NON_CACHEABLE == 0U)
+      DCache_Refresh((void *)(uint32_t)src, num_of_bytes);
+#endif
+      memcpy(&xfer->rx_data[offset], src, num_of_bytes);
+      xfer->stat.bounce_bytes += num_of_bytes;
+    }
+  }
+
+  if ((xfer->seg_cnt + xfer->seg_len) < xfer->num) {
+    xfer->seg_cnt += xfer->seg_len;
+    pending = 1U;
+    if (SegmentStart(spi) != HAL_OK) {
+      BounceBufFree(spi);
+      if (spi->xfer->sched_cur != NULL) {
+        SchedDone(spi, ARM_SPI_EVENT_DATA_LOST);
+      } else if (spi->info->cb_event != NULL) {
+        spi->info->cb_event(ARM_SPI_EVENT_DATA_LOST);
+      }
+    }
+  } else {
+    BounceBufFree(spi);
+  }
+
+  return pending;
+}
+
+/**
+  Update transfer path statistics.
+  \param[in]    spi       Pointer to SPI resources
+  \param[in]    dma_flag  DMA used for transfer
+*/
+__STATIC_INLINE void UpdateStatistics (const SPI_RESOURCES *spi, uint8_t dma_flag) {
+
+  if (spi->xfer->fast != 0U) {
+    spi->xfer->stat.fast++;
+  } else if (dma_flag == SPI_DMA_FLAG_NONE) {
+    spi->xfer->stat.irq++;
+  } else if (dma_flag == SPI_DMA_FLAG_BOUNCE) {
+    spi->xfer->stat.dma_bounce++;
+  } else {
+    spi->xfer->stat.dma++;
+  }
+}
+
 // SPI Driver functions
 
 /**
@@ -677,6 +1689,7 @@ static int32_t SPI_Initialize (ARM_SPI_SignalEvent_t cb_event, const SPI_RESOURC
 
   // Initialize SPI Run-Time Resources
   spi->info->cb_event = cb_event;
+  spi->info->path     = SPI_PATH_AUTO;
 
   // Clear transfer information
   memset(spi->xfer, 0, sizeof(SPI_TRANSFER_INFO));
@@ -786,7 +1799,6 @@ static int32_t SPI_PowerControl (ARM_POWER_STATE state, const SPI_RESOURCES *spi
 */
 static int32_t SPI_Send (const void *data, uint32_t num, const SPI_RESOURCES *spi) {
   HAL_StatusTypeDef stat;
-  uint8_t           tx_dma_flag;
 
   if ((data == NULL) || (num == 0U)) { return ARM_DRIVER_ERROR_PARAMETER; }
 
@@ -807,22 +1819,22 @@ static int32_t SPI_Send (const void *data, uint32_t num, const SPI_RESOURCES *sp
   }
 
   // Save transfer info
-  spi->xfer->num = num;
-  spi->xfer->cnt = 0;
+  spi->xfer->tx_data = data;
+  spi->xfer->rx_data = NULL;
+  spi->xfer->num     = num;
+  spi->xfer->cnt     = 0;
+  spi->xfer->seg_cnt = 0U;
 
-  tx_dma_flag = 0U;
-  if ((spi->dma_use & SPI_DMA_USE_TX) != 0U) {
+  spi->xfer->dma_flag = SPI_DMA_FLAG_NONE;
+  spi->xfer->fast     = FastCheck(spi, num);
+  if ((spi->xfer->fast == 0U) && (spi->info->path != SPI_PATH_IRQ) && ((spi->dma_use & SPI_DMA_USE_TX) != 0U)) {
     // Determine if DMA should be used for the transfer
-    tx_dma_flag = CheckDmaForTx(spi->h->hdmatx, data, num);
+    spi->xfer->dma_flag = CheckDmaForTx(spi->h->hdmatx, data, num);
   }
+  UpdateStatistics(spi, (uint8_t)spi->xfer->dma_flag);
 
-  if (tx_dma_flag != 0U) {
-    // DMA mode
-    stat = HAL_SPI_Transmit_DMA(spi->h, (uint8_t *)(uint32_t)data, (uint16_t)num);
-  } else {
-    // Interrupt mode
-    stat = HAL_SPI_Transmit_IT (spi->h, (uint8_t *)(uint32_t)data, (uint16_t)num);
-  }
+  // Start first segment (DMA or Interrupt mode)
+  stat = SegmentStart(spi);
 
   switch (stat) {
     case HAL_ERROR:
@@ -872,9 +1884,11 @@ static int32_t SPI_Receive (void *data, uint32_t num, const SPI_RESOURCES *spi)
   }
 
   // Save transfer info
+  spi->xfer->tx_data = data;
   spi->xfer->rx_data = data;
   spi->xfer->num     = num;
   spi->xfer->cnt     = 0;
+  spi->xfer->seg_cnt = 0U;
 
   // Since HAL does not support default value for Transmission during Reception,
   // this is emulated by loading receive buffer with default values and providing it 
@@ -893,20 +1907,25 @@ static int32_t SPI_Receive (void *data, uint32_t num, const SPI_RESOURCES *spi)
     }
   }
 
-  spi->xfer->dma_flag = 0U;
-  if ((spi->dma_use & SPI_DMA_USE_TX_RX) == SPI_DMA_USE_TX_RX) {
+  spi->xfer->dma_flag = SPI_DMA_FLAG_NONE;
+  spi->xfer->fast     = FastCheck(spi, num);
+  if ((spi->xfer->fast == 0U) && (spi->info->path != SPI_PATH_IRQ) && ((spi->dma_use & SPI_DMA_USE_TX_RX) == SPI_DMA_USE_TX_RX)) {
     // Determine if DMA should be used for the transfer, only if Tx and Rx can use DMA
     if (CheckDmaForTx(spi->h->hdmatx, data, num) != 0U) {
       spi->xfer->dma_flag = CheckDmaForRx(spi->h->hdmarx, data, num);
+      if (spi->xfer->dma_flag == SPI_DMA_FLAG_NONE) {
+        // Receive unaligned head and tail through bounce buffer
+        spi->xfer->dma_flag = CheckBounceForRx(spi, data, num);
+      }
     }
   }
+  UpdateStatistics(spi, (uint8_t)spi->xfer->dma_flag);
 
-  if (spi->xfer->dma_flag != 0U) {
-    // DMA mode
-    stat = HAL_SPI_TransmitReceive_DMA(spi->h, (uint8_t *)(uint32_t)data, (uint8_t *)(uint32_t)data, (uint16_t)num);
-  } else {
-    // Interrupt mode
-    stat = HAL_SPI_TransmitReceive_IT (spi->h, (uint8_t *)(uint32_t)data, (uint8_t *)(uint32_t)data, (uint16_t)num);
+  // Start first segment (DMA or Interrupt mode)
+  stat = SegmentStart(spi);
+
+  if (stat != HAL_OK) {
+    BounceBufFree(spi);
   }
 
   switch (stat) {
@@ -955,24 +1974,31 @@ static int32_t SPI_Transfer (const void *data_out, void *data_in, uint32_t num,
   }
 
   // Save transfer info
+  spi->xfer->tx_data = data_out;
   spi->xfer->rx_data = data_in;
-  spi->xfer->num = num;
-  spi->xfer->cnt = 0;
+  spi->xfer->num     = num;
+  spi->xfer->cnt     = 0;
+  spi->xfer->seg_cnt = 0U;
 
-  spi->xfer->dma_flag = 0U;
-  if ((spi->dma_use & SPI_DMA_USE_TX_RX) == SPI_DMA_USE_TX_RX) {
+  spi->xfer->dma_flag = SPI_DMA_FLAG_NONE;
+  spi->xfer->fast     = FastCheck(spi, num);
+  if ((spi->xfer->fast == 0U) && (spi->info->path != SPI_PATH_IRQ) && ((spi->dma_use & SPI_DMA_USE_TX_RX) == SPI_DMA_USE_TX_RX)) {
     // Determine if DMA should be used for the transfer, only if Tx and Rx can use DMA
     if (CheckDmaForTx(spi->h->hdmatx, data_out, num) != 0U) {
       spi->xfer->dma_flag = CheckDmaForRx(spi->h->hdmarx, data_in, num);
+      if (spi->xfer->dma_flag == SPI_DMA_FLAG_NONE) {
+        // Receive unaligned head and tail through bounce buffer
+        spi->xfer->dma_flag = CheckBounceForRx(spi, data_in, num);
+      }
     }
   }
+  UpdateStatistics(spi, (uint8_t)spi->xfer->dma_flag);
 
-  if (spi->xfer->dma_flag != 0U) {
-    // DMA mode
-    stat = HAL_SPI_TransmitReceive_DMA(spi->h, (uint8_t *)(uint32_t)data_out, (uint8_t *)(uint32_t)data_in, (uint16_t)num);
-  } else {
-    // Interrupt mode
-    stat = HAL_SPI_TransmitReceive_IT (spi->h, (uint8_t *)(uint32_t)data_out, (uint8_t *)(uint32_t)data_in, (uint16_t)num);
+  // Start first segment (DMA or Interrupt mode)
+  stat = SegmentStart(spi);
+
+  if (stat != HAL_OK) {
+    BounceBufFree(spi);
   }
 
   switch (stat) {
@@ -1002,30 +2028,34 @@ static uint32_t SPI_GetDataCount (const SPI_RESOURCES *spi) {
     return 0U;
   }
 
+  if (spi->xfer->fast != 0U) {
+    return (spi->h->RxXferSize - spi->h->RxXferCount);
+  }
+
 #ifdef __SPI_DMA
   if (((spi->dma_use & SPI_DMA_USE_RX) != 0U) && (spi->h->hdmarx != NULL)) {
     if (spi->h->RxXferSize != 0U) {
       // If reception is active
       if (spi->h->RxXferSize >= __HAL_DMA_GET_COUNTER(spi->h->hdmarx)) {
-        return (spi->h->RxXferSize - __HAL_DMA_GET_COUNTER(spi->h->hdmarx));
+        return (spi->xfer->seg_cnt + spi->h->RxXferSize - __HAL_DMA_GET_COUNTER(spi->h->hdmarx));
       }
     }
   }
   if (((spi->dma_use & SPI_DMA_USE_TX) != 0U) && (spi->h->hdmatx != NULL)) {
     if (spi->h->TxXferSize != 0U) {
       if (spi->h->TxXferSize >= __HAL_DMA_GET_COUNTER(spi->h->hdmatx)) {
-        return (spi->h->TxXferSize - __HAL_DMA_GET_COUNTER(spi->h->hdmatx));
+        return (spi->xfer->seg_cnt + spi->h->TxXferSize - __HAL_DMA_GET_COUNTER(spi->h->hdmatx));
       }
     }
   }
 #endif
   if (spi->h->RxXferSize != 0U) {
     // If reception is active
-    return (spi->h->RxXferSize - spi->h->RxXferCount);
+    return (spi->xfer->seg_cnt + spi->h->RxXferSize - spi->h->RxXferCount);
   }
 
   if (spi->h->TxXferSize != 0U) {
-    return (spi->h->TxXferSize - spi->h->TxXferCount);
+    return (spi->xfer->seg_cnt + spi->h->TxXferSize - spi->h->TxXferCount);
   }
 
   return 0;
@@ -1047,12 +2077,44 @@ static int32_t SPI_Control (uint32_t control, uint32_t arg, const SPI_RESOURCES
   if ((spi->info->state & SPI_POWERED) == 0U) { return ARM_DRIVER_ERROR; }
 
   if ((control & ARM_SPI_CONTROL_Msk) == ARM_SPI_ABORT_TRANSFER) {
+    SchedFlush(spi);
     (void)HAL_SPI_Abort(spi->h);
+    if (spi->xfer->fast != 0U) {
+      MODIFY_REG(spi->reg->CFG1, SPI_CFG1_FTHLV, spi->h->Init.FifoThreshold);
+    }
+    BounceBufFree(spi);
     spi->h->RxXferSize = 0U;
     spi->h->TxXferSize = 0U;
+    spi->xfer->seg_cnt = 0U;
     return ARM_DRIVER_OK;
   }
 
+  if ((control & ARM_SPI_CONTROL_Msk) == SPI_GET_STATISTICS) {
+    if (arg == 0U) { return ARM_DRIVER_ERROR_PARAMETER; }
+    memcpy((void *)arg, &spi->xfer->stat, sizeof(SPI_STATISTICS));
+    return ARM_DRIVER_OK;
+  }
+
+  if ((control & ARM_SPI_CONTROL_Msk) == SPI_CLEAR_STATISTICS) {
+    memset(&spi->xfer->stat, 0, sizeof(SPI_STATISTICS));
+    return ARM_DRIVER_OK;
+  }
+
+  if ((control & ARM_SPI_CONTROL_Msk) == SPI_SCHED_SUBMIT) {
+    return SchedSubmit(spi, (SPI_SCHED_XFER *)arg);
+  }
+
+  if ((control & ARM_SPI_CONTROL_Msk) == SPI_SET_PATH) {
+    if (arg > SPI_PATH_IRQ) { return ARM_DRIVER_ERROR_PARAMETER; }
+    spi->info->path = (uint8_t)arg;
+    return ARM_DRIVER_OK;
+  }
+
+  // Bus is owned by the scheduler until all scheduled transactions are completed
+  if (spi->xfer->sched_cur != NULL) {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
   // Check for busy flag
   switch (HAL_SPI_GetState (spi->h)) {
     case HAL_SPI_STATE_ABORT:
@@ -1359,37 +2421,7 @@ static int32_t SPI_Control (uint32_t control, uint32_t arg, const SPI_RESOURCES
   }
 
   // Reconfigure DMA
-#ifdef __SPI_DMA_RX
-  if (((spi->dma_use & SPI_DMA_USE_RX) != 0U) && (spi->h->hdmarx != NULL)) {
-    if ((control & ARM_SPI_DATA_BITS_Msk) > ARM_SPI_DATA_BITS(16U)) {
-      spi->h->hdmarx->Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
-      spi->h->hdmarx->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
-    } else if ((control & ARM_SPI_DATA_BITS_Msk) > ARM_SPI_DATA_BITS(8U)) {
-      spi->h->hdmarx->Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
-      spi->h->hdmarx->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
-    } else {
-      spi->h->hdmarx->Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-      spi->h->hdmarx->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-    }
-    HAL_DMA_Init(spi->h->hdmarx);
-  }
-#endif
-
-#ifdef __SPI_DMA_TX
-  if (((spi->dma_use & SPI_DMA_USE_TX) != 0U) && (spi->h->hdmatx != NULL)) {
-    if ((control & ARM_SPI_DATA_BITS_Msk) > ARM_SPI_DATA_BITS(16U)) {
-      spi->h->hdmatx->Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
-      spi->h->hdmatx->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
-    } else if ((control & ARM_SPI_DATA_BITS_Msk) > ARM_SPI_DATA_BITS(8U)) {
-      spi->h->hdmatx->Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
-      spi->h->hdmatx->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
-    } else {
-      spi->h->hdmatx->Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
-      spi->h->hdmatx->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-    }
-    HAL_DMA_Init(spi->h->hdmatx);
-  }
-#endif
+  DmaSetDataSize(spi, spi->xfer->dataSize);
 
   spi->info->mode   = control;
   spi->info->state |= SPI_CONFIGURED;
@@ -1441,15 +2473,27 @@ static void SPI_TransferComplete (SPI_HandleTypeDef *hspi) {
   const SPI_RESOURCES * spi;
   spi = SPI_Resources (hspi);
 
-  if (spi->xfer->dma_flag == 3U) {              // If DMA was used for Rx and cache Refresh should be performed
-    RefreshDCacheAfterDmaRx(spi->h->hdmarx, spi->xfer->rx_data, spi->h->RxXferSize);
+  if (spi->xfer->fast != 0U) {
+    FastClose(spi);
+  }
+
+  if (SegmentDone(spi) != 0U) {
+    return;                                     // Transfer of next segment is in progress
   }
 
   spi->xfer->cnt = spi->xfer->num;
 
+  if (spi->xfer->sched_cur != NULL) {
+    SchedDone(spi, ARM_SPI_EVENT_TRANSFER_COMPLETE);
+    return;
+  }
+
   if (spi->info->cb_event != NULL) {
     spi->info->cb_event(ARM_SPI_EVENT_TRANSFER_COMPLETE);
   }
+
+  // Start scheduled transactions queued during this transfer
+  SchedNext(spi);
 }
 
 /**
@@ -1499,6 +2543,12 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
   spi = SPI_Resources (hspi);
   error = HAL_SPI_GetError (hspi);
 
+  BounceBufFree(spi);
+  if (spi->xfer->fast != 0U) {
+    // Fast path transfer: SPI is disabled by HAL error handling (or by FastPoll)
+    MODIFY_REG(spi->reg->CFG1, SPI_CFG1_FTHLV, spi->h->Init.FifoThreshold);
+  }
+
   event = 0;
   if (error & HAL_SPI_ERROR_MODF) {
     event |= ARM_SPI_EVENT_MODE_FAULT;
@@ -1507,6 +2557,11 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
     event |= ARM_SPI_EVENT_DATA_LOST;
   }
 
+  if (spi->xfer->sched_cur != NULL) {
+    SchedDone(spi, event);
+    return;
+  }
+
   if ((spi->info->cb_event != NULL) && (event != 0)) {
     spi->info->cb_event(event);
   }
@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        24. June 2022
- * $Revision:    V1.2
+ * $Date:        18. October 2024
+ * $Revision:    V1.5
  *
  * Project:      SPI Driver definitions for STMicroelectronics STM32H7xx
  * -------------------------------------------------------------------------- */
@@ -31,6 +31,7 @@
 #include <string.h>
 
 #include "Driver_SPI.h"
+#include "SPI_STM32H7xx_Ext.h"
 #include "stm32h7xx_hal.h"
 
 #include "RTE_Components.h"
@@ -85,6 +86,12 @@ ARM_DRIVER_SPI Driver_SPI##x = {
 #define SPI_DMA_USE_RX                  (1U << 1)
 #define SPI_DMA_USE_TX_RX               (SPI_DMA_USE_TX | SPI_DMA_USE_RX)
 
+// DMA usage of a transfer (SPI_TRANSFER_INFO dma_flag)
+#define SPI_DMA_FLAG_NONE               (0U)    // Interrupt mode
+#define SPI_DMA_FLAG_DMA                (1U)    // DMA
+#define SPI_DMA_FLAG_REFRESH            (3U)    // DMA, Data Cache Refresh after reception
+#define SPI_DMA_FLAG_BOUNCE             (5U)    // DMA, head and tail of reception through bounce buffer
+
 // Current driver status flag definition
 #define SPI_INITIALIZED                 ((uint8_t)(1U))          // SPI initialized
 #define SPI_POWERED                     ((uint8_t)(1U << 1))     // SPI powered on
@@ -262,7 +269,8 @@ typedef struct {
   ARM_SPI_SignalEvent_t cb_event;       // Event Callback
   uint32_t              mode;           // Current SPI mode
   uint8_t               state;          // Current SPI state
-  uint8_t               reserved[3];
+  uint8_t               path;           // Transfer path selection (SPI_PATH_xxx)
+  uint8_t               reserved[2];
 } SPI_INFO;
 
 // SPI Transfer Information (Run-Time)
@@ -272,7 +280,19 @@ typedef struct {
   uint32_t              num;            // Total number of transfers
   uint32_t              cnt;            // Number of send/received data
   uint16_t              def_val;        // Default transfer value
-  uint16_t              dma_flag;       // DMA used for transfer
+  uint16_t              dma_flag;       // DMA used for transfer (SPI_DMA_FLAG_x)
+  uint32_t              fast;           // Fast path: 0 = not used, 1 = interrupt, 2 = polled
+  uint32_t              fast_tx;        // Fast path: number of bytes written to the transmit FIFO
+  uint32_t              fast_dummy[2];  // Fast path: destination of discarded frames read at end of transfer
+  const uint8_t        *tx_data;        // Pointer to transmit data buffer
+  uint8_t              *bounce;         // Bounce buffer (bounce buffered transfer)
+  uint32_t              seg_num[3];     // Number of items in head, middle and tail part (bounce buffered transfer)
+  uint32_t              seg_cnt;        // Number of items transferred in completed segments
+  uint32_t              seg_len;        // Number of items in active segment
+  SPI_STATISTICS        stat;           // Transfer path statistics
+  SPI_SCHED_XFER       *sched_cur;      // Active scheduled transaction
+  SPI_SCHED_XFER       *sched_head;     // First queued scheduled transaction
+  SPI_SCHED_XFER       *sched_tail;     // Last queued scheduled transaction
 } SPI_TRANSFER_INFO;
 
 
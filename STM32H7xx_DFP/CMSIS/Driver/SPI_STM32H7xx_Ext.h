@@ -0,0 +1,85 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      SPI Driver vendor extensions for STMicroelectronics STM32H7xx
+ * -------------------------------------------------------------------------- */
+
+#ifndef __SPI_STM32H7XX_EXT_H
+#define __SPI_STM32H7XX_EXT_H
+
+#include <stdint.h>
+
+#include "Driver_SPI.h"
+#include "stm32h7xx.h"
+
+// Vendor specific Control codes
+#define SPI_GET_STATISTICS              (0x80UL << ARM_SPI_CONTROL_Pos)     // Get transfer path statistics; arg = pointer to SPI_STATISTICS
+#define SPI_CLEAR_STATISTICS            (0x81UL << ARM_SPI_CONTROL_Pos)     // Clear transfer path statistics
+#define SPI_SCHED_SUBMIT                (0x82UL << ARM_SPI_CONTROL_Pos)     // Submit scheduled transaction; arg = pointer to SPI_SCHED_XFER
+#define SPI_SET_PATH                    (0x83UL << ARM_SPI_CONTROL_Pos)     // Restrict transfer path selection; arg = SPI_PATH_xxx
+
+// Transfer path selection (SPI_SET_PATH)
+#define SPI_PATH_AUTO                   (0U)    // Fast path, DMA or interrupt mode selected per transfer (default)
+#define SPI_PATH_DMA                    (1U)    // DMA or interrupt mode (fast path not used)
+#define SPI_PATH_IRQ                    (2U)    // Interrupt mode only
+
+// Scheduled transaction slave select (SPI_SCHED_DEVICE ss)
+#define SPI_SCHED_SS_NONE               (0U)    // No slave select
+#define SPI_SCHED_SS_GPIO               (1U)    // GPIO pin (active low), driven by the driver
+#define SPI_SCHED_SS_HW                 (2U)    // Hardware NSS output, active during the whole transaction
+#define SPI_SCHED_SS_HW_PULSE           (3U)    // Hardware NSS output, pulsed between data frames
+
+// SPI Transfer path statistics
+typedef struct {
+  uint32_t              dma;            // Transfers by DMA directly from/to user buffers
+  uint32_t              dma_bounce;     // Transfers by DMA with unaligned head/tail received through a bounce buffer
+  uint32_t              irq;            // Transfers in interrupt mode
+  uint32_t              fast;           // Transfers by the FIFO packed fast path (short Master mode transfers)
+  uint32_t              pool_empty;     // Interrupt mode transfers because no bounce buffer was free
+  uint32_t              bounce_bytes;   // Bytes copied from bounce buffers
+} SPI_STATISTICS;
+
+// SPI Scheduler device (bus configuration of a slave device)
+typedef struct {
+  uint32_t              mode;           // Frame format, data bits and bit order (ARM_SPI_CPOLx_CPHAx, ARM_SPI_DATA_BITS(n), ARM_SPI_MSB_LSB)
+  uint32_t              bus_speed;      // Bus speed in bps
+  GPIO_TypeDef         *ss_port;        // Slave select GPIO port (SPI_SCHED_SS_GPIO)
+  uint16_t              ss_pin;         // Slave select GPIO pin (SPI_SCHED_SS_GPIO)
+  uint8_t               ss;             // Slave select: SPI_SCHED_SS_xxx
+  uint8_t               ss_idle;        // Clock cycles between NSS active and first data (hardware NSS, 0..15)
+  uint8_t               data_idle;      // Clock cycles between data frames (0..15)
+  uint8_t               reserved[3];
+  uint32_t              cfg1;           // Driver internal: CFG1 register value
+  uint32_t              cfg2;           // Driver internal: CFG2 register value
+} SPI_SCHED_DEVICE;
+
+// SPI Scheduled transaction
+typedef struct _SPI_SCHED_XFER {
+  SPI_SCHED_DEVICE     *dev;            // Device
+  const void           *data_out;       // Data to send (NULL: default transmit value is sent)
+  void                 *data_in;        // Buffer for received data (NULL: received data is discarded)
+  uint32_t              num;            // Number of data items
+  void                (*cb_event)(uint32_t event, struct _SPI_SCHED_XFER *xfer);   // Completion callback (ARM_SPI_EVENT_xxx)
+  struct _SPI_SCHED_XFER *next;         // Driver internal: next queued transaction
+} SPI_SCHED_XFER;
+
+#endif /* __SPI_STM32H7XX_EXT_H */
@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        10. July 2023
- * $Revision:    V2.4
+ * $Date:        18. October 2024
+ * $Revision:    V2.7
  *
  * Driver:       Driver_USART1/2/3/4/5/6/7/8/9/10/21
  *
@@ -30,6 +30,12 @@
 
 # Revision History
 
+- Version 2.7
+  - Added oversampling, FIFO mode and auto baud rate detection control codes
+- Version 2.6
+  - Added optional transmit queue (UART_TX_QUEUE_DEPTH)
+- Version 2.5
+  - Added streaming receive into a circular ring with idle line detection (UART_CONTROL_RX_RING)
 - Version 2.4
   - Corrected peripheral reset for UART9, USART10 and LPUART1
   - Corrected USART6 RTS pin configuration
@@ -105,6 +111,77 @@ DMA usage limitations:
    in size can be dangerous and can corrupt other data that is also maintained
    by the same 32 Byte DCache line.
 
+# Streaming Receive
+
+Vendor specific control codes and events of this driver, **UART_RX_RING** and
+**UART_RxRingRead** are declared in the public header **UART_STM32H7xx_Ext.h**.
+
+Control code **UART_CONTROL_RX_RING** starts continuous reception into a user
+supplied **UART_RX_RING** (arg = pointer to ring, 0 stops reception). The ring
+size must be a power of 2 and at most 32768 bytes; 9 data bits without parity
+are not supported. Reception is not re-armed by the application:
+ - with Rx DMA, the DMA stream is switched to circular mode and keeps writing
+   into the ring; new data is reported on half transfer, transfer complete and
+   Rx Idle events
+ - without Rx DMA (or if the ring does not meet the DCache requirements above)
+   reception runs in interrupt mode and is re-armed by the driver on each
+   transfer complete and Rx Idle event
+
+The driver advances ring **head** and signals **UART_EVENT_RX_RING**. The
+application consumes data with **UART_RxRingRead** (or by advancing **tail**
+itself). If the driver overtakes unread data, **ARM_USART_EVENT_RX_OVERFLOW**
+is signaled and the reader discards the pending data. Receive errors that stop
+the HAL reception resume streaming automatically. Circular DMA resumes at ring
+start: **head** is advanced to the next multiple of the ring size, the skipped
+data is lost and **ARM_USART_EVENT_RX_OVERFLOW** is signaled. If reception
+cannot be resumed, streaming stops. While streaming,
+ARM_USART_Receive returns busy, ARM_USART_GetRxCount returns **head** and
+ARM_USART_ABORT_RECEIVE stops the stream.
+
+# Transmit Queue
+
+With UART_TX_QUEUE_DEPTH > 0, ARM_USART_Send called while a transmission is in
+progress does not return busy: the buffer reference is queued (no data is
+copied) and sent after the buffers queued before it. Busy is returned only if
+the queue is full. The buffer must remain valid until its
+**ARM_USART_EVENT_SEND_COMPLETE** is signaled; send complete is signaled for
+each buffer and **ARM_USART_EVENT_TX_COMPLETE** only when the queue is drained.
+ - DMA buffers are chained from the DMA transfer complete interrupt while the
+   transmitter is still shifting out the previous data, so there is no gap
+   between buffers
+ - buffers sent in interrupt mode (no Tx DMA or DCache requirements not met)
+   are started from the transmission complete interrupt
+
+ARM_USART_GetTxCount returns the count of the buffer currently being sent.
+ARM_USART_ABORT_SEND discards all queued buffers.
+The transmit queue is available in asynchronous mode only, the synchronous
+USART driver does not queue buffers.
+
+# High-speed Mode
+
+Vendor specific control codes configure the peripheral for high baud rates.
+They return busy while a transfer or streaming receive is active; when called
+before the mode is configured (ARM_USART_MODE_ASYNCHRONOUS) the setting is
+applied together with it.
+ - **UART_CONTROL_OVERSAMPLING** (arg = 8 or 16) selects oversampling by 8,
+   which doubles the maximum baud rate to kernel clock / 8 (12.5 Mbaud with a 100 MHz kernel clock) at the cost of
+   receiver tolerance to clock deviation (not available on LPUART1)
+ - **UART_CONTROL_FIFO** (arg = **UART_FIFO_ENABLE** |
+   **UART_FIFO_TX_THRESHOLD**(x) | **UART_FIFO_RX_THRESHOLD**(x), 0 = disable)
+   enables the 16 byte Tx/Rx FIFOs; in interrupt mode each Rx/Tx interrupt then
+   services as many bytes as the threshold allows (for example up to 8 bytes
+   with threshold 1/2) instead of one
+ - **UART_CONTROL_AUTO_BAUD** (arg = **UART_AUTO_BAUD_xxx**, 0 = disable)
+   measures the baud rate on the next received character (start bit, falling
+   edges, 0x7F or 0x55 character); the measuring character itself may be
+   received corrupted. **UART_GET_AUTO_BAUD** (arg = pointer to uint32_t)
+   returns busy until the measurement is complete, an error if it failed, and
+   otherwise the detected baud rate, which is kept on reconfiguration (not
+   available on LPUART1)
+
+FIFO mode and thresholds are restored whenever the driver re-initializes the
+peripheral (ARM_USART_CONTROL_TX/RX and mode configuration).
+
 # Configuration
 
 ## Compile-time
@@ -123,6 +200,8 @@ UART_DCACHE_DATA_TX_ALIGNMENT      |     **1**     |   1   | UART DCache data Tx
 ^                                  |       ^       |   0   | UART DCache data Tx alignment check: **disabled**
 UART_DCACHE_DATA_TX_SIZE           |     **1**     |   1   | UART DCache data Tx size check: **enabled**
 ^                                  |       ^       |   0   | UART DCache data Tx size check: **disabled**
+UART_TX_QUEUE_DEPTH                |     **0**     |   0   | Transmit queue: **disabled** (Send returns busy while transmitting)
+^                                  |       ^       | 1..255| Number of buffers Send can queue while transmitting
 
 ## STM32CubeMX
 
@@ -239,7 +318,7 @@ Results of the **CMSIS-Driver Validation** for this driver can be found in the [
 
 #ifdef USARTx_MODE_ASYNC
 
-#define ARM_USART_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(2,4)
+#define ARM_USART_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(2,7)
 
 #ifndef UART_DCACHE_MAINTENANCE
 #define UART_DCACHE_MAINTENANCE                (1U)
@@ -569,6 +648,422 @@ __STATIC_INLINE void RefreshDCacheAfterDmaRx (DMA_HandleTypeDef *hdma, void *dat
 #endif
 }
 
+#if (UART_TX_QUEUE_DEPTH > 0U)
+static void TxQueueDmaCplt (DMA_HandleTypeDef *hdma);
+#endif
+
+/**
+  Start transmission of one buffer.
+  \param[in]    uart   Pointer to UART resources
+  \param[in]    data   Pointer to data for transmission
+  \param[in]    num    Number of items for transmission
+  \param[in]    dma    DMA used for transmission (result of CheckDmaForTx)
+  \return       HAL status
+*/
+static HAL_StatusTypeDef TxStart (const UART_RESOURCES *uart, const void *data, uint32_t num, uint8_t dma) {
+  HAL_StatusTypeDef stat;
+  uint32_t          primask;
+
+  // Save buffer info
+  uart->xfer->tx_num      = num;
+  uart->xfer->tx_dma_flag = dma;
+
+  if (dma != 0U) {
+    // DMA mode
+    primask = __get_PRIMASK();
+    __disable_irq();
+    stat = HAL_UART_Transmit_DMA(uart->h, (uint8_t *)(uint32_t)data, (uint16_t)num);
+#if (UART_TX_QUEUE_DEPTH > 0U)
+    if (stat == HAL_OK) {
+      // Chain queued buffers from DMA transfer complete (before the DMA interrupt can run)
+      uart->xfer->txq_dma_cplt = uart->h->hdmatx->XferCpltCallback;
+      uart->h->hdmatx->XferCpltCallback = TxQueueDmaCplt;
+    }
+#endif
+    __set_PRIMASK(primask);
+  } else {
+    // Interrupt mode
+    stat = HAL_UART_Transmit_IT (uart->h, (uint8_t *)(uint32_t)data, (uint16_t)num);
+  }
+
+  return stat;
+}
+
+#if (UART_TX_QUEUE_DEPTH > 0U)
+/**
+  Queue buffer for transmission while transmitter is busy.
+  \param[in]    uart   Pointer to UART resources
+  \param[in]    data   Pointer to data for transmission
+  \param[in]    num    Number of items for transmission
+  \return       \ref execution_status
+*/
+static int32_t TxQueuePut (const UART_RESOURCES *uart, const void *data, uint32_t num) {
+  UART_TX_DESC *desc;
+  uint32_t      primask;
+  uint8_t       dma;
+  int32_t       status;
+
+  dma = 0U;
+  if (uart->dma_use_tx != 0U) {
+    // Determine if DMA should be used (Data Cache is flushed now)
+    dma = CheckDmaForTx(uart->h->hdmatx, data, num);
+  }
+
+  status = ARM_DRIVER_OK;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  if ((uart->h->gState == HAL_UART_STATE_READY) && (uart->xfer->txq_cnt == 0U)) {
+    // Transmission completed in the meantime
+    uart->info->status.tx_underflow = 0;
+    if (TxStart(uart, data, num, dma) != HAL_OK) {
+      status = ARM_DRIVER_ERROR;
+    }
+  } else if (uart->xfer->txq_cnt == UART_TX_QUEUE_DEPTH) {
+    status = ARM_DRIVER_ERROR_BUSY;
+  } else {
+    desc = &uart->xfer->txq[uart->xfer->txq_wr];
+    desc->data     = data;
+    desc->num      = (uint16_t)num;
+    desc->dma_flag = dma;
+    uart->xfer->txq_wr = (uint8_t)((uart->xfer->txq_wr + 1U) % UART_TX_QUEUE_DEPTH);
+    uart->xfer->txq_cnt++;
+  }
+
+  __set_PRIMASK(primask);
+
+  return status;
+}
+
+/**
+  Remove first buffer from transmit queue.
+  \param[in]    uart   Pointer to UART resources
+  \return       pointer to removed queue entry
+*/
+__STATIC_INLINE UART_TX_DESC *TxQueueGet (const UART_RESOURCES *uart) {
+  UART_TX_DESC *desc = &uart->xfer->txq[uart->xfer->txq_rd];
+
+  uart->xfer->txq_rd = (uint8_t)((uart->xfer->txq_rd + 1U) % UART_TX_QUEUE_DEPTH);
+  uart->xfer->txq_cnt--;
+
+  return desc;
+}
+
+/**
+  Tx DMA transfer complete: feed next queued DMA buffer to the running transmitter.
+  \param[in]    hdma   Tx DMA handle
+*/
+static void TxQueueDmaCplt (DMA_HandleTypeDef *hdma) {
+  UART_HandleTypeDef   *huart = (UART_HandleTypeDef *)hdma->Parent;
+  const UART_RESOURCES *uart  = UART_Resources (huart);
+  UART_TX_DESC         *desc;
+
+  if (uart->xfer->txq_cnt != 0U) {
+    desc = &uart->xfer->txq[uart->xfer->txq_rd];
+    if ((desc->dma_flag != 0U) &&
+        (HAL_DMA_Start_IT(hdma, (uint32_t)desc->data, (uint32_t)&huart->Instance->TDR, desc->num) == HAL_OK)) {
+      (void)TxQueueGet(uart);
+      huart->pTxBuffPtr   = desc->data;
+      huart->TxXferSize   = desc->num;
+      huart->TxXferCount  = desc->num;
+      uart->xfer->tx_num  = desc->num;
+
+      if (uart->info->cb_event != NULL) {
+        uart->info->cb_event(ARM_USART_EVENT_SEND_COMPLETE);
+      }
+      return;
+    }
+  }
+
+  // Let HAL complete the transmission (next buffer is started from Tx complete)
+  uart->xfer->txq_dma_cplt(hdma);
+}
+#endif
+
+/**
+  Arm HAL reception for streaming receive ring.
+  \param[in]    uart   Pointer to UART resources
+  \return       HAL status
+*/
+static HAL_StatusTypeDef RxRingArm (const UART_RESOURCES *uart) {
+  UART_RX_RING *ring = uart->xfer->rx_ring;
+  uint32_t      seg;
+
+  seg = uart->xfer->rx_ring_pos;
+  uart->xfer->rx_ring_seg = seg;
+
+  if (uart->xfer->rx_dma_flag != 0U) {
+    return HAL_UARTEx_ReceiveToIdle_DMA(uart->h, &ring->buf[seg], (uint16_t)(ring->size - seg));
+  }
+  return HAL_UARTEx_ReceiveToIdle_IT (uart->h, &ring->buf[seg], (uint16_t)(ring->size - seg));
+}
+
+/**
+  Stop streaming receive.
+  \param[in]    uart   Pointer to UART resources
+*/
+static void RxRingStop (const UART_RESOURCES *uart) {
+
+  if (uart->xfer->rx_ring == NULL) {
+    return;
+  }
+
+  HAL_UART_AbortReceive(uart->h);
+  uart->h->RxXferSize = 0U;
+  uart->xfer->rx_ring = NULL;
+
+  if (uart->xfer->rx_ring_circ != 0U) {
+    // Restore normal DMA mode for one-shot receive
+    uart->xfer->rx_ring_circ = 0U;
+    uart->h->hdmarx->Init.Mode = DMA_NORMAL;
+    HAL_DMA_Init(uart->h->hdmarx);
+  }
+  uart->xfer->rx_dma_flag = 0U;
+}
+
+/**
+  Start streaming receive into circular ring.
+  \param[in]    uart   Pointer to UART resources
+  \param[in]    ring   Pointer to streaming receive ring
+  \return       \ref execution_status
+*/
+static int32_t RxRingStart (const UART_RESOURCES *uart, UART_RX_RING *ring) {
+  HAL_StatusTypeDef stat;
+
+  if ((ring->buf == NULL) || (ring->size == 0U) || (ring->size > 0x8000U) ||
+     ((ring->size & (ring->size - 1U)) != 0U)) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  if ((uart->info->flags & UART_FLAG_CONFIGURED) == 0U) {
+    // UART is not configured (mode not selected)
+    return ARM_DRIVER_ERROR;
+  }
+
+  if ((uart->h->Init.WordLength == UART_WORDLENGTH_9B) && (uart->h->Init.Parity == UART_PARITY_NONE)) {
+    // Ring holds 8-bit items only
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+
+  if ((uart->xfer->rx_ring != NULL) || (uart->h->RxState != HAL_UART_STATE_READY)) {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  // Clear ARM UART STATUS flags
+  uart->info->status.rx_overflow = 0;
+  uart->info->status.rx_break = 0;
+  uart->info->status.rx_framing_error = 0;
+  uart->info->status.rx_parity_error = 0;
+
+  ring->head = 0U;
+  ring->tail = 0U;
+
+  uart->xfer->rx_ring_pos  = 0U;
+  uart->xfer->rx_ring_circ = 0U;
+  uart->xfer->rx_dma_flag  = 0U;
+  if (uart->dma_use_rx != 0U) {
+    // Determine if DMA should be used for the ring
+    uart->xfer->rx_dma_flag = CheckDmaForRx(uart->h->hdmarx, ring->buf, ring->size);
+  }
+
+  if (uart->xfer->rx_dma_flag != 0U) {
+    if (uart->xfer->rx_dma_flag == 3U) {
+      // Discard cached ring content before DMA writes to it
+      RefreshDCacheAfterDmaRx(uart->h->hdmarx, ring->buf, ring->size);
+    }
+    // DMA keeps writing into the ring in circular mode
+    uart->h->hdmarx->Init.Mode = DMA_CIRCULAR;
+    HAL_DMA_Init(uart->h->hdmarx);
+    uart->xfer->rx_ring_circ = 1U;
+  }
+
+  uart->xfer->rx_ring = ring;
+
+  stat = RxRingArm(uart);
+  if (stat != HAL_OK) {
+    RxRingStop(uart);
+  }
+
+  return UART_HAL_STATUS(stat);
+}
+
+static const uint32_t TxFifoThreshold[6] = {
+  UART_TXFIFO_THRESHOLD_1_8, UART_TXFIFO_THRESHOLD_1_4, UART_TXFIFO_THRESHOLD_1_2,
+  UART_TXFIFO_THRESHOLD_3_4, UART_TXFIFO_THRESHOLD_7_8, UART_TXFIFO_THRESHOLD_8_8
+};
+static const uint32_t RxFifoThreshold[6] = {
+  UART_RXFIFO_THRESHOLD_1_8, UART_RXFIFO_THRESHOLD_1_4, UART_RXFIFO_THRESHOLD_1_2,
+  UART_RXFIFO_THRESHOLD_3_4, UART_RXFIFO_THRESHOLD_7_8, UART_RXFIFO_THRESHOLD_8_8
+};
+static const uint32_t AutoBaudMode[4] = {
+  UART_ADVFEATURE_AUTOBAUDRATE_ONSTARTBIT,  UART_ADVFEATURE_AUTOBAUDRATE_ONFALLINGEDGE,
+  UART_ADVFEATURE_AUTOBAUDRATE_ON0X7FFRAME, UART_ADVFEATURE_AUTOBAUDRATE_ON0X55FRAME
+};
+
+/**
+  Initialize UART peripheral and restore FIFO mode.
+  \param[in]    uart   Pointer to UART resources
+  \return       HAL status
+*/
+static HAL_StatusTypeDef UartInit (const UART_RESOURCES *uart) {
+  HAL_StatusTypeDef stat;
+  uint32_t          fifo;
+
+  stat = HAL_UART_Init(uart->h);
+  if (stat != HAL_OK) {
+    return stat;
+  }
+
+  // Reference for auto baud rate calculation
+  uart->info->brr = (uint16_t)uart->h->Instance->BRR;
+
+  // HAL_UART_Init clears FIFO enable and thresholds
+  fifo = uart->info->fifo;
+  if ((fifo & 0x80U) != 0U) {
+    stat = HAL_UARTEx_SetTxFifoThreshold(uart->h, TxFifoThreshold[fifo & 0x07U]);
+    if (stat == HAL_OK) {
+      stat = HAL_UARTEx_SetRxFifoThreshold(uart->h, RxFifoThreshold[(fifo >> 4) & 0x07U]);
+    }
+    if (stat == HAL_OK) {
+      stat = HAL_UARTEx_EnableFifoMode(uart->h);
+    }
+  } else if (uart->h->FifoMode == UART_FIFOMODE_ENABLE) {
+    stat = HAL_UARTEx_DisableFifoMode(uart->h);
+  }
+
+  return stat;
+}
+
+/**
+  Apply high-speed mode configuration (oversampling, FIFO mode, auto baud rate).
+  \param[in]    control  Vendor specific control code
+  \param[in]    arg      Argument of control code
+  \param[in]    uart     Pointer to UART resources
+  \return       \ref execution_status
+*/
+static int32_t ControlHighSpeed (uint32_t control, uint32_t arg, const UART_RESOURCES *uart) {
+  HAL_StatusTypeDef stat;
+
+  if (((uart->h->gState  != HAL_UART_STATE_RESET) && (uart->h->gState  != HAL_UART_STATE_READY)) ||
+      ((uart->h->RxState != HAL_UART_STATE_RESET) && (uart->h->RxState != HAL_UART_STATE_READY)) ||
+       (uart->xfer->rx_ring != NULL)) {
+    // Transfer in progress
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  switch (control) {
+    case UART_CONTROL_OVERSAMPLING:
+      if (arg == 16U) {
+        uart->h->Init.OverSampling = UART_OVERSAMPLING_16;
+      } else if (arg == 8U) {
+        if (UART_INSTANCE_LOWPOWER(uart->h)) {
+          return ARM_DRIVER_ERROR_UNSUPPORTED;
+        }
+        uart->h->Init.OverSampling = UART_OVERSAMPLING_8;
+      } else {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      break;
+
+    case UART_CONTROL_FIFO:
+      if (arg == 0U) {
+        uart->info->fifo = 0U;
+        break;
+      }
+      if (((arg & ~(UART_FIFO_ENABLE | 0x77U)) != 0U) || ((arg & UART_FIFO_ENABLE) == 0U) ||
+          ((arg & 0x07U) > UART_FIFO_THRESHOLD_8_8) || (((arg >> 4) & 0x07U) > UART_FIFO_THRESHOLD_8_8)) {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      if (!IS_UART_FIFO_INSTANCE(uart->h->Instance)) {
+        return ARM_DRIVER_ERROR_UNSUPPORTED;
+      }
+      uart->info->fifo = (uint8_t)(0x80U | (arg & 0x77U));
+      break;
+
+    case UART_CONTROL_AUTO_BAUD:
+      if (arg > UART_AUTO_BAUD_0x55) {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      if (!IS_USART_AUTOBAUDRATE_DETECTION_INSTANCE(uart->h->Instance)) {
+        return ARM_DRIVER_ERROR_UNSUPPORTED;
+      }
+      uart->h->AdvancedInit.AdvFeatureInit |= UART_ADVFEATURE_AUTOBAUDRATE_INIT;
+      if (arg == 0U) {
+        uart->h->AdvancedInit.AutoBaudRateEnable = UART_ADVFEATURE_AUTOBAUDRATE_DISABLE;
+      } else {
+        uart->h->AdvancedInit.AutoBaudRateEnable = UART_ADVFEATURE_AUTOBAUDRATE_ENABLE;
+        uart->h->AdvancedInit.AutoBaudRateMode   = AutoBaudMode[arg - 1U];
+      }
+      break;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+
+  if ((uart->info->flags & UART_FLAG_CONFIGURED) == 0U) {
+    // Applied on mode configuration
+    return ARM_DRIVER_OK;
+  }
+
+  // Re-initialization also restarts auto baud rate detection
+  stat = UartInit(uart);
+
+  return UART_HAL_STATUS(stat);
+}
+
+/**
+  Get baud rate detected by auto baud rate detection.
+  \param[in]    uart   Pointer to UART resources
+  \param[out]   baud   Pointer to detected baud rate
+  \return       \ref execution_status
+*/
+static int32_t GetAutoBaud (const UART_RESOURCES *uart, uint32_t *baud) {
+  uint32_t isr, brr, div, div_ref;
+
+  if (baud == NULL) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  if (uart->h->AdvancedInit.AutoBaudRateEnable != UART_ADVFEATURE_AUTOBAUDRATE_ENABLE) {
+    // Detection not active: configured (or previously detected) baud rate
+    *baud = uart->h->Init.BaudRate;
+    return ARM_DRIVER_OK;
+  }
+
+  if ((uart->info->flags & UART_FLAG_CONFIGURED) == 0U) {
+    return ARM_DRIVER_ERROR;
+  }
+
+  isr = uart->h->Instance->ISR;
+  if ((isr & USART_ISR_ABRE) != 0U) {
+    return ARM_DRIVER_ERROR;
+  }
+  if ((isr & USART_ISR_ABRF) == 0U) {
+    return ARM_DRIVER_ERROR_BUSY;
+  }
+
+  // Baud rate is inversely proportional to USARTDIV (same kernel clock and oversampling)
+  brr     = uart->h->Instance->BRR & 0xFFFFU;
+  div     = brr;
+  div_ref = uart->info->brr;
+  if (uart->h->Init.OverSampling == UART_OVERSAMPLING_8) {
+    div     = (div     & 0xFFF0U) | ((div     & 0x07U) << 1);
+    div_ref = (div_ref & 0xFFF0U) | ((div_ref & 0x07U) << 1);
+  }
+  if (div == 0U) {
+    return ARM_DRIVER_ERROR;
+  }
+  *baud = (uint32_t)((((uint64_t)uart->h->Init.BaudRate * div_ref) + (div / 2U)) / div);
+
+  // Keep detected baud rate on reconfiguration
+  uart->h->Init.BaudRate = *baud;
+  uart->h->AdvancedInit.AutoBaudRateEnable = UART_ADVFEATURE_AUTOBAUDRATE_DISABLE;
+  uart->info->brr = (uint16_t)brr;
+
+  return ARM_DRIVER_OK;
+}
+
 // UART Driver functions
 
 /**
@@ -667,6 +1162,9 @@ static int32_t UART_PowerControl (      ARM_POWER_STATE  state,
   switch (state) {
     case ARM_POWER_OFF:
 
+      // Stop streaming receive (restores DMA normal mode)
+      RxRingStop(uart);
+
       // UART peripheral reset
       UART_PeripheralReset (uart->reg);
 
@@ -674,6 +1172,11 @@ static int32_t UART_PowerControl (      ARM_POWER_STATE  state,
         HAL_UART_MspDeInit (uart->h);
       }
 
+#if (UART_TX_QUEUE_DEPTH > 0U)
+      uart->xfer->txq_cnt      = 0U;
+      uart->xfer->txq_rd       = uart->xfer->txq_wr;
+#endif
+
       // Clear Status flags
       uart->info->status.tx_busy          = 0;
       uart->info->status.rx_busy          = 0;
@@ -708,6 +1211,7 @@ static int32_t UART_PowerControl (      ARM_POWER_STATE  state,
       uart->info->status.rx_parity_error  = 0;
 
       uart->info->flags = UART_FLAG_POWERED | UART_FLAG_INITIALIZED;
+      uart->info->fifo  = 0U;
 
       HAL_UART_MspInit (uart->h);
 
@@ -734,6 +1238,7 @@ static int32_t UART_Send (const void            *data,
                           const UART_RESOURCES  *uart) {
 
   HAL_StatusTypeDef stat;
+  uint8_t           dma;
 
   if ((data == NULL) || (num == 0U)) {
     // Invalid parameters
@@ -754,9 +1259,15 @@ static int32_t UART_Send (const void            *data,
       return ARM_DRIVER_ERROR_TIMEOUT;
 
     case HAL_UART_STATE_BUSY:
+      return ARM_DRIVER_ERROR_BUSY;
+
     case HAL_UART_STATE_BUSY_TX:
     case HAL_UART_STATE_BUSY_TX_RX:
+#if (UART_TX_QUEUE_DEPTH > 0U)
+      return TxQueuePut(uart, data, num);
+#else
       return ARM_DRIVER_ERROR_BUSY;
+#endif
 
     case HAL_UART_STATE_BUSY_RX:
     case HAL_UART_STATE_READY:
@@ -766,22 +1277,13 @@ static int32_t UART_Send (const void            *data,
   // Clear ARM UART STATUS flags
   uart->info->status.tx_underflow = 0;
 
-  // Save buffer info
-  uart->xfer->tx_num = num;
-
-  uart->xfer->tx_dma_flag = 0U;
+  dma = 0U;
   if (uart->dma_use_tx != 0U) {
     // Determine if DMA should be used for the transfer
-    uart->xfer->tx_dma_flag = CheckDmaForTx(uart->h->hdmatx, data, num);
+    dma = CheckDmaForTx(uart->h->hdmatx, data, num);
   }
 
-  if (uart->xfer->tx_dma_flag != 0U) {
-    // DMA mode
-    stat = HAL_UART_Transmit_DMA(uart->h, (uint8_t *)(uint32_t)data, (uint16_t)num);
-  } else {
-    // Interrupt mode
-    stat = HAL_UART_Transmit_IT (uart->h, (uint8_t *)(uint32_t)data, (uint16_t)num);
-  }
+  stat = TxStart(uart, data, num, dma);
 
   switch (stat) {
     case HAL_ERROR:
@@ -942,7 +1444,10 @@ static uint32_t UART_GetRxCount (const UART_RESOURCES *uart) {
     return 0U;
   }
 
-  if (uart->xfer->rx_dma_flag != 0U) {
+  if (uart->xfer->rx_ring != NULL) {
+    // Streaming receive: bytes delivered to the ring
+    cnt = uart->xfer->rx_ring->head;
+  } else if (uart->xfer->rx_dma_flag != 0U) {
     cnt = uart->xfer->rx_num - __HAL_DMA_GET_COUNTER(uart->h->hdmarx);
   } else {
     cnt = uart->h->RxXferSize - uart->h->RxXferCount;
@@ -979,19 +1484,45 @@ static int32_t UART_Control (      uint32_t         control,
 
     // Abort
     case ARM_USART_ABORT_SEND:
+#if (UART_TX_QUEUE_DEPTH > 0U)
+      uart->xfer->txq_cnt = 0U;
+      uart->xfer->txq_rd  = uart->xfer->txq_wr;
+#endif
       HAL_UART_AbortTransmit(uart->h);
       uart->h->TxXferSize = 0U;
       return ARM_DRIVER_OK;
     case ARM_USART_ABORT_RECEIVE:
+      RxRingStop(uart);
       HAL_UART_AbortReceive(uart->h);
       uart->h->RxXferSize = 0U;
       return ARM_DRIVER_OK;
     case ARM_USART_ABORT_TRANSFER:
+#if (UART_TX_QUEUE_DEPTH > 0U)
+      uart->xfer->txq_cnt = 0U;
+      uart->xfer->txq_rd  = uart->xfer->txq_wr;
+#endif
+      RxRingStop(uart);
       HAL_UART_Abort(uart->h);
       uart->h->RxXferSize = 0U;
       uart->h->TxXferSize = 0U;
       return ARM_DRIVER_OK;
 
+    // Streaming receive
+    case UART_CONTROL_RX_RING:
+      if (arg == 0U) {
+        RxRingStop(uart);
+        return ARM_DRIVER_OK;
+      }
+      return RxRingStart(uart, (UART_RX_RING *)arg);
+
+    // High-speed mode
+    case UART_CONTROL_OVERSAMPLING:
+    case UART_CONTROL_FIFO:
+    case UART_CONTROL_AUTO_BAUD:
+      return ControlHighSpeed(control & ARM_USART_CONTROL_Msk, arg, uart);
+    case UART_GET_AUTO_BAUD:
+      return GetAutoBaud(uart, (uint32_t *)arg);
+
     // Control TX
     case ARM_USART_CONTROL_TX:
       if (arg) {
@@ -1001,7 +1532,7 @@ static int32_t UART_Control (      uint32_t         control,
         // Transmitter disable
         uart->h->Init.Mode &= ~UART_MODE_TX;
       }
-      status = HAL_UART_Init(uart->h);
+      status = UartInit(uart);
       return UART_HAL_STATUS(status);
 
     // Control RX
@@ -1013,7 +1544,7 @@ static int32_t UART_Control (      uint32_t         control,
         // Receiver disable
         uart->h->Init.Mode &= ~UART_MODE_RX;
       }
-      status = HAL_UART_Init(uart->h);
+      status = UartInit(uart);
       return UART_HAL_STATUS(status);
     default: break;
   }
@@ -1027,6 +1558,10 @@ static int32_t UART_Control (      uint32_t         control,
       return ARM_USART_ERROR_MODE;
 
     case ARM_USART_MODE_ASYNCHRONOUS:
+      if (uart->xfer->rx_ring != NULL) {
+        // Stop streaming receive before reconfiguration
+        return ARM_DRIVER_ERROR_BUSY;
+      }
       break;
 
     // Default TX value
@@ -1125,7 +1660,7 @@ static int32_t UART_Control (      uint32_t         control,
   uart->info->flags |= UART_FLAG_CONFIGURED;
 
   // Initialize UART
-  status = HAL_UART_Init(uart->h);
+  status = UartInit(uart);
 
   // Reconfigure DMA
   if ((uart->dma_use_tx != 0U) && (uart->h->hdmatx !=NULL)) {
@@ -1228,9 +1763,25 @@ static ARM_USART_MODEM_STATUS UART_GetModemStatus (void) {
   */
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
   const UART_RESOURCES * uart;
+#if (UART_TX_QUEUE_DEPTH > 0U)
+        UART_TX_DESC   * desc;
+#endif
 
   uart = UART_Resources (huart);
 
+#if (UART_TX_QUEUE_DEPTH > 0U)
+  if (uart->xfer->txq_cnt != 0U) {
+    // Start next queued buffer
+    desc = TxQueueGet(uart);
+    if (TxStart(uart, desc->data, desc->num, desc->dma_flag) == HAL_OK) {
+      if (uart->info->cb_event != NULL) {
+        uart->info->cb_event(ARM_USART_EVENT_SEND_COMPLETE);
+      }
+      return;
+    }
+  }
+#endif
+
   if (uart->info->cb_event != NULL) {
     uart->info->cb_event(ARM_USART_EVENT_TX_COMPLETE | ARM_USART_EVENT_SEND_COMPLETE);
   }
@@ -1283,11 +1834,91 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
     uart->info->status.rx_overflow = 1;
   }
 
+  if ((uart->xfer->rx_ring != NULL) && (huart->RxState == HAL_UART_STATE_READY)) {
+    // Reception stopped on error: resume streaming receive
+    if ((uart->xfer->rx_ring_circ != 0U) && (uart->xfer->rx_ring_pos != 0U)) {
+      // Circular DMA restarts at ring start: skip to the next ring boundary (skipped data is lost)
+      uart->xfer->rx_ring->head += uart->xfer->rx_ring->size - uart->xfer->rx_ring_pos;
+      uart->xfer->rx_ring_pos    = 0U;
+      event |= ARM_USART_EVENT_RX_OVERFLOW;
+      uart->info->status.rx_overflow = 1;
+    }
+    if (RxRingArm(uart) != HAL_OK) {
+      RxRingStop(uart);
+    }
+  }
+
   if ((event != 0) && (uart->info->cb_event != NULL)) {
     uart->info->cb_event(event);
   }
 }
 
+/**
+  * @brief Rx Event callback (half transfer, transfer complete or Rx Idle).
+  * @param huart: UART handle.
+  * @param Size: Position in reception buffer.
+  * @retval None
+  */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+  const UART_RESOURCES * uart;
+        UART_RX_RING   * ring;
+        uint32_t         pos;
+        uint32_t         num;
+        uint32_t         event;
+
+  uart = UART_Resources (huart);
+  ring = uart->xfer->rx_ring;
+
+  if (ring == NULL) {
+    return;
+  }
+
+  if (uart->xfer->rx_ring_circ != 0U) {
+    // Circular DMA: Size is ambiguous at wrap, use DMA write position
+    pos = (ring->size - __HAL_DMA_GET_COUNTER(huart->hdmarx)) & (ring->size - 1U);
+    num = (pos - uart->xfer->rx_ring_pos) & (ring->size - 1U);
+  } else {
+    pos = uart->xfer->rx_ring_seg + Size;
+    num = pos - uart->xfer->rx_ring_pos;
+    pos &= ring->size - 1U;
+  }
+
+#if (DRIVER_DCACHE_MAINTENANCE == 1U)
+  if ((uart->xfer->rx_dma_flag == 3U) && (num != 0U)) {
+    // Refresh received part of the ring (ring is cache line aligned)
+    if ((uart->xfer->rx_ring_pos + num) > ring->size) {
+      DCache_Refresh(&ring->buf[uart->xfer->rx_ring_pos], ring->size - uart->xfer->rx_ring_pos);
+      DCache_Refresh(&ring->buf[0], pos);
+    } else {
+      DCache_Refresh(&ring->buf[uart->xfer->rx_ring_pos], num);
+    }
+  }
+#endif
+
+  uart->xfer->rx_ring_pos = pos;
+  ring->head += num;
+
+  event = 0U;
+  if (num != 0U) {
+    event = UART_EVENT_RX_RING;
+  }
+  if ((ring->head - ring->tail) > ring->size) {
+    event |= ARM_USART_EVENT_RX_OVERFLOW;
+    uart->info->status.rx_overflow = 1;
+  }
+
+  if (huart->RxState == HAL_UART_STATE_READY) {
+    // Interrupt mode reception ended at ring end or Rx Idle: re-arm
+    if (RxRingArm(uart) != HAL_OK) {
+      RxRingStop(uart);
+    }
+  }
+
+  if ((event != 0U) && (uart->info->cb_event != NULL)) {
+    uart->info->cb_event(event);
+  }
+}
+
 #ifdef USART1_MODE_ASYNC
 UARTx_EXPORT_DRIVER(1);
 #endif
@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        10. July 2023
- * $Revision:    V2.4
+ * $Date:        18. October 2024
+ * $Revision:    V2.7
  *
  * Project:      UART Driver definitions for STMicroelectronics STM32H7xx
  * -------------------------------------------------------------------------- */
@@ -31,6 +31,7 @@
 #include <string.h>
 
 #include "Driver_USART.h"
+#include "UART_STM32H7xx_Ext.h"
 #include "stm32h7xx_hal.h"
 
 #include "RTE_Components.h"
@@ -48,7 +49,6 @@
                                         ((stat == HAL_TIMEOUT) ? ARM_DRIVER_ERROR_TIMEOUT : \
                                                                  ARM_DRIVER_ERROR)))
 
-
 #if (defined(ARM_USART_API_VERSION) && (ARM_USART_API_VERSION >= 0x203U))
 #define UARTx_CAPABILITIES(x)  { \
     1,                           \
@@ -631,6 +631,22 @@ ARM_DRIVER_USART Driver_USART##x = { \
 #define UART_FLAG_TX_ENABLED            ((uint8_t)(1U << 3))
 #define UART_FLAG_RX_ENABLED            ((uint8_t)(1U << 4))
 
+// Transmit queue depth (0 = Send returns busy while transmitting)
+#ifndef UART_TX_QUEUE_DEPTH
+#define UART_TX_QUEUE_DEPTH             (0U)
+#endif
+#if (UART_TX_QUEUE_DEPTH > 255U)
+#error  Too many transmit queue entries defined, maximum value of UART_TX_QUEUE_DEPTH is 255 !!!
+#endif
+
+// Transmit queue entry
+typedef struct {
+  const uint8_t *data;                  // Pointer to data
+  uint16_t  num;                        // Number of data items
+  uint8_t   dma_flag;                   // DMA used for transfer
+  uint8_t   reserved;
+} UART_TX_DESC;
+
 // Transfer Information (Run-Time)
 typedef struct {
   uint32_t  rx_num;                     // Total number of receive data
@@ -639,6 +655,19 @@ typedef struct {
   uint16_t  def_val;                    // Default transfer value
   uint8_t   rx_dma_flag;                // DMA used for transfer
   uint8_t   tx_dma_flag;                // DMA used for transfer
+  UART_RX_RING *rx_ring;                // Streaming receive ring (NULL when not active)
+  uint32_t  rx_ring_pos;                // Ring position of last reported data
+  uint32_t  rx_ring_seg;                // Ring position where current reception started
+  uint8_t   rx_ring_circ;               // Circular DMA used for streaming receive
+  uint8_t   reserved[3];
+#if (UART_TX_QUEUE_DEPTH > 0U)
+  UART_TX_DESC txq[UART_TX_QUEUE_DEPTH]; // Transmit queue
+  uint8_t   txq_rd;                     // Transmit queue read index
+  uint8_t   txq_wr;                     // Transmit queue write index
+  uint8_t   txq_cnt;                    // Number of queued transmit buffers
+  uint8_t   reserved_txq;
+  void   (*txq_dma_cplt)(DMA_HandleTypeDef *hdma);    // HAL Tx DMA complete handler
+#endif
 } UART_TRANSFER_INFO;
 
 // Status Information (Run-time)
@@ -658,7 +687,8 @@ typedef struct {
   ARM_USART_SignalEvent_t  cb_event;    // Event Callback
   volatile UART_STATUS     status;      // Status flags
   uint8_t                  flags;       // Current USART flags
-  uint8_t                  reserved[3];
+  uint8_t                  fifo;        // FIFO mode: bit 7 = enabled, bits 0..6 = thresholds
+  uint16_t                 brr;         // Baud rate register value for configured baud rate
 } UART_INFO;
 
 // Resources definition
@@ -0,0 +1,107 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      UART Driver vendor extensions for STMicroelectronics STM32H7xx
+ * -------------------------------------------------------------------------- */
+
+#ifndef __UART_STM32H7XX_EXT_H
+#define __UART_STM32H7XX_EXT_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "cmsis_compiler.h"
+#include "Driver_USART.h"
+
+// Vendor specific Control codes
+#define UART_CONTROL_RX_RING            (0x80UL << ARM_USART_CONTROL_Pos)   // Start streaming receive; arg = pointer to UART_RX_RING (0 = stop)
+#define UART_CONTROL_OVERSAMPLING       (0x81UL << ARM_USART_CONTROL_Pos)   // Set oversampling; arg = 16 (default) or 8
+#define UART_CONTROL_FIFO               (0x82UL << ARM_USART_CONTROL_Pos)   // Configure FIFO mode; arg = UART_FIFO_ENABLE | thresholds (0 = disable)
+#define UART_CONTROL_AUTO_BAUD          (0x83UL << ARM_USART_CONTROL_Pos)   // Start auto baud rate detection; arg = UART_AUTO_BAUD_xxx (0 = disable)
+#define UART_GET_AUTO_BAUD              (0x84UL << ARM_USART_CONTROL_Pos)   // Get detected baud rate; arg = pointer to uint32_t
+
+// UART_CONTROL_FIFO arguments
+#define UART_FIFO_ENABLE                (1UL << 8)      // Enable FIFO mode
+#define UART_FIFO_TX_THRESHOLD(x)       ((x) & 7UL)     // Tx FIFO threshold (UART_FIFO_THRESHOLD_xxx)
+#define UART_FIFO_RX_THRESHOLD(x)       (((x) & 7UL) << 4)  // Rx FIFO threshold (UART_FIFO_THRESHOLD_xxx)
+#define UART_FIFO_THRESHOLD_1_8         (0UL)           // FIFO threshold: 1/8 of depth
+#define UART_FIFO_THRESHOLD_1_4         (1UL)           // FIFO threshold: 1/4 of depth
+#define UART_FIFO_THRESHOLD_1_2         (2UL)           // FIFO threshold: 1/2 of depth
+#define UART_FIFO_THRESHOLD_3_4         (3UL)           // FIFO threshold: 3/4 of depth
+#define UART_FIFO_THRESHOLD_7_8         (4UL)           // FIFO threshold: 7/8 of depth
+#define UART_FIFO_THRESHOLD_8_8         (5UL)           // FIFO threshold: Tx FIFO empty, Rx FIFO full
+
+// UART_CONTROL_AUTO_BAUD arguments
+#define UART_AUTO_BAUD_START_BIT        (1UL)           // Measure start bit
+#define UART_AUTO_BAUD_FALLING_EDGE     (2UL)           // Measure falling edge to falling edge (character with LSB 1)
+#define UART_AUTO_BAUD_0x7F             (3UL)           // Detect on 0x7F character
+#define UART_AUTO_BAUD_0x55             (4UL)           // Detect on 0x55 character
+
+// Vendor specific Events
+#define UART_EVENT_RX_RING              (1UL << 31)     // New data available in streaming receive ring
+
+// Streaming receive ring (single producer: driver, single consumer: application)
+typedef struct {
+  uint8_t                 *buf;         // Ring buffer
+  uint32_t                 size;        // Ring size in bytes (power of 2, max 32768)
+  volatile uint32_t        head;        // Number of bytes received (free-running, written by driver)
+  volatile uint32_t        tail;        // Number of bytes read (free-running, written by application)
+} UART_RX_RING;
+
+/**
+  Read data from streaming receive ring.
+  \param[in]    ring   Pointer to ring started with UART_CONTROL_RX_RING
+  \param[out]   data   Pointer to buffer for read data
+  \param[in]    num    Maximum number of bytes to read
+  \return       number of bytes read (pending data is discarded on ring overflow)
+*/
+__STATIC_INLINE uint32_t UART_RxRingRead (UART_RX_RING *ring, uint8_t *data, uint32_t num) {
+  uint32_t head, tail, pos, cnt;
+
+  head = ring->head;
+  tail = ring->tail;
+
+  if ((head - tail) > ring->size) {
+    // Unread data was overwritten: resynchronize with the producer
+    ring->tail = head;
+    return 0U;
+  }
+  if (num > (head - tail)) {
+    num = head - tail;
+  }
+  __DMB();                              // Read data only after head
+
+  pos = tail & (ring->size - 1U);
+  cnt = ring->size - pos;
+  if (cnt > num) {
+    cnt = num;
+  }
+  memcpy(data, &ring->buf[pos], cnt);
+  memcpy(&data[cnt], &ring->buf[0], num - cnt);
+  __DMB();                              // Release data before tail
+
+  ring->tail = tail + num;
+
+  return num;
+}
+
+#endif /* __UART_STM32H7XX_EXT_H */
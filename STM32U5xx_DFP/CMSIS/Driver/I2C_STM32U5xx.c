@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        10. July 2023
- * $Revision:    V1.1
+ * $Date:        18. October 2024
+ * $Revision:    V1.2
  *
  * Driver:       Driver_I2C1/2/3/4/5/6
  *
@@ -30,6 +30,9 @@
 
 # Revision History
 
+- Version 1.2
+  - Replaced exhaustive TIMING register search with a closed-form solver
+  - Added cache of computed TIMING register values (I2C_TIMING_CACHE_SIZE)
 - Version 1.1
   - Updated PowerControl function (added check if Instance is valid)
   - Updated Control function implementation for transfer abort (added check for master mode)
@@ -91,6 +94,8 @@ I2C5_DNF_COEFFICIENT               |     **0**     |   0   | I2C5 digital noise
 ^                                  |       ^       | 1..15 | I2C5 digital noise filter coefficient number
 I2C6_DNF_COEFFICIENT               |     **0**     |   0   | I2C6 digital noise filter coefficient: **disabled**
 ^                                  |       ^       | 1..15 | I2C6 digital noise filter coefficient number
+I2C_TIMING_CACHE_SIZE              |     **4**     |   0   | TIMING register cache: **disabled**
+^                                  |       ^       | 1..32 | Number of cached TIMING register values (kernel clock, bus speed, filters)
 
 ## STM32CubeMX
 
@@ -262,7 +267,7 @@ Generate source code by clicking on the **GENERATE CODE** button on the toolbar.
 
 #ifdef  I2C_CUBE_MX_ENABLED
 
-#define ARM_I2C_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,1)    /* driver version */
+#define ARM_I2C_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,2)    /* driver version */
 
 /* Analog noise filter state: 0 - disable, 1 - enable */
 #ifndef I2C1_ANF_ENABLE
@@ -304,6 +309,14 @@ Generate source code by clicking on the **GENERATE CODE** button on the toolbar.
 #define I2C6_DNF_COEFFICIENT            0
 #endif
 
+/* TIMING register cache: 0 - disable, [1:32] - number of entries */
+#ifndef I2C_TIMING_CACHE_SIZE
+#define I2C_TIMING_CACHE_SIZE           (4U)
+#endif
+#if    (I2C_TIMING_CACHE_SIZE > 32U)
+#error  "I2C_TIMING_CACHE_SIZE value invalid (must be 0..32)!!!"
+#endif
+
 /* Driver Version */
 static const ARM_DRIVER_VERSION DriverVersion = {
   ARM_I2C_API_VERSION,
@@ -518,6 +531,13 @@ static I2C_RESOURCES *I2C_GetResources   (I2C_HandleTypeDef *hi2c);
 static uint32_t       I2C_GetPeriClock   (I2C_TypeDef *i2c);
 static int32_t        I2C_GetSCLRatio    (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec, I2C_TIMING *cfg);
 static uint32_t       I2C_GetTimingValue (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec);
+static uint32_t       I2C_GetTiming      (I2C_RESOURCES *i2c, uint32_t fpclk, uint32_t fscl, I2C_STD_TIME *spec);
+
+#if (I2C_TIMING_CACHE_SIZE > 0U)
+/* TIMING register cache (shared by all instances) */
+static I2C_TIMING_CACHE I2C_TimingCache[I2C_TIMING_CACHE_SIZE];
+static uint32_t         I2C_TimingCacheNext;
+#endif
 
 /* Retrieve pointer to I2C instance resources */
 static I2C_RESOURCES *I2C_GetResources (I2C_HandleTypeDef *hi2c) {
@@ -585,9 +605,8 @@ static uint32_t I2C_GetPeriClock (I2C_TypeDef *i2c) {
 static int32_t I2C_GetSCLRatio (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec, I2C_TIMING *cfg) {
   uint32_t clk_max, clk_min;
   uint32_t tpresc, tsync;
-  uint32_t tscl, tscll, tsclh;
-  uint32_t scll, sclh;
-  int32_t  err;
+  uint32_t tscl, tmin;
+  uint32_t scll, sclh, n;
 
   /* Set minimum bus clock frequency to 80% of max */
   clk_min = (spec->clk_max * 80) / 100;
@@ -598,38 +617,53 @@ static int32_t I2C_GetSCLRatio (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec, I2C_TI
   tsync   = setup->afd_min + setup->dfd + (2 * setup->i2cclk);
   tpresc = (cfg->presc + 1) * setup->i2cclk;
 
-  err = 0;
-
-  /* Evaluate all values of SCLL and SCLH */
-  for (scll = 0; scll < I2C_TIMINGR_SCLL_MAX; scll++) {
-    tscll = ((scll + 1) * tpresc) + tsync;
-
-    if ((tscll >= spec->scll_min) && (setup->i2cclk < ((tscll - setup->afd_min - setup->dfd) / 4))) {
-      /* SCL low meets specification */
+  /* tSCLL = (SCLL + 1) * tPRESC + tSYNC: lowest SCLL meeting SCL low specification */
+  tmin = (uint32_t)setup->afd_min + setup->dfd + (4U * (setup->i2cclk + 1U));
+  if (tmin < spec->scll_min) {
+    tmin = spec->scll_min;
+  }
+  scll = (tmin > (tpresc + tsync)) ? (((tmin - tsync) + tpresc - 1) / tpresc) - 1 : 0;
 
-      for (sclh = 0; sclh < I2C_TIMINGR_SCLH_MAX; sclh++) {
-        tsclh = ((sclh + 1) * tpresc) + tsync;
+  /* tSCLH = (SCLH + 1) * tPRESC + tSYNC: lowest SCLH meeting SCL high specification */
+  tmin = spec->sclh_min;
+  if (tmin < (setup->i2cclk + 1U)) {
+    tmin = setup->i2cclk + 1U;
+  }
+  sclh = (tmin > (tpresc + tsync)) ? (((tmin - tsync) + tpresc - 1) / tpresc) - 1 : 0;
 
-        if ((tsclh >= spec->sclh_min) && (tsclh > setup->i2cclk)) {
-          /* SCL high meets specification */
-          tscl = tscll + tsclh;
+  if ((scll >= I2C_TIMINGR_SCLL_MAX) || (sclh >= I2C_TIMINGR_SCLH_MAX)) {
+    /* No solution */
+    return (-1);
+  }
 
-          if ((tscl >= clk_min) && (tscl <= clk_max)) {
-            /* Evaluate SCL period error */
-            err = (int32_t)(tscl - setup->busclk);
+  /* tSCL = (SCLL + SCLH + 2) * tPRESC + 2 * tSYNC: lowest sum not below bus clock period */
+  tmin = (setup->busclk > clk_min) ? setup->busclk : clk_min;
+  n    = (tmin > ((2 * tpresc) + (2 * tsync))) ? (((tmin - (2 * tsync)) + tpresc - 1) / tpresc) - 2 : 0;
+  if (n < (scll + sclh)) {
+    n = scll + sclh;
+  }
 
-            if (err >= 0) {
-              cfg->sclh = (uint8_t)sclh;
-              cfg->scll = (uint8_t)scll;
-              return (err);
-            }
-          }
-        }
-      }
+  /* Extend SCL low when SCL high alone cannot cover the period */
+  if ((n - scll) >= I2C_TIMINGR_SCLH_MAX) {
+    scll = n - (I2C_TIMINGR_SCLH_MAX - 1);
+    if (scll >= I2C_TIMINGR_SCLL_MAX) {
+      /* No solution */
+      return (-1);
     }
   }
-  /* No solution */
-  return (-1);
+  sclh = n - scll;
+
+  tscl = ((n + 2) * tpresc) + (2 * tsync);
+  if (tscl > clk_max) {
+    /* No solution */
+    return (-1);
+  }
+
+  cfg->sclh = (uint8_t)sclh;
+  cfg->scll = (uint8_t)scll;
+
+  /* SCL period error */
+  return ((int32_t)(tscl - setup->busclk));
 }
 
 /* TIMING setup: Determine TIMING register settings based on input structures */
@@ -637,8 +671,8 @@ static uint32_t I2C_GetTimingValue (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec) {
   I2C_TIMING time;
   uint32_t dnf_en;
   uint32_t presc;
-  uint32_t sdadel, sdadel_min, sdadel_max;
-  uint32_t scldel, scldel_min;
+  uint32_t sdadel_min, sdadel_max;
+  uint32_t scldel_min;
   uint32_t p, l, a;
   uint32_t timing;
   int32_t  val, err;
@@ -674,50 +708,114 @@ static uint32_t I2C_GetTimingValue (I2C_CLK_SETUP *setup, I2C_STD_TIME *spec) {
   /* Set timing register max value */
   timing = 0xF0FFFFFF;
 
-  /* Evaluate all values of PRESC, SCLDEL and SDADEL */
+  /* SCL low/high ratio depends on PRESC only: evaluate each PRESC once, with
+     the lowest SCLDEL and SDADEL within limits (lowest PRESC wins on equal error) */
   for (p = 0; p < I2C_TIMINGR_PRESC_MAX; p++) {
     presc = (p + 1) * setup->i2cclk;
 
-    for (l = 0; l < I2C_TIMINGR_SCLDEL_MAX; l++) {
-      /* tSCLDEL = (SCLDEL + 1) * ((PRESC + 1) * tI2CCLK) */
-      scldel = (l + 1) * presc;
-
-      if (scldel >= scldel_min) {
-        /* SCLDEL is above low limit, evaluate SDADEL */
-        for (a = 0; a < I2C_TIMINGR_SDADEL_MAX; a++) {
-          /* tSDADEL = SDADEL * ((PRESC + 1) * tI2CCLK) */
-          sdadel = a * presc;
-
-          if ((sdadel >= sdadel_min) && (sdadel <= sdadel_max)) {
-            /* Valid presc (p), scldel (l) and sdadel (a) */
-            time.presc  = (uint8_t)p;
-            time.scldel = (uint8_t)l;
-            time.sdadel = (uint8_t)a;
-
-            /* Determine SCLL and SCLH values */
-            err = I2C_GetSCLRatio (setup, spec, &time);
-
-            if (err >= 0) {
-              if (err < setup->error) {
-                /* Truncate error since it will never be bigger than 16-bit */
-                setup->error = (uint16_t)err;
-
-                /* Save timing settings */
-                timing  = (time.scll   & 0xFFU);
-                timing |= (time.sclh   & 0xFFU) <<  8;
-                timing |= (time.sdadel & 0x0FU) << 16;
-                timing |= (time.scldel & 0x0FU) << 20;
-                timing |= (time.presc  & 0x0FU) << 28;
-              }
-            }
-          }
-        }
+    /* tSCLDEL = (SCLDEL + 1) * ((PRESC + 1) * tI2CCLK) */
+    l = (scldel_min + presc - 1) / presc;
+    l = (l > 0U) ? (l - 1U) : 0U;
+
+    /* tSDADEL = SDADEL * ((PRESC + 1) * tI2CCLK) */
+    a = (sdadel_min + presc - 1) / presc;
+
+    if ((l >= I2C_TIMINGR_SCLDEL_MAX) || (a >= I2C_TIMINGR_SDADEL_MAX) || ((a * presc) > sdadel_max)) {
+      /* No valid SCLDEL or SDADEL for this PRESC */
+      continue;
+    }
+
+    time.presc  = (uint8_t)p;
+    time.scldel = (uint8_t)l;
+    time.sdadel = (uint8_t)a;
+
+    /* Determine SCLL and SCLH values */
+    err = I2C_GetSCLRatio (setup, spec, &time);
+
+    if ((err >= 0) && (err < setup->error)) {
+      /* Truncate error since it will never be bigger than 16-bit */
+      setup->error = (uint16_t)err;
+
+      /* Save timing settings */
+      timing  = (time.scll   & 0xFFU);
+      timing |= (time.sclh   & 0xFFU) <<  8;
+      timing |= (time.sdadel & 0x0FU) << 16;
+      timing |= (time.scldel & 0x0FU) << 20;
+      timing |= (time.presc  & 0x0FU) << 28;
+
+      if (err == 0) {
+        /* Exact bus clock */
+        break;
       }
     }
   }
 
   return (timing);
 }
+/* TIMING setup: end of solver (host cross-check in Tools/I2CTiming) */
+
+/* TIMING setup: Get TIMING register value for kernel and bus clock (cached) */
+static uint32_t I2C_GetTiming (I2C_RESOURCES *i2c, uint32_t fpclk, uint32_t fscl, I2C_STD_TIME *spec) {
+  I2C_CLK_SETUP clk_setup;
+  uint32_t timing;
+#if (I2C_TIMING_CACHE_SIZE > 0U)
+  I2C_TIMING_CACHE *entry;
+  uint32_t primask;
+  uint32_t i;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  for (i = 0U; i < I2C_TIMING_CACHE_SIZE; i++) {
+    entry = &I2C_TimingCache[i];
+
+    if ((entry->fpclk == fpclk) && (entry->fscl == fscl) &&
+        (entry->dnf   == i2c->dnf_coef) && (entry->anf == i2c->anf_enable)) {
+      timing = entry->timing;
+      __set_PRIMASK(primask);
+      return (timing);
+    }
+  }
+
+  __set_PRIMASK(primask);
+#endif
+
+  /* Determine peripheral and bus clock period (ns) */
+  clk_setup.i2cclk = (uint16_t)((1000000000 + (fpclk / 2)) / fpclk);
+  clk_setup.busclk = (uint16_t)((1000000000 + (fscl  / 2)) / fscl);
+
+  /* Determine digital filter delay (ns) */
+  clk_setup.dfd = clk_setup.i2cclk * i2c->dnf_coef;
+
+  /* Set analog filter delay (ns) */
+  clk_setup.afd_min = ((i2c->anf_enable != 0U) ? (I2C_ANALOG_FILTER_DELAY_MIN) : (0));
+  clk_setup.afd_max = ((i2c->anf_enable != 0U) ? (I2C_ANALOG_FILTER_DELAY_MAX) : (0));
+
+  /* Set max iteration error */
+  clk_setup.error  = 0xFFFF;
+
+  /* Get TIMING register values */
+  timing = I2C_GetTimingValue (&clk_setup, spec);
+
+#if (I2C_TIMING_CACHE_SIZE > 0U)
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  /* Replace entries in round-robin order */
+  entry = &I2C_TimingCache[I2C_TimingCacheNext];
+  I2C_TimingCacheNext = (I2C_TimingCacheNext + 1U) % I2C_TIMING_CACHE_SIZE;
+
+  entry->fpclk  = fpclk;
+  entry->fscl   = fscl;
+  entry->dnf    = (uint8_t)i2c->dnf_coef;
+  entry->anf    = (uint8_t)i2c->anf_enable;
+  entry->timing = timing;
+
+  __set_PRIMASK(primask);
+#endif
+
+  return (timing);
+}
 
 /**
   \fn          ARM_DRV_VERSION I2C_GetVersion (void)
@@ -1196,7 +1294,6 @@ static int32_t I2C_Control (uint32_t control, uint32_t arg, I2C_RESOURCES *i2c)
   uint32_t i, val;
   uint32_t fpclk, fscl;
 
-  I2C_CLK_SETUP  clk_setup;
   I2C_STD_TIME  *clk_spec;
 
   if ((i2c->info->flags & I2C_POWER) == 0U) {
@@ -1259,22 +1356,8 @@ static int32_t I2C_Control (uint32_t control, uint32_t arg, I2C_RESOURCES *i2c)
           return ARM_DRIVER_ERROR_UNSUPPORTED;
       }
 
-      /* Determine peripheral and bus clock period (ns) */
-      clk_setup.i2cclk = (uint16_t)((1000000000 + (fpclk / 2)) / fpclk);
-      clk_setup.busclk = (uint16_t)((1000000000 + (fscl  / 2)) / fscl);
-
-      /* Determine digital filter delay (ns) */
-      clk_setup.dfd = clk_setup.i2cclk * i2c->dnf_coef;
-
-      /* Set analog filter delay (ns) */
-      clk_setup.afd_min = ((i2c->anf_enable != 0U) ? (I2C_ANALOG_FILTER_DELAY_MIN) : (0));
-      clk_setup.afd_max = ((i2c->anf_enable != 0U) ? (I2C_ANALOG_FILTER_DELAY_MAX) : (0));
-
-      /* Set max iteration error */
-      clk_setup.error  = 0xFFFF;
-
       /* Get TIMING register values */
-      val = I2C_GetTimingValue (&clk_setup, clk_spec);
+      val = I2C_GetTiming (i2c, fpclk, fscl, clk_spec);
 
       /* Set register values */
       i2c->reg->CR1    &= ~I2C_CR1_PE;
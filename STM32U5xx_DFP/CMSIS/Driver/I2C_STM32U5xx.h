@@ -108,6 +108,16 @@ typedef struct {
   uint8_t                 scll;                 // Timing register value SCLL[7:0]
 } I2C_TIMING;
 
+/* I2C TIMING register cache entry */
+typedef struct {
+  uint32_t                fpclk;                // Kernel clock frequency (Hz), 0 = unused entry
+  uint32_t                fscl;                 // Bus clock frequency (Hz)
+  uint8_t                 dnf;                  // Digital noise filter coefficient
+  uint8_t                 anf;                  // Analog noise filter enabled
+  uint16_t                reserved;
+  uint32_t                timing;               // TIMING register value
+} I2C_TIMING_CACHE;
+
 /* I2C Input/Output Configuration */
 typedef const struct {
   GPIO_TypeDef           *scl_port;             // SCL IO Port
@@ -1,5 +1,5 @@
 /* -----------------------------------------------------------------------------
- * Copyright (c) 2023 Arm Limited (or its affiliates).
+ * Copyright (c) 2023-2024 Arm Limited (or its affiliates).
  * All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        23. February 2023
- * $Revision:    V1.0
+ * $Date:        18. October 2024
+ * $Revision:    V1.2
  *
  * Driver:       Driver_MCI0, Driver_MCI1
  *
@@ -30,6 +30,10 @@
 
 # Revision History
 
+- Version 1.2
+  - Added SDR50/SDR104 and MMC HS200 bus modes with delay block sampling clock tuning
+- Version 1.1
+  - Added scatter-gather transfers using IDMA linked list mode (MCI_CONTROL_SG_LIST)
 - Version 1.0
   - Initial release
 
@@ -42,6 +46,47 @@ Driver Instance     | Hardware Resource
 Driver_MCI0         | SDMMC1
 Driver_MCI1         | SDMMC2
 
+# Scatter-Gather Transfers
+
+Vendor specific control code **MCI_CONTROL_SG_LIST** sets a list of (buffer, length) segments for the
+next SetupTransfer (arg = pointer to **MCI_SG_LIST**). The driver builds SDMMC IDMA linked list nodes
+from the segments, so a single multi-block command reads or writes non-contiguous buffers without
+intermediate copies.
+
+SetupTransfer must then be called with **data** pointing to the first segment and the segment lengths
+must add up to block_count * block_size. Segment buffers must be word aligned and segment lengths must be
+a multiple of 32 Bytes (max 65504 Bytes). The list must remain valid until the transfer is completed.
+The list is consumed by the SetupTransfer call that starts the transfer; if SetupTransfer returns an error
+the list remains set for the next call (AbortTransfer discards it).
+The number of segments is limited by **MCI_SG_SEG_MAX** (default 8).
+
+# UHS-I and HS200 Bus Modes
+
+Bus speed modes **ARM_MCI_BUS_UHS_SDR50**, **ARM_MCI_BUS_UHS_SDR104** and **MCI_BUS_MMC_HS200** (MMC HS200,
+equivalent to SDR104 on the controller side) sample received data with the SDMMC feedback clock routed through
+the delay block (DLYB). The delay block is calibrated to the bus clock when the mode is selected and again when
+tuning is reset, therefore ARM_MCI_BUS_SPEED must be set before.
+
+The sampling point is tuned with **ARM_MCI_UHS_TUNING_OPERATION** and **ARM_MCI_UHS_TUNING_RESULT**:
+  1. Control(ARM_MCI_UHS_TUNING_OPERATION, 0): reset, calibrate the delay line and select the first phase
+  2. Send tuning command SEND_TUNING_BLOCK (CMD19, SD) or SEND_TUNING_BLOCK_HS200 (CMD21, MMC) with
+     the tuning block read and wait for the transfer to finish
+  3. Control(ARM_MCI_UHS_TUNING_OPERATION, 1): evaluate the tuning block (no CRC error nor timeout)
+     and select the next phase
+  4. Control(ARM_MCI_UHS_TUNING_RESULT, 0) returns 1 while phases remain (continue with step 2),
+     0 when tuning is done or -1 when no phase received the tuning block correctly
+
+When all phases are tested the centre of the longest window of passing phases is selected. A short data
+timeout (ARM_MCI_DATA_TIMEOUT) speeds up tuning as failing phases may not receive the tuning block at all.
+
+UHS-I SD cards require 1.8V signaling. Define **MemoryCard_UHS0** (SDMMC1) or **MemoryCard_UHS1** (SDMMC2)
+when the board supports it and implement function **MCI_DriveTransceiver_1V8** in the application.
+CardPower with ARM_MCI_POWER_VCCQ_1V8 after VOLTAGE_SWITCH (CMD11) then completes the voltage switch sequence
+and calls MCI_DriveTransceiver_1V8 to switch the transceiver to 1.8V. The definition also enables the UHS-I
+capabilities (uhs_signaling, uhs_tuning, uhs_sdr50, uhs_sdr104, vccq_1v8) and the delay block. Without
+MemoryCard_UHS0/1 the delay block code is not compiled, stm32u5xx_ll_dlyb.c is not required and
+ARM_MCI_UHS_TUNING_OPERATION returns ARM_DRIVER_ERROR_UNSUPPORTED.
+
 # Configuration
 
 ## STM32CubeMX
@@ -54,6 +99,8 @@ The MCI driver requires:
   - When using MMC devices:
     - Define **MemoryCard_MMC0** if SDMMC1 uses MMC device (otherwise define is not required)
     - Define **MemoryCard_MMC1** if SDMMC2 uses MMC device (otherwise define is not required)
+  - When using SDR50, SDR104 or HS200 bus modes (MemoryCard_UHS0/1 defined):
+    - **stm32u5xx_ll_dlyb.c** HAL driver source added to the project
 
 Optional configuration:
   - Card Detect Pin:
@@ -69,6 +116,12 @@ Optional configuration:
       - default value is 1U
     - **define Driver_MCI1_DCache {value}**
       - value set as for MCI0 instance (see above)
+  - 1.8V Signaling (UHS-I):
+    - **define MemoryCard_UHS0** if SDMMC1 supports 1.8V signaling and **implement function MCI_DriveTransceiver_1V8** in application
+    - **define MemoryCard_UHS1** if SDMMC2 supports 1.8V signaling (see above)
+  - Scatter-Gather Transfers:
+    - **define MCI_SG_SEG_MAX {value}**
+      - maximum number of segments per transfer (default value is 8U)
 
 # STM32U575I-EV Board Configuration
 
@@ -170,7 +223,7 @@ Generate source code by clicking on the **GENERATE CODE** button on the toolbar.
 
 #include "MCI_STM32U5xx.h"
 
-#define ARM_MCI_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,0)  /* driver version */
+#define ARM_MCI_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,2)  /* driver version */
 
 /* MCI0: Define Card Detect pin active state */
 #if !defined(MemoryCard_CD0_Pin_Active)
@@ -234,6 +287,23 @@ Generate source code by clicking on the **GENERATE CODE** button on the toolbar.
   #define MCI1_HANDLE_TYPE      1U
 #endif
 
+/* MCI0: Define MemoryCard_UHS0 if SDMMC1 supports 1.8V signaling */
+#if defined(MemoryCard_UHS0) && defined(DLYB_SDMMC1)
+  #define MCI0_UHS              1U
+#else
+  #define MCI0_UHS              0U
+#endif
+
+/* MCI1: Define MemoryCard_UHS1 if SDMMC2 supports 1.8V signaling */
+#if defined(MemoryCard_UHS1) && defined(DLYB_SDMMC2)
+  #define MCI1_UHS              1U
+#else
+  #define MCI1_UHS              0U
+#endif
+
+/* Voltage switch sequence timeout in ms */
+#define MCI_VSWITCH_TIMEOUT     (20U)
+
 /* MCI0: DCACHE maintenance operations: 0U = disable, 1U = enable */
 #if !defined(Driver_MCI0_DCache)
   #define MCI0_DCACHE_MAINTENANCE   1U
@@ -292,6 +362,12 @@ static MCI_INFO MCI0_Info = {
   0U,
   0U,
   0U,
+  0U,
+  NULL,
+  {{0U, 0U, 0U}},
+  0U,
+  0U,
+  0U,
   0U
 };
 
@@ -310,7 +386,12 @@ static MCI_RESOURCES MCI0_Resources = {
   #else
   NULL,
   #endif
-  &MCI0_Info
+  &MCI0_Info,
+  #if (MCI0_UHS != 0U)
+  DLYB_SDMMC1
+  #else
+  NULL
+  #endif
 };
 
 /* MCI0 Driver Capabilities */
@@ -321,17 +402,17 @@ static const ARM_MCI_CAPABILITIES MCI0_DriverCapabilities = {
   0U,                                             /* vdd               */
   0U,                                             /* vdd_1v8           */
   0U,                                             /* vccq              */
-  0U,                                             /* vccq_1v8          */
+  MCI0_UHS,                                       /* vccq_1v8          */
   0U,                                             /* vccq_1v2          */
   MCI0_BUS_WIDTH_4,                               /* data_width_4      */
   MCI0_BUS_WIDTH_8,                               /* data_width_8      */
   0U,                                             /* data_width_4_ddr  */
   0U,                                             /* data_width_8_ddr  */
   1U,                                             /* high_speed        */
-  0U,                                             /* uhs_signaling     */
-  0U,                                             /* uhs_tuning        */
-  0U,                                             /* uhs_sdr50         */
-  0U,                                             /* uhs_sdr104        */
+  MCI0_UHS,                                       /* uhs_signaling     */
+  MCI0_UHS,                                       /* uhs_tuning        */
+  MCI0_UHS,                                       /* uhs_sdr50         */
+  MCI0_UHS,                                       /* uhs_sdr104        */
   0U,                                             /* uhs_ddr50         */
   0U,                                             /* uhs_driver_type_a */
   0U,                                             /* uhs_driver_type_c */
@@ -390,6 +471,12 @@ static MCI_INFO MCI1_Info = {
   0U,
   0U,
   0U,
+  0U,
+  NULL,
+  {{0U, 0U, 0U}},
+  0U,
+  0U,
+  0U,
   0U
 };
 
@@ -408,7 +495,12 @@ static MCI_RESOURCES MCI1_Resources = {
   #else
   NULL,
   #endif
-  &MCI1_Info
+  &MCI1_Info,
+  #if (MCI1_UHS != 0U)
+  DLYB_SDMMC2
+  #else
+  NULL
+  #endif
 };
 
 /* MCI1 Driver Capabilities */
@@ -419,17 +511,17 @@ static const ARM_MCI_CAPABILITIES MCI1_DriverCapabilities = {
   0U,                                             /* vdd               */
   0U,                                             /* vdd_1v8           */
   0U,                                             /* vccq              */
-  0U,                                             /* vccq_1v8          */
+  MCI1_UHS,                                       /* vccq_1v8          */
   0U,                                             /* vccq_1v2          */
   MCI1_BUS_WIDTH_4,                               /* data_width_4      */
   MCI1_BUS_WIDTH_8,                               /* data_width_8      */
   0U,                                             /* data_width_4_ddr  */
   0U,                                             /* data_width_8_ddr  */
   1U,                                             /* high_speed        */
-  0U,                                             /* uhs_signaling     */
-  0U,                                             /* uhs_tuning        */
-  0U,                                             /* uhs_sdr50         */
-  0U,                                             /* uhs_sdr104        */
+  MCI1_UHS,                                       /* uhs_signaling     */
+  MCI1_UHS,                                       /* uhs_tuning        */
+  MCI1_UHS,                                       /* uhs_sdr50         */
+  MCI1_UHS,                                       /* uhs_sdr104        */
   0U,                                             /* uhs_ddr50         */
   0U,                                             /* uhs_driver_type_a */
   0U,                                             /* uhs_driver_type_c */
@@ -702,6 +794,13 @@ static int32_t PowerControl (ARM_POWER_STATE state, MCI_RESOURCES *mci) {
 
   switch (state) {
     case ARM_POWER_OFF:
+#if (MCI_DLYB != 0U)
+      if (mci->dlyb != NULL) {
+        /* Disable delay block */
+        LL_DLYB_Disable ((DLYB_TypeDef *)mci->dlyb);
+      }
+#endif
+
       /* Reset/Dereset SDMMC peripheral */
       Control_SDMMC_Reset (mci->reg);
 
@@ -717,7 +816,7 @@ static int32_t PowerControl (ARM_POWER_STATE state, MCI_RESOURCES *mci) {
       mci->info->status.sdio_interrupt   = 0U;
       mci->info->status.ccs              = 0U;
 
-      mci->info->flags &= ~MCI_POWER;
+      mci->info->flags &= ~(MCI_POWER | MCI_TUNING);
       break;
 
     case ARM_POWER_FULL:
@@ -768,6 +867,58 @@ static int32_t PowerControl (ARM_POWER_STATE state, MCI_RESOURCES *mci) {
 }
 
 
+#if (MCI0_UHS != 0U) || (MCI1_UHS != 0U)
+/**
+  \fn            int32_t VoltageSwitch (MCI_RESOURCES *mci)
+  \brief         Complete voltage switch sequence started by VOLTAGE_SWITCH (CMD11).
+  \param[in]     mci   Pointer to MCI resources
+  \return        \ref execution_status
+*/
+static int32_t VoltageSwitch (MCI_RESOURCES *mci) {
+  uint32_t instance, tick;
+
+  instance = (mci->reg == SDMMC1) ? 0U : 1U;
+
+  /* Wait until SDMMC_CK is stopped after CMD11 response */
+  tick = HAL_GetTick();
+  while ((mci->reg->STA & SDMMC_STA_CKSTOP) == 0U) {
+    if ((HAL_GetTick() - tick) >= MCI_VSWITCH_TIMEOUT) {
+      return ARM_DRIVER_ERROR_TIMEOUT;
+    }
+  }
+  mci->reg->ICR = SDMMC_ICR_CKSTOPC;
+
+  /* Card must drive D0 low */
+  if ((mci->reg->STA & SDMMC_STA_BUSYD0) == 0U) {
+    mci->reg->POWER &= ~SDMMC_POWER_VSWITCHEN;
+    return ARM_DRIVER_ERROR;
+  }
+
+  /* Switch transceiver to 1.8V and start voltage switch timing */
+  MCI_DriveTransceiver_1V8 (instance, 1U);
+  mci->reg->POWER |= SDMMC_POWER_VSWITCH;
+
+  /* Wait until SDMMC_CK is restarted and D0 is released */
+  tick = HAL_GetTick();
+  while ((mci->reg->STA & SDMMC_STA_VSWEND) == 0U) {
+    if ((HAL_GetTick() - tick) >= MCI_VSWITCH_TIMEOUT) {
+      return ARM_DRIVER_ERROR_TIMEOUT;
+    }
+  }
+  mci->reg->ICR = SDMMC_ICR_VSWENDC;
+
+  mci->reg->POWER &= ~(SDMMC_POWER_VSWITCH | SDMMC_POWER_VSWITCHEN);
+
+  if ((mci->reg->STA & SDMMC_STA_BUSYD0) != 0U) {
+    /* Card did not switch to 1.8V */
+    return ARM_DRIVER_ERROR;
+  }
+
+  return ARM_DRIVER_OK;
+}
+#endif
+
+
 /**
   \fn            int32_t CardPower (uint32_t voltage)
   \brief         Set Memory Card supply voltage.
@@ -775,9 +926,23 @@ static int32_t PowerControl (ARM_POWER_STATE state, MCI_RESOURCES *mci) {
   \return        \ref execution_status
 */
 static int32_t CardPower (uint32_t voltage, MCI_RESOURCES *mci) {
-  (void)voltage;
 
   if ((mci->info->flags & MCI_POWER) == 0U) { return ARM_DRIVER_ERROR; }
+
+#if (MCI0_UHS != 0U) || (MCI1_UHS != 0U)
+  if ((voltage & ARM_MCI_POWER_VCCQ_Msk) == ARM_MCI_POWER_VCCQ_1V8) {
+    if ((mci->reg->POWER & SDMMC_POWER_VSWITCHEN) != 0U) {
+      /* VOLTAGE_SWITCH (CMD11) sent */
+      return VoltageSwitch (mci);
+    }
+  }
+  else if ((voltage & ARM_MCI_POWER_VCCQ_Msk) == ARM_MCI_POWER_VCCQ_3V3) {
+    MCI_DriveTransceiver_1V8 ((mci->reg == SDMMC1) ? 0U : 1U, 0U);
+  }
+#else
+  (void)voltage;
+#endif
+
   return ARM_DRIVER_OK;
 }
 
@@ -961,6 +1126,50 @@ static int32_t SendCommand (uint32_t cmd, uint32_t arg, uint32_t flags, uint32_t
 }
 
 
+/**
+  \fn            void SetupLinkedList (MCI_SG_LIST *sg, MCI_RESOURCES *mci)
+  \brief         Build IDMA linked list nodes from scatter-gather list and start IDMA in linked list mode.
+  \param[in]     sg    Pointer to scatter-gather list
+  \param[in]     mci   Pointer to MCI resources
+*/
+static void SetupLinkedList (MCI_SG_LIST *sg, MCI_RESOURCES *mci) {
+  MCI_LL_NODE *node = mci->info->ll;
+  uint32_t i;
+
+  for (i = 0U; i < sg->cnt; i++) {
+    node[i].idmabaser = (uint32_t)sg->seg[i].data;
+    node[i].idmabsize = sg->seg[i].len;
+
+    if ((i + 1U) < sg->cnt) {
+      /* Load next node (offset from IDMABAR): update buffer address and size */
+      node[i].idmalar = SDMMC_IDMALAR_ULA | SDMMC_IDMALAR_ULS | SDMMC_IDMALAR_ABR |
+                        (((uint32_t)&node[i + 1U] - (uint32_t)&node[0]) & SDMMC_IDMALAR_IDMALA);
+    }
+    else {
+      /* Last node */
+      node[i].idmalar = SDMMC_IDMALAR_ABR;
+    }
+  }
+
+#if defined(MX_DCACHE1) && (MX_DCACHE1 != 0U)
+  if (mci->h_dcache != NULL) {
+    /* DCache is present */
+    if (HAL_DCACHE_IsEnabled(mci->h_dcache) == 1U) {
+      /* Clean data cache: nodes are read by IDMA */
+      HAL_DCACHE_CleanByAddr (mci->h_dcache, (uint32_t *)node, sg->cnt * sizeof(MCI_LL_NODE));
+    }
+  }
+#endif
+
+  /* First node is loaded directly into registers */
+  mci->reg->IDMABAR   = (uint32_t)&node[0];
+  mci->reg->IDMALAR   = node[0].idmalar;
+  mci->reg->IDMABASER = node[0].idmabaser;
+  mci->reg->IDMABSIZE = node[0].idmabsize;
+  mci->reg->IDMACTRL  = SDMMC_IDMA_IDMABMODE | SDMMC_IDMA_IDMAEN;
+}
+
+
 /**
   \fn            int32_t SetupTransfer (uint8_t *data,
                                         uint32_t block_count,
@@ -974,7 +1183,8 @@ static int32_t SendCommand (uint32_t cmd, uint32_t arg, uint32_t flags, uint32_t
   \return        \ref execution_status
 */
 static int32_t SetupTransfer (uint8_t *data, uint32_t block_count, uint32_t block_size, uint32_t mode, MCI_RESOURCES *mci) {
-  uint32_t sz, dctrl, daddr;
+  MCI_SG_LIST *sg;
+  uint32_t sz, dctrl, daddr, i, len;
 
   if ((data == NULL) || (block_count == 0U) || (block_size == 0U)) { return ARM_DRIVER_ERROR_PARAMETER; }
 
@@ -986,9 +1196,48 @@ static int32_t SetupTransfer (uint8_t *data, uint32_t block_count, uint32_t bloc
   }
 
   daddr = (uint32_t)data;
+  sg    = NULL;
+
+  if ((mci->info->flags & MCI_SG_PEND) != 0U) {
+    sg = mci->info->sg;
+
+    /* Data must point to first segment, segments must cover the transfer */
+    len = 0U;
+    for (i = 0U; i < sg->cnt; i++) {
+      len += sg->seg[i].len;
+    }
+    if ((data != sg->seg[0].data) || (len != (block_count * block_size))) {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+  }
+
+  /* Set data block size */
+  if (block_size == 512U) {
+    sz = 9U;
+  }
+  else {
+    if (block_size > 16384U) {
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+    }
+    for (sz = 0U; sz < 14U; sz++) {
+      if (block_size & (1UL << sz)) {
+        break;
+      }
+    }
+  }
+
+  if (sg != NULL) {
+    /* Scatter-gather list is used for this transfer only */
+    mci->info->flags &= ~MCI_SG_PEND;
 
-  mci->reg->IDMABASER = daddr;
-  mci->reg->IDMACTRL  =  SDMMC_IDMA_IDMAEN;
+    SetupLinkedList (sg, mci);
+    mci->info->flags |=  MCI_DATA_SG;
+  }
+  else {
+    mci->reg->IDMABASER = daddr;
+    mci->reg->IDMACTRL  =  SDMMC_IDMA_IDMAEN;
+    mci->info->flags &= ~MCI_DATA_SG;
+  }
 
   dctrl = 0U;
 
@@ -1006,7 +1255,14 @@ static int32_t SetupTransfer (uint8_t *data, uint32_t block_count, uint32_t bloc
       /* DCache is present */
       if (HAL_DCACHE_IsEnabled(mci->h_dcache) == 1U) {
         /* Clean data cache:ensure data coherency between DMA and CPU */
-        HAL_DCACHE_CleanByAddr (mci->h_dcache, (uint32_t *)daddr, block_count * block_size);
+        if (sg != NULL) {
+          for (i = 0U; i < sg->cnt; i++) {
+            HAL_DCACHE_CleanByAddr (mci->h_dcache, (uint32_t *)sg->seg[i].data, sg->seg[i].len);
+          }
+        }
+        else {
+          HAL_DCACHE_CleanByAddr (mci->h_dcache, (uint32_t *)daddr, block_count * block_size);
+        }
       }
     }
 #endif
@@ -1017,21 +1273,6 @@ static int32_t SetupTransfer (uint8_t *data, uint32_t block_count, uint32_t bloc
     dctrl |= SDMMC_DCTRL_DTMODE;
   }
 
-  /* Set data block size */
-  if (block_size == 512U) {
-    sz = 9U;
-  }
-  else {
-    if (block_size > 16384U) {
-      return ARM_DRIVER_ERROR_UNSUPPORTED;
-    }
-    for (sz = 0U; sz < 14U; sz++) {
-      if (block_size & (1UL << sz)) {
-        break;
-      }
-    }
-  }
-
   mci->info->dlen   = block_count * block_size;
   mci->info->dctrl  = dctrl | (sz << 4);
 
@@ -1058,6 +1299,7 @@ static int32_t AbortTransfer (MCI_RESOURCES *mci) {
 
   /* Disable IDMA */
   mci->reg->IDMACTRL &= ~(SDMMC_IDMA_IDMAEN);
+  mci->info->flags   &= ~(MCI_SG_PEND | MCI_DATA_SG);
 
   /* Flush FIFO */
   mci->reg->DCTRL |= SDMMC_DCTRL_FIFORST;
@@ -1080,6 +1322,92 @@ static int32_t AbortTransfer (MCI_RESOURCES *mci) {
 }
 
 
+#if (MCI_DLYB != 0U)
+/**
+  \fn            uint32_t DelayBlockCalibrate (MCI_RESOURCES *mci)
+  \brief         Enable delay block and determine unit delay and phases per bus clock period.
+  \param[in]     mci   Pointer to MCI resources
+  \return        0 on success, 1 on error
+*/
+static uint32_t DelayBlockCalibrate (MCI_RESOURCES *mci) {
+  LL_DLYB_CfgTypeDef cfg;
+
+  LL_DLYB_Enable ((DLYB_TypeDef *)mci->dlyb);
+
+  /* Determine delay line configuration for one bus clock period */
+  if (LL_DLYB_GetClockPeriod ((DLYB_TypeDef *)mci->dlyb, &cfg) != (uint32_t)SUCCESS) {
+    return 1U;
+  }
+  mci->info->dlyb_sel  = cfg.PhaseSel;
+  mci->info->dlyb_unit = cfg.Units;
+
+  if ((mci->info->dlyb_sel == 0U) || (mci->info->dlyb_sel > DLYB_MAX_SELECT)) {
+    return 1U;
+  }
+  return 0U;
+}
+
+/**
+  \fn            void DelayBlockPhase (MCI_RESOURCES *mci, uint32_t phase)
+  \brief         Select delay block output clock phase.
+  \param[in]     mci    Pointer to MCI resources
+  \param[in]     phase  Output clock phase
+*/
+static void DelayBlockPhase (MCI_RESOURCES *mci, uint32_t phase) {
+  LL_DLYB_CfgTypeDef cfg;
+
+  cfg.Units    = mci->info->dlyb_unit;
+  cfg.PhaseSel = phase;
+  LL_DLYB_SetDelay ((DLYB_TypeDef *)mci->dlyb, &cfg);
+}
+
+/**
+  \fn            void TuningStep (MCI_RESOURCES *mci)
+  \brief         Evaluate tuning block received with current phase and select next phase.
+  \param[in]     mci   Pointer to MCI resources
+*/
+static void TuningStep (MCI_RESOURCES *mci) {
+  uint32_t i, cnt, best, best_cnt;
+
+  if ((mci->info->status.transfer_error   == 0U) &&
+      (mci->info->status.transfer_timeout == 0U) &&
+      (mci->info->status.command_error    == 0U) &&
+      (mci->info->status.command_timeout  == 0U)) {
+    /* Tuning block received correctly */
+    mci->info->tune_pass |= 1UL << mci->info->tune_phase;
+  }
+
+  mci->info->tune_phase++;
+
+  if (mci->info->tune_phase < mci->info->dlyb_sel) {
+    /* Test next phase */
+    DelayBlockPhase (mci, mci->info->tune_phase);
+    return;
+  }
+
+  /* All phases tested: select centre of the longest window of passing phases */
+  best     = 0U;
+  best_cnt = 0U;
+  cnt      = 0U;
+  for (i = 0U; i < mci->info->dlyb_sel; i++) {
+    if ((mci->info->tune_pass & (1UL << i)) != 0U) {
+      cnt++;
+      if (cnt > best_cnt) {
+        best_cnt = cnt;
+        best     = i - (cnt / 2U);
+      }
+    }
+    else {
+      cnt = 0U;
+    }
+  }
+  DelayBlockPhase (mci, best);
+
+  mci->info->flags &= ~MCI_TUNING;
+}
+#endif
+
+
 /**
   \fn            int32_t Control (uint32_t control, uint32_t arg)
   \brief         Control MCI Interface.
@@ -1090,6 +1418,7 @@ static int32_t AbortTransfer (MCI_RESOURCES *mci) {
 static int32_t Control (uint32_t control, uint32_t arg, MCI_RESOURCES *mci) {
   GPIO_InitTypeDef GPIO_InitStruct;
   GPIO_TypeDef *port;
+  MCI_SG_LIST *sg;
   uint32_t val, clkdiv, bps;
 
   if ((mci->info->flags & MCI_POWER) == 0U) { return ARM_DRIVER_ERROR; }
@@ -1138,11 +1467,31 @@ static int32_t Control (uint32_t control, uint32_t arg, MCI_RESOURCES *mci) {
           /* SDR50:  up to 100MHz,  50  MB/s: UHS-I 1.8V signaling */
         case ARM_MCI_BUS_UHS_SDR104:
           /* SDR104: up to 208MHz, 104  MB/s: UHS-I 1.8V signaling */
+          /* HS200:  up to 200MHz, 200  MB/s: MMC 1.8V signaling   */
           val |= SDMMC_CLKCR_BUSSPEED;
           break;
 
         default: return ARM_DRIVER_ERROR_UNSUPPORTED;
       }
+
+      /* Receive clock: feedback clock through delay block in SDR50/SDR104 modes */
+      val &= ~SDMMC_CLKCR_SELCLKRX;
+      mci->info->flags &= ~MCI_TUNING;
+
+#if (MCI_DLYB != 0U)
+      if (mci->dlyb != NULL) {
+        if ((arg == ARM_MCI_BUS_UHS_SDR50) || (arg == ARM_MCI_BUS_UHS_SDR104)) {
+          if (DelayBlockCalibrate (mci) != 0U) {
+            return ARM_DRIVER_ERROR;
+          }
+          val |= SDMMC_CLKCR_SELCLKRX_1;
+        }
+        else {
+          LL_DLYB_Disable ((DLYB_TypeDef *)mci->dlyb);
+        }
+      }
+#endif
+
       /* Set new register value */
       mci->reg->CLKCR = val;
       break;
@@ -1236,6 +1585,68 @@ static int32_t Control (uint32_t control, uint32_t arg, MCI_RESOURCES *mci) {
       }
       break;
 
+    case ARM_MCI_UHS_TUNING_OPERATION:
+#if (MCI_DLYB != 0U)
+      if ((mci->dlyb == NULL) || ((mci->reg->CLKCR & SDMMC_CLKCR_SELCLKRX) != SDMMC_CLKCR_SELCLKRX_1)) {
+        /* Not in SDR50/SDR104 mode */
+        return ARM_DRIVER_ERROR;
+      }
+      if (mci->info->status.transfer_active) {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      if (arg == 0U) {
+        /* Reset: calibrate delay line to current bus clock, test first phase */
+        if (DelayBlockCalibrate (mci) != 0U) {
+          return ARM_DRIVER_ERROR;
+        }
+        mci->info->tune_phase = 0U;
+        mci->info->tune_pass  = 0U;
+        DelayBlockPhase (mci, 0U);
+
+        mci->info->flags |= MCI_TUNING;
+      }
+      else {
+        if ((mci->info->flags & MCI_TUNING) == 0U) {
+          return ARM_DRIVER_ERROR;
+        }
+        TuningStep (mci);
+      }
+      break;
+#else
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+#endif
+
+    case ARM_MCI_UHS_TUNING_RESULT:
+      if ((mci->info->flags & MCI_TUNING) != 0U) {
+        /* Tuning in progress */
+        return 1;
+      }
+      if (mci->info->tune_pass == 0U) {
+        return ARM_DRIVER_ERROR;
+      }
+      break;
+
+    case MCI_CONTROL_SG_LIST:
+      if (mci->info->status.transfer_active) {
+        return ARM_DRIVER_ERROR_BUSY;
+      }
+      sg = (MCI_SG_LIST *)arg;
+
+      if ((sg == NULL) || (sg->seg == NULL) || (sg->cnt == 0U) || (sg->cnt > MCI_SG_SEG_MAX)) {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+      for (val = 0U; val < sg->cnt; val++) {
+        /* Buffers must be word aligned, length is n*32 and fits IDMABSIZE */
+        if ((sg->seg[val].data == NULL) || (((uint32_t)sg->seg[val].data & 3U) != 0U) ||
+            (sg->seg[val].len  == 0U)   || ((sg->seg[val].len & 0x1FU) != 0U)         ||
+            (sg->seg[val].len  > MCI_SG_SEG_LEN_MAX)) {
+          return ARM_DRIVER_ERROR_PARAMETER;
+        }
+      }
+      mci->info->sg     = sg;
+      mci->info->flags |= MCI_SG_PEND;
+      break;
+
     default: return ARM_DRIVER_ERROR_UNSUPPORTED;
   }
 
@@ -1357,8 +1768,16 @@ static void SDMMC_IRQHandler (MCI_RESOURCES *mci) {
     if (mci->h_dcache != NULL) {
       /* DCache is present */
       if (HAL_DCACHE_IsEnabled(mci->h_dcache) == 1U) {
+        uint32_t i;
         /* Invalidate data cache: ensure data coherency between DMA and CPU */
-        HAL_DCACHE_InvalidateByAddr (mci->h_dcache, (uint32_t *)mci->reg->IDMABASER, mci->info->dlen);
+        if ((mci->info->flags & MCI_DATA_SG) != 0U) {
+          for (i = 0U; i < mci->info->sg->cnt; i++) {
+            HAL_DCACHE_InvalidateByAddr (mci->h_dcache, (uint32_t *)mci->info->sg->seg[i].data, mci->info->sg->seg[i].len);
+          }
+        }
+        else {
+          HAL_DCACHE_InvalidateByAddr (mci->h_dcache, (uint32_t *)mci->reg->IDMABASER, mci->info->dlen);
+        }
       }
     }
 #endif
@@ -1,5 +1,5 @@
 /* -----------------------------------------------------------------------------
- * Copyright (c) 2023 Arm Limited (or its affiliates).
+ * Copyright (c) 2023-2024 Arm Limited (or its affiliates).
  * All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        14. February 2023
- * $Revision:    V1.1
+ * $Date:        18. October 2024
+ * $Revision:    V1.3
  *
  * Project:      MCI Driver Definitions for STMicroelectronics STM32U5xx
  * -------------------------------------------------------------------------- */
@@ -34,6 +34,14 @@
 
 #include <string.h>
 
+/* MCI: Delay block for receive clock tuning (stm32u5xx_ll_dlyb.c), used with 1.8V signaling (MemoryCard_UHSx) */
+#if (defined(MemoryCard_UHS0) && defined(DLYB_SDMMC1)) || (defined(MemoryCard_UHS1) && defined(DLYB_SDMMC2))
+#include "stm32u5xx_ll_dlyb.h"
+#define MCI_DLYB            1U
+#else
+#define MCI_DLYB            0U
+#endif
+
 #if ((defined(RTE_Drivers_MCI0) || \
       defined(RTE_Drivers_MCI1))   \
       && (!defined (MX_SDMMC1))    \
@@ -137,6 +145,39 @@
 #define MCI_DCACHE          0U
 #endif
 
+/* Vendor specific Control codes */
+#define MCI_CONTROL_SG_LIST           (0x80UL)        /* Scatter-gather list for next SetupTransfer; arg = pointer to MCI_SG_LIST */
+
+/* Vendor specific bus speed modes (ARM_MCI_BUS_SPEED_MODE) */
+#define MCI_BUS_MMC_HS200             (ARM_MCI_BUS_UHS_SDR104) /* MMC HS200: up to 200MHz, 1.8V signaling, tuned sampling clock */
+
+/* MCI: Maximum number of scatter-gather segments per transfer */
+#ifndef MCI_SG_SEG_MAX
+#define MCI_SG_SEG_MAX      8U
+#endif
+
+/* IDMA linked list buffer size limit */
+#define MCI_SG_SEG_LEN_MAX            (SDMMC_IDMABSIZE_IDMABNDT_Msk)
+
+/* Scatter-gather segment definition */
+typedef struct {
+  uint8_t                  *data;       /* Segment buffer (word aligned)      */
+  uint32_t                  len;        /* Segment length (n*32 Bytes)        */
+} MCI_SG_SEG;
+
+/* Scatter-gather list definition */
+typedef struct {
+  MCI_SG_SEG               *seg;        /* Array of segments                  */
+  uint32_t                  cnt;        /* Number of segments                 */
+} MCI_SG_LIST;
+
+/* IDMA linked list node definition (loaded by IDMA in register order) */
+typedef struct {
+  uint32_t volatile         idmalar;    /* Next node: IDMALAR register value  */
+  uint32_t volatile         idmabaser;  /* Buffer: IDMABASER register value   */
+  uint32_t volatile         idmabsize;  /* Size: IDMABSIZE register value     */
+} MCI_LL_NODE;
+
 
 /* Interrupt clear mask */
 #define SDMMC_ICR_BIT_Msk     (SDMMC_IT_CCRCFAIL   | \
@@ -183,6 +224,9 @@
 #define MCI_READ_WAIT ((uint32_t)0x0080)  /* Read wait operation start     */
 #define MCI_BUS_HS    ((uint32_t)0x0100)  /* High speed bus mode is active */
 #define MCI_BUS_SDR12 ((uint32_t)0x0200)  /* SDR12 bus mode is active      */
+#define MCI_SG_PEND   ((uint32_t)0x0400)  /* Scatter-gather list set       */
+#define MCI_DATA_SG   ((uint32_t)0x0800)  /* Scatter-gather transfer       */
+#define MCI_TUNING    ((uint32_t)0x1000)  /* Sampling clock tuning active  */
 
 #define MCI_RESPONSE_EXPECTED_Msk (ARM_MCI_RESPONSE_SHORT      | \
                                    ARM_MCI_RESPONSE_SHORT_BUSY | \
@@ -206,6 +250,12 @@ typedef struct {
   uint32_t                  dlen;       /* Data length register value         */
   uint32_t                  ker_clk;    /* SDMMC kernel clock frequency       */
   uint32_t volatile         flags;      /* Driver state flags                 */
+  MCI_SG_LIST              *sg;         /* Scatter-gather list                */
+  MCI_LL_NODE               ll[MCI_SG_SEG_MAX]; /* IDMA linked list nodes     */
+  uint32_t                  dlyb_unit;  /* Delay block unit delay             */
+  uint32_t                  dlyb_sel;   /* Delay block phases per clock period*/
+  uint32_t                  tune_phase; /* Tuning: phase being tested         */
+  uint32_t                  tune_pass;  /* Tuning: passed phases bit mask     */
 } MCI_INFO;
 
 /* MCI Resources Definition */
@@ -216,6 +266,7 @@ typedef struct {
   MCI_IO        *io_cd;                 /* I/O config: card detect            */
   MCI_IO        *io_wp;                 /* I/O config: write protect line     */
   MCI_INFO      *info;                  /* Run-Time information               */
+  void          *dlyb;                  /* DLYB_TypeDef: delay block          */
 } const MCI_RESOURCES;
 
 /* Global functions and variables */
@@ -237,5 +288,6 @@ extern ARM_DRIVER_MCI Driver_MCI1;
 
 extern int32_t MCI_ReadCD (uint32_t instance);
 extern int32_t MCI_ReadWP (uint32_t instance);
+extern void    MCI_DriveTransceiver_1V8 (uint32_t instance, uint32_t enable);
 
 #endif /* __MCI_STM32U5XX_H */
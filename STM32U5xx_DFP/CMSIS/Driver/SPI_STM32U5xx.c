@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        10. March 2023
- * $Revision:    V1.1
+ * $Date:        18. October 2024
+ * $Revision:    V1.3
  *
  * Driver:       Driver_SPI1/2/3
  *
@@ -30,6 +30,11 @@
 
 # Revision History
 
+- Version 1.3
+  - Added transfer queue (SPI_QUEUE_PREPARE and SPI_QUEUE_START control codes): sequence of transfers
+    executed by GPDMA linked-list without CPU intervention
+- Version 1.2
+  - Added support for transfers of more than 65535 items (1023 items for SPI3) (performed in segments)
 - Version 1.1
   - Updated Receive function to properly support Default Tx Value transmission during reception
     (due to STM32 HAL changed functionality)
@@ -55,13 +60,19 @@ Driver_SPI3     | SPI3
 # Limitations
 
 Hardware limitations:
- - Number of items to send, receive or transmit for SPI3 is limited to 1023
+ - Number of items of a single transfer for SPI3 is limited to 1023
 
 STM32 HAL limitations:
- - Number of items to send, receive or transmit is limited to 65535
+ - Number of items of a single transfer is limited to 65535
+ - Number of bytes of a single DMA transfer is limited to 65535 (32767 items of 16-bit, 16383 items of 32-bit frames)
  - Mode Fault and Data Lost events can be detected only when reception is active
  - Settings changes using Control function activate upon send/receive/transfer operation start
 
+Larger transfers are performed in segments, the next segment is started from the transfer
+complete interrupt of the previous one. Between segments the SPI is briefly idle:
+ - In Master mode with Hardware NSS output the NSS signal is deactivated between segments.
+ - In Slave mode the master must not clock data before the next segment is started.
+
 \note If SPI driver is used in IRQ mode, ensure that it has higher priority then
       any IRQ routine requiring longer processing time, because such IRQ routine
       can prevent SPI IRQ routine to correctly handle reception thus fail to
@@ -69,8 +80,43 @@ STM32 HAL limitations:
       event.
 \note The previous limitation can also be avoided by using SPI driver in DMA mode.
 
+# Transfer Queue
+
+Instances with Tx and Rx DMA on GPDMA1 channels can execute a queue of transfers (different buffers,
+optional Slave Select toggles between them) as a single operation. The queue is described by an
+array of SPI_QUEUE_XFER entries (see SPI_STM32U5xx.h):
+ - **SPI_QUEUE_PREPARE** (arg: pointer to SPI_QUEUE) builds the GPDMA linked-list nodes.
+   The entries and the buffers they point to must stay valid while the queue is used, a prepared
+   queue can be started any number of times.
+ - **SPI_QUEUE_START** starts the prepared queue. ARM_SPI_EVENT_TRANSFER_COMPLETE is signaled once,
+   after the last transfer. GetDataCount returns the number of items transferred by the queue,
+   also after the queue was stopped by an error or abort.
+
+The SPI runs as a single transfer of unlimited size (TSIZE = 0), the Tx DMA channel starts each
+transfer (except the first) only after the Rx DMA channel completed the previous one.
+With **SPI_QUEUE_SS_TOGGLE** set in an entry the Tx DMA channel deactivates the Slave Select GPIO
+after that transfer (SPI_QUEUE_SS_IDLE writes of GPIO BSRR) and activates it again before the next
+transfer (after the last transfer it stays inactive).
+
+Transfer queue limitations:
+ - Available in Master mode (ARM_SPI_MODE_MASTER) only.
+ - SPI_QUEUE_SS_TOGGLE requires Slave Select mode ARM_SPI_SS_MASTER_SW, with Hardware NSS output
+   the NSS signal stays active for the whole queue.
+ - Number of bytes of a single transfer is limited to 65535.
+ - Linked-list nodes of an instance must not cross a 64 kB boundary (SPI_QUEUE_PREPARE fails).
+ - Changing the frame format or data bits (ARM_SPI_MODE_xxx control) discards the prepared queue.
+
 # Configuration
 
+## Compile-time
+
+Definitions used for compile-time configuration of this driver are shown in the table below:
+
+Definition                         | Default value | Value | Description
+:----------------------------------|:-------------:|:-----:|:-----------------------------------------------
+SPI_QUEUE_MAX                      |     **8**     | 0..64 | Maximum number of transfers in a transfer queue (0 = transfer queue disabled)
+SPI_QUEUE_SS_IDLE                  |     **4**     | 1..64 | Number of GPIO writes keeping Slave Select inactive between queued transfers
+
 ## STM32CubeMX
 
 The SPI driver requires:
@@ -250,7 +296,23 @@ Results of the **CMSIS-Driver Validation** for this driver can be found in the [
 
 #include "SPI_STM32U5xx.h"
 
-#define ARM_SPI_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,1)
+#define ARM_SPI_DRV_VERSION ARM_DRIVER_VERSION_MAJOR_MINOR(1,3)
+
+#define SPI_SEGMENT_MAX                 (65535U)        // Maximum number of items (DMA: bytes) in a segment
+#define SPI_SEGMENT_MAX_LIMITED         (1023U)         // Maximum number of items in a segment (limited instance)
+
+#ifndef SPI_QUEUE_SS_IDLE
+#define SPI_QUEUE_SS_IDLE               (4U)
+#endif
+
+#if (SPI_QUEUE_MAX > 64U)
+#error  Too many queued transfers defined, maximum value of SPI_QUEUE_MAX is 64 !!!
+#endif
+#if ((SPI_QUEUE_SS_IDLE < 1U) || (SPI_QUEUE_SS_IDLE > 64U))
+#error  SPI_QUEUE_SS_IDLE must be in range 1 to 64 !!!
+#endif
+
+#define SPI_QUEUE_SUSP_TIMEOUT          (1000U)         // Number of polls for SPI suspend at the end of a queue
 
 // Driver Version
 static const ARM_DRIVER_VERSION DriverVersion = { ARM_SPI_API_VERSION, ARM_SPI_DRV_VERSION };
@@ -282,6 +344,9 @@ static ARM_SPI_STATUS       SPI_GetStatus        (const SPI_RESOURCES *spi);
 #ifdef  MX_SPI1_NSS_Pin
   SPIx_PIN_NSS_STRUCT_ALLOC(1);
 #endif
+#ifdef  SPI1_QUEUE_EN
+  SPIx_QUEUE_INFO_ALLOC(1);
+#endif
 SPIx_RESOURCE_ALLOC(1);
 #endif
 
@@ -290,6 +355,9 @@ SPIx_RESOURCE_ALLOC(1);
 #ifdef  MX_SPI2_NSS_Pin
   SPIx_PIN_NSS_STRUCT_ALLOC(2);
 #endif
+#ifdef  SPI2_QUEUE_EN
+  SPIx_QUEUE_INFO_ALLOC(2);
+#endif
 SPIx_RESOURCE_ALLOC(2);
 #endif
 
@@ -298,6 +366,9 @@ SPIx_RESOURCE_ALLOC(2);
 #ifdef  MX_SPI3_NSS_Pin
   SPIx_PIN_NSS_STRUCT_ALLOC(3);
 #endif
+#ifdef  SPI3_QUEUE_EN
+  SPIx_QUEUE_INFO_ALLOC(3);
+#endif
 SPIx_RESOURCE_ALLOC(3);
 #endif
 
@@ -369,6 +440,528 @@ static void SPI_PeripheralReset (const SPI_TypeDef *spi) {
 #endif
 }
 
+/**
+  Get size of a data item in bytes.
+  \param[in]    spi    Pointer to SPI resources
+  \return       data item size (1, 2 or 4)
+*/
+__STATIC_INLINE uint32_t ItemSize (const SPI_RESOURCES *spi) {
+  uint32_t size = 1U;
+
+  if (spi->h->Init.DataSize > SPI_DATASIZE_16BIT) {
+    size = 4U;
+  } else if (spi->h->Init.DataSize > SPI_DATASIZE_8BIT) {
+    size = 2U;
+  }
+
+  return size;
+}
+
+/**
+  Get maximum number of items of a single HAL transfer.
+  The GPDMA block size (BNDT) is a 16-bit byte count, DMA segments are limited to 65535 bytes.
+  \param[in]    spi    Pointer to SPI resources
+  \return       maximum number of items
+*/
+__STATIC_INLINE uint32_t SegmentMax (const SPI_RESOURCES *spi) {
+  uint32_t max = SPI_SEGMENT_MAX;
+
+  if (spi->xfer->dma_flag != 0U) {
+    max = SPI_SEGMENT_MAX / ItemSize(spi);
+  }
+  if (IS_SPI_LIMITED_INSTANCE(spi->reg) && (max > SPI_SEGMENT_MAX_LIMITED)) {
+    max = SPI_SEGMENT_MAX_LIMITED;
+  }
+
+  return max;
+}
+
+/**
+  Start the next segment of a transfer.
+  Transfers are split into segments of at most SegmentMax items.
+  \param[in]    spi    Pointer to SPI resources
+  \return       \ref HAL_StatusTypeDef
+*/
+static HAL_StatusTypeDef SegmentStart (const SPI_RESOURCES *spi) {
+  SPI_TRANSFER_INFO *xfer = spi->xfer;
+  HAL_StatusTypeDef  stat;
+  uint32_t           offset;
+  uint8_t           *tx, *rx;
+
+  xfer->seg_len = xfer->num - xfer->seg_cnt;
+  if (xfer->seg_len > SegmentMax(spi)) {
+    xfer->seg_len = SegmentMax(spi);
+  }
+
+  // Offset of the segment in bytes
+  offset = xfer->seg_cnt * ItemSize(spi);
+
+  tx = (uint8_t *)(uint32_t)&xfer->tx_data[offset];
+  if (xfer->rx_data == NULL) {
+#ifdef __SPI_DMA_TX
+    if (xfer->dma_flag != 0U) {
+      // DMA mode
+      stat = HAL_SPI_Transmit_DMA(spi->h, tx, (uint16_t)xfer->seg_len);
+    } else
+#endif
+    {
+      // Interrupt mode
+      stat = HAL_SPI_Transmit_IT (spi->h, tx, (uint16_t)xfer->seg_len);
+    }
+  } else {
+    rx = &xfer->rx_data[offset];
+#ifdef __SPI_DMA
+    if (xfer->dma_flag != 0U) {
+      // DMA mode
+      stat = HAL_SPI_TransmitReceive_DMA(spi->h, tx, rx, (uint16_t)xfer->seg_len);
+    } else
+#endif
+    {
+      // Interrupt mode
+      stat = HAL_SPI_TransmitReceive_IT (spi->h, tx, rx, (uint16_t)xfer->seg_len);
+    }
+  }
+
+  return stat;
+}
+
+/**
+  Complete the active segment of a transfer and start the next segment.
+  \param[in]    spi    Pointer to SPI resources
+  \return       result
+                0 = transfer is completed
+                1 = transfer is not completed (next segment started, or transfer failed)
+*/
+static uint8_t SegmentDone (const SPI_RESOURCES *spi) {
+  SPI_TRANSFER_INFO *xfer    = spi->xfer;
+  uint8_t            pending = 0U;
+
+  if ((xfer->seg_cnt + xfer->seg_len) < xfer->num) {
+    xfer->seg_cnt += xfer->seg_len;
+    pending = 1U;
+    if (SegmentStart(spi) != HAL_OK) {
+      if (spi->info->cb_event != NULL) {
+        spi->info->cb_event(ARM_SPI_EVENT_DATA_LOST);
+      }
+    }
+  }
+
+  return pending;
+}
+
+#ifdef __SPI_QUEUE
+/**
+  Add a node to a transfer queue linked-list.
+  \param[in]    list   Pointer to linked-list queue
+  \param[in]    conf   Pointer to node configuration
+  \param[in]    node   Pointer to node
+  \return       \ref HAL_StatusTypeDef
+*/
+static HAL_StatusTypeDef QueueNodeAdd (DMA_QListTypeDef *list, const DMA_NodeConfTypeDef *conf, DMA_NodeTypeDef *node) {
+  HAL_StatusTypeDef stat;
+
+  stat = HAL_DMAEx_List_BuildNode(conf, node);
+  if (stat == HAL_OK) {
+    stat = HAL_DMAEx_List_InsertNode_Tail(list, node);
+  }
+
+  return stat;
+}
+
+/**
+  Set trigger of a transfer queue node configuration.
+  \param[in]    conf     Pointer to node configuration
+  \param[in]    trigger  Trigger selection (0xFFFFFFFF = no trigger)
+*/
+static void QueueNodeTrigger (DMA_NodeConfTypeDef *conf, uint32_t trigger) {
+
+  if (trigger != 0xFFFFFFFFU) {
+    conf->TriggerConfig.TriggerMode      = DMA_TRIGM_BLOCK_TRANSFER;
+    conf->TriggerConfig.TriggerPolarity  = DMA_TRIG_POLARITY_RISING;
+    conf->TriggerConfig.TriggerSelection = trigger;
+  } else {
+    conf->TriggerConfig.TriggerMode      = DMA_TRIGM_BLOCK_TRANSFER;
+    conf->TriggerConfig.TriggerPolarity  = DMA_TRIG_POLARITY_MASKED;
+    conf->TriggerConfig.TriggerSelection = 0U;
+  }
+}
+
+/**
+  Prepare transfer queue: build GPDMA linked-list nodes.
+  Tx list: transfer 0, [Slave Select inactive, active], transfer 1, ..., end
+  Rx list: transfer 0, transfer 1, ...
+  The first Tx node after each transfer is triggered by the Rx channel transfer complete event,
+  so the next transfer (or Slave Select change) starts only when the previous one is received.
+  \param[in]    spi    Pointer to SPI resources
+  \param[in]    queue  Pointer to transfer queue
+  \return       \ref execution_status
+*/
+static int32_t QueuePrepare (const SPI_RESOURCES *spi, const SPI_QUEUE *queue) {
+  SPI_QUEUE_INFO       *q = spi->queue;
+  const SPI_QUEUE_XFER *x;
+  DMA_NodeConfTypeDef   tx_conf, rx_conf, ss_conf;
+  DMA_NodeTypeDef      *tx_node;
+  DMA_HandleTypeDef    *hdmatx, *hdmarx;
+  HAL_StatusTypeDef     stat;
+  uint32_t              i, size, trigger;
+
+  if (q == NULL) { return ARM_DRIVER_ERROR_UNSUPPORTED; }
+
+  if ((queue == NULL) || (queue->xfer == NULL) || (queue->num == 0U) || (queue->num > SPI_QUEUE_MAX)) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  if (((spi->info->state & SPI_CONFIGURED) == 0U) ||
+      ((spi->info->mode & ARM_SPI_CONTROL_Msk) != ARM_SPI_MODE_MASTER)) {
+    return ARM_DRIVER_ERROR;
+  }
+
+  hdmatx = spi->h->hdmatx;
+  hdmarx = spi->h->hdmarx;
+  if ((hdmatx == NULL) || (hdmarx == NULL) ||
+      (IS_GPDMA_INSTANCE(hdmatx->Instance) == 0U) || (IS_GPDMA_INSTANCE(hdmarx->Instance) == 0U)) {
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+
+  for (i = 0U; i < queue->num; i++) {
+    x = &queue->xfer[i];
+    if ((x->num == 0U) || (x->num > (0xFFFFU / ItemSize(spi)))) {
+      return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    if ((x->flags & SPI_QUEUE_SS_TOGGLE) != 0U) {
+      if ((spi->nss == NULL) || ((spi->info->mode & ARM_SPI_SS_MASTER_MODE_Msk) != ARM_SPI_SS_MASTER_SW)) {
+        return ARM_DRIVER_ERROR_PARAMETER;
+      }
+    }
+  }
+
+  // Discard previously prepared queue
+  q->num = 0U;
+  memset(&q->tx_list, 0, sizeof(DMA_QListTypeDef));
+  memset(&q->rx_list, 0, sizeof(DMA_QListTypeDef));
+
+  if (spi->nss != NULL) {
+    q->ss_inactive = spi->nss->pin;
+    q->ss_active   = spi->nss->pin << 16;
+  }
+
+  // Rx channel transfer complete event
+  trigger = GPDMA1_TRIGGER_GPDMA1_CH0_TCF + (((uint32_t)hdmarx->Instance - (uint32_t)GPDMA1_Channel0) /
+                                             ((uint32_t)GPDMA1_Channel1 - (uint32_t)GPDMA1_Channel0));
+
+  // Node configurations: channel settings of the CubeMX configuration
+  memset(&tx_conf, 0, sizeof(DMA_NodeConfTypeDef));
+  tx_conf.NodeType                       = DMA_GPDMA_LINEAR_NODE;
+  tx_conf.Init                           = hdmatx->Init;
+  tx_conf.Init.Mode                      = DMA_NORMAL;
+  tx_conf.Init.TransferEventMode         = DMA_TCEM_LAST_LL_ITEM_TRANSFER;
+  tx_conf.DataHandlingConfig.DataExchange  = DMA_EXCHANGE_NONE;
+  tx_conf.DataHandlingConfig.DataAlignment = DMA_DATA_RIGHTALIGN_ZEROPADDED;
+  tx_conf.DstAddress                     = (uint32_t)&spi->reg->TXDR;
+
+  rx_conf                                = tx_conf;
+  rx_conf.Init                           = hdmarx->Init;
+  rx_conf.Init.Mode                      = DMA_NORMAL;
+  rx_conf.Init.TransferEventMode         = DMA_TCEM_EACH_LL_ITEM_TRANSFER;
+  rx_conf.SrcAddress                     = (uint32_t)&spi->reg->RXDR;
+  QueueNodeTrigger(&rx_conf, 0xFFFFFFFFU);
+
+  // Slave Select and end nodes: software request, word writes to a fixed address
+  ss_conf                                = tx_conf;
+  ss_conf.Init.Request                   = DMA_REQUEST_SW;
+  ss_conf.Init.BlkHWRequest              = DMA_BREQ_SINGLE_BURST;
+  ss_conf.Init.Direction                 = DMA_MEMORY_TO_MEMORY;
+  ss_conf.Init.SrcInc                    = DMA_SINC_FIXED;
+  ss_conf.Init.DestInc                   = DMA_DINC_FIXED;
+  ss_conf.Init.SrcDataWidth              = DMA_SRC_DATAWIDTH_WORD;
+  ss_conf.Init.DestDataWidth             = DMA_DEST_DATAWIDTH_WORD;
+  ss_conf.Init.SrcBurstLength            = 1U;
+  ss_conf.Init.DestBurstLength           = 1U;
+
+  stat    = HAL_OK;
+  tx_node = q->tx_node;
+  for (i = 0U; (i < queue->num) && (stat == HAL_OK); i++) {
+    x    = &queue->xfer[i];
+    size = x->num * ItemSize(spi);
+
+    // Tx transfer, triggered by the previous reception if not preceded by Slave Select nodes
+    if (x->data_out != NULL) {
+      tx_conf.Init.SrcInc = DMA_SINC_INCREMENTED;
+      tx_conf.SrcAddress  = (uint32_t)x->data_out;
+    } else {
+      tx_conf.Init.SrcInc = DMA_SINC_FIXED;
+      tx_conf.SrcAddress  = (uint32_t)&q->def_val;
+    }
+    tx_conf.DataSize = size;
+    if ((i != 0U) && ((queue->xfer[i - 1U].flags & SPI_QUEUE_SS_TOGGLE) == 0U)) {
+      QueueNodeTrigger(&tx_conf, trigger);
+    } else {
+      QueueNodeTrigger(&tx_conf, 0xFFFFFFFFU);
+    }
+    stat = QueueNodeAdd(&q->tx_list, &tx_conf, tx_node++);
+
+    // Rx transfer
+    if (x->data_in != NULL) {
+      rx_conf.Init.DestInc = DMA_DINC_INCREMENTED;
+      rx_conf.DstAddress   = (uint32_t)x->data_in;
+    } else {
+      rx_conf.Init.DestInc = DMA_DINC_FIXED;
+      rx_conf.DstAddress   = (uint32_t)&q->dummy;
+    }
+    rx_conf.DataSize = size;
+    if (stat == HAL_OK) {
+      stat = QueueNodeAdd(&q->rx_list, &rx_conf, &q->rx_node[i]);
+    }
+
+    if ((x->flags & SPI_QUEUE_SS_TOGGLE) != 0U) {
+      // Slave Select inactive, triggered by the end of this reception
+      ss_conf.SrcAddress = (uint32_t)&q->ss_inactive;
+      ss_conf.DstAddress = (uint32_t)&spi->nss->port->BSRR;
+      ss_conf.DataSize   = SPI_QUEUE_SS_IDLE * 4U;
+      QueueNodeTrigger(&ss_conf, trigger);
+      if (stat == HAL_OK) {
+        stat = QueueNodeAdd(&q->tx_list, &ss_conf, tx_node++);
+      }
+      if (i < (queue->num - 1U)) {
+        // Slave Select active
+        ss_conf.SrcAddress = (uint32_t)&q->ss_active;
+        ss_conf.DataSize   = 4U;
+        QueueNodeTrigger(&ss_conf, 0xFFFFFFFFU);
+        if (stat == HAL_OK) {
+          stat = QueueNodeAdd(&q->tx_list, &ss_conf, tx_node++);
+        }
+      }
+    } else if (i == (queue->num - 1U)) {
+      // End node, triggered by the end of the last reception: Tx channel completes last
+      ss_conf.SrcAddress = (uint32_t)&q->def_val;
+      ss_conf.DstAddress = (uint32_t)&q->dummy;
+      ss_conf.DataSize   = 4U;
+      QueueNodeTrigger(&ss_conf, trigger);
+      if (stat == HAL_OK) {
+        stat = QueueNodeAdd(&q->tx_list, &ss_conf, tx_node++);
+      }
+    }
+  }
+
+  if (stat != HAL_OK) {
+    return ARM_DRIVER_ERROR;
+  }
+
+  q->xfer = queue->xfer;
+  q->num  = queue->num;
+
+  return ARM_DRIVER_OK;
+}
+
+/**
+  Switch DMA channel to linked-list mode and link transfer queue.
+  \param[in]    hdma   Pointer to DMA handle
+  \param[in]    list   Pointer to linked-list queue
+  \return       \ref HAL_StatusTypeDef
+*/
+static HAL_StatusTypeDef QueueDmaInit (DMA_HandleTypeDef *hdma, DMA_QListTypeDef *list) {
+  HAL_StatusTypeDef stat;
+
+  hdma->InitLinkedList.Priority          = hdma->Init.Priority;
+  hdma->InitLinkedList.LinkStepMode      = DMA_LSM_FULL_EXECUTION;
+  hdma->InitLinkedList.LinkAllocatedPort = DMA_LINK_ALLOCATED_PORT1;
+  hdma->InitLinkedList.TransferEventMode = DMA_TCEM_LAST_LL_ITEM_TRANSFER;
+  hdma->InitLinkedList.LinkedListMode    = DMA_LINKEDLIST_NORMAL;
+
+  list->State = HAL_DMA_QUEUE_STATE_READY;
+
+  stat = HAL_DMAEx_List_Init(hdma);
+  if (stat == HAL_OK) {
+    stat = HAL_DMAEx_List_LinkQ(hdma, list);
+  }
+
+  // Callbacks are set by the transfer queue functions
+  hdma->XferCpltCallback     = NULL;
+  hdma->XferHalfCpltCallback = NULL;
+  hdma->XferErrorCallback    = NULL;
+  hdma->XferAbortCallback    = NULL;
+
+  return stat;
+}
+
+/**
+  Get number of items transferred by the transfer queue.
+  \param[in]    spi    Pointer to SPI resources
+  \return       number of data items transferred
+*/
+static uint32_t QueueDataCount (const SPI_RESOURCES *spi) {
+  const SPI_QUEUE_INFO *q = spi->queue;
+  DMA_Channel_TypeDef  *ch;
+  uint32_t              i, cnt, cllr, rem;
+
+  if ((q == NULL) || (q->num == 0U)) {
+    return 0U;
+  }
+  if (spi->xfer->queue != SPI_QUEUE_ACTIVE) {
+    // Count saved when the queue was stopped
+    return q->cnt;
+  }
+
+  // Rx node in progress precedes the node loaded next (CLLR), or is the last one (CLLR = 0)
+  ch   = spi->h->hdmarx->Instance;
+  cllr = ch->CLLR & DMA_CLLR_LA;
+  rem  = ch->CBR1 & DMA_CBR1_BNDT;
+  cnt  = 0U;
+  for (i = 0U; i < (q->num - 1U); i++) {
+    if (((uint32_t)&q->rx_node[i + 1U] & DMA_CLLR_LA) == cllr) {
+      break;
+    }
+    cnt += q->xfer[i].num;
+  }
+  rem /= ItemSize(spi);
+  if (rem <= q->xfer[i].num) {
+    cnt += q->xfer[i].num - rem;
+  }
+
+  return cnt;
+}
+
+/**
+  Stop transfer queue: disable SPI and return DMA channels to normal mode.
+  \param[in]    spi    Pointer to SPI resources
+*/
+static void QueueStop (const SPI_RESOURCES *spi) {
+  SPI_HandleTypeDef *h = spi->h;
+  uint32_t           n;
+
+  if (spi->xfer->queue != SPI_QUEUE_ACTIVE) {
+    return;
+  }
+
+  // Suspend endless transfer (immediate when all data is transferred)
+  if ((h->Instance->CR1 & SPI_CR1_CSTART) != 0U) {
+    SET_BIT(h->Instance->CR1, SPI_CR1_CSUSP);
+    for (n = 0U; (n < SPI_QUEUE_SUSP_TIMEOUT) && ((h->Instance->SR & SPI_FLAG_SUSP) == 0U); n++);
+  }
+  __HAL_SPI_DISABLE_IT(h, (SPI_IT_OVR | SPI_IT_UDR | SPI_IT_FRE | SPI_IT_MODF));
+  __HAL_SPI_DISABLE(h);
+  CLEAR_BIT(h->Instance->CFG1, SPI_CFG1_TXDMAEN | SPI_CFG1_RXDMAEN);
+  __HAL_SPI_CLEAR_SUSPFLAG(h);
+  __HAL_SPI_CLEAR_EOTFLAG(h);
+  __HAL_SPI_CLEAR_TXTFFLAG(h);
+
+  // Save count of transferred items before the Rx channel is reinitialized
+  spi->queue->cnt = QueueDataCount(spi);
+
+  // Abort channels still running and reinitialize them in normal mode
+  if ((h->hdmatx->Instance->CCR & DMA_CCR_EN) != 0U) {
+    (void)HAL_DMA_Abort(h->hdmatx);
+  }
+  if ((h->hdmarx->Instance->CCR & DMA_CCR_EN) != 0U) {
+    (void)HAL_DMA_Abort(h->hdmarx);
+  }
+  (void)HAL_DMA_Init(h->hdmatx);
+  (void)HAL_DMA_Init(h->hdmarx);
+
+  spi->xfer->queue = SPI_QUEUE_DONE;
+  h->State         = HAL_SPI_STATE_READY;
+}
+
+/**
+  Transfer queue Tx DMA channel complete callback (end node executed).
+  \param[in]    hdma   Pointer to DMA handle
+*/
+static void QueueDmaComplete (DMA_HandleTypeDef *hdma) {
+  const SPI_RESOURCES *spi = SPI_Resources((SPI_HandleTypeDef *)hdma->Parent);
+
+  QueueStop(spi);
+
+  if (spi->info->cb_event != NULL) {
+    spi->info->cb_event(ARM_SPI_EVENT_TRANSFER_COMPLETE);
+  }
+}
+
+/**
+  Transfer queue DMA channel error callback.
+  \param[in]    hdma   Pointer to DMA handle
+*/
+static void QueueDmaError (DMA_HandleTypeDef *hdma) {
+  const SPI_RESOURCES *spi = SPI_Resources((SPI_HandleTypeDef *)hdma->Parent);
+
+  QueueStop(spi);
+
+  if (spi->info->cb_event != NULL) {
+    spi->info->cb_event(ARM_SPI_EVENT_DATA_LOST);
+  }
+}
+
+/**
+  Start prepared transfer queue.
+  \param[in]    spi    Pointer to SPI resources
+  \return       \ref execution_status
+*/
+static int32_t QueueStart (const SPI_RESOURCES *spi) {
+  SPI_QUEUE_INFO    *q = spi->queue;
+  SPI_HandleTypeDef *h = spi->h;
+  uint32_t           i;
+
+  if (q == NULL) { return ARM_DRIVER_ERROR_UNSUPPORTED; }
+  if (q->num == 0U) { return ARM_DRIVER_ERROR; }
+
+  // Save transfer info
+  spi->xfer->tx_data  = NULL;
+  spi->xfer->rx_data  = NULL;
+  spi->xfer->num      = 0U;
+  for (i = 0U; i < q->num; i++) {
+    spi->xfer->num   += q->xfer[i].num;
+  }
+  spi->xfer->seg_cnt  = 0U;
+  spi->xfer->dma_flag = 1U;
+  spi->xfer->queue    = SPI_QUEUE_ACTIVE;
+  q->def_val          = spi->xfer->def_val;
+
+  h->State       = HAL_SPI_STATE_BUSY_TX_RX;
+  h->ErrorCode   = HAL_SPI_ERROR_NONE;
+  h->TxXferSize  = 0U;
+  h->RxXferSize  = 0U;
+
+  // Switch DMA channels to linked-list mode
+  if ((QueueDmaInit(h->hdmarx, &q->rx_list) != HAL_OK) ||
+      (QueueDmaInit(h->hdmatx, &q->tx_list) != HAL_OK)) {
+    QueueStop(spi);
+    q->cnt = 0U;
+    return ARM_DRIVER_ERROR;
+  }
+  h->hdmarx->XferErrorCallback = QueueDmaError;
+  h->hdmatx->XferErrorCallback = QueueDmaError;
+  h->hdmatx->XferCpltCallback  = QueueDmaComplete;
+
+  // Endless transfer (TSIZE = 0), data flow is controlled by the DMA channels
+  __HAL_SPI_DISABLE(h);
+  CLEAR_BIT(h->Instance->CFG1, SPI_CFG1_TXDMAEN | SPI_CFG1_RXDMAEN);
+  MODIFY_REG(h->Instance->CR2, SPI_CR2_TSIZE, 0U);
+  SET_BIT(h->Instance->CFG1, SPI_CFG1_RXDMAEN);
+
+  // Rx channel: only error interrupts, its transfer complete events trigger the Tx channel
+  if (HAL_DMAEx_List_Start(h->hdmarx) != HAL_OK) {
+    QueueStop(spi);
+    q->cnt = 0U;
+    return ARM_DRIVER_ERROR;
+  }
+  __HAL_DMA_ENABLE_IT(h->hdmarx, (DMA_IT_DTE | DMA_IT_ULE | DMA_IT_USE | DMA_IT_TO));
+
+  // Tx channel: transfer complete interrupt after the end node
+  if (HAL_DMAEx_List_Start_IT(h->hdmatx) != HAL_OK) {
+    QueueStop(spi);
+    q->cnt = 0U;
+    return ARM_DRIVER_ERROR;
+  }
+  SET_BIT(h->Instance->CFG1, SPI_CFG1_TXDMAEN);
+
+  __HAL_SPI_ENABLE_IT(h, (SPI_IT_OVR | SPI_IT_UDR | SPI_IT_FRE | SPI_IT_MODF));
+  __HAL_SPI_ENABLE(h);
+  SET_BIT(h->Instance->CR1, SPI_CR1_CSTART);
+
+  return ARM_DRIVER_OK;
+}
+
+#endif
+
 // SPI Driver functions
 
 /**
@@ -530,16 +1123,21 @@ static int32_t SPI_Send (const void *data, uint32_t num, const SPI_RESOURCES *sp
       break;
   }
 
+  // Save transfer info
+  spi->xfer->tx_data  = data;
+  spi->xfer->rx_data  = NULL;
+  spi->xfer->num      = num;
+  spi->xfer->seg_cnt  = 0U;
+  spi->xfer->dma_flag = 0U;
+  spi->xfer->queue    = SPI_QUEUE_NONE;
 #ifdef __SPI_DMA_TX
   if ((spi->dma_use & SPI_DMA_USE_TX) != 0U) {
-    // DMA mode
-    stat = HAL_SPI_Transmit_DMA(spi->h, (uint8_t *)(uint32_t)data, (uint16_t)num);
-  } else
-#endif
-  {
-    // Interrupt mode
-    stat = HAL_SPI_Transmit_IT (spi->h, (uint8_t *)(uint32_t)data, (uint16_t)num);
+    spi->xfer->dma_flag = 1U;
   }
+#endif
+
+  // Start first segment (DMA or Interrupt mode)
+  stat = SegmentStart(spi);
 
   switch (stat) {
     case HAL_ERROR:
@@ -605,16 +1203,21 @@ static int32_t SPI_Receive (void *data, uint32_t num, const SPI_RESOURCES *spi)
     }
   }
 
+  // Save transfer info
+  spi->xfer->tx_data  = data;
+  spi->xfer->rx_data  = data;
+  spi->xfer->num      = num;
+  spi->xfer->seg_cnt  = 0U;
+  spi->xfer->dma_flag = 0U;
+  spi->xfer->queue    = SPI_QUEUE_NONE;
 #ifdef __SPI_DMA
   if ((spi->dma_use & SPI_DMA_USE_TX_RX) == SPI_DMA_USE_TX_RX) {
-    // DMA mode
-    stat = HAL_SPI_TransmitReceive_DMA(spi->h, (uint8_t *)(uint32_t)data, (uint8_t *)(uint32_t)data, (uint16_t)num);
-  } else
-#endif
-  {
-    // Interrupt mode
-    stat = HAL_SPI_TransmitReceive_IT (spi->h, (uint8_t *)(uint32_t)data, (uint8_t *)(uint32_t)data, (uint16_t)num);
+    spi->xfer->dma_flag = 1U;
   }
+#endif
+
+  // Start first segment (DMA or Interrupt mode)
+  stat = SegmentStart(spi);
 
   switch (stat) {
     case HAL_ERROR:
@@ -661,16 +1264,21 @@ static int32_t SPI_Transfer (const void *data_out, void *data_in, uint32_t num,
       break;
   }
 
+  // Save transfer info
+  spi->xfer->tx_data  = data_out;
+  spi->xfer->rx_data  = data_in;
+  spi->xfer->num      = num;
+  spi->xfer->seg_cnt  = 0U;
+  spi->xfer->dma_flag = 0U;
+  spi->xfer->queue    = SPI_QUEUE_NONE;
 #ifdef __SPI_DMA
   if (spi->dma_use == SPI_DMA_USE_TX_RX) {
-    // DMA mode
-    stat = HAL_SPI_TransmitReceive_DMA(spi->h, (uint8_t *)(uint32_t)data_out, (uint8_t *)(uint32_t)data_in, (uint16_t)num);
-  } else
-#endif
-  {
-    // Interrupt mode
-    stat = HAL_SPI_TransmitReceive_IT (spi->h, (uint8_t *)(uint32_t)data_out, (uint8_t *)(uint32_t)data_in, (uint16_t)num);
+    spi->xfer->dma_flag = 1U;
   }
+#endif
+
+  // Start first segment (DMA or Interrupt mode)
+  stat = SegmentStart(spi);
 
   switch (stat) {
     case HAL_ERROR:
@@ -694,35 +1302,47 @@ static int32_t SPI_Transfer (const void *data_out, void *data_in, uint32_t num,
   \return      number of data items transferred
 */
 static uint32_t SPI_GetDataCount (const SPI_RESOURCES *spi) {
+#ifdef __SPI_DMA
+  uint32_t cnt;
+#endif
 
   if ((spi->info->state & SPI_INITIALIZED) == 0U) {
     return 0U;
   }
 
+#ifdef __SPI_QUEUE
+  if (spi->xfer->queue != SPI_QUEUE_NONE) {
+    return QueueDataCount(spi);
+  }
+#endif
 #ifdef __SPI_DMA
   if (((spi->dma_use & SPI_DMA_USE_RX) != 0U) && (spi->h->hdmarx != NULL)) {
     if (spi->h->RxXferSize != 0U) {
       // If reception is active
-      if (spi->h->RxXferSize >= __HAL_DMA_GET_COUNTER(spi->h->hdmarx)) {
-        return (spi->h->RxXferSize - __HAL_DMA_GET_COUNTER(spi->h->hdmarx));
+      // DMA counter is in bytes
+      cnt = __HAL_DMA_GET_COUNTER(spi->h->hdmarx) / ItemSize(spi);
+      if (spi->h->RxXferSize >= cnt) {
+        return (spi->xfer->seg_cnt + spi->h->RxXferSize - cnt);
       }
     }
   }
   if (((spi->dma_use & SPI_DMA_USE_TX) != 0U) && (spi->h->hdmatx != NULL)) {
     if (spi->h->TxXferSize != 0U) {
-      if (spi->h->TxXferSize >= __HAL_DMA_GET_COUNTER(spi->h->hdmatx)) {
-        return (spi->h->TxXferSize - __HAL_DMA_GET_COUNTER(spi->h->hdmatx));
+      // DMA counter is in bytes
+      cnt = __HAL_DMA_GET_COUNTER(spi->h->hdmatx) / ItemSize(spi);
+      if (spi->h->TxXferSize >= cnt) {
+        return (spi->xfer->seg_cnt + spi->h->TxXferSize - cnt);
       }
     }
   }
 #endif
   if (spi->h->RxXferSize != 0U) {
     // If reception is active
-    return (spi->h->RxXferSize - spi->h->RxXferCount);
+    return (spi->xfer->seg_cnt + spi->h->RxXferSize - spi->h->RxXferCount);
   }
 
   if (spi->h->TxXferSize != 0U) {
-    return (spi->h->TxXferSize - spi->h->TxXferCount);
+    return (spi->xfer->seg_cnt + spi->h->TxXferSize - spi->h->TxXferCount);
   }
 
   return 0;
@@ -744,9 +1364,17 @@ static int32_t SPI_Control (uint32_t control, uint32_t arg, const SPI_RESOURCES
   if ((spi->info->state & SPI_POWERED) == 0U) { return ARM_DRIVER_ERROR; }
 
   if ((control & ARM_SPI_CONTROL_Msk) == ARM_SPI_ABORT_TRANSFER) {
-    (void)HAL_SPI_Abort(spi->h);
+#ifdef __SPI_QUEUE
+    if (spi->xfer->queue == SPI_QUEUE_ACTIVE) {
+      QueueStop(spi);
+    } else
+#endif
+    {
+      (void)HAL_SPI_Abort(spi->h);
+    }
     spi->h->RxXferSize = 0U;
     spi->h->TxXferSize = 0U;
+    spi->xfer->seg_cnt = 0U;
     return ARM_DRIVER_OK;
   }
 
@@ -854,6 +1482,14 @@ static int32_t SPI_Control (uint32_t control, uint32_t arg, const SPI_RESOURCES
         } else { return ARM_DRIVER_ERROR; }
       } else { return ARM_DRIVER_ERROR; }
 
+#ifdef __SPI_QUEUE
+    case SPI_QUEUE_PREPARE:
+      return QueuePrepare(spi, (const SPI_QUEUE *)arg);
+
+    case SPI_QUEUE_START:
+      return QueueStart(spi);
+#endif
+
     default:
       return ARM_DRIVER_ERROR_UNSUPPORTED;
   }
@@ -1082,6 +1718,13 @@ static int32_t SPI_Control (uint32_t control, uint32_t arg, const SPI_RESOURCES
   }
 #endif
 
+#ifdef __SPI_QUEUE
+  if (spi->queue != NULL) {
+    // Prepared transfer queue depends on frame format and data bits
+    spi->queue->num = 0U;
+  }
+#endif
+
   spi->info->mode   = control;
   spi->info->state |= SPI_CONFIGURED;
 
@@ -1132,6 +1775,10 @@ static void SPI_TransferComplete (SPI_HandleTypeDef *hspi) {
   const SPI_RESOURCES * spi;
   spi = SPI_Resources (hspi);
 
+  if (SegmentDone(spi) != 0U) {
+    return;                                     // Transfer of next segment is in progress
+  }
+
   if (spi->info->cb_event != NULL) {
     spi->info->cb_event(ARM_SPI_EVENT_TRANSFER_COMPLETE);
   }
@@ -1184,6 +1831,10 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
   spi = SPI_Resources (hspi);
   error = HAL_SPI_GetError (hspi);
 
+#ifdef __SPI_QUEUE
+  QueueStop(spi);
+#endif
+
   event = 0;
   if (error & HAL_SPI_ERROR_MODF) {
     event |= ARM_SPI_EVENT_MODE_FAULT;
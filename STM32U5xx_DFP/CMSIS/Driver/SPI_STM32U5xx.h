@@ -17,8 +17,8 @@
  * limitations under the License.
  *
  *
- * $Date:        09. December 2021
- * $Revision:    V1.0
+ * $Date:        18. October 2024
+ * $Revision:    V1.2
  *
  * Project:      SPI Driver definitions for STMicroelectronics STM32U5xx
  * -------------------------------------------------------------------------- */
@@ -43,6 +43,9 @@
 #define SPIx_PIN_STRUCT_PTR(x, pin)     SPI##x##_PIN_##pin##_STRUCT_PTR
 #define SPIx_PIN_NSS_STRUCT_PTR(x)      SPIx_PIN_STRUCT_PTR(x, NSS)
 
+#define SPIx_QUEUE_INFO_ALLOC(x)        static SPI_QUEUE_INFO SPI##x##_QueueInfo
+#define SPIx_QUEUE_INFO_PTR(x)          SPI##x##_QUEUE_INFO_PTR
+
 #define SPIx_RESOURCE_ALLOC(x)          extern SPI_HandleTypeDef SPI##x##_HANDLE;             \
                                         static SPI_INFO          SPI##x##_Info;               \
                                         static SPI_TRANSFER_INFO SPI##x##_TransferInfo;       \
@@ -52,6 +55,7 @@
                                                SPIx_PIN_NSS_STRUCT_PTR(x),                    \
                                                &SPI##x##_Info,                                \
                                                &SPI##x##_TransferInfo,                        \
+                                               SPIx_QUEUE_INFO_PTR(x),                        \
                                                 SPI##x##_DMA_USE                              \
                                      }
 
@@ -92,6 +96,23 @@ ARM_DRIVER_SPI Driver_SPI##x = {
 #define SPI_DATA_LOST                   ((uint8_t)(1U << 3))     // SPI data lost occurred
 #define SPI_MODE_FAULT                  ((uint8_t)(1U << 4))     // SPI mode fault occurred
 
+// SPI Control Codes: Transfer queue (vendor specific)
+#define SPI_QUEUE_PREPARE               (0x80UL << ARM_SPI_CONTROL_Pos)     // Prepare transfer queue; arg: pointer to SPI_QUEUE
+#define SPI_QUEUE_START                 (0x81UL << ARM_SPI_CONTROL_Pos)     // Start prepared transfer queue; arg: not used
+
+// SPI Transfer queue entry flags
+#define SPI_QUEUE_SS_TOGGLE             (1UL << 0)      // Deactivate Slave Select after the transfer (activate it before the next one)
+
+// Maximum number of transfers in a transfer queue (0 = transfer queue disabled)
+#ifndef SPI_QUEUE_MAX
+#define SPI_QUEUE_MAX                   (8U)
+#endif
+
+// Transfer queue state
+#define SPI_QUEUE_NONE                  ((uint8_t)(0U))          // Last operation was not a transfer queue
+#define SPI_QUEUE_ACTIVE                ((uint8_t)(1U))          // Transfer queue in progress
+#define SPI_QUEUE_DONE                  ((uint8_t)(2U))          // Transfer queue completed or aborted
+
 // SPI1 Configuration
 #ifdef MX_SPI1
 
@@ -117,6 +138,14 @@ ARM_DRIVER_SPI Driver_SPI##x = {
 #else
   #define SPI1_PIN_NSS_STRUCT_PTR       NULL
 #endif
+
+// SPI1 transfer queue (requires Tx and Rx DMA)
+#if ((SPI1_DMA_USE == SPI_DMA_USE_TX_RX) && (SPI_QUEUE_MAX != 0U))
+  #define SPI1_QUEUE_EN                 1
+  #define SPI1_QUEUE_INFO_PTR           &SPI1_QueueInfo
+#else
+  #define SPI1_QUEUE_INFO_PTR           NULL
+#endif
 #endif
 
 //SPI2 Configuration
@@ -144,6 +173,14 @@ ARM_DRIVER_SPI Driver_SPI##x = {
 #else
   #define SPI2_PIN_NSS_STRUCT_PTR       NULL
 #endif
+
+// SPI2 transfer queue (requires Tx and Rx DMA)
+#if ((SPI2_DMA_USE == SPI_DMA_USE_TX_RX) && (SPI_QUEUE_MAX != 0U))
+  #define SPI2_QUEUE_EN                 1
+  #define SPI2_QUEUE_INFO_PTR           &SPI2_QueueInfo
+#else
+  #define SPI2_QUEUE_INFO_PTR           NULL
+#endif
 #endif
 
 // SPI3 Configuration
@@ -171,6 +208,14 @@ ARM_DRIVER_SPI Driver_SPI##x = {
 #else
   #define SPI3_PIN_NSS_STRUCT_PTR       NULL
 #endif
+
+// SPI3 transfer queue (requires Tx and Rx DMA)
+#if ((SPI3_DMA_USE == SPI_DMA_USE_TX_RX) && (SPI_QUEUE_MAX != 0U))
+  #define SPI3_QUEUE_EN                 1
+  #define SPI3_QUEUE_INFO_PTR           &SPI3_QueueInfo
+#else
+  #define SPI3_QUEUE_INFO_PTR           NULL
+#endif
 #endif
 
 #if ((defined(MX_SPI1) && defined(MX_SPI1_RX_DMA_Instance)) || \
@@ -186,6 +231,25 @@ ARM_DRIVER_SPI Driver_SPI##x = {
 #if (defined(__SPI_DMA_RX) && defined(__SPI_DMA_TX))
 #define __SPI_DMA
 #endif
+#if ((defined(MX_SPI1) && defined(SPI1_QUEUE_EN)) || \
+     (defined(MX_SPI2) && defined(SPI2_QUEUE_EN)) || \
+     (defined(MX_SPI3) && defined(SPI3_QUEUE_EN)))
+#define __SPI_QUEUE
+#endif
+
+// SPI Transfer queue entry
+typedef struct {
+  const void           *data_out;       // Pointer to data to send (NULL: send default Tx value)
+  void                 *data_in;        // Pointer to buffer for received data (NULL: discard received data)
+  uint32_t              num;            // Number of data items to transfer
+  uint32_t              flags;          // Transfer flags (SPI_QUEUE_SS_TOGGLE)
+} SPI_QUEUE_XFER;
+
+// SPI Transfer queue
+typedef struct {
+  const SPI_QUEUE_XFER *xfer;           // Pointer to array of transfers
+  uint32_t              num;            // Number of transfers (1 .. SPI_QUEUE_MAX)
+} SPI_QUEUE;
 
 // SPI pin
 typedef const struct {
@@ -204,10 +268,34 @@ typedef struct {
 
 // SPI Transfer Information (Run-Time)
 typedef struct {
+  const uint8_t        *tx_data;        // Pointer to transmit data buffer
+  uint8_t              *rx_data;        // Pointer to receive data buffer (NULL for send)
+  uint32_t              num;            // Total number of items to transfer
+  uint32_t              seg_cnt;        // Number of items transferred in completed segments
+  uint32_t              seg_len;        // Number of items in active segment
   uint16_t              def_val;        // Default transfer value
-  uint16_t              reserved;
+  uint8_t               dma_flag;       // DMA used for transfer
+  uint8_t               queue;          // Transfer queue state
 } SPI_TRANSFER_INFO;
 
+// SPI Transfer queue information (Run-Time)
+typedef struct _SPI_QUEUE_INFO SPI_QUEUE_INFO;
+#ifdef __SPI_QUEUE
+struct _SPI_QUEUE_INFO {
+  DMA_NodeTypeDef       tx_node[(SPI_QUEUE_MAX * 3U) + 1U]; // Tx nodes: transfer, Slave Select inactive/active, end
+  DMA_NodeTypeDef       rx_node[SPI_QUEUE_MAX];             // Rx nodes: transfer
+  DMA_QListTypeDef      tx_list;        // Tx linked-list queue
+  DMA_QListTypeDef      rx_list;        // Rx linked-list queue
+  const SPI_QUEUE_XFER *xfer;           // Prepared transfers
+  uint32_t              num;            // Number of prepared transfers (0 = none)
+  uint32_t              cnt;            // Number of items transferred by the stopped queue
+  uint32_t              def_val;        // Default transfer value (source of Tx nodes without data)
+  uint32_t              dummy;          // Destination of discarded data and of the end node
+  uint32_t              ss_inactive;    // GPIO BSRR value deactivating Slave Select
+  uint32_t              ss_active;      // GPIO BSRR value activating Slave Select
+};
+#endif
+
 
 // SPI Resources definition
 typedef struct {
@@ -216,6 +304,7 @@ typedef struct {
   SPI_PIN              *nss;            // NSS pin
   SPI_INFO             *info;           // Run-Time Information
   SPI_TRANSFER_INFO    *xfer;           // Transfer information
+  SPI_QUEUE_INFO       *queue;          // Transfer queue information (NULL if not available)
   uint32_t              dma_use;        // DMA use: bit0 - DMA_TX, bit1 -DMA_RX
 } SPI_RESOURCES;
 
@@ -62,6 +62,13 @@ The interface selection in STM32CubeMX selects the actual implementation that is
 STM32 HAL limitations:
  - Rx Overflow event can be detected only when send/receive/transfer operation is active
 
+Transmit queue:
+ - The transmit queue of the asynchronous driver (UART_TX_QUEUE_DEPTH) is not available
+   in synchronous mode. Send, Receive and Transfer share the generated clock and one HAL
+   transfer state, so queued sends would keep Receive and Transfer busy until the whole
+   queue is sent. Synchronous slave devices are accessed transfer by transfer, each Send
+   returns busy until the previous operation is completed.
+
 # Configuration
 
 ## STM32CubeMX
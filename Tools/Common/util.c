@@ -0,0 +1,499 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Common helpers for pack host tools
+ * -------------------------------------------------------------------------- */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util.h"
+
+#define FNV_OFFSET      0xCBF29CE484222325ULL
+#define FNV_PRIME       0x00000100000001B3ULL
+
+#define ARENA_CHUNK     0x10000U        // Default arena chunk size
+
+struct util_arena_chunk {
+  util_arena_chunk_t   *next;           // Previous chunk
+  size_t                size;           // Usable size
+  size_t                used;           // Used size
+  uint64_t              data[];         // Objects (8-byte aligned)
+};
+
+/* Abort on out of memory (tools have no meaningful way to recover) */
+static void *xrealloc (void *ptr, size_t size) {
+  void *p = realloc(ptr, size);
+
+  if (p == NULL) {
+    fprintf(stderr, "error: out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  return p;
+}
+
+/**
+  Map file into memory (read-only).
+  \param[in]    path   file path
+  \param[out]   file   mapped file
+  \return       0 on success, or -1 on error.
+*/
+int util_file_map (const char *path, util_file_t *file) {
+  struct stat st;
+  void *p;
+  int fd;
+
+  file->data = NULL;
+  file->size = 0U;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return -1;
+  }
+  if (st.st_size == 0) {
+    close(fd);
+    file->data = "";
+    return 0;
+  }
+  p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    return -1;
+  }
+  file->data = (const char *)p;
+  file->size = (size_t)st.st_size;
+  return 0;
+}
+
+/**
+  Unmap file mapped with util_file_map.
+  \param[in]    file   mapped file
+*/
+void util_file_unmap (util_file_t *file) {
+  if (file->size != 0U) {
+    munmap((void *)(uintptr_t)file->data, file->size);
+  }
+  file->data = NULL;
+  file->size = 0U;
+}
+
+/**
+  Write buffer to file (replaces the file atomically).
+  \param[in]    path   file path
+  \param[in]    data   file content
+  \param[in]    size   file size in bytes
+  \return       0 on success, or -1 on error.
+*/
+int util_file_write (const char *path, const void *data, size_t size) {
+  char  *tmp;
+  FILE  *f;
+  size_t len = strlen(path);
+  int    err = 0;
+
+  tmp = xrealloc(NULL, len + 5U);
+  memcpy(tmp, path, len);
+  memcpy(&tmp[len], ".tmp", 5U);
+
+  f = fopen(tmp, "wb");
+  if (f == NULL) {
+    free(tmp);
+    return -1;
+  }
+  if ((size != 0U) && (fwrite(data, 1U, size, f) != size)) {
+    err = -1;
+  }
+  if (fclose(f) != 0) {
+    err = -1;
+  }
+  if ((err == 0) && (rename(tmp, path) != 0)) {
+    err = -1;
+  }
+  if (err != 0) {
+    remove(tmp);
+  }
+  free(tmp);
+  return err;
+}
+
+/**
+  Initialize growable array.
+  \param[in]    vec    array
+  \param[in]    elem   element size in bytes
+*/
+void util_vec_init (util_vec_t *vec, size_t elem) {
+  vec->data = NULL;
+  vec->num  = 0U;
+  vec->cap  = 0U;
+  vec->elem = elem;
+}
+
+/**
+  Append elements to array.
+  \param[in]    vec    array
+  \param[in]    data   elements to append (NULL = zero initialized)
+  \param[in]    num    number of elements
+  \return       pointer to first appended element
+*/
+void *util_vec_append (util_vec_t *vec, const void *data, size_t num) {
+  char *p;
+
+  if ((vec->num + num) > vec->cap) {
+    size_t cap = (vec->cap != 0U) ? vec->cap : 16U;
+    while (cap < (vec->num + num)) {
+      cap *= 2U;
+    }
+    vec->data = xrealloc(vec->data, cap * vec->elem);
+    vec->cap  = cap;
+  }
+  p = (char *)vec->data + (vec->num * vec->elem);
+  if (data != NULL) {
+    memcpy(p, data, num * vec->elem);
+  } else {
+    memset(p, 0, num * vec->elem);
+  }
+  vec->num += num;
+  return p;
+}
+
+/**
+  Append one zero initialized element to array.
+  \param[in]    vec    array
+  \return       pointer to appended element
+*/
+void *util_vec_push (util_vec_t *vec) {
+  return util_vec_append(vec, NULL, 1U);
+}
+
+/**
+  Release array memory.
+  \param[in]    vec    array
+*/
+void util_vec_free (util_vec_t *vec) {
+  free(vec->data);
+  util_vec_init(vec, vec->elem);
+}
+
+/**
+  Calculate 64-bit FNV-1a hash.
+  \param[in]    data   data
+  \param[in]    size   data size in bytes
+  \return       hash value
+*/
+uint64_t util_hash (const void *data, size_t size) {
+  return util_hash_update(FNV_OFFSET, data, size);
+}
+
+/**
+  Continue 64-bit FNV-1a hash calculation.
+  \param[in]    hash   hash value of preceding data
+  \param[in]    data   data
+  \param[in]    size   data size in bytes
+  \return       hash value
+*/
+uint64_t util_hash_update (uint64_t hash, const void *data, size_t size) {
+  const uint8_t *p = (const uint8_t *)data;
+
+  while (size-- != 0U) {
+    hash ^= *p++;
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+  Initialize hash index.
+  \param[in]    idx    hash index
+*/
+void util_hindex_init (util_hindex_t *idx) {
+  idx->hash  = NULL;
+  idx->index = NULL;
+  idx->mask  = 0U;
+  idx->num   = 0U;
+}
+
+/**
+  Find element with given hash for which equality callback returns true.
+  \param[in]    idx    hash index
+  \param[in]    hash   content hash
+  \param[in]    eq     equality callback
+  \param[in]    ctx    callback context
+  \return       element index, or UINT32_MAX when not found
+*/
+uint32_t util_hindex_find (const util_hindex_t *idx, uint64_t hash, util_eq_t eq, void *ctx) {
+  uint32_t i;
+
+  if (idx->mask == 0U) {
+    return UINT32_MAX;
+  }
+  for (i = (uint32_t)hash & idx->mask; idx->index[i] != UINT32_MAX; i = (i + 1U) & idx->mask) {
+    if ((idx->hash[i] == hash) && (eq(ctx, idx->index[i]) != 0)) {
+      return idx->index[i];
+    }
+  }
+  return UINT32_MAX;
+}
+
+/* Insert slot without growing */
+static void hindex_insert (util_hindex_t *idx, uint64_t hash, uint32_t index) {
+  uint32_t i;
+
+  for (i = (uint32_t)hash & idx->mask; idx->index[i] != UINT32_MAX; i = (i + 1U) & idx->mask);
+  idx->hash[i]  = hash;
+  idx->index[i] = index;
+  idx->num++;
+}
+
+/**
+  Add element to hash index.
+  \param[in]    idx    hash index
+  \param[in]    hash   content hash
+  \param[in]    index  element index
+*/
+void util_hindex_add (util_hindex_t *idx, uint64_t hash, uint32_t index) {
+  if (((idx->num + 1U) * 2U) > idx->mask) {
+    util_hindex_t old = *idx;
+    uint32_t slots = (old.mask != 0U) ? ((old.mask + 1U) * 2U) : 1024U;
+    uint32_t i;
+
+    idx->hash  = xrealloc(NULL, slots * sizeof(uint64_t));
+    idx->index = xrealloc(NULL, slots * sizeof(uint32_t));
+    idx->mask  = slots - 1U;
+    idx->num   = 0U;
+    memset(idx->index, 0xFF, slots * sizeof(uint32_t));
+    if (old.mask != 0U) {
+      for (i = 0U; i <= old.mask; i++) {
+        if (old.index[i] != UINT32_MAX) {
+          hindex_insert(idx, old.hash[i], old.index[i]);
+        }
+      }
+    }
+    util_hindex_free(&old);
+  }
+  hindex_insert(idx, hash, index);
+}
+
+/**
+  Release hash index memory.
+  \param[in]    idx    hash index
+*/
+void util_hindex_free (util_hindex_t *idx) {
+  free(idx->hash);
+  free(idx->index);
+  util_hindex_init(idx);
+}
+
+/**
+  Initialize string pool.
+  \param[in]    pool   string pool
+*/
+void util_strpool_init (util_strpool_t *pool) {
+  util_vec_init(&pool->buf, 1U);
+  util_hindex_init(&pool->idx);
+  util_vec_push(&pool->buf);
+}
+
+/* String pool lookup context */
+typedef struct {
+  const util_strpool_t *pool;
+  const char           *str;
+  size_t                len;
+} strpool_key_t;
+
+static int strpool_eq (void *ctx, uint32_t index) {
+  const strpool_key_t *key = (const strpool_key_t *)ctx;
+  const char *s = (const char *)key->pool->buf.data + index;
+
+  return (memcmp(s, key->str, key->len) == 0) && (s[key->len] == '\0');
+}
+
+/**
+  Add string to pool (identical strings are stored once).
+  \param[in]    pool   string pool
+  \param[in]    str    string (need not be NUL terminated)
+  \param[in]    len    string length
+  \return       string offset within pool
+*/
+uint32_t util_strpool_add (util_strpool_t *pool, const char *str, size_t len) {
+  strpool_key_t key;
+  uint64_t hash;
+  uint32_t offs;
+  char    *p;
+
+  if (len == 0U) {
+    return 0U;
+  }
+  key.pool = pool;
+  key.str  = str;
+  key.len  = len;
+  hash = util_hash(str, len);
+  offs = util_hindex_find(&pool->idx, hash, strpool_eq, &key);
+  if (offs == UINT32_MAX) {
+    offs = (uint32_t)pool->buf.num;
+    p = util_vec_append(&pool->buf, NULL, len + 1U);
+    memcpy(p, str, len);
+    util_hindex_add(&pool->idx, hash, offs);
+  }
+  return offs;
+}
+
+/**
+  Release string pool memory.
+  \param[in]    pool   string pool
+*/
+void util_strpool_free (util_strpool_t *pool) {
+  util_vec_free(&pool->buf);
+  util_hindex_free(&pool->idx);
+}
+
+/**
+  Initialize arena allocator.
+  \param[out]   arena  arena
+*/
+void util_arena_init (util_arena_t *arena) {
+  arena->chunk    = NULL;
+  arena->used     = 0U;
+  arena->reserved = 0U;
+}
+
+/**
+  Allocate zero initialized, 8-byte aligned memory from arena.
+  \param[in]    arena  arena
+  \param[in]    size   size in bytes
+  \return       pointer to allocated memory
+*/
+void *util_arena_alloc (util_arena_t *arena, size_t size) {
+  util_arena_chunk_t *c = arena->chunk;
+  void *p;
+
+  size = (size + 7U) & ~(size_t)7U;
+  if ((c == NULL) || ((c->size - c->used) < size)) {
+    size_t n = (size > ARENA_CHUNK) ? size : ARENA_CHUNK;
+    c = xrealloc(NULL, sizeof(util_arena_chunk_t) + n);
+    c->next = arena->chunk;
+    c->size = n;
+    c->used = 0U;
+    arena->chunk     = c;
+    arena->reserved += sizeof(util_arena_chunk_t) + n;
+  }
+  p = (char *)c->data + c->used;
+  c->used     += size;
+  arena->used += size;
+  memset(p, 0, size);
+  return p;
+}
+
+/**
+  Copy string to arena.
+  \param[in]    arena  arena
+  \param[in]    str    string (need not be NUL terminated)
+  \param[in]    len    string length
+  \return       NUL terminated copy
+*/
+char *util_arena_strdup (util_arena_t *arena, const char *str, size_t len) {
+  char *s = util_arena_alloc(arena, len + 1U);
+
+  memcpy(s, str, len);
+  return s;
+}
+
+/**
+  Release all arena memory.
+  \param[in]    arena  arena
+*/
+void util_arena_free (util_arena_t *arena) {
+  util_arena_chunk_t *c = arena->chunk;
+
+  while (c != NULL) {
+    util_arena_chunk_t *next = c->next;
+    free(c);
+    c = next;
+  }
+  util_arena_init(arena);
+}
+
+/**
+  Parse number in SVD/PDSC notation (decimal, 0x hexadecimal, # binary).
+  \param[in]    str    text (leading and trailing white space is ignored)
+  \param[in]    len    text length
+  \param[out]   value  parsed value
+  \return       0 on success, or -1 on error.
+*/
+int util_parse_number (const char *str, size_t len, uint64_t *value) {
+  uint64_t v = 0U;
+  unsigned base = 10U;
+  unsigned d;
+  size_t   n = 0U;
+
+  while ((len != 0U) && ((*str == ' ') || (*str == '\t') || (*str == '\r') || (*str == '\n'))) {
+    str++; len--;
+  }
+  while ((len != 0U) && ((str[len-1U] == ' ') || (str[len-1U] == '\t') || (str[len-1U] == '\r') || (str[len-1U] == '\n'))) {
+    len--;
+  }
+  if ((len > 2U) && (str[0] == '0') && ((str[1] == 'x') || (str[1] == 'X'))) {
+    base = 16U; str += 2; len -= 2U;
+  } else if ((len > 1U) && (str[0] == '#')) {
+    base = 2U;  str += 1; len -= 1U;
+  }
+  for (; len != 0U; str++, len--) {
+    char c = *str;
+    if      ((c >= '0') && (c <= '9')) { d = (unsigned)(c - '0'); }
+    else if ((c >= 'a') && (c <= 'f')) { d = (unsigned)(c - 'a') + 10U; }
+    else if ((c >= 'A') && (c <= 'F')) { d = (unsigned)(c - 'A') + 10U; }
+    else if (((c == 'x') || (c == 'X')) && (base == 2U)) { d = 0U; }   // Don't care bit
+    else { return -1; }
+    if (d >= base) {
+      return -1;
+    }
+    v = (v * base) + d;
+    n++;
+  }
+  if (n == 0U) {
+    return -1;
+  }
+  *value = v;
+  return 0;
+}
+
+/**
+  Get monotonic time.
+  \return       time in milliseconds
+*/
+double util_time_ms (void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((double)ts.tv_sec * 1000.0) + ((double)ts.tv_nsec / 1000000.0);
+}
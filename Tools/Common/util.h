@@ -0,0 +1,109 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Common helpers for pack host tools
+ * -------------------------------------------------------------------------- */
+
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Memory-mapped (read-only) file */
+typedef struct {
+  const char           *data;           // File content
+  size_t                size;           // File size in bytes
+} util_file_t;
+
+/* Growable array of fixed-size elements */
+typedef struct {
+  void                 *data;           // Elements
+  size_t                num;            // Number of elements
+  size_t                cap;            // Allocated elements
+  size_t                elem;           // Element size in bytes
+} util_vec_t;
+
+/* Hash index: maps 64-bit content hash to element index */
+typedef struct {
+  uint64_t             *hash;           // Slot hash values
+  uint32_t             *index;          // Slot element index (UINT32_MAX = empty)
+  uint32_t              mask;           // Number of slots - 1
+  uint32_t              num;            // Number of used slots
+} util_hindex_t;
+
+/* Deduplicated string pool (offset 0 is the empty string) */
+typedef struct {
+  util_vec_t            buf;            // NUL terminated strings
+  util_hindex_t         idx;            // Hash index of string offsets
+} util_strpool_t;
+
+/* Arena allocator (objects are released together) */
+typedef struct util_arena_chunk util_arena_chunk_t;
+typedef struct {
+  util_arena_chunk_t   *chunk;          // Current chunk
+  size_t                used;           // Bytes allocated (statistics)
+  size_t                reserved;       // Bytes reserved from heap (statistics)
+} util_arena_t;
+
+/* Element equality callback used by hash index lookups */
+typedef int (*util_eq_t) (void *ctx, uint32_t index);
+
+extern int       util_file_map          (const char *path, util_file_t *file);
+extern void      util_file_unmap        (util_file_t *file);
+extern int       util_file_write        (const char *path, const void *data, size_t size);
+
+extern void      util_vec_init          (util_vec_t *vec, size_t elem);
+extern void     *util_vec_push          (util_vec_t *vec);
+extern void     *util_vec_append        (util_vec_t *vec, const void *data, size_t num);
+extern void      util_vec_free          (util_vec_t *vec);
+#define UTIL_VEC_AT(vec, type, i)       (((type *)(vec)->data)[i])
+
+extern uint64_t  util_hash              (const void *data, size_t size);
+extern uint64_t  util_hash_update       (uint64_t hash, const void *data, size_t size);
+
+extern void      util_hindex_init       (util_hindex_t *idx);
+extern uint32_t  util_hindex_find       (const util_hindex_t *idx, uint64_t hash, util_eq_t eq, void *ctx);
+extern void      util_hindex_add        (util_hindex_t *idx, uint64_t hash, uint32_t index);
+extern void      util_hindex_free       (util_hindex_t *idx);
+
+extern void      util_strpool_init      (util_strpool_t *pool);
+extern uint32_t  util_strpool_add       (util_strpool_t *pool, const char *str, size_t len);
+extern void      util_strpool_free      (util_strpool_t *pool);
+
+extern void      util_arena_init        (util_arena_t *arena);
+extern void     *util_arena_alloc       (util_arena_t *arena, size_t size);
+extern char     *util_arena_strdup      (util_arena_t *arena, const char *str, size_t len);
+extern void      util_arena_free        (util_arena_t *arena);
+
+extern int       util_parse_number      (const char *str, size_t len, uint64_t *value);
+extern double    util_time_ms           (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UTIL_H */
@@ -0,0 +1,439 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Streaming (zero-copy) XML tokenizer for pack host tools
+ * -------------------------------------------------------------------------- */
+
+/* The tokenizer works directly on a (memory-mapped) document buffer and
+ * reports start/end/text events with slices pointing into that buffer.
+ * It covers the XML subset used by PDSC and SVD files: elements, attributes,
+ * comments, CDATA, processing instructions and a DOCTYPE without internal
+ * subset. Entities are left encoded; use xml_unescape where needed.
+ *
+ * Parsing can be stopped by any callback and resumed with xml_run, and an
+ * element can be skipped without tokenizing its content (xml_skip).
+ */
+
+#include <string.h>
+
+#include "xml.h"
+
+#define IS_SPACE(c)     (((c) == ' ') || ((c) == '\t') || ((c) == '\r') || ((c) == '\n'))
+#define IS_NAME_END(c)  (IS_SPACE(c) || ((c) == '>') || ((c) == '/') || ((c) == '='))
+
+/* Find NUL terminated pattern in buffer, returns pointer to match or NULL */
+static const char *find (const char *p, const char *end, const char *pat) {
+  size_t n = strlen(pat);
+
+  while ((size_t)(end - p) >= n) {
+    p = memchr(p, pat[0], (size_t)(end - p) - (n - 1U));
+    if (p == NULL) {
+      return NULL;
+    }
+    if (memcmp(p, pat, n) == 0) {
+      return p;
+    }
+    p++;
+  }
+  return NULL;
+}
+
+/* Check if text consists of white space only */
+static int is_blank (const char *p, const char *end) {
+  for (; p < end; p++) {
+    if (!IS_SPACE(*p)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+  Initialize parser.
+  \param[out]   parser   parser state
+  \param[in]    buf      document
+  \param[in]    len      document length
+*/
+void xml_init (xml_parser_t *parser, const char *buf, size_t len) {
+  parser->buf   = buf;
+  parser->end   = buf + len;
+  parser->p     = buf;
+  parser->tag   = buf;
+  parser->depth = 0U;
+  parser->empty = 0;
+}
+
+/**
+  Parse (or continue parsing) document and report events to handler.
+  \param[in]    parser   parser state
+  \param[in]    handler  event callbacks (NULL entries are ignored)
+  \param[in]    ctx      callback context
+  \return       XML_OK, XML_STOP or XML_ERROR
+*/
+int xml_run (xml_parser_t *parser, const xml_handler_t *handler, void *ctx) {
+  xml_attr_t  attr[XML_ATTR_MAX];
+  uint32_t    attr_num;
+  const char *end = parser->end;
+  const char *p   = parser->p;
+  const char *q;
+  xml_str_t   name, text;
+  int         rc  = XML_OK;
+
+  // End of self-closing element whose start callback stopped parsing
+  if (parser->empty != 0) {
+    parser->empty = 0;
+    parser->depth--;
+    if ((handler->end != NULL) && (handler->end(ctx, parser->stack[parser->depth]) != 0)) {
+      return XML_STOP;
+    }
+  }
+
+  while ((p < end) && (rc == XML_OK)) {
+    // Character data up to next markup
+    q = memchr(p, '<', (size_t)(end - p));
+    if (q == NULL) {
+      q = end;
+    }
+    if ((q != p) && (parser->depth != 0U) && (handler->text != NULL) && !is_blank(p, q)) {
+      text.ptr = p;
+      text.len = (size_t)(q - p);
+      if (handler->text(ctx, text) != 0) {
+        p  = q;
+        rc = XML_STOP;
+        break;
+      }
+    }
+    p = q;
+    if (p == end) {
+      break;
+    }
+    parser->tag = p;
+
+    if ((end - p) >= 4 && (memcmp(p, "<!--", 4) == 0)) {
+      q = find(p + 4, end, "-->");
+      if (q == NULL) { rc = XML_ERROR; break; }
+      p = q + 3;
+    } else if ((end - p) >= 9 && (memcmp(p, "<![CDATA[", 9) == 0)) {
+      q = find(p + 9, end, "]]>");
+      if (q == NULL) { rc = XML_ERROR; break; }
+      p = q + 3;
+      if ((parser->depth != 0U) && (handler->text != NULL)) {
+        text.ptr = parser->tag + 9;
+        text.len = (size_t)(q - text.ptr);
+        if (handler->text(ctx, text) != 0) {
+          rc = XML_STOP;
+        }
+      }
+    } else if ((end - p) >= 2 && (p[1] == '?')) {
+      q = find(p + 2, end, "?>");
+      if (q == NULL) { rc = XML_ERROR; break; }
+      p = q + 2;
+    } else if ((end - p) >= 2 && (p[1] == '!')) {
+      q = memchr(p, '>', (size_t)(end - p));
+      if (q == NULL) { rc = XML_ERROR; break; }
+      p = q + 1;
+    } else if ((end - p) >= 2 && (p[1] == '/')) {
+      // End tag
+      name.ptr = p + 2;
+      for (q = name.ptr; (q < end) && !IS_NAME_END(*q); q++);
+      name.len = (size_t)(q - name.ptr);
+      while ((q < end) && IS_SPACE(*q)) { q++; }
+      if ((q == end) || (*q != '>') || (parser->depth == 0U)) { rc = XML_ERROR; break; }
+      parser->depth--;
+      if ((parser->stack[parser->depth].len != name.len) ||
+          (memcmp(parser->stack[parser->depth].ptr, name.ptr, name.len) != 0)) {
+        rc = XML_ERROR;
+        break;
+      }
+      p = q + 1;
+      parser->p = p;
+      if ((handler->end != NULL) && (handler->end(ctx, name) != 0)) {
+        rc = XML_STOP;
+      }
+    } else {
+      // Start tag with attributes
+      int empty = 0;
+
+      name.ptr = p + 1;
+      for (q = name.ptr; (q < end) && !IS_NAME_END(*q); q++);
+      name.len = (size_t)(q - name.ptr);
+      if (name.len == 0U) { rc = XML_ERROR; break; }
+      attr_num = 0U;
+      for (;;) {
+        char quote;
+
+        while ((q < end) && IS_SPACE(*q)) { q++; }
+        if (q == end) { rc = XML_ERROR; break; }
+        if (*q == '>') { q++; break; }
+        if (*q == '/') {
+          if (((end - q) < 2) || (q[1] != '>')) { rc = XML_ERROR; break; }
+          empty = 1;
+          q += 2;
+          break;
+        }
+        attr[attr_num].name.ptr = q;
+        for (; (q < end) && !IS_NAME_END(*q); q++);
+        attr[attr_num].name.len = (size_t)(q - attr[attr_num].name.ptr);
+        while ((q < end) && IS_SPACE(*q)) { q++; }
+        if ((q == end) || (*q != '=')) { rc = XML_ERROR; break; }
+        q++;
+        while ((q < end) && IS_SPACE(*q)) { q++; }
+        if ((q == end) || ((*q != '"') && (*q != '\''))) { rc = XML_ERROR; break; }
+        quote = *q++;
+        attr[attr_num].value.ptr = q;
+        q = memchr(q, quote, (size_t)(end - q));
+        if (q == NULL) { rc = XML_ERROR; break; }
+        attr[attr_num].value.len = (size_t)(q - attr[attr_num].value.ptr);
+        q++;
+        if (attr_num < (XML_ATTR_MAX - 1U)) {
+          attr_num++;
+        }
+      }
+      if (rc != XML_OK) {
+        break;
+      }
+      if (parser->depth == XML_DEPTH_MAX) { rc = XML_ERROR; break; }
+      parser->stack[parser->depth++] = name;
+      parser->p     = q;
+      parser->empty = empty;
+      if ((handler->start != NULL) && (handler->start(ctx, name, attr, attr_num) != 0)) {
+        rc = XML_STOP;
+      }
+      // Start callback may have skipped the element
+      p = parser->p;
+      if ((parser->empty != 0) && (rc == XML_OK)) {
+        parser->empty = 0;
+        parser->depth--;
+        if ((handler->end != NULL) && (handler->end(ctx, name) != 0)) {
+          rc = XML_STOP;
+        }
+      }
+    }
+  }
+
+  if ((rc == XML_OK) && (parser->depth != 0U)) {
+    rc = XML_ERROR;
+  }
+  parser->p = p;
+  return rc;
+}
+
+/**
+  Skip content and end tag of the element reported by the last start event.
+  Only tags with the same name are examined (comments containing such tags
+  are not supported), the content is not tokenized.
+  \param[in]    parser   parser state
+  \return       XML_OK or XML_ERROR
+*/
+int xml_skip (xml_parser_t *parser) {
+  const char *end = parser->end;
+  const char *p   = parser->p;
+  xml_str_t   name;
+  uint32_t    nest = 1U;
+
+  if (parser->depth == 0U) {
+    return XML_ERROR;
+  }
+  parser->depth--;
+  if (parser->empty != 0) {
+    parser->empty = 0;
+    return XML_OK;
+  }
+  name = parser->stack[parser->depth];
+
+  while (p < end) {
+    p = memchr(p, '<', (size_t)(end - p));
+    if (p == NULL) {
+      break;
+    }
+    p++;
+    if ((p < end) && (*p == '/')) {
+      if (((size_t)(end - p) > name.len + 1U) && (memcmp(p + 1, name.ptr, name.len) == 0) &&
+          ((p[name.len + 1U] == '>') || IS_SPACE(p[name.len + 1U]))) {
+        if (--nest == 0U) {
+          p = memchr(p, '>', (size_t)(end - p));
+          if (p == NULL) {
+            break;
+          }
+          parser->p = p + 1;
+          return XML_OK;
+        }
+      }
+    } else if (((size_t)(end - p) > name.len) && (memcmp(p, name.ptr, name.len) == 0) &&
+               IS_NAME_END(p[name.len])) {
+      const char *q = memchr(p, '>', (size_t)(end - p));
+      if ((q == NULL) || (q[-1] != '/')) {
+        nest++;
+      }
+    }
+  }
+  parser->p = end;
+  return XML_ERROR;
+}
+
+/**
+  Parse XML document and report events to handler.
+  \param[in]    buf      document
+  \param[in]    len      document length
+  \param[in]    handler  event callbacks (NULL entries are ignored)
+  \param[in]    ctx      callback context
+  \param[out]   pos      offset where parsing stopped (may be NULL)
+  \return       XML_OK, XML_STOP or XML_ERROR
+*/
+int xml_parse (const char *buf, size_t len, const xml_handler_t *handler, void *ctx, size_t *pos) {
+  xml_parser_t parser;
+  int rc;
+
+  xml_init(&parser, buf, len);
+  rc = xml_run(&parser, handler, ctx);
+  if (pos != NULL) {
+    *pos = (size_t)(parser.p - buf);
+  }
+  return rc;
+}
+
+/**
+  Get line number of buffer offset (for diagnostics).
+  \param[in]    buf    document
+  \param[in]    pos    offset
+  \return       line number (1-based)
+*/
+uint32_t xml_line (const char *buf, size_t pos) {
+  uint32_t line = 1U;
+  size_t   i;
+
+  for (i = 0U; i < pos; i++) {
+    if (buf[i] == '\n') {
+      line++;
+    }
+  }
+  return line;
+}
+
+/**
+  Compare string slice with NUL terminated literal.
+  \param[in]    str    string slice
+  \param[in]    lit    literal
+  \return       1 when equal, 0 otherwise
+*/
+int xml_eq (xml_str_t str, const char *lit) {
+  return (strncmp(str.ptr, lit, str.len) == 0) && (lit[str.len] == '\0');
+}
+
+/**
+  Remove leading and trailing white space.
+  \param[in]    str    string slice
+  \return       trimmed string slice
+*/
+xml_str_t xml_trim (xml_str_t str) {
+  while ((str.len != 0U) && IS_SPACE(str.ptr[0])) {
+    str.ptr++;
+    str.len--;
+  }
+  while ((str.len != 0U) && IS_SPACE(str.ptr[str.len - 1U])) {
+    str.len--;
+  }
+  return str;
+}
+
+/**
+  Decode predefined and numeric (ASCII) entities and collapse white space.
+  \param[out]   dst    destination buffer (at least src.len bytes)
+  \param[in]    src    encoded string slice
+  \return       decoded length (dst is not NUL terminated)
+*/
+size_t xml_unescape (char *dst, xml_str_t src) {
+  static const struct { const char *ent; size_t len; char ch; } ent[] = {
+    { "&amp;",  5U, '&'  },
+    { "&lt;",   4U, '<'  },
+    { "&gt;",   4U, '>'  },
+    { "&quot;", 6U, '"'  },
+    { "&apos;", 6U, '\'' }
+  };
+  size_t i, n = 0U;
+  size_t k;
+  int    space = 0;
+
+  src = xml_trim(src);
+  for (i = 0U; i < src.len; i++) {
+    char c = src.ptr[i];
+
+    if (IS_SPACE(c)) {
+      space = 1;
+      continue;
+    }
+    if (space != 0) {
+      dst[n++] = ' ';
+      space = 0;
+    }
+    if (c == '&') {
+      for (k = 0U; k < (sizeof(ent) / sizeof(ent[0])); k++) {
+        if (((src.len - i) >= ent[k].len) && (memcmp(&src.ptr[i], ent[k].ent, ent[k].len) == 0)) {
+          c  = ent[k].ch;
+          i += ent[k].len - 1U;
+          break;
+        }
+      }
+      if ((k == (sizeof(ent) / sizeof(ent[0]))) && ((src.len - i) > 3U) && (src.ptr[i+1U] == '#')) {
+        unsigned v = 0U;
+        size_t   j = i + 2U;
+        int      hex = 0;
+
+        if ((src.ptr[j] == 'x') || (src.ptr[j] == 'X')) {
+          hex = 1;
+          j++;
+        }
+        for (; (j < src.len) && (src.ptr[j] != ';'); j++) {
+          char d = src.ptr[j];
+          if      ((d >= '0') && (d <= '9'))              { v = (v * (hex ? 16U : 10U)) + (unsigned)(d - '0'); }
+          else if (hex && (d >= 'a') && (d <= 'f'))       { v = (v * 16U) + (unsigned)(d - 'a') + 10U; }
+          else if (hex && (d >= 'A') && (d <= 'F'))       { v = (v * 16U) + (unsigned)(d - 'A') + 10U; }
+          else { break; }
+        }
+        if ((j < src.len) && (src.ptr[j] == ';') && (v != 0U) && (v < 0x80U)) {
+          c = (char)v;
+          i = j;
+        }
+      }
+    }
+    dst[n++] = c;
+  }
+  return n;
+}
+
+/**
+  Find attribute by name.
+  \param[in]    attr      attributes
+  \param[in]    attr_num  number of attributes
+  \param[in]    name      attribute name
+  \return       attribute value, or NULL when not present
+*/
+const xml_str_t *xml_attr_find (const xml_attr_t *attr, uint32_t attr_num, const char *name) {
+  uint32_t i;
+
+  for (i = 0U; i < attr_num; i++) {
+    if (xml_eq(attr[i].name, name)) {
+      return &attr[i].value;
+    }
+  }
+  return NULL;
+}
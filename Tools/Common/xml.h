@@ -0,0 +1,89 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Streaming (zero-copy) XML tokenizer for pack host tools
+ * -------------------------------------------------------------------------- */
+
+#ifndef XML_H
+#define XML_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define XML_ATTR_MAX            16U     // Maximum attributes reported per element
+#define XML_DEPTH_MAX           64U     // Maximum element nesting
+
+/* Parser return codes */
+#define XML_OK                  0       // Document parsed completely
+#define XML_STOP                1       // Parsing stopped by a callback
+#define XML_ERROR             (-1)      // Malformed document
+
+/* Non NUL terminated string slice pointing into the parsed buffer */
+typedef struct {
+  const char           *ptr;
+  size_t                len;
+} xml_str_t;
+
+/* Element attribute (value is not entity decoded) */
+typedef struct {
+  xml_str_t             name;
+  xml_str_t             value;
+} xml_attr_t;
+
+/* Resumable parser state */
+typedef struct {
+  const char           *buf;                   // Document
+  const char           *end;                   // End of document
+  const char           *p;                     // Current position
+  const char           *tag;                   // Start of last reported tag
+  xml_str_t             stack[XML_DEPTH_MAX];   // Open elements
+  uint32_t              depth;                  // Number of open elements
+  int                   empty;                  // Current start tag is self-closing
+} xml_parser_t;
+
+/* Event callbacks: return 0 to continue, non-zero to stop parsing.
+   A start callback may call xml_skip() to skip the element content. */
+typedef struct {
+  int (*start) (void *ctx, xml_str_t name, const xml_attr_t *attr, uint32_t attr_num);
+  int (*end)   (void *ctx, xml_str_t name);
+  int (*text)  (void *ctx, xml_str_t text);
+} xml_handler_t;
+
+extern void      xml_init               (xml_parser_t *parser, const char *buf, size_t len);
+extern int       xml_run                (xml_parser_t *parser, const xml_handler_t *handler, void *ctx);
+extern int       xml_skip               (xml_parser_t *parser);
+extern int       xml_parse              (const char *buf, size_t len, const xml_handler_t *handler, void *ctx, size_t *pos);
+extern uint32_t  xml_line               (const char *buf, size_t pos);
+extern int       xml_eq                 (xml_str_t str, const char *lit);
+extern xml_str_t xml_trim               (xml_str_t str);
+extern size_t    xml_unescape           (char *dst, xml_str_t src);
+extern const xml_str_t *xml_attr_find   (const xml_attr_t *attr, uint32_t attr_num, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XML_H */
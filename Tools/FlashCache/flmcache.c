@@ -0,0 +1,748 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Flash algorithm build cache (input hashing and build)
+ * -------------------------------------------------------------------------- */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "flmcache.h"
+
+#ifndef PATH_MAX
+#define PATH_MAX        4096
+#endif
+
+#define KEY_VERSION     "flmcache 1"    // Changes all keys when the key computation changes
+#define JOBS_MAX        64U
+
+/* Scanned file (content hash and #include list are shared by all targets) */
+typedef struct {
+  const char           *path;           // Path as requested (project directory joined)
+  uint64_t              hash;           // Content hash
+  int                   exists;         // File found (with case-insensitive fallback)
+  const char * const   *inc;            // Included names, first character '"' or '<'
+  uint32_t              inc_num;
+  uint32_t              mark;           // Last target (index + 1) that visited the file
+} file_t;
+
+/* Scan state of one target */
+typedef struct {
+  flm_set_t            *set;
+  flm_target_t         *t;
+  uint32_t              mark;
+  char                  buf[PATH_MAX];
+} scan_t;
+
+/* Running build */
+typedef struct {
+  pid_t                 pid;
+  uint32_t              target;
+  int                   existed;        // Output existed before build
+  struct timespec       mtime;          // Output modification time before build
+  double                t0;
+} job_t;
+
+/**
+  Initialize empty project set.
+  \param[out]   set    project set
+*/
+void flm_init (flm_set_t *set) {
+  memset(set, 0, sizeof(*set));
+  util_arena_init(&set->arena);
+  util_vec_init(&set->target, sizeof(flm_target_t));
+  util_vec_init(&set->file, sizeof(file_t));
+  util_hindex_init(&set->file_idx);
+}
+
+/**
+  Release project set.
+  \param[in]    set    project set
+*/
+void flm_free (flm_set_t *set) {
+  size_t i;
+
+  for (i = 0U; i < set->target.num; i++) {
+    util_vec_free(&FLM_TARGET(set, i)->include);
+    util_vec_free(&FLM_TARGET(set, i)->source);
+    util_vec_free(&FLM_TARGET(set, i)->input);
+  }
+  util_vec_free(&set->target);
+  util_vec_free(&set->file);
+  util_hindex_free(&set->file_idx);
+  util_arena_free(&set->arena);
+}
+
+/* Join two paths and normalize '.' and '..' components (dir may be empty) */
+static const char *path_join (util_arena_t *arena, const char *dir, const char *rel) {
+  size_t      n = strlen(dir) + strlen(rel) + 3U;
+  char       *out = util_arena_alloc(arena, n), *o = out, *base, *s;
+  const char *src[2] = { dir, rel };
+  const char *p, *q;
+  size_t      k, len;
+
+  if (dir[0] == '/') {
+    *o++ = '/';
+  }
+  base = o;
+  for (k = 0U; k < 2U; k++) {
+    for (p = src[k]; *p != '\0'; p = q) {
+      q = p + strcspn(p, "/");
+      len = (size_t)(q - p);
+      if (*q == '/') {
+        q++;
+      }
+      if ((len == 0U) || ((len == 1U) && (p[0] == '.'))) {
+        continue;
+      }
+      if ((len == 2U) && (p[0] == '.') && (p[1] == '.')) {
+        // Remove last component unless it is '..' itself
+        s = o;
+        while ((s > base) && (s[-1] != '/')) {
+          s--;
+        }
+        if ((o > base) && !(((o - s) == 2) && (s[0] == '.') && (s[1] == '.'))) {
+          o = (s > base) ? s - 1 : base;
+          continue;
+        }
+      }
+      if (o > base) {
+        *o++ = '/';
+      }
+      memcpy(o, p, len);
+      o += len;
+    }
+  }
+  if (o == out) {
+    *o++ = '.';
+  }
+  *o = '\0';
+  return out;
+}
+
+/* Find path with case-insensitive match of missing components (projects come from
+   Windows hosts, for example "..\FlashOS.H"). Corrects path in place. */
+static int path_fix (char *path) {
+  struct stat    st;
+  struct dirent *ent;
+  DIR           *d;
+  char          *p, *end, save;
+  size_t         len;
+  int            found;
+
+  if (stat(path, &st) == 0) {
+    return 0;
+  }
+  for (p = path; *p != '\0'; p = (*end != '\0') ? end + 1 : end) {
+    end  = p + strcspn(p, "/");
+    len  = (size_t)(end - p);
+    save = *end;
+    *end = '\0';
+    if ((len == 0U) || (stat(path, &st) == 0)) {
+      *end = save;
+      continue;
+    }
+    // Search component in parent directory
+    if (p == path) {
+      d = opendir(".");
+    } else if (p == path + 1) {
+      d = opendir("/");
+    } else {
+      p[-1] = '\0';
+      d = opendir(path);
+      p[-1] = '/';
+    }
+    found = 0;
+    while ((d != NULL) && ((ent = readdir(d)) != NULL)) {
+      if ((strlen(ent->d_name) == len) && (strcasecmp(ent->d_name, p) == 0)) {
+        memcpy(p, ent->d_name, len);
+        found = 1;
+        break;
+      }
+    }
+    if (d != NULL) {
+      closedir(d);
+    }
+    *end = save;
+    if (found == 0) {
+      return -1;
+    }
+  }
+  return (stat(path, &st) == 0) && S_ISREG(st.st_mode) ? 0 : -1;
+}
+
+/* Collect #include names (all preprocessor branches: the input set is a superset) */
+static void scan_includes (flm_set_t *set, file_t *f, const char *p, const char *end) {
+  util_vec_t  inc;
+  const char *q;
+  char       *name;
+  char        close;
+  size_t      i;
+
+  util_vec_init(&inc, sizeof(const char *));
+  while (p < end) {
+    while ((p < end) && ((*p == ' ') || (*p == '\t'))) {
+      p++;
+    }
+    if ((p < end) && (*p == '#')) {
+      p++;
+      while ((p < end) && ((*p == ' ') || (*p == '\t'))) {
+        p++;
+      }
+      if (((size_t)(end - p) > 7U) && (memcmp(p, "include", 7U) == 0)) {
+        p += 7;
+        while ((p < end) && ((*p == ' ') || (*p == '\t'))) {
+          p++;
+        }
+        if ((p < end) && ((*p == '"') || (*p == '<'))) {
+          close = (*p == '"') ? '"' : '>';
+          for (q = p + 1; (q < end) && (*q != close) && (*q != '\n'); q++) {}
+          if ((q < end) && (*q == close) && (q > p + 1)) {
+            name = util_arena_strdup(&set->arena, p, (size_t)(q - p));
+            for (i = 1U; name[i] != '\0'; i++) {
+              if (name[i] == '\\') {
+                name[i] = '/';
+              }
+            }
+            *(const char **)util_vec_push(&inc) = name;
+          }
+        }
+      }
+    }
+    q = memchr(p, '\n', (size_t)(end - p));
+    p = (q != NULL) ? q + 1 : end;
+  }
+  if (inc.num != 0U) {
+    f->inc = util_arena_alloc(&set->arena, inc.num * sizeof(const char *));
+    memcpy((void *)(uintptr_t)f->inc, inc.data, inc.num * sizeof(const char *));
+    f->inc_num = (uint32_t)inc.num;
+  }
+  util_vec_free(&inc);
+}
+
+/* File cache lookup context */
+typedef struct {
+  flm_set_t            *set;
+  const char           *path;
+} file_key_t;
+
+static int file_eq (void *ctx, uint32_t index) {
+  const file_key_t *k = ctx;
+  return strcmp(UTIL_VEC_AT(&k->set->file, file_t, index).path, k->path) == 0;
+}
+
+/* Get file from cache, hash and scan it on first use */
+static uint32_t file_get (flm_set_t *set, const char *path) {
+  file_key_t  k = { set, path };
+  uint64_t    h = util_hash(path, strlen(path));
+  uint32_t    index = util_hindex_find(&set->file_idx, h, file_eq, &k);
+  util_file_t file;
+  file_t     *f;
+  char       *real;
+
+  if (index != UINT32_MAX) {
+    return index;
+  }
+  index = (uint32_t)set->file.num;
+  f = util_vec_push(&set->file);
+  f->path = path;
+  util_hindex_add(&set->file_idx, h, index);
+
+  real = util_arena_strdup(&set->arena, path, strlen(path));
+  if ((path_fix(real) == 0) && (util_file_map(real, &file) == 0)) {
+    f->exists = 1;
+    f->hash   = util_hash(file.data, file.size);
+    scan_includes(set, f, file.data, file.data + file.size);
+    util_file_unmap(&file);
+  }
+  return index;
+}
+
+/* Directory part of a relative path ("" for none) */
+static const char *dir_of (scan_t *s, const char *rel) {
+  const char *slash = strrchr(rel, '/');
+  size_t      len = (slash != NULL) ? (size_t)(slash - rel) : 0U;
+
+  memcpy(s->buf, rel, len);
+  s->buf[len] = '\0';
+  return s->buf;
+}
+
+/* Add file and (recursively) its includes to the target inputs */
+static void visit (scan_t *s, const char *rel, int source) {
+  flm_set_t          *set = s->set;
+  const char * const *inc;
+  const char         *cand, *name;
+  flm_input_t        *in;
+  file_t             *f;
+  uint32_t            fi, i, j, inc_num, num;
+
+  fi = file_get(set, path_join(&set->arena, s->t->dir, rel));
+  f  = &UTIL_VEC_AT(&set->file, file_t, fi);
+  if (f->mark == s->mark) {
+    return;
+  }
+  f->mark = s->mark;
+  if ((f->exists == 0) && (source == 0)) {
+    return;
+  }
+  in = util_vec_push(&s->t->input);
+  in->path   = rel;
+  in->hash   = f->hash;
+  in->exists = f->exists;
+  if (f->exists == 0) {
+    s->t->missing++;
+    return;
+  }
+
+  // Resolve includes: directory of the including file ("" only), include paths, project directory
+  inc     = f->inc;
+  inc_num = f->inc_num;
+  num     = (uint32_t)s->t->include.num;
+  for (i = 0U; i < inc_num; i++) {
+    name = &inc[i][1];
+    if ((name[0] == '/') || (name[1] == ':')) {
+      continue;
+    }
+    for (j = (inc[i][0] == '"') ? 0U : 1U; j <= num + 1U; j++) {
+      if (j == 0U) {
+        cand = path_join(&set->arena, dir_of(s, rel), name);
+      } else if (j <= num) {
+        cand = path_join(&set->arena, UTIL_VEC_AT(&s->t->include, const char *, j - 1U), name);
+      } else {
+        cand = path_join(&set->arena, "", name);
+      }
+      fi = file_get(set, path_join(&set->arena, s->t->dir, cand));
+      if (UTIL_VEC_AT(&set->file, file_t, fi).exists != 0) {
+        visit(s, cand, 0);
+        break;
+      }
+    }
+  }
+}
+
+static int cmp_input (const void *a, const void *b) {
+  return strcmp(((const flm_input_t *)a)->path, ((const flm_input_t *)b)->path);
+}
+
+/**
+  Collect inputs of all targets and compute their cache keys.
+  \param[in]    set    project set
+  \return       0 on success, or -1 on error.
+*/
+int flm_scan (flm_set_t *set) {
+  flm_target_t *t;
+  flm_input_t  *in;
+  scan_t        s;
+  uint32_t      i, j;
+  uint64_t      h;
+  uint8_t       exists;
+
+  s.set = set;
+  for (i = 0U; i < set->target.num; i++) {
+    t = FLM_TARGET(set, i);
+    s.t    = t;
+    s.mark = i + 1U;
+    t->input.num = 0U;
+    t->missing   = 0U;
+    for (j = 0U; j < t->source.num; j++) {
+      visit(&s, UTIL_VEC_AT(&t->source, const char *, j), 1);
+    }
+    if (t->scatter[0] != '\0') {
+      visit(&s, t->scatter, 1);
+    }
+    qsort(t->input.data, t->input.num, sizeof(flm_input_t), cmp_input);
+
+    h = util_hash(KEY_VERSION, sizeof(KEY_VERSION));
+    h = util_hash_update(h, &t->options, sizeof(t->options));
+    for (j = 0U; j < t->input.num; j++) {
+      in = &UTIL_VEC_AT(&t->input, flm_input_t, j);
+      exists = (uint8_t)in->exists;
+      h = util_hash_update(h, in->path, strlen(in->path) + 1U);
+      h = util_hash_update(h, &in->hash, sizeof(in->hash));
+      h = util_hash_update(h, &exists, sizeof(exists));
+    }
+    t->key = h;
+  }
+  return 0;
+}
+
+/* Cache entry path of a target (empty when too long) */
+static void cache_path (char *buf, size_t size, const char *cache, const flm_target_t *t, const char *ext) {
+  int n = snprintf(buf, size, "%s/%016llx.%s", cache, (unsigned long long)t->key, ext);
+
+  if ((n < 0) || ((size_t)n >= size)) {
+    buf[0] = '\0';
+  }
+}
+
+/* Output path of a target (empty when too long) */
+static void output_path (char *buf, size_t size, const flm_target_t *t) {
+  int n = snprintf(buf, size, "%s/%s", t->dir, t->output);
+
+  if ((n < 0) || ((size_t)n >= size)) {
+    buf[0] = '\0';
+  }
+}
+
+/* Copy file (destination replaced atomically) */
+static int copy_file (const char *from, const char *to) {
+  util_file_t file;
+  int         rc;
+
+  if (util_file_map(from, &file) != 0) {
+    return -1;
+  }
+  rc = util_file_write(to, file.data, file.size);
+  util_file_unmap(&file);
+  return rc;
+}
+
+/* Compare file contents (-1 if a file is missing) */
+static int same_file (const char *a, const char *b) {
+  util_file_t fa, fb;
+  int         rc;
+
+  if (util_file_map(a, &fa) != 0) {
+    return -1;
+  }
+  if (util_file_map(b, &fb) != 0) {
+    util_file_unmap(&fa);
+    return -1;
+  }
+  rc = (fa.size == fb.size) && (memcmp(fa.data, fb.data, fa.size) == 0);
+  util_file_unmap(&fb);
+  util_file_unmap(&fa);
+  return rc;
+}
+
+/**
+  Determine target states from the cache.
+  \param[in]    set    project set (scanned)
+  \param[in]    cache  cache directory
+  \return       0 on success, or -1 on error.
+*/
+int flm_state (flm_set_t *set, const char *cache) {
+  flm_target_t *t;
+  struct stat   st;
+  char          entry[PATH_MAX], out[PATH_MAX];
+  uint32_t      i;
+
+  for (i = 0U; i < set->target.num; i++) {
+    t = FLM_TARGET(set, i);
+    cache_path(entry, sizeof(entry), cache, t, "flm");
+    output_path(out, sizeof(out), t);
+    if (stat(entry, &st) != 0) {
+      t->state = FLM_BUILD;
+    } else {
+      t->state = (same_file(entry, out) == 1) ? FLM_UP_TO_DATE : FLM_RESTORE;
+    }
+  }
+  return 0;
+}
+
+/* Create directory and its parents */
+static int mkdir_p (const char *path) {
+  char   buf[PATH_MAX];
+  size_t i, len = strlen(path);
+
+  if (len >= sizeof(buf)) {
+    return -1;
+  }
+  memcpy(buf, path, len + 1U);
+  for (i = 1U; i <= len; i++) {
+    if ((buf[i] == '/') || (buf[i] == '\0')) {
+      buf[i] = '\0';
+      if ((mkdir(buf, 0777) != 0) && (errno != EEXIST)) {
+        return -1;
+      }
+      buf[i] = (i < len) ? '/' : '\0';
+    }
+  }
+  return 0;
+}
+
+/* Expand build command: %p project file, %t target, %o output, %% */
+static int expand (char *buf, size_t size, const char *cmd, const flm_target_t *t) {
+  const char *slash = strrchr(t->project, '/');
+  const char *project = (slash != NULL) ? slash + 1 : t->project;
+  const char *arg;
+  size_t      n = 0U;
+
+  for (; *cmd != '\0'; cmd++) {
+    arg = NULL;
+    if (cmd[0] == '%') {
+      switch (cmd[1]) {
+        case 'p': arg = project;   break;
+        case 't': arg = t->name;   break;
+        case 'o': arg = t->output; break;
+        case '%': arg = "%";       break;
+        default:                   break;
+      }
+    }
+    if (arg != NULL) {
+      n += (size_t)snprintf(&buf[(n < size) ? n : size - 1U], (n < size) ? size - n : 1U, "%s", arg);
+      cmd++;
+    } else if (n < size) {
+      buf[n++] = *cmd;
+    }
+  }
+  if (n >= size) {
+    return -1;
+  }
+  buf[n] = '\0';
+  return 0;
+}
+
+/* Start build of a target (runs in the project directory, output to log file) */
+static int job_start (job_t *job, flm_target_t *t, uint32_t index, const flm_options_t *opt, const char *cache) {
+  char        cmd[PATH_MAX], log[PATH_MAX], out[PATH_MAX];
+  struct stat st;
+  pid_t       pid;
+  int         fd;
+
+  if (expand(cmd, sizeof(cmd), opt->command, t) != 0) {
+    fprintf(stderr, "%s: error: target '%s': command too long\n", t->project, t->name);
+    return -1;
+  }
+  cache_path(log, sizeof(log), cache, t, "log");
+  output_path(out, sizeof(out), t);
+  job->existed = (stat(out, &st) == 0);
+  if (job->existed != 0) {
+    job->mtime = st.st_mtim;
+  }
+  if (opt->verbose != 0) {
+    printf("build   %s %s: %s\n", t->project, t->name, cmd);
+  }
+
+  pid = fork();
+  if (pid < 0) {
+    fprintf(stderr, "%s: error: target '%s': fork failed\n", t->project, t->name);
+    return -1;
+  }
+  if (pid == 0) {
+    fd = open(log, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if ((fd < 0) || (chdir(t->dir) != 0)) {
+      _exit(127);
+    }
+    dup2(fd, STDOUT_FILENO);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+    execl("/bin/sh", "sh", "-c", cmd, (char *)NULL);
+    _exit(127);
+  }
+  job->pid    = pid;
+  job->target = index;
+  job->t0     = util_time_ms();
+  return 0;
+}
+
+/* Finish build: check that the output was written and store it in the cache */
+static int job_finish (const job_t *job, flm_target_t *t, int status, const char *cache, int verbose) {
+  char        entry[PATH_MAX], log[PATH_MAX], out[PATH_MAX];
+  struct stat st;
+
+  cache_path(log, sizeof(log), cache, t, "log");
+  cache_path(entry, sizeof(entry), cache, t, "flm");
+  output_path(out, sizeof(out), t);
+
+  if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+    fprintf(stderr, "%s: error: target '%s' failed (exit %d), see %s\n", t->project, t->name,
+            WIFEXITED(status) ? WEXITSTATUS(status) : -1, log);
+    return -1;
+  }
+  if ((stat(out, &st) != 0) ||
+      ((job->existed != 0) && (st.st_mtim.tv_sec == job->mtime.tv_sec) && (st.st_mtim.tv_nsec == job->mtime.tv_nsec))) {
+    fprintf(stderr, "%s: error: target '%s': build did not write %s, see %s\n", t->project, t->name, out, log);
+    return -1;
+  }
+  if (copy_file(out, entry) != 0) {
+    fprintf(stderr, "%s: error: cannot write cache entry\n", entry);
+    return -1;
+  }
+  unlink(log);
+  t->state = FLM_UP_TO_DATE;
+  if (verbose != 0) {
+    printf("built   %s %s -> %s (%.0f ms)\n", t->project, t->name, t->output, util_time_ms() - job->t0);
+  }
+  return 0;
+}
+
+/**
+  Restore cached targets and build the others (targets of one project in sequence).
+  \param[in]    set    project set (scanned, states set by flm_state)
+  \param[in]    opt    build options
+  \return       0 on success, or -1 if a target failed.
+*/
+int flm_build (flm_set_t *set, const flm_options_t *opt) {
+  job_t         job[JOBS_MAX];
+  char          cache[PATH_MAX], entry[PATH_MAX], out[PATH_MAX];
+  flm_target_t *t;
+  uint8_t      *busy, *pending;
+  uint32_t      jobs = (opt->jobs == 0U) ? 1U : ((opt->jobs > JOBS_MAX) ? JOBS_MAX : opt->jobs);
+  uint32_t      i, running = 0U;
+  uint32_t      built = 0U, restored = 0U, failed = 0U;
+  pid_t         pid;
+  int           status;
+
+  if ((opt->dry_run == 0) &&
+      ((mkdir_p(opt->cache) != 0) || (realpath(opt->cache, cache) == NULL))) {
+    fprintf(stderr, "%s: error: cannot create cache directory\n", opt->cache);
+    return -1;
+  }
+  if (opt->dry_run != 0) {
+    snprintf(cache, sizeof(cache), "%s", opt->cache);
+  }
+
+  // Restore targets whose key is cached
+  for (i = 0U; i < set->target.num; i++) {
+    t = FLM_TARGET(set, i);
+    if (t->state != FLM_RESTORE) {
+      continue;
+    }
+    cache_path(entry, sizeof(entry), cache, t, "flm");
+    output_path(out, sizeof(out), t);
+    if (opt->dry_run != 0) {
+      printf("restore %s %s -> %s\n", t->project, t->name, t->output);
+    } else if (copy_file(entry, out) != 0) {
+      fprintf(stderr, "%s: error: cannot restore from %s\n", out, entry);
+      failed++;
+    } else {
+      t->state = FLM_UP_TO_DATE;
+      if (opt->verbose != 0) {
+        printf("restore %s %s -> %s\n", t->project, t->name, t->output);
+      }
+    }
+    restored++;
+  }
+
+  if (opt->dry_run != 0) {
+    for (i = 0U; i < set->target.num; i++) {
+      t = FLM_TARGET(set, i);
+      if ((t->state == FLM_BUILD) && (expand(out, sizeof(out), opt->command, t) == 0)) {
+        printf("build   %s %s: %s\n", t->project, t->name, out);
+        built++;
+      }
+    }
+    printf("%u targets: %u to restore, %u to build\n", (uint32_t)set->target.num, restored, built);
+    return 0;
+  }
+
+  // Build the remaining targets: at most one job per project (shared object directory)
+  pending = malloc(set->target.num + 1U);
+  busy    = calloc(set->project_num + 1U, 1U);
+  if ((pending == NULL) || (busy == NULL)) {
+    free(pending);
+    free(busy);
+    return -1;
+  }
+  for (i = 0U; i < set->target.num; i++) {
+    pending[i] = (FLM_TARGET(set, i)->state == FLM_BUILD);
+  }
+  for (;;) {
+    for (i = 0U; (i < set->target.num) && (running < jobs); i++) {
+      t = FLM_TARGET(set, i);
+      if ((pending[i] == 0U) || (busy[t->project_id] != 0U)) {
+        continue;
+      }
+      pending[i] = 0U;
+      if (job_start(&job[running], t, i, opt, cache) != 0) {
+        failed++;
+        continue;
+      }
+      busy[t->project_id] = 1U;
+      running++;
+    }
+    if (running == 0U) {
+      break;
+    }
+    pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    for (i = 0U; (i < running) && (job[i].pid != pid); i++) {}
+    if (i == running) {
+      continue;
+    }
+    t = FLM_TARGET(set, job[i].target);
+    if (job_finish(&job[i], t, status, cache, opt->verbose) != 0) {
+      failed++;
+    } else {
+      built++;
+    }
+    busy[t->project_id] = 0U;
+    job[i] = job[--running];
+  }
+  free(pending);
+  free(busy);
+
+  printf("%u targets: %u restored, %u built, %u failed\n", (uint32_t)set->target.num, restored, built, failed);
+  return (failed == 0U) ? 0 : -1;
+}
+
+/**
+  Store existing outputs in the cache for targets without cache entry
+  (for example the Flash algorithms committed with the pack sources).
+  \param[in]    set    project set (scanned, states set by flm_state)
+  \param[in]    cache  cache directory
+  \param[out]   num    number of stored entries
+  \return       0 on success, or -1 on error.
+*/
+int flm_adopt (flm_set_t *set, const char *cache, uint32_t *num) {
+  flm_target_t *t;
+  char          entry[PATH_MAX], out[PATH_MAX];
+  struct stat   st;
+  uint32_t      i;
+
+  *num = 0U;
+  if (mkdir_p(cache) != 0) {
+    fprintf(stderr, "%s: error: cannot create cache directory\n", cache);
+    return -1;
+  }
+  for (i = 0U; i < set->target.num; i++) {
+    t = FLM_TARGET(set, i);
+    output_path(out, sizeof(out), t);
+    if ((t->state != FLM_BUILD) || (stat(out, &st) != 0)) {
+      continue;
+    }
+    cache_path(entry, sizeof(entry), cache, t, "flm");
+    if (copy_file(out, entry) != 0) {
+      fprintf(stderr, "%s: error: cannot write cache entry\n", entry);
+      return -1;
+    }
+    t->state = FLM_UP_TO_DATE;
+    (*num)++;
+  }
+  return 0;
+}
@@ -0,0 +1,114 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Flash algorithm build cache
+ * -------------------------------------------------------------------------- */
+
+#ifndef FLMCACHE_H
+#define FLMCACHE_H
+
+#include <stdint.h>
+
+#include "util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Build cache
+ *
+ * Every target of a Flash algorithm project (*.uvprojx) is identified by a
+ * key: the hash of the target settings (the <Target> element, including
+ * toolchain version, defines, include paths and linker options) and of the
+ * content of all its inputs (source files, scatter file and all headers
+ * reached through #include from the project include paths). Paths enter the
+ * key relative to the project directory, so the key does not depend on the
+ * checkout location.
+ *
+ * The cache directory holds one file <key>.flm per built target. A target
+ * whose key is in the cache is restored from there; only targets with a new
+ * key are built. Targets of one project share the object directory and are
+ * built one after the other, different projects in parallel.
+ */
+
+/* Target state */
+#define FLM_UP_TO_DATE          0U      // Output matches cache entry
+#define FLM_RESTORE             1U      // Cache entry exists, output differs or is missing
+#define FLM_BUILD               2U      // No cache entry for the key
+
+/* Target input */
+typedef struct {
+  const char           *path;           // Path relative to project directory
+  uint64_t              hash;           // Content hash
+  int                   exists;         // File found
+} flm_input_t;
+
+/* Target of a Flash algorithm project */
+typedef struct {
+  const char           *project;        // Project file
+  const char           *dir;            // Project directory
+  const char           *name;           // TargetName
+  const char           *output;         // Output FLM (relative to project directory)
+  const char           *scatter;        // Scatter file (relative, "" if none)
+  uint32_t              project_id;     // Project index (targets of a project are serialized)
+  uint64_t              options;        // Hash of the <Target> element
+  util_vec_t            include;        // Include paths (const char *, relative)
+  util_vec_t            source;         // Source files (const char *, relative)
+  util_vec_t            input;          // flm_input_t (sorted by path), set by flm_scan
+  uint64_t              key;            // Cache key, set by flm_scan
+  uint32_t              missing;        // Number of missing sources
+  uint32_t              state;          // FLM_x, set by flm_state
+} flm_target_t;
+
+/* Loaded projects */
+typedef struct {
+  util_arena_t          arena;          // Strings
+  util_vec_t            target;         // flm_target_t
+  util_vec_t            file;           // Scanned files (file cache of flmcache.c)
+  util_hindex_t         file_idx;
+  uint32_t              project_num;
+} flm_set_t;
+
+/* Build options */
+typedef struct {
+  const char           *cache;          // Cache directory
+  const char           *command;        // Build command (%p project, %t target, %o output)
+  uint32_t              jobs;           // Parallel builds
+  int                   dry_run;        // Print actions only
+  int                   verbose;
+} flm_options_t;
+
+extern void      flm_init               (flm_set_t *set);
+extern void      flm_free               (flm_set_t *set);
+extern int       flm_load               (flm_set_t *set, const char *project);
+extern int       flm_scan               (flm_set_t *set);
+extern int       flm_state              (flm_set_t *set, const char *cache);
+extern int       flm_build              (flm_set_t *set, const flm_options_t *opt);
+extern int       flm_adopt              (flm_set_t *set, const char *cache, uint32_t *num);
+
+#define FLM_TARGET(set, i)      (&UTIL_VEC_AT(&(set)->target, flm_target_t, i))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLMCACHE_H */
@@ -0,0 +1,180 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Flash algorithm build cache command line tool
+ * -------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "flmcache.h"
+
+#define DEFAULT_CACHE   ".flmcache"
+#define DEFAULT_COMMAND "UV4 -j0 -b %p -t %t"   // Overridden by -c or FLMCACHE_CMD
+
+static void usage (void) {
+  fprintf(stderr,
+    "usage: flmcache status [-C <cache>] <uvprojx>...\n"
+    "       flmcache build  [-C <cache>] [-j <jobs>] [-c <command>] [-n] [-v] <uvprojx>...\n"
+    "       flmcache adopt  [-C <cache>] <uvprojx>...\n"
+    "       flmcache inputs <uvprojx> [<target>]\n"
+    "command: %%p project file, %%t target name, %%o output (run in the project directory)\n");
+}
+
+/* Load and scan projects */
+static int load (flm_set_t *set, int argc, char **argv) {
+  int i;
+
+  if (argc == 0) {
+    usage();
+    return -1;
+  }
+  for (i = 0; i < argc; i++) {
+    if (flm_load(set, argv[i]) != 0) {
+      return -1;
+    }
+  }
+  return flm_scan(set);
+}
+
+static int cmd_status (flm_set_t *set, const char *cache) {
+  static const char * const state[] = { "ok", "restore", "build" };
+  flm_target_t *t;
+  uint32_t      i, num[3] = { 0U, 0U, 0U };
+
+  if (flm_state(set, cache) != 0) {
+    return EXIT_FAILURE;
+  }
+  for (i = 0U; i < set->target.num; i++) {
+    t = FLM_TARGET(set, i);
+    num[t->state]++;
+    printf("%-8s %016llx %s %s -> %s (%u inputs", state[t->state], (unsigned long long)t->key,
+           t->project, t->name, t->output, (uint32_t)t->input.num);
+    if (t->missing != 0U) {
+      printf(", %u missing", t->missing);
+    }
+    printf(")\n");
+  }
+  printf("%u targets: %u up to date, %u to restore, %u to build\n",
+         (uint32_t)set->target.num, num[FLM_UP_TO_DATE], num[FLM_RESTORE], num[FLM_BUILD]);
+  return EXIT_SUCCESS;
+}
+
+static int cmd_inputs (flm_set_t *set, const char *target) {
+  const flm_input_t  *in;
+  const flm_target_t *t;
+  uint32_t            i, j, found = 0U;
+
+  for (i = 0U; i < set->target.num; i++) {
+    t = FLM_TARGET(set, i);
+    if ((target != NULL) && (strcmp(t->name, target) != 0)) {
+      continue;
+    }
+    found++;
+    printf("%s %s -> %s, key %016llx\n", t->project, t->name, t->output, (unsigned long long)t->key);
+    for (j = 0U; j < t->input.num; j++) {
+      in = &UTIL_VEC_AT(&t->input, flm_input_t, j);
+      if (in->exists != 0) {
+        printf("  %016llx %s\n", (unsigned long long)in->hash, in->path);
+      } else {
+        printf("  %-16s %s\n", "missing", in->path);
+      }
+    }
+  }
+  if (found == 0U) {
+    fprintf(stderr, "error: target '%s' not found\n", target);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int main (int argc, char **argv) {
+  flm_options_t opt;
+  flm_set_t     set;
+  const char   *cmd;
+  const char   *env = getenv("FLMCACHE_CMD");
+  uint32_t      num;
+  long          cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  double        t0;
+  int           c, rc = EXIT_FAILURE;
+
+  if (argc < 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  cmd = argv[1];
+  memset(&opt, 0, sizeof(opt));
+  opt.cache   = DEFAULT_CACHE;
+  opt.command = (env != NULL) ? env : DEFAULT_COMMAND;
+  opt.jobs    = (cpus > 0) ? (uint32_t)cpus : 1U;
+
+  optind = 2;
+  while ((c = getopt(argc, argv, "C:j:c:nv")) != -1) {
+    switch (c) {
+      case 'C': opt.cache   = optarg;                         break;
+      case 'j': opt.jobs    = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'c': opt.command = optarg;                         break;
+      case 'n': opt.dry_run = 1;                              break;
+      case 'v': opt.verbose = 1;                              break;
+      default:
+        usage();
+        return EXIT_FAILURE;
+    }
+  }
+  argc -= optind;
+  argv += optind;
+
+  flm_init(&set);
+  t0 = util_time_ms();
+  if (strcmp(cmd, "inputs") == 0) {
+    if ((argc == 1) || (argc == 2)) {
+      if (load(&set, 1, argv) == 0) {
+        rc = cmd_inputs(&set, (argc == 2) ? argv[1] : NULL);
+      }
+    } else {
+      usage();
+    }
+  } else if ((strcmp(cmd, "status") == 0) || (strcmp(cmd, "build") == 0) || (strcmp(cmd, "adopt") == 0)) {
+    if (load(&set, argc, argv) == 0) {
+      if (opt.verbose != 0) {
+        printf("scan:    %u targets, %u files hashed, %.1f ms\n",
+               (uint32_t)set.target.num, (uint32_t)set.file.num, util_time_ms() - t0);
+      }
+      if (strcmp(cmd, "status") == 0) {
+        rc = cmd_status(&set, opt.cache);
+      } else if (flm_state(&set, opt.cache) == 0) {
+        if (strcmp(cmd, "build") == 0) {
+          rc = (flm_build(&set, &opt) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+        } else if (flm_adopt(&set, opt.cache, &num) == 0) {
+          printf("%u outputs stored in %s\n", num, opt.cache);
+          rc = EXIT_SUCCESS;
+        }
+      }
+    }
+  } else {
+    usage();
+  }
+  flm_free(&set);
+  return rc;
+}
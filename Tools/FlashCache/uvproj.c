@@ -0,0 +1,334 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Flash algorithm build cache (uVision project reader)
+ * -------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "flmcache.h"
+#include "xml.h"
+
+/* Element whose text is collected */
+enum {
+  TEXT_NONE = 0,
+  TEXT_TARGET_NAME,
+  TEXT_OUTPUT_DIR,
+  TEXT_OUTPUT_NAME,
+  TEXT_RUN_USER_PROG1,
+  TEXT_USER_PROG1,
+  TEXT_INCLUDE_PATH,
+  TEXT_SCATTER_FILE,
+  TEXT_FILE_PATH
+};
+
+/* Reader state */
+typedef struct {
+  flm_set_t            *set;
+  const char           *project;
+  const char           *dir;
+  const char           *data;           // Document
+  xml_parser_t         *xml;
+  flm_target_t         *target;         // Target being read (NULL outside <Target>)
+  const char           *target_start;   // Start of <Target> element
+  uint32_t              target_num;
+  int                   text_kind;      // TEXT_x of current element
+  util_vec_t            text;           // Collected text
+  int                   in_after_make;  // Inside <AfterMake>
+  int                   in_compiler;    // Inside <Cads> or <Aads>
+  char                 *output_dir;     // OutputDirectory
+  char                 *user_prog1;     // AfterMake UserProg1Name
+  int                   run_user_prog1; // AfterMake RunUserProg1
+} reader_t;
+
+/* Convert Windows path to normalized relative path (NULL for absolute paths) */
+static char *rel_path (reader_t *r, const char *path, size_t len) {
+  char  *out = util_arena_strdup(&r->set->arena, path, len);
+  size_t i;
+
+  if (len == 0U) {
+    return out;
+  }
+  for (i = 0U; i < len; i++) {
+    if (out[i] == '\\') {
+      out[i] = '/';
+    }
+  }
+  if ((out[0] == '/') || ((len >= 2U) && (out[1] == ':'))) {
+    return NULL;
+  }
+  while ((out[0] == '.') && (out[1] == '/')) {
+    out += 2;
+  }
+  len = strlen(out);
+  while ((len > 1U) && (out[len - 1U] == '/')) {
+    out[--len] = '\0';
+  }
+  return out;
+}
+
+/* Add ';' separated include paths */
+static void add_include_paths (reader_t *r, const char *list) {
+  const char *p = list, *q;
+  char       *path;
+
+  while (*p != '\0') {
+    q = strchr(p, ';');
+    if (q == NULL) {
+      q = p + strlen(p);
+    }
+    while ((p < q) && (*p == ' ')) {
+      p++;
+    }
+    if (p < q) {
+      path = rel_path(r, p, (size_t)(q - p));
+      if ((path != NULL) && (path[0] != '\0') && (strcmp(path, ".") != 0)) {
+        *(const char **)util_vec_push(&r->target->include) = path;
+      }
+    }
+    p = (*q == ';') ? q + 1 : q;
+  }
+}
+
+/* Output FLM path: destination of the AfterMake copy command
+   (cmd.exe /C copy "!L" "..\@L.FLM"), else the linker output */
+static const char *output_path (reader_t *r) {
+  const char *name = r->target->output;
+  const char *q0 = NULL, *q1 = NULL, *p;
+  char        buf[512];
+  size_t      n = 0U;
+
+  if ((r->run_user_prog1 != 0) && (r->user_prog1 != NULL)) {
+    for (p = r->user_prog1; *p != '\0'; p++) {
+      if (*p == '"') {
+        if (q1 != NULL) {
+          q0 = q1 = NULL;
+        }
+        if (q0 == NULL) {
+          q0 = p + 1;
+        } else {
+          q1 = p;
+        }
+      }
+    }
+    if ((q0 != NULL) && (q1 != NULL)) {
+      for (p = q0; (p < q1) && (n < (sizeof(buf) - 1U)); p++) {
+        if ((p + 1 < q1) && (p[0] == '@') && (p[1] == 'L')) {
+          n += (size_t)snprintf(&buf[n], sizeof(buf) - n, "%s", name);
+          if (n >= sizeof(buf)) {
+            return NULL;
+          }
+          p++;
+        } else {
+          buf[n++] = *p;
+        }
+      }
+      return rel_path(r, buf, n);
+    }
+  }
+  if ((r->output_dir != NULL) && (r->output_dir[0] != '\0')) {
+    n = (size_t)snprintf(buf, sizeof(buf), "%s/%s.axf", r->output_dir, name);
+  } else {
+    n = (size_t)snprintf(buf, sizeof(buf), "%s.axf", name);
+  }
+  return (n < sizeof(buf)) ? rel_path(r, buf, n) : NULL;
+}
+
+static int on_start (void *ctx, xml_str_t name, const xml_attr_t *attr, uint32_t num) {
+  reader_t *r = ctx;
+
+  (void)attr;
+  (void)num;
+
+  r->text_kind = TEXT_NONE;
+  if (xml_eq(name, "Target")) {
+    r->target = util_vec_push(&r->set->target);
+    r->target_start = r->xml->tag;
+    r->target->project    = r->project;
+    r->target->dir        = r->dir;
+    r->target->name       = "";
+    r->target->output     = "";
+    r->target->scatter    = "";
+    r->target->project_id = r->set->project_num;
+    util_vec_init(&r->target->include, sizeof(const char *));
+    util_vec_init(&r->target->source,  sizeof(const char *));
+    util_vec_init(&r->target->input,   sizeof(flm_input_t));
+    r->output_dir     = NULL;
+    r->user_prog1     = NULL;
+    r->run_user_prog1 = 0;
+    r->target_num++;
+    return 0;
+  }
+  if (r->target == NULL) {
+    return 0;
+  }
+  if (xml_eq(name, "AfterMake")) {
+    r->in_after_make = 1;
+  } else if (xml_eq(name, "Cads") || xml_eq(name, "Aads")) {
+    r->in_compiler = 1;
+  } else if (xml_eq(name, "TargetName")) {
+    r->text_kind = TEXT_TARGET_NAME;
+  } else if (xml_eq(name, "OutputDirectory")) {
+    r->text_kind = TEXT_OUTPUT_DIR;
+  } else if (xml_eq(name, "OutputName")) {
+    r->text_kind = TEXT_OUTPUT_NAME;
+  } else if (xml_eq(name, "RunUserProg1") && (r->in_after_make != 0)) {
+    r->text_kind = TEXT_RUN_USER_PROG1;
+  } else if (xml_eq(name, "UserProg1Name") && (r->in_after_make != 0)) {
+    r->text_kind = TEXT_USER_PROG1;
+  } else if (xml_eq(name, "IncludePath") && (r->in_compiler != 0)) {
+    r->text_kind = TEXT_INCLUDE_PATH;
+  } else if (xml_eq(name, "ScatterFile")) {
+    r->text_kind = TEXT_SCATTER_FILE;
+  } else if (xml_eq(name, "FilePath")) {
+    r->text_kind = TEXT_FILE_PATH;
+  }
+  r->text.num = 0U;
+  return 0;
+}
+
+static int on_text (void *ctx, xml_str_t text) {
+  reader_t *r = ctx;
+  size_t    n = r->text.num;
+
+  if (r->text_kind != TEXT_NONE) {
+    util_vec_append(&r->text, NULL, text.len + 1U);
+    n += xml_unescape((char *)r->text.data + n, text);
+    r->text.num = n;
+  }
+  return 0;
+}
+
+static int on_end (void *ctx, xml_str_t name) {
+  reader_t     *r = ctx;
+  flm_target_t *t = r->target;
+  const char   *text;
+  char         *path;
+  size_t        len;
+
+  if (t == NULL) {
+    return 0;
+  }
+  util_vec_append(&r->text, NULL, 1U);
+  text = r->text.data;
+  len  = r->text.num - 1U;
+
+  switch (r->text_kind) {
+    case TEXT_TARGET_NAME:
+      t->name = util_arena_strdup(&r->set->arena, text, len);
+      break;
+    case TEXT_OUTPUT_DIR:
+      r->output_dir = rel_path(r, text, len);
+      break;
+    case TEXT_OUTPUT_NAME:
+      t->output = util_arena_strdup(&r->set->arena, text, len);
+      break;
+    case TEXT_RUN_USER_PROG1:
+      r->run_user_prog1 = (strcmp(text, "1") == 0);
+      break;
+    case TEXT_USER_PROG1:
+      r->user_prog1 = util_arena_strdup(&r->set->arena, text, len);
+      break;
+    case TEXT_INCLUDE_PATH:
+      add_include_paths(r, text);
+      break;
+    case TEXT_SCATTER_FILE:
+      if (len != 0U) {
+        path = rel_path(r, text, len);
+        t->scatter = (path != NULL) ? path : "";
+      }
+      break;
+    case TEXT_FILE_PATH:
+      path = rel_path(r, text, len);
+      if (path != NULL) {
+        *(const char **)util_vec_push(&t->source) = path;
+      } else {
+        fprintf(stderr, "%s: warning: target '%s': absolute path '%s' ignored\n", r->project, t->name, text);
+      }
+      break;
+    default:
+      break;
+  }
+  r->text_kind = TEXT_NONE;
+  r->text.num  = 0U;
+
+  if (xml_eq(name, "AfterMake")) {
+    r->in_after_make = 0;
+  } else if (xml_eq(name, "Cads") || xml_eq(name, "Aads")) {
+    r->in_compiler = 0;
+  } else if (xml_eq(name, "Target")) {
+    // Settings hash covers the whole <Target> element
+    t->options = util_hash(r->target_start, (size_t)(r->xml->p - r->target_start));
+    t->output  = output_path(r);
+    if (t->output == NULL) {
+      fprintf(stderr, "%s: error: target '%s': invalid output path\n", r->project, t->name);
+      return 1;
+    }
+    r->target = NULL;
+  }
+  return 0;
+}
+
+/**
+  Load targets of a uVision project.
+  \param[in]    set      project set
+  \param[in]    project  project file (*.uvprojx)
+  \return       0 on success, or -1 on error.
+*/
+int flm_load (flm_set_t *set, const char *project) {
+  static const xml_handler_t handler = { on_start, on_end, on_text };
+  xml_parser_t xml;
+  util_file_t  file;
+  reader_t     r;
+  const char  *slash = strrchr(project, '/');
+  int          rc;
+
+  if (util_file_map(project, &file) != 0) {
+    fprintf(stderr, "%s: error: cannot open file\n", project);
+    return -1;
+  }
+  memset(&r, 0, sizeof(r));
+  r.set     = set;
+  r.project = util_arena_strdup(&set->arena, project, strlen(project));
+  r.dir     = (slash != NULL) ? util_arena_strdup(&set->arena, project, (size_t)(slash - project)) : ".";
+  r.data    = file.data;
+  r.xml     = &xml;
+  util_vec_init(&r.text, 1U);
+
+  xml_init(&xml, file.data, file.size);
+  rc = xml_run(&xml, &handler, &r);
+  util_vec_free(&r.text);
+  if (rc != XML_OK) {
+    if (rc == XML_ERROR) {
+      fprintf(stderr, "%s:%u: error: malformed XML\n", project, xml_line(file.data, (size_t)(xml.p - file.data)));
+    }
+    util_file_unmap(&file);
+    return -1;
+  }
+  util_file_unmap(&file);
+  if (r.target_num == 0U) {
+    fprintf(stderr, "%s: warning: no targets\n", project);
+  }
+  set->project_num++;
+  return 0;
+}
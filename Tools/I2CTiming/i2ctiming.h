@@ -0,0 +1,49 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      I2C TIMINGR solver check and benchmark
+ * -------------------------------------------------------------------------- */
+
+#ifndef I2CTIMING_H
+#define I2CTIMING_H
+
+#include <stdint.h>
+
+/* Bus speed change as done by ARM_I2C_BUS_SPEED of the drivers */
+typedef struct {
+  uint32_t fpclk;               /* Kernel clock frequency (Hz) */
+  uint32_t speed;               /* 0 = standard, 1 = fast, 2 = fast plus */
+  uint32_t dnf;                 /* Digital noise filter coefficient (0..15) */
+  uint32_t anf;                 /* Analog noise filter enabled */
+} i2c_timing_case_t;
+
+/* TIMING register solver (generated from a driver source) */
+typedef struct {
+  const char *name;
+  uint32_t  (*solve) (const i2c_timing_case_t *c, uint32_t *error);   /* error: SCL period error (ns), 0xFFFF = no solution */
+} i2c_timing_solver_t;
+
+extern const i2c_timing_solver_t i2c_timing_stm32h7xx;    /* I2C_STM32H7xx.c */
+extern const i2c_timing_solver_t i2c_timing_stm32u5xx;    /* I2C_STM32U5xx.c */
+extern const i2c_timing_solver_t i2c_timing_exhaustive;   /* exhaustive.inc (reference) */
+
+#endif /* I2CTIMING_H */
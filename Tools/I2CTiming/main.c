@@ -0,0 +1,182 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      I2C TIMINGR solver check and benchmark
+ * -------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "i2ctiming.h"
+#include "util.h"
+
+static const i2c_timing_solver_t *solvers[] = {
+  &i2c_timing_stm32h7xx,
+  &i2c_timing_stm32u5xx
+};
+#define SOLVER_NUM      (sizeof(solvers) / sizeof(solvers[0]))
+
+static const char *speed_name[3] = { "standard", "fast", "fast plus" };
+
+/* Kernel clocks beside the 0.5 MHz grid (HSI/CSI, PLL and bus clocks) */
+static const uint32_t clk_extra[] = {
+  4000000, 16000000, 48000000, 64000000, 137500000, 133333333, 66666666, 33333333, 83333333
+};
+
+/* Kernel clocks of the benchmark */
+static const uint32_t clk_bench[] = {
+  4000000, 16000000, 64000000, 100000000, 120000000, 137500000, 160000000, 200000000
+};
+
+static void usage (void) {
+  fprintf(stderr,
+    "usage: i2ctiming check      compare solvers with the exhaustive search\n"
+    "       i2ctiming bench      time per bus speed change\n");
+}
+
+/* Check one case of all solvers against the reference */
+static int check_case (const i2c_timing_case_t *c, uint32_t stat[SOLVER_NUM][3]) {
+  uint32_t ref, ref_err, val, err;
+  uint32_t i;
+  int      fail = 0;
+
+  ref = i2c_timing_exhaustive.solve(c, &ref_err);
+
+  for (i = 0U; i < SOLVER_NUM; i++) {
+    val = solvers[i]->solve(c, &err);
+
+    if (val == ref) {
+      stat[i][0]++;
+    } else if (err < ref_err) {
+      stat[i][1]++;
+    } else {
+      stat[i][2]++;
+      if (fail == 0) {
+        printf("%s: %u Hz %s dnf %u anf %u: 0x%08X (error %u ns), exhaustive 0x%08X (error %u ns)\n",
+               solvers[i]->name, c->fpclk, speed_name[c->speed], c->dnf, c->anf,
+               val, err, ref, ref_err);
+      }
+      fail = 1;
+    }
+  }
+
+  return fail;
+}
+
+/* Check all solvers over kernel clock, bus speed and filter settings */
+static int cmd_check (void) {
+  uint32_t stat[SOLVER_NUM][3];
+  i2c_timing_case_t c;
+  uint32_t clk, num, i;
+  int      fail = 0;
+  double   t;
+
+  memset(stat, 0, sizeof(stat));
+  num = 0U;
+  t   = util_time_ms();
+
+  for (i = 0U; i < (400U + (sizeof(clk_extra) / sizeof(clk_extra[0]))); i++) {
+    /* 0.5 MHz .. 200 MHz in 0.5 MHz steps, followed by the extra clocks */
+    clk = (i < 400U) ? ((i + 1U) * 500000U) : clk_extra[i - 400U];
+
+    for (c.speed = 0U; c.speed < 3U; c.speed++) {
+      for (c.anf = 0U; c.anf < 2U; c.anf++) {
+        for (c.dnf = 0U; c.dnf < 16U; c.dnf++) {
+          c.fpclk = clk;
+          fail   |= check_case(&c, stat);
+          num++;
+        }
+      }
+    }
+  }
+
+  for (i = 0U; i < SOLVER_NUM; i++) {
+    printf("%-22s %u cases: %u identical, %u lower error, %u worse\n",
+           solvers[i]->name, num, stat[i][0], stat[i][1], stat[i][2]);
+  }
+  printf("time: %.1f ms\n", util_time_ms() - t);
+
+  return fail;
+}
+
+/* Time solver over the benchmark cases (ns per bus speed change) */
+static double bench_solver (const i2c_timing_solver_t *s) {
+  i2c_timing_case_t c;
+  uint32_t err, sum, n, i;
+  double   t, dt;
+
+  sum = 0U;
+  n   = 0U;
+  t   = util_time_ms();
+  do {
+    for (i = 0U; i < (sizeof(clk_bench) / sizeof(clk_bench[0])); i++) {
+      for (c.speed = 0U; c.speed < 3U; c.speed++) {
+        c.fpclk = clk_bench[i];
+        c.dnf   = 0U;
+        c.anf   = 1U;
+        sum    += s->solve(&c, &err);
+        n++;
+      }
+    }
+    dt = util_time_ms() - t;
+  } while (dt < 200.0);
+
+  /* Keep the result alive */
+  if (sum == 1U) {
+    printf(" ");
+  }
+
+  return (dt * 1e6) / n;
+}
+
+static int cmd_bench (void) {
+  double ref, val;
+  uint32_t i;
+
+  ref = bench_solver(&i2c_timing_exhaustive);
+  printf("%-22s %10.0f ns per bus speed change\n", i2c_timing_exhaustive.name, ref);
+
+  for (i = 0U; i < SOLVER_NUM; i++) {
+    val = bench_solver(solvers[i]);
+    printf("%-22s %10.0f ns per bus speed change (%.0fx)\n", solvers[i]->name, val, ref / val);
+  }
+
+  return 0;
+}
+
+int main (int argc, char **argv) {
+
+  if (argc != 2) {
+    usage();
+    return 2;
+  }
+
+  if (strcmp(argv[1], "check") == 0) {
+    return (cmd_check() != 0) ? 1 : 0;
+  }
+  if (strcmp(argv[1], "bench") == 0) {
+    return cmd_bench();
+  }
+
+  usage();
+  return 2;
+}
@@ -0,0 +1,506 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Random-access compressed pack archive command line tool
+ * -------------------------------------------------------------------------- */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <zlib.h>
+
+#include "pdpak.h"
+#include "util.h"
+
+#define BENCH_RUNS      20U             // Runs per single file measurement (best is reported)
+#define BENCH_RUNS_ALL  3U              // Runs per whole archive measurement
+
+#ifdef PDPAK_ZSTD
+#define DEFAULT_CODEC   PDPAK_CODEC_ZSTD
+#define DEFAULT_LEVEL   19
+#else
+#define DEFAULT_CODEC   PDPAK_CODEC_ZLIB
+#define DEFAULT_LEVEL   9
+#endif
+
+static void usage (void) {
+  fprintf(stderr,
+    "usage: pdpak create [-z zlib|zstd] [-l <level>] [-v] <archive> <directory>\n"
+    "       pdpak list <archive>\n"
+    "       pdpak cat <archive> <path>\n"
+    "       pdpak extract <archive> <directory>\n"
+    "       pdpak bench <archive> <zip> [<path>...]\n");
+}
+
+static int cmd_create (int argc, char **argv) {
+  pdpak_options_t opt;
+  int             i;
+
+  opt.codec   = DEFAULT_CODEC;
+  opt.level   = DEFAULT_LEVEL;
+  opt.verbose = 0;
+  for (i = 0; (i < argc) && (argv[i][0] == '-'); i++) {
+    if ((strcmp(argv[i], "-z") == 0) && ((i + 1) < argc)) {
+      i++;
+      if (strcmp(argv[i], "zlib") == 0) {
+        opt.codec = PDPAK_CODEC_ZLIB;
+        opt.level = 9;
+      } else if (strcmp(argv[i], "zstd") == 0) {
+        opt.codec = PDPAK_CODEC_ZSTD;
+        opt.level = 19;
+      } else {
+        usage();
+        return EXIT_FAILURE;
+      }
+    } else if ((strcmp(argv[i], "-l") == 0) && ((i + 1) < argc)) {
+      opt.level = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-v") == 0) {
+      opt.verbose = 1;
+    } else {
+      usage();
+      return EXIT_FAILURE;
+    }
+  }
+  if ((argc - i) != 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  return (pdpak_build(argv[i], argv[i + 1], &opt) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Open archive or report error */
+static int open_archive (const char *path, pdpak_t *pak) {
+  if (pdpak_open(path, pak) != 0) {
+    fprintf(stderr, "%s: error: cannot open archive (or codec not supported by this build)\n", path);
+    return -1;
+  }
+  return 0;
+}
+
+static int cmd_list (int argc, char **argv) {
+  const pdpak_blob_t *b;
+  pdpak_t  pak;
+  uint32_t i;
+
+  if (argc != 1) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (open_archive(argv[0], &pak) != 0) {
+    return EXIT_FAILURE;
+  }
+  for (i = 0U; i < pak.hdr->file_num; i++) {
+    b = PDPAK_BLOB(&pak, &pak.file[i]);
+    printf("%10u %10u %6u %s\n", b->usize, b->csize, pak.file[i].blob, PDPAK_STR(&pak, pak.file[i].path));
+  }
+  printf("%u files, %u unique, %llu bytes\n", pak.hdr->file_num, pak.hdr->blob_num, (unsigned long long)pak.size);
+  pdpak_close(&pak);
+  return EXIT_SUCCESS;
+}
+
+static int cmd_cat (int argc, char **argv) {
+  const pdpak_file_t *f;
+  pdpak_t  pak;
+  size_t   size;
+  void    *data;
+  int      rc = EXIT_FAILURE;
+
+  if (argc != 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (open_archive(argv[0], &pak) != 0) {
+    return EXIT_FAILURE;
+  }
+  f = pdpak_find(&pak, argv[1]);
+  if (f == NULL) {
+    fprintf(stderr, "%s: error: '%s' not found\n", argv[0], argv[1]);
+  } else {
+    data = pdpak_extract(&pak, f, &size);
+    if (data == NULL) {
+      fprintf(stderr, "%s: error: '%s' is corrupt\n", argv[0], argv[1]);
+    } else {
+      rc = (fwrite(data, 1U, size, stdout) == size) ? EXIT_SUCCESS : EXIT_FAILURE;
+      free(data);
+    }
+  }
+  pdpak_close(&pak);
+  return rc;
+}
+
+/* Create parent directories of path */
+static int make_dirs (char *path) {
+  char *p;
+
+  for (p = strchr(path, '/'); p != NULL; p = strchr(p + 1, '/')) {
+    *p = '\0';
+    if ((path[0] != '\0') && (mkdir(path, 0777) != 0) && (errno != EEXIST)) {
+      *p = '/';
+      return -1;
+    }
+    *p = '/';
+  }
+  return 0;
+}
+
+static int cmd_extract (int argc, char **argv) {
+  pdpak_t  pak;
+  uint32_t i;
+  size_t   size;
+  void    *data;
+  char     path[1024];
+  int      rc = EXIT_SUCCESS;
+
+  if (argc != 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (open_archive(argv[0], &pak) != 0) {
+    return EXIT_FAILURE;
+  }
+  for (i = 0U; (i < pak.hdr->file_num) && (rc == EXIT_SUCCESS); i++) {
+    if ((size_t)snprintf(path, sizeof(path), "%s/%s", argv[1], PDPAK_STR(&pak, pak.file[i].path)) >= sizeof(path)) {
+      fprintf(stderr, "%s: error: path too long\n", PDPAK_STR(&pak, pak.file[i].path));
+      rc = EXIT_FAILURE;
+      break;
+    }
+    data = pdpak_extract(&pak, &pak.file[i], &size);
+    if (data == NULL) {
+      fprintf(stderr, "%s: error: '%s' is corrupt\n", argv[0], PDPAK_STR(&pak, pak.file[i].path));
+      rc = EXIT_FAILURE;
+    } else if ((make_dirs(path) != 0) || (util_file_write(path, data, size) != 0)) {
+      fprintf(stderr, "%s: error: cannot write file\n", path);
+      rc = EXIT_FAILURE;
+    }
+    free(data);
+  }
+  pdpak_close(&pak);
+  return rc;
+}
+
+/* Zip archive (reference for the benchmark): central directory, no zip64 */
+typedef struct {
+  util_file_t           file;
+  const uint8_t        *d;
+  uint32_t              cd_off;         // Central directory offset
+  uint32_t              cd_num;         // Central directory entries
+} zip_t;
+
+static uint16_t rd16 (const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd32 (const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Map zip file and locate the central directory (end record) */
+static int zip_open (const char *path, zip_t *zip) {
+  size_t i;
+
+  if (util_file_map(path, &zip->file) != 0) {
+    return -1;
+  }
+  zip->d = (const uint8_t *)zip->file.data;
+  for (i = zip->file.size; i >= 22U; i--) {
+    if (rd32(&zip->d[i - 22U]) == 0x06054B50U) {
+      zip->cd_num = rd16(&zip->d[i - 22U + 10U]);
+      zip->cd_off = rd32(&zip->d[i - 22U + 16U]);
+      if (zip->cd_off < zip->file.size) {
+        return 0;
+      }
+      break;
+    }
+    if ((zip->file.size - i) > 0x10000U + 22U) {
+      break;
+    }
+  }
+  util_file_unmap(&zip->file);
+  return -1;
+}
+
+/* Next central directory entry (pos: offset of the current entry, 0 to start) */
+static const uint8_t *zip_next (const zip_t *zip, size_t *pos) {
+  const uint8_t *e;
+  size_t         off = (*pos == 0U) ? zip->cd_off : *pos;
+
+  if (*pos != 0U) {
+    e    = &zip->d[off];
+    off += 46U + rd16(&e[28]) + rd16(&e[30]) + rd16(&e[32]);
+  }
+  if (((off + 46U) > zip->file.size) || (rd32(&zip->d[off]) != 0x02014B50U)) {
+    return NULL;
+  }
+  *pos = off;
+  return &zip->d[off];
+}
+
+/* Inflate entry content (stored or deflate) into an allocated buffer, check CRC-32 like unzip */
+static void *zip_read (const zip_t *zip, const uint8_t *e, size_t *size) {
+  uint32_t  method = rd16(&e[10]), csize = rd32(&e[20]), usize = rd32(&e[24]), loc = rd32(&e[42]);
+  z_stream  zs;
+  uint8_t  *buf;
+  size_t    off;
+
+  if (((uint64_t)loc + 30U) > zip->file.size) {
+    return NULL;
+  }
+  off = loc + 30U + rd16(&zip->d[loc + 26U]) + rd16(&zip->d[loc + 28U]);
+  if (((uint64_t)off + csize) > zip->file.size) {
+    return NULL;
+  }
+  buf = malloc((usize != 0U) ? usize : 1U);
+  if (buf == NULL) {
+    return NULL;
+  }
+  if (method == 0U) {
+    memcpy(buf, &zip->d[off], usize);
+  } else {
+    memset(&zs, 0, sizeof(zs));
+    zs.next_in   = (Bytef *)(uintptr_t)&zip->d[off];
+    zs.avail_in  = csize;
+    zs.next_out  = buf;
+    zs.avail_out = usize;
+    if ((method != 8U) || (inflateInit2(&zs, -MAX_WBITS) != Z_OK)) {
+      free(buf);
+      return NULL;
+    }
+    if ((inflate(&zs, Z_FINISH) != Z_STREAM_END) || (zs.total_out != usize)) {
+      inflateEnd(&zs);
+      free(buf);
+      return NULL;
+    }
+    inflateEnd(&zs);
+  }
+  if (crc32(0UL, buf, usize) != rd32(&e[16])) {
+    free(buf);
+    return NULL;
+  }
+  *size = usize;
+  return buf;
+}
+
+/* Find entry by name (entries may start with "./") */
+static const uint8_t *zip_find (const zip_t *zip, const char *name) {
+  const uint8_t *e;
+  const char    *n;
+  size_t         pos = 0U, len = strlen(name), nlen;
+
+  while ((e = zip_next(zip, &pos)) != NULL) {
+    n    = (const char *)&e[46];
+    nlen = rd16(&e[28]);
+    if ((nlen >= 2U) && (n[0] == '.') && (n[1] == '/')) {
+      n += 2; nlen -= 2U;
+    }
+    if ((nlen == len) && (memcmp(n, name, len) == 0)) {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+/* Single file: archive open, lookup, decompress, close */
+static double bench_pdpak_file (const char *archive, const char *name, size_t *size) {
+  pdpak_t  pak;
+  void    *data;
+  uint32_t run;
+  double   t0, t, best = -1.0;
+
+  for (run = 0U; run < BENCH_RUNS; run++) {
+    t0 = util_time_ms();
+    if (pdpak_open(archive, &pak) != 0) {
+      return -1.0;
+    }
+    data = (pdpak_find(&pak, name) != NULL) ? pdpak_extract(&pak, pdpak_find(&pak, name), size) : NULL;
+    pdpak_close(&pak);
+    t = util_time_ms() - t0;
+    if (data == NULL) {
+      return -1.0;
+    }
+    free(data);
+    if ((best < 0.0) || (t < best)) {
+      best = t;
+    }
+  }
+  return best;
+}
+
+static double bench_zip_file (const char *path, const char *name) {
+  const uint8_t *e;
+  zip_t          zip;
+  size_t         size;
+  void          *data;
+  uint32_t       run;
+  double         t0, t, best = -1.0;
+
+  for (run = 0U; run < BENCH_RUNS; run++) {
+    t0 = util_time_ms();
+    if (zip_open(path, &zip) != 0) {
+      return -1.0;
+    }
+    e    = zip_find(&zip, name);
+    data = (e != NULL) ? zip_read(&zip, e, &size) : NULL;
+    util_file_unmap(&zip.file);
+    t = util_time_ms() - t0;
+    if (data == NULL) {
+      return -1.0;
+    }
+    free(data);
+    if ((best < 0.0) || (t < best)) {
+      best = t;
+    }
+  }
+  return best;
+}
+
+/* Whole archive: decompress every file */
+static double bench_pdpak_all (const char *archive) {
+  pdpak_t  pak;
+  size_t   size;
+  void    *data;
+  uint32_t run, i;
+  double   t0, t, best = -1.0;
+
+  for (run = 0U; run < BENCH_RUNS_ALL; run++) {
+    t0 = util_time_ms();
+    if (pdpak_open(archive, &pak) != 0) {
+      return -1.0;
+    }
+    for (i = 0U; i < pak.hdr->file_num; i++) {
+      data = pdpak_extract(&pak, &pak.file[i], &size);
+      if (data == NULL) {
+        pdpak_close(&pak);
+        return -1.0;
+      }
+      free(data);
+    }
+    pdpak_close(&pak);
+    t = util_time_ms() - t0;
+    if ((best < 0.0) || (t < best)) {
+      best = t;
+    }
+  }
+  return best;
+}
+
+static double bench_zip_all (const char *path) {
+  const uint8_t *e;
+  zip_t          zip;
+  size_t         pos, size;
+  void          *data;
+  uint32_t       run;
+  double         t0, t, best = -1.0;
+
+  for (run = 0U; run < BENCH_RUNS_ALL; run++) {
+    t0 = util_time_ms();
+    if (zip_open(path, &zip) != 0) {
+      return -1.0;
+    }
+    for (pos = 0U; (e = zip_next(&zip, &pos)) != NULL; ) {
+      if ((rd16(&e[28]) == 0U) || (((const char *)&e[46])[rd16(&e[28]) - 1U] == '/')) {
+        continue;                       // Directory entry
+      }
+      data = zip_read(&zip, e, &size);
+      if (data == NULL) {
+        util_file_unmap(&zip.file);
+        return -1.0;
+      }
+      free(data);
+    }
+    util_file_unmap(&zip.file);
+    t = util_time_ms() - t0;
+    if ((best < 0.0) || (t < best)) {
+      best = t;
+    }
+  }
+  return best;
+}
+
+static int cmd_bench (int argc, char **argv) {
+  pdpak_t     pak;
+  zip_t       zip;
+  size_t      size = 0U;
+  double      t_pak, t_zip;
+  int         i;
+
+  if (argc < 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (open_archive(argv[0], &pak) != 0) {
+    return EXIT_FAILURE;
+  }
+  if (zip_open(argv[1], &zip) != 0) {
+    fprintf(stderr, "%s: error: cannot open zip file\n", argv[1]);
+    pdpak_close(&pak);
+    return EXIT_FAILURE;
+  }
+  printf("archive size:  pdpak %zu bytes (%u files, %u unique), zip %zu bytes\n",
+         pak.size, pak.hdr->file_num, pak.hdr->blob_num, zip.file.size);
+  util_file_unmap(&zip.file);
+  pdpak_close(&pak);
+
+  for (i = 2; i < argc; i++) {
+    t_pak = bench_pdpak_file(argv[0], argv[i], &size);
+    t_zip = bench_zip_file(argv[1], argv[i]);
+    if ((t_pak < 0.0) || (t_zip < 0.0)) {
+      fprintf(stderr, "error: '%s' cannot be read from both archives\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+    printf("%-40s %9zu bytes: pdpak %8.3f ms, zip %8.3f ms\n", argv[i], size, t_pak, t_zip);
+  }
+  t_pak = bench_pdpak_all(argv[0]);
+  t_zip = bench_zip_all(argv[1]);
+  if ((t_pak < 0.0) || (t_zip < 0.0)) {
+    fprintf(stderr, "error: archives cannot be read completely\n");
+    return EXIT_FAILURE;
+  }
+  printf("%-40s %15s: pdpak %8.1f ms, zip %8.1f ms\n", "all files", "", t_pak, t_zip);
+  return EXIT_SUCCESS;
+}
+
+int main (int argc, char **argv) {
+  if (argc < 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (strcmp(argv[1], "create") == 0) {
+    return cmd_create(argc - 2, &argv[2]);
+  }
+  if (strcmp(argv[1], "list") == 0) {
+    return cmd_list(argc - 2, &argv[2]);
+  }
+  if (strcmp(argv[1], "cat") == 0) {
+    return cmd_cat(argc - 2, &argv[2]);
+  }
+  if (strcmp(argv[1], "extract") == 0) {
+    return cmd_extract(argc - 2, &argv[2]);
+  }
+  if (strcmp(argv[1], "bench") == 0) {
+    return cmd_bench(argc - 2, &argv[2]);
+  }
+  usage();
+  return EXIT_FAILURE;
+}
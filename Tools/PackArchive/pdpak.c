@@ -0,0 +1,206 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Random-access compressed pack archive
+ * -------------------------------------------------------------------------- */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+#ifdef PDPAK_ZSTD
+#include <zstd.h>
+#endif
+
+#include "pdpak.h"
+#include "util.h"
+
+/* Check that table lies within the file */
+static int table_valid (const pdpak_header_t *hdr, uint64_t off, uint64_t num, size_t elem) {
+  return ((off & 7U) == 0U) && (off <= hdr->file_size) && (num <= ((hdr->file_size - off) / elem));
+}
+
+/**
+  Check if a codec is supported by this build.
+  \param[in]    codec  PDPAK_CODEC_x
+  \return       1 if supported, 0 otherwise.
+*/
+int pdpak_codec (uint32_t codec) {
+#ifdef PDPAK_ZSTD
+  if (codec == PDPAK_CODEC_ZSTD) {
+    return 1;
+  }
+#endif
+  return codec == PDPAK_CODEC_ZLIB;
+}
+
+/**
+  Open archive (memory-mapped, no decompression).
+  \param[in]    path   archive file
+  \param[out]   pak    opened archive
+  \return       0 on success, or -1 on error.
+*/
+int pdpak_open (const char *path, pdpak_t *pak) {
+  const pdpak_header_t *hdr;
+  const pdpak_file_t   *f;
+  const pdpak_blob_t   *b;
+  const uint8_t        *base;
+  util_file_t           file;
+  uint32_t              i;
+
+  memset(pak, 0, sizeof(*pak));
+  if (util_file_map(path, &file) != 0) {
+    return -1;
+  }
+  base = (const uint8_t *)file.data;
+  hdr  = (const pdpak_header_t *)(const void *)base;
+  if ((file.size < sizeof(pdpak_header_t))                                         ||
+      (hdr->magic != PDPAK_MAGIC) || (hdr->version != PDPAK_VERSION)               ||
+      (hdr->file_size != file.size) || !pdpak_codec(hdr->codec)                    ||
+      !table_valid(hdr, hdr->file_off,   hdr->file_num,    sizeof(pdpak_file_t))   ||
+      !table_valid(hdr, hdr->blob_off,   hdr->blob_num,    sizeof(pdpak_blob_t))   ||
+      !table_valid(hdr, hdr->string_off, hdr->string_size, 1U)                     ||
+      (hdr->string_size == 0U) || (base[hdr->string_off + hdr->string_size - 1U] != '\0')) {
+    util_file_unmap(&file);
+    return -1;
+  }
+
+  // Tables are used without further checks
+  f = (const pdpak_file_t *)(const void *)(base + hdr->file_off);
+  b = (const pdpak_blob_t *)(const void *)(base + hdr->blob_off);
+  for (i = 0U; i < hdr->file_num; i++) {
+    if ((f[i].blob >= hdr->blob_num) || (f[i].path >= hdr->string_size)) {
+      util_file_unmap(&file);
+      return -1;
+    }
+  }
+  for (i = 0U; i < hdr->blob_num; i++) {
+    if ((b[i].offset > hdr->file_size) || (b[i].csize > (hdr->file_size - b[i].offset))) {
+      util_file_unmap(&file);
+      return -1;
+    }
+  }
+
+  pak->base   = base;
+  pak->size   = file.size;
+  pak->hdr    = hdr;
+  pak->file   = f;
+  pak->blob   = b;
+  pak->string = (const char *)(const void *)(base + hdr->string_off);
+  return 0;
+}
+
+/**
+  Close archive.
+  \param[in]    pak    opened archive
+*/
+void pdpak_close (pdpak_t *pak) {
+  util_file_t file;
+
+  if (pak->base != NULL) {
+    file.data = (const char *)pak->base;
+    file.size = pak->size;
+    util_file_unmap(&file);
+  }
+  memset(pak, 0, sizeof(*pak));
+}
+
+/**
+  Find file by path (binary search).
+  \param[in]    pak    opened archive
+  \param[in]    path   relative path ('/' separated)
+  \return       file, or NULL when not found
+*/
+const pdpak_file_t *pdpak_find (const pdpak_t *pak, const char *path) {
+  uint32_t lo = 0U, hi = pak->hdr->file_num, mid;
+  int      cmp;
+
+  while (lo < hi) {
+    mid = lo + ((hi - lo) / 2U);
+    cmp = strcmp(path, PDPAK_STR(pak, pak->file[mid].path));
+    if (cmp == 0) {
+      return &pak->file[mid];
+    }
+    if (cmp < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1U;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Decompress file content (only the frame of the file is read).
+  \param[in]    pak    opened archive
+  \param[in]    file   file of the archive
+  \param[out]   buf    content buffer
+  \param[in]    size   buffer size (at least the content size)
+  \return       0 on success, or -1 on error (corrupt frame or hash mismatch).
+*/
+int pdpak_read (const pdpak_t *pak, const pdpak_file_t *file, void *buf, size_t size) {
+  const pdpak_blob_t *b   = PDPAK_BLOB(pak, file);
+  const uint8_t      *src = pak->base + b->offset;
+  uLongf              len = b->usize;
+
+  if (size < b->usize) {
+    return -1;
+  }
+  if (b->csize == b->usize) {
+    // Stored frame: content hash is the only check
+    memcpy(buf, src, b->usize);
+    return (util_hash(buf, b->usize) == b->hash) ? 0 : -1;
+  }
+  // Compressed frames are checked by the codec (zlib Adler-32, zstd frame checksum)
+  if (pak->hdr->codec == PDPAK_CODEC_ZLIB) {
+    if ((uncompress(buf, &len, src, b->csize) == Z_OK) && (len == b->usize)) {
+      return 0;
+    }
+#ifdef PDPAK_ZSTD
+  } else if (pak->hdr->codec == PDPAK_CODEC_ZSTD) {
+    if (ZSTD_decompress(buf, size, src, b->csize) == b->usize) {
+      return 0;
+    }
+#endif
+  }
+  return -1;
+}
+
+/**
+  Decompress file content into an allocated buffer.
+  \param[in]    pak    opened archive
+  \param[in]    file   file of the archive
+  \param[out]   size   content size in bytes
+  \return       content (free with free()), or NULL on error
+*/
+void *pdpak_extract (const pdpak_t *pak, const pdpak_file_t *file, size_t *size) {
+  size_t usize = PDPAK_BLOB(pak, file)->usize;
+  void  *buf   = malloc((usize != 0U) ? usize : 1U);
+
+  if ((buf != NULL) && (pdpak_read(pak, file, buf, usize) != 0)) {
+    free(buf);
+    buf = NULL;
+  }
+  *size = (buf != NULL) ? usize : 0U;
+  return buf;
+}
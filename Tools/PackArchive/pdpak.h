@@ -0,0 +1,120 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Random-access compressed pack archive
+ * -------------------------------------------------------------------------- */
+
+#ifndef PDPAK_H
+#define PDPAK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* File format
+ *
+ * A pack directory is stored as one little-endian file used in place after
+ * mmap(). Every distinct file content is one independently compressed frame
+ * (blob), so a single file is read without touching the rest of the archive.
+ * Files with identical content share one blob.
+ *
+ *   header
+ *   blob data     compressed frames, in order of first use
+ *   file[]        path and blob of every file, sorted by path
+ *   blob[]        frame offset, sizes and content hash
+ *   string[]      NUL terminated file paths ('/' separated, relative)
+ *
+ * A blob with csize == usize is stored uncompressed and checked against its
+ * content hash on read; compressed frames are checked by the codec.
+ */
+
+#define PDPAK_MAGIC             0x4B504450U     // "PDPK"
+#define PDPAK_VERSION           1U
+
+/* Codecs */
+#define PDPAK_CODEC_ZLIB        1U              // zlib stream (deflate)
+#define PDPAK_CODEC_ZSTD        2U              // zstd frame (PDPAK_ZSTD builds only)
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t codec;                       // PDPAK_CODEC_x
+  uint32_t reserved;
+  uint64_t file_size;
+  uint32_t file_num,    blob_num;
+  uint64_t file_off;
+  uint64_t blob_off;
+  uint64_t string_off;
+  uint64_t string_size;
+} pdpak_header_t;
+
+typedef struct {
+  uint32_t path;                        // Path (string offset)
+  uint32_t blob;                        // Blob index
+} pdpak_file_t;
+
+typedef struct {
+  uint64_t offset;                      // Frame offset in archive
+  uint32_t csize;                       // Frame size in bytes
+  uint32_t usize;                       // Content size in bytes
+  uint64_t hash;                        // Content hash (FNV-1a)
+} pdpak_blob_t;
+
+/* Opened archive */
+typedef struct {
+  const uint8_t            *base;       // Mapped file
+  size_t                    size;       // Mapped size
+  const pdpak_header_t     *hdr;
+  const pdpak_file_t       *file;
+  const pdpak_blob_t       *blob;
+  const char               *string;
+} pdpak_t;
+
+/* Archive creation options and statistics */
+typedef struct {
+  uint32_t                  codec;      // PDPAK_CODEC_x
+  int                       level;      // Compression level (codec specific)
+  int                       verbose;    // Print statistics
+} pdpak_options_t;
+
+extern int                  pdpak_open     (const char *path, pdpak_t *pak);
+extern void                 pdpak_close    (pdpak_t *pak);
+extern const pdpak_file_t  *pdpak_find     (const pdpak_t *pak, const char *path);
+extern int                  pdpak_read     (const pdpak_t *pak, const pdpak_file_t *file, void *buf, size_t size);
+extern void                *pdpak_extract  (const pdpak_t *pak, const pdpak_file_t *file, size_t *size);
+extern int                  pdpak_codec    (uint32_t codec);
+
+/* Table access */
+#define PDPAK_STR(pak, offs)            (&(pak)->string[offs])
+#define PDPAK_BLOB(pak, file)           (&(pak)->blob[(file)->blob])
+
+/* Builder (pdpak_build.c) */
+extern int                  pdpak_build    (const char *out, const char *dir, const pdpak_options_t *opt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PDPAK_H */
@@ -0,0 +1,315 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Random-access compressed pack archive
+ * -------------------------------------------------------------------------- */
+
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <zlib.h>
+#ifdef PDPAK_ZSTD
+#include <zstd.h>
+#endif
+
+#include "pdpak.h"
+#include "util.h"
+
+/* File found in the pack directory */
+typedef struct {
+  const char           *path;           // Relative path
+  const char           *full;           // Path to open
+  uint32_t              blob;           // Blob index
+} entry_t;
+
+/* Builder state */
+typedef struct {
+  util_arena_t          arena;
+  util_vec_t            entry;          // entry_t
+  util_vec_t            blob;           // pdpak_blob_t
+  util_vec_t            source;         // const char * (first file of each blob)
+  util_hindex_t         blob_idx;       // content hash -> blob index
+  util_vec_t            frame;          // Compression buffer
+#ifdef PDPAK_ZSTD
+  ZSTD_CCtx            *zctx;           // zstd context (frame checksum enabled)
+#endif
+  const pdpak_options_t *opt;
+} build_t;
+
+/* Collect regular files below dir (rel: path relative to the pack root) */
+static int walk (build_t *b, const char *dir, const char *rel) {
+  struct dirent *de;
+  struct stat    st;
+  entry_t       *e;
+  DIR           *d;
+  char          *full, *path;
+  size_t         dlen = strlen(dir), rlen = strlen(rel), nlen;
+  int            err = 0;
+
+  d = opendir(dir);
+  if (d == NULL) {
+    fprintf(stderr, "%s: error: cannot open directory\n", dir);
+    return -1;
+  }
+  while ((err == 0) && ((de = readdir(d)) != NULL)) {
+    if ((strcmp(de->d_name, ".") == 0) || (strcmp(de->d_name, "..") == 0)) {
+      continue;
+    }
+    nlen = strlen(de->d_name);
+    full = util_arena_alloc(&b->arena, dlen + nlen + 2U);
+    path = util_arena_alloc(&b->arena, rlen + nlen + 2U);
+    sprintf(full, "%s/%s", dir, de->d_name);
+    sprintf(path, "%s%s%s", rel, (rlen != 0U) ? "/" : "", de->d_name);
+    if (lstat(full, &st) != 0) {
+      fprintf(stderr, "%s: error: cannot stat file\n", full);
+      err = -1;
+    } else if (S_ISDIR(st.st_mode)) {
+      err = walk(b, full, path);
+    } else if (S_ISREG(st.st_mode)) {
+      e = util_vec_push(&b->entry);
+      e->path = path;
+      e->full = full;
+    }
+  }
+  closedir(d);
+  return err;
+}
+
+static int cmp_entry (const void *a, const void *b) {
+  return strcmp(((const entry_t *)a)->path, ((const entry_t *)b)->path);
+}
+
+/* Blob lookup context: content of the file being added */
+typedef struct {
+  const build_t        *b;
+  const char           *data;
+  size_t                size;
+} blob_key_t;
+
+/* Compare content with the first file of a blob (hash hit only) */
+static int blob_eq (void *ctx, uint32_t index) {
+  const blob_key_t *key = ctx;
+  util_file_t       file;
+  int               eq;
+
+  if (UTIL_VEC_AT(&key->b->blob, pdpak_blob_t, index).usize != key->size) {
+    return 0;
+  }
+  if (util_file_map(UTIL_VEC_AT(&key->b->source, const char *, index), &file) != 0) {
+    return 0;
+  }
+  eq = (file.size == key->size) && (memcmp(file.data, key->data, key->size) == 0);
+  util_file_unmap(&file);
+  return eq;
+}
+
+/* Compress content into b->frame, return frame size (size: stored uncompressed) */
+static size_t compress_frame (build_t *b, const char *data, size_t size) {
+  size_t bound, len = 0U;
+  uLongf zlen;
+
+  if (b->opt->codec == PDPAK_CODEC_ZLIB) {
+    bound = compressBound((uLong)size);
+  } else {
+#ifdef PDPAK_ZSTD
+    bound = ZSTD_compressBound(size);
+#else
+    bound = size;
+#endif
+  }
+  b->frame.num = 0U;
+  util_vec_append(&b->frame, NULL, bound);
+  if (b->opt->codec == PDPAK_CODEC_ZLIB) {
+    zlen = (uLongf)bound;
+    if (compress2(b->frame.data, &zlen, (const Bytef *)data, (uLong)size, b->opt->level) == Z_OK) {
+      len = zlen;
+    }
+#ifdef PDPAK_ZSTD
+  } else {
+    len = ZSTD_compress2(b->zctx, b->frame.data, bound, data, size);
+    if (ZSTD_isError(len)) {
+      len = 0U;
+    }
+#endif
+  }
+  return ((len == 0U) || (len >= size)) ? size : len;
+}
+
+/* Add content of entry (new blob unless an identical one exists) */
+static int add_entry (build_t *b, entry_t *e, util_vec_t *img) {
+  util_file_t   file;
+  pdpak_blob_t *blob;
+  blob_key_t    key;
+  uint64_t      hash;
+  size_t        len;
+
+  if (util_file_map(e->full, &file) != 0) {
+    fprintf(stderr, "%s: error: cannot read file\n", e->full);
+    return -1;
+  }
+  if (file.size > UINT32_MAX) {
+    fprintf(stderr, "%s: error: file too large\n", e->full);
+    util_file_unmap(&file);
+    return -1;
+  }
+  hash     = util_hash(file.data, file.size);
+  key.b    = b;
+  key.data = file.data;
+  key.size = file.size;
+  e->blob  = util_hindex_find(&b->blob_idx, hash, blob_eq, &key);
+  if (e->blob == UINT32_MAX) {
+    len = compress_frame(b, file.data, file.size);
+    e->blob = (uint32_t)b->blob.num;
+    blob = util_vec_push(&b->blob);
+    blob->offset = img->num;
+    blob->csize  = (uint32_t)len;
+    blob->usize  = (uint32_t)file.size;
+    blob->hash   = hash;
+    util_vec_append(img, (len == file.size) ? file.data : b->frame.data, len);
+    *(const char **)util_vec_push(&b->source) = e->full;
+    util_hindex_add(&b->blob_idx, hash, e->blob);
+  }
+  util_file_unmap(&file);
+  return 0;
+}
+
+/* Append table to image at 8-byte aligned offset */
+static uint64_t emit (util_vec_t *out, const void *data, size_t size) {
+  uint64_t offs;
+
+  while ((out->num & 7U) != 0U) {
+    util_vec_push(out);
+  }
+  offs = out->num;
+  if (size != 0U) {
+    util_vec_append(out, data, size);
+  }
+  return offs;
+}
+
+/**
+  Build archive from a pack directory.
+  \param[in]    out    archive file
+  \param[in]    dir    pack directory (root of the relative paths)
+  \param[in]    opt    codec, level and verbosity
+  \return       0 on success, or -1 on error.
+*/
+int pdpak_build (const char *out, const char *dir, const pdpak_options_t *opt) {
+  pdpak_header_t  hdr;
+  util_strpool_t  str;
+  util_vec_t      img, file;
+  pdpak_file_t   *f;
+  entry_t        *e;
+  build_t         b;
+  uint64_t        total = 0U, unique = 0U;
+  uint32_t        i;
+  double          t0 = util_time_ms();
+  int             err;
+
+  if (!pdpak_codec(opt->codec)) {
+    fprintf(stderr, "error: codec %u not supported by this build\n", opt->codec);
+    return -1;
+  }
+  memset(&b, 0, sizeof(b));
+  b.opt = opt;
+  util_arena_init(&b.arena);
+  util_vec_init(&b.entry,  sizeof(entry_t));
+  util_vec_init(&b.blob,   sizeof(pdpak_blob_t));
+  util_vec_init(&b.source, sizeof(const char *));
+  util_vec_init(&b.frame,  1U);
+  util_hindex_init(&b.blob_idx);
+  util_strpool_init(&str);
+  util_vec_init(&img,  1U);
+  util_vec_init(&file, sizeof(pdpak_file_t));
+
+#ifdef PDPAK_ZSTD
+  b.zctx = ZSTD_createCCtx();
+  ZSTD_CCtx_setParameter(b.zctx, ZSTD_c_compressionLevel, opt->level);
+  ZSTD_CCtx_setParameter(b.zctx, ZSTD_c_checksumFlag, 1);
+#endif
+  err = walk(&b, dir, "");
+  if (err == 0) {
+    // Sorted paths allow binary search; blobs are stored in order of first use
+    qsort(b.entry.data, b.entry.num, sizeof(entry_t), cmp_entry);
+    util_vec_append(&img, NULL, sizeof(hdr));
+    for (i = 0U; (i < b.entry.num) && (err == 0); i++) {
+      e   = &UTIL_VEC_AT(&b.entry, entry_t, i);
+      err = add_entry(&b, e, &img);
+      if (err == 0) {
+        f = util_vec_push(&file);
+        f->path = util_strpool_add(&str, e->path, strlen(e->path));
+        f->blob = e->blob;
+        total  += UTIL_VEC_AT(&b.blob, pdpak_blob_t, e->blob).usize;
+      }
+    }
+  }
+
+  if (err == 0) {
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic       = PDPAK_MAGIC;
+    hdr.version     = PDPAK_VERSION;
+    hdr.codec       = opt->codec;
+    hdr.file_num    = (uint32_t)file.num;
+    hdr.file_off    = emit(&img, file.data,    file.num   * sizeof(pdpak_file_t));
+    hdr.blob_num    = (uint32_t)b.blob.num;
+    hdr.blob_off    = emit(&img, b.blob.data,  b.blob.num * sizeof(pdpak_blob_t));
+    hdr.string_size = str.buf.num;
+    hdr.string_off  = emit(&img, str.buf.data, str.buf.num);
+    emit(&img, NULL, 0U);
+    hdr.file_size   = img.num;
+    memcpy(img.data, &hdr, sizeof(hdr));
+    if (util_file_write(out, img.data, img.num) != 0) {
+      fprintf(stderr, "%s: error: cannot write file\n", out);
+      err = -1;
+    }
+  }
+
+  if ((err == 0) && (opt->verbose != 0)) {
+    for (i = 0U; i < b.blob.num; i++) {
+      unique += UTIL_VEC_AT(&b.blob, pdpak_blob_t, i).usize;
+    }
+    printf("files:       %u, %llu bytes\n", hdr.file_num, (unsigned long long)total);
+    printf("unique:      %u, %llu bytes\n", hdr.blob_num, (unsigned long long)unique);
+    printf("archive:     %llu bytes (%s level %d, %.1f%% of input)\n", (unsigned long long)hdr.file_size,
+           (opt->codec == PDPAK_CODEC_ZLIB) ? "zlib" : "zstd", opt->level,
+           (total != 0U) ? ((100.0 * (double)hdr.file_size) / (double)total) : 0.0);
+    printf("build time:  %.1f ms\n", util_time_ms() - t0);
+  }
+
+#ifdef PDPAK_ZSTD
+  ZSTD_freeCCtx(b.zctx);
+#endif
+  util_vec_free(&file);
+  util_vec_free(&img);
+  util_strpool_free(&str);
+  util_hindex_free(&b.blob_idx);
+  util_vec_free(&b.frame);
+  util_vec_free(&b.source);
+  util_vec_free(&b.blob);
+  util_vec_free(&b.entry);
+  util_arena_free(&b.arena);
+  return err;
+}
@@ -0,0 +1,219 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Flash algorithm (FLM) device description reader
+ * -------------------------------------------------------------------------- */
+
+/* An FLM file is an ELF32 (little-endian) image linked with Target.lin:
+ * execution regions PrgCode and PrgData are loaded to RAM by the debugger,
+ * region DevDscr holds the FlashDevice structure (symbol FlashDevice).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "flashdev.h"
+#include "util.h"
+
+#define SHT_SYMTAB      2U
+
+/* FlashDevice layout (FlashOS.h, AAPCS) */
+#define FD_VERS         0U
+#define FD_NAME         2U
+#define FD_TYPE         130U
+#define FD_DEV_ADR      132U
+#define FD_SZ_DEV       136U
+#define FD_SZ_PAGE      140U
+#define FD_VAL_EMPTY    148U
+#define FD_TO_PROG      152U
+#define FD_TO_ERASE     156U
+#define FD_SECTORS      160U
+
+static uint16_t rd16 (const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd32 (const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Check that [off, off + len) lies within the file */
+static int in_file (size_t size, uint32_t off, uint32_t len) {
+  return ((uint64_t)off + len) <= size;
+}
+
+/* Decode FlashDevice structure of len bytes */
+static void decode (const uint8_t *p, uint32_t len, flashdev_t *dev) {
+  uint32_t i, size, addr;
+
+  dev->vers = rd16(&p[FD_VERS]);
+  memcpy(dev->name, &p[FD_NAME], 128U);
+  dev->name[128]  = '\0';
+  dev->type       = rd16(&p[FD_TYPE]);
+  dev->dev_adr    = rd32(&p[FD_DEV_ADR]);
+  dev->sz_dev     = rd32(&p[FD_SZ_DEV]);
+  dev->sz_page    = rd32(&p[FD_SZ_PAGE]);
+  dev->val_empty  = p[FD_VAL_EMPTY];
+  dev->to_prog    = rd32(&p[FD_TO_PROG]);
+  dev->to_erase   = rd32(&p[FD_TO_ERASE]);
+  dev->sector_num = 0U;
+  for (i = 0U; (i < FLASHDEV_SECTOR_MAX) && ((FD_SECTORS + (i * 8U) + 8U) <= len); i++) {
+    size = rd32(&p[FD_SECTORS + (i * 8U)]);
+    addr = rd32(&p[FD_SECTORS + (i * 8U) + 4U]);
+    if ((size == 0xFFFFFFFFU) && (addr == 0xFFFFFFFFU)) {
+      break;
+    }
+    dev->sector[i].size = size;
+    dev->sector[i].addr = addr;
+    dev->sector_num++;
+  }
+}
+
+/* Section header access */
+typedef struct {
+  const uint8_t        *d;              // File content
+  size_t                size;           // File size
+  uint32_t              off;            // Section header table offset
+  uint32_t              num;            // Number of section headers
+  uint32_t              entsize;        // Section header size
+} elf_t;
+
+#define SH(e, i)        (&(e)->d[(e)->off + ((i) * (e)->entsize)])
+#define SH_NAME(p)      rd32(&(p)[0])
+#define SH_TYPE(p)      rd32(&(p)[4])
+#define SH_ADDR(p)      rd32(&(p)[12])
+#define SH_OFFSET(p)    rd32(&(p)[16])
+#define SH_SIZE(p)      rd32(&(p)[20])
+#define SH_LINK(p)      rd32(&(p)[24])
+
+/* Sum sizes of the execution regions PrgCode and PrgData */
+static int footprint (const elf_t *e, uint32_t shstrndx, flashdev_t *dev) {
+  uint32_t    stroff  = SH_OFFSET(SH(e, shstrndx));
+  uint32_t    strsize = SH_SIZE(SH(e, shstrndx));
+  uint32_t    i, name;
+  const char *str;
+
+  if (!in_file(e->size, stroff, strsize)) {
+    return -1;
+  }
+  for (i = 0U; i < e->num; i++) {
+    name = SH_NAME(SH(e, i));
+    if (name >= strsize) {
+      continue;
+    }
+    str = (const char *)&e->d[stroff + name];
+    if (memchr(str, '\0', strsize - name) == NULL) {
+      continue;
+    }
+    if (strcmp(str, "PrgCode") == 0) {
+      dev->code_size += SH_SIZE(SH(e, i));
+    } else if (strcmp(str, "PrgData") == 0) {
+      dev->data_size += SH_SIZE(SH(e, i));
+    }
+  }
+  return 0;
+}
+
+/* Find symbol FlashDevice and decode the structure */
+static int find_device (const elf_t *e, flashdev_t *dev) {
+  const uint8_t *sh, *sym, *sec;
+  uint32_t       i, k, symoff, symsize, stroff, strsize, name, value, shndx, avail;
+
+  for (i = 0U; i < e->num; i++) {
+    sh = SH(e, i);
+    if ((SH_TYPE(sh) != SHT_SYMTAB) || (SH_LINK(sh) >= e->num)) {
+      continue;
+    }
+    symoff  = SH_OFFSET(sh);
+    symsize = SH_SIZE(sh);
+    stroff  = SH_OFFSET(SH(e, SH_LINK(sh)));
+    strsize = SH_SIZE(SH(e, SH_LINK(sh)));
+    if (!in_file(e->size, symoff, symsize) || !in_file(e->size, stroff, strsize)) {
+      continue;
+    }
+    for (k = 0U; (k + 16U) <= symsize; k += 16U) {
+      sym   = &e->d[symoff + k];
+      name  = rd32(&sym[0]);
+      value = rd32(&sym[4]);
+      shndx = rd16(&sym[14]);
+      if ((name >= strsize) || ((strsize - name) < sizeof("FlashDevice")) ||
+          (memcmp(&e->d[stroff + name], "FlashDevice", sizeof("FlashDevice")) != 0)) {
+        continue;
+      }
+      if (shndx >= e->num) {
+        return -1;
+      }
+      sec = SH(e, shndx);
+      if ((value < SH_ADDR(sec)) || ((value - SH_ADDR(sec)) >= SH_SIZE(sec))) {
+        return -1;
+      }
+      avail = SH_SIZE(sec) - (value - SH_ADDR(sec));    // Bytes up to section end
+      if ((avail < FD_SECTORS) || !in_file(e->size, SH_OFFSET(sec) + (value - SH_ADDR(sec)), avail)) {
+        return -1;
+      }
+      decode(&e->d[SH_OFFSET(sec) + (value - SH_ADDR(sec))], avail, dev);
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/**
+  Read FlashDevice structure and RAM footprint from an FLM file.
+  \param[in]    path      FLM file
+  \param[out]   dev       device description
+  \param[out]   err       error text (on error)
+  \param[in]    err_size  size of err
+  \return       0 on success, or -1 on error.
+*/
+int flashdev_read (const char *path, flashdev_t *dev, char *err, size_t err_size) {
+  util_file_t file;
+  elf_t       e;
+  uint32_t    shstrndx;
+  int         rc = -1;
+
+  memset(dev, 0, sizeof(*dev));
+  if (util_file_map(path, &file) != 0) {
+    snprintf(err, err_size, "cannot read file");
+    return -1;
+  }
+  e.d    = (const uint8_t *)file.data;
+  e.size = file.size;
+  if ((e.size < 52U) || (memcmp(e.d, "\177ELF", 4U) != 0) || (e.d[4] != 1U) || (e.d[5] != 1U)) {
+    snprintf(err, err_size, "not an ELF32 little-endian file");
+  } else {
+    e.off     = rd32(&e.d[0x20]);
+    e.entsize = rd16(&e.d[0x2E]);
+    e.num     = rd16(&e.d[0x30]);
+    shstrndx  = rd16(&e.d[0x32]);
+    if ((e.entsize < 40U) || !in_file(e.size, e.off, e.num * e.entsize) || (shstrndx >= e.num) ||
+        (footprint(&e, shstrndx, dev) != 0)) {
+      snprintf(err, err_size, "invalid section header table");
+    } else if (find_device(&e, dev) != 0) {
+      snprintf(err, err_size, "symbol FlashDevice not found");
+    } else {
+      rc = 0;
+    }
+  }
+  util_file_unmap(&file);
+  return rc;
+}
@@ -0,0 +1,67 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Flash algorithm (FLM) device description reader
+ * -------------------------------------------------------------------------- */
+
+#ifndef FLASHDEV_H
+#define FLASHDEV_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLASHDEV_SECTOR_MAX     512U    // SECTOR_NUM of FlashOS.h
+
+/* Sector group (FlashSectors): sectors of size starting at addr up to the next group */
+typedef struct {
+  uint32_t              size;           // szSector
+  uint32_t              addr;           // AddrSector (offset from DevAdr)
+} flashdev_sector_t;
+
+/* Content of the FlashDevice structure and RAM footprint of an FLM file */
+typedef struct {
+  uint16_t              vers;           // Vers
+  uint16_t              type;           // DevType
+  char                  name[129];      // DevName
+  uint32_t              dev_adr;        // DevAdr
+  uint32_t              sz_dev;         // szDev
+  uint32_t              sz_page;        // szPage
+  uint8_t               val_empty;      // valEmpty
+  uint32_t              to_prog;        // toProg
+  uint32_t              to_erase;       // toErase
+  uint32_t              sector_num;     // Sector groups before SECTOR_END
+  flashdev_sector_t     sector[FLASHDEV_SECTOR_MAX];
+  uint32_t              code_size;      // PrgCode section size
+  uint32_t              data_size;      // PrgData section size (RW and ZI)
+} flashdev_t;
+
+extern int flashdev_read (const char *path, flashdev_t *dev, char *err, size_t err_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLASHDEV_H */
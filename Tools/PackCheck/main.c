@@ -0,0 +1,99 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Pack consistency checker command line tool
+ * -------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pdchk.h"
+#include "util.h"
+
+static void usage (void) {
+  fprintf(stderr,
+    "usage: pdchk [-j <jobs>] [-v] <pdsc>...\n"
+    "       pdchk [-j <jobs>] [-v] <index>\n");
+}
+
+/* Check for file name extension */
+static int has_ext (const char *path, const char *ext) {
+  size_t n = strlen(path), e = strlen(ext);
+
+  return (n > e) && (strcmp(&path[n - e], ext) == 0);
+}
+
+int main (int argc, char **argv) {
+  pdchk_options_t opt;
+  pdchk_result_t  res;
+  pdidx_t         idx;
+  long            cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  double          t0, t_load;
+  int             c, rc;
+
+  memset(&opt, 0, sizeof(opt));
+  opt.jobs = (cpus > 0) ? (uint32_t)cpus : 1U;
+  while ((c = getopt(argc, argv, "j:v")) != -1) {
+    switch (c) {
+      case 'j': opt.jobs    = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'v': opt.verbose = 1;                                  break;
+      default:
+        usage();
+        return EXIT_FAILURE;
+    }
+  }
+  argc -= optind;
+  argv += optind;
+  if (argc == 0) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (opt.jobs == 0U) {
+    opt.jobs = 1U;
+  }
+
+  t0 = util_time_ms();
+  if ((argc == 1) && has_ext(argv[0], ".pdidx")) {
+    rc = pdidx_open(argv[0], &idx);
+    if (rc != 0) {
+      fprintf(stderr, "%s: error: cannot open index\n", argv[0]);
+    }
+  } else {
+    rc = pdidx_load((const char * const *)argv, (uint32_t)argc, &idx);
+  }
+  if (rc != 0) {
+    return EXIT_FAILURE;
+  }
+  t_load = util_time_ms() - t0;
+
+  rc = pdchk_run(&idx, &opt, &res);
+  pdidx_close(&idx);
+  if (rc != 0) {
+    return EXIT_FAILURE;
+  }
+  printf("%u devices, %u algorithms, %u files: %u errors, %u warnings (%u distinct)\n",
+         res.devices, res.algorithms, res.files, res.errors, res.warnings, res.unique);
+  printf("time: index %.1f ms, total %.1f ms (%u jobs)\n", t_load, util_time_ms() - t0, opt.jobs);
+  return (res.errors == 0U) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
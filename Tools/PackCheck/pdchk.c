@@ -0,0 +1,701 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Pack consistency checker
+ * -------------------------------------------------------------------------- */
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "flashdev.h"
+#include "pdchk.h"
+#include "svd.h"
+#include "util.h"
+
+#define ALGO_HEADER     32U     // Breakpoint header placed before PrgCode by the debugger
+#define DEVICES_SHOWN   4U      // Devices listed per message (without verbose)
+
+/* Referenced file kinds */
+#define FILE_FLM        0U
+#define FILE_SVD        1U
+#define FILE_DBGCONF    2U
+
+/* Referenced file and its check result */
+typedef struct {
+  const char           *path;           // Resolved path
+  uint32_t              kind;           // FILE_x
+  int                   ok;             // File exists and is valid
+  char                  err[128];       // Error text (ok == 0)
+  flashdev_t           *flm;            // FLM: FlashDevice content
+  util_vec_t            names;          // dbgconf: assigned variables (char, NUL separated)
+} file_t;
+
+/* Distinct message and the devices reporting it */
+typedef struct {
+  const char           *text;           // "E" or "W" followed by text
+  util_vec_t            device;         // Device indices (uint32_t)
+} group_t;
+
+typedef struct check check_t;
+typedef void (*work_t) (check_t *c, uint32_t i);
+
+struct check {
+  const pdidx_t        *idx;
+  util_arena_t          arena;
+  util_vec_t            file;           // file_t
+  util_hindex_t         file_idx;       // file path -> file index
+  util_file_t          *pack;           // Mapped pdsc files
+  util_vec_t           *out;            // Messages per device (char, NUL separated)
+  pthread_mutex_t       lock;
+  uint32_t              next;           // Next work item
+  uint32_t              num;            // Number of work items
+  work_t                work;
+};
+
+typedef struct {
+  check_t              *c;
+  const char           *path;
+} file_key_t;
+
+static int file_eq (void *ctx, uint32_t index) {
+  const file_key_t *k = ctx;
+  return strcmp(UTIL_VEC_AT(&k->c->file, file_t, index).path, k->path) == 0;
+}
+
+/* Resolve path relative to the directory of the pdsc file */
+static void resolve (const check_t *c, uint32_t pack, const char *rel, char *buf, size_t size) {
+  const char *pdsc = PDIDX_STR(c->idx, c->idx->pack[pack].path);
+  const char *slash = strrchr(pdsc, '/');
+  size_t      dir = (slash != NULL) ? (size_t)(slash - pdsc) + 1U : 0U;
+  size_t      i;
+
+  if ((dir + strlen(rel)) >= size) {
+    buf[0] = '\0';
+    return;
+  }
+  memcpy(buf, pdsc, dir);
+  for (i = 0U; rel[i] != '\0'; i++) {
+    buf[dir + i] = (rel[i] == '\\') ? '/' : rel[i];
+  }
+  buf[dir + i] = '\0';
+}
+
+/* Find referenced file (NULL when not registered) */
+static file_t *file_find (check_t *c, uint32_t pack, const char *rel) {
+  char       path[1024];
+  file_key_t key;
+  uint32_t   i;
+
+  resolve(c, pack, rel, path, sizeof(path));
+  key.c    = c;
+  key.path = path;
+  i = util_hindex_find(&c->file_idx, util_hash(path, strlen(path)), file_eq, &key);
+  return (i != UINT32_MAX) ? &UTIL_VEC_AT(&c->file, file_t, i) : NULL;
+}
+
+/* Register referenced file (once per resolved path) */
+static void file_add (check_t *c, uint32_t pack, const char *rel, uint32_t kind) {
+  char     path[1024];
+  file_t  *f;
+
+  if ((rel[0] == '\0') || (file_find(c, pack, rel) != NULL)) {
+    return;
+  }
+  resolve(c, pack, rel, path, sizeof(path));
+  f = util_vec_push(&c->file);
+  f->path = util_arena_strdup(&c->arena, path, strlen(path));
+  f->kind = kind;
+  util_vec_init(&f->names, 1U);
+  util_hindex_add(&c->file_idx, util_hash(path, strlen(path)), (uint32_t)(c->file.num - 1U));
+}
+
+/* Worker thread: process work items until none is left */
+static void *worker (void *arg) {
+  check_t *c = arg;
+  uint32_t i;
+
+  for (;;) {
+    pthread_mutex_lock(&c->lock);
+    i = c->next++;
+    pthread_mutex_unlock(&c->lock);
+    if (i >= c->num) {
+      break;
+    }
+    c->work(c, i);
+  }
+  return NULL;
+}
+
+/* Run work items 0 .. num-1 on jobs threads */
+static void parallel (check_t *c, uint32_t num, uint32_t jobs, work_t work) {
+  pthread_t *thread;
+  uint32_t   i, started = 0U;
+
+  c->next = 0U;
+  c->num  = num;
+  c->work = work;
+  if (jobs > num) {
+    jobs = num;
+  }
+  thread = calloc((jobs != 0U) ? jobs : 1U, sizeof(pthread_t));
+  for (i = 1U; (thread != NULL) && (i < jobs); i++) {
+    if (pthread_create(&thread[i], NULL, worker, c) != 0) {
+      break;
+    }
+    started = i;
+  }
+  worker(c);                    // Calling thread is a worker too
+  for (i = 1U; i <= started; i++) {
+    pthread_join(thread[i], NULL);
+  }
+  free(thread);
+}
+
+/* Check identifier character */
+static int is_ident (char ch, int first) {
+  return ((ch >= 'a') && (ch <= 'z')) || ((ch >= 'A') && (ch <= 'Z')) || (ch == '_') ||
+         ((first == 0) && (ch >= '0') && (ch <= '9'));
+}
+
+/* Parse dbgconf content: comments and "Name = Value;" assignments */
+static int parse_dbgconf (const char *s, size_t n, util_vec_t *names, char *err, size_t err_size) {
+  uint64_t value;
+  uint32_t line = 1U;
+  size_t   i = 0U, k, len;
+  int      comment = 0;
+
+  while (i < n) {
+    if (s[i] == '\n') {
+      line++;
+      i++;
+    } else if (comment != 0) {
+      if (((i + 1U) < n) && (s[i] == '*') && (s[i + 1U] == '/')) {
+        comment = 0;
+        i++;
+      }
+      i++;
+    } else if ((s[i] == ' ') || (s[i] == '\t') || (s[i] == '\r')) {
+      i++;
+    } else if (((i + 1U) < n) && (s[i] == '/') && (s[i + 1U] == '/')) {
+      while ((i < n) && (s[i] != '\n')) {
+        i++;
+      }
+    } else if (((i + 1U) < n) && (s[i] == '/') && (s[i + 1U] == '*')) {
+      comment = 1;
+      i += 2U;
+    } else if (is_ident(s[i], 1)) {
+      k = i;
+      while ((i < n) && is_ident(s[i], 0)) {
+        i++;
+      }
+      len = i - k;
+      util_vec_append(names, &s[k], len);
+      util_vec_append(names, "", 1U);
+      while ((i < n) && ((s[i] == ' ') || (s[i] == '\t'))) {
+        i++;
+      }
+      if ((i >= n) || (s[i] != '=')) {
+        snprintf(err, err_size, "line %u: expected '=' after '%.*s'", line, (int)len, &s[k]);
+        return -1;
+      }
+      k = ++i;
+      while ((i < n) && (s[i] != ';') && (s[i] != '\n')) {
+        i++;
+      }
+      if ((i >= n) || (s[i] != ';') || (util_parse_number(&s[k], i - k, &value) != 0)) {
+        snprintf(err, err_size, "line %u: expected number followed by ';'", line);
+        return -1;
+      }
+      i++;
+    } else {
+      snprintf(err, err_size, "line %u: unexpected character '%c'", line, s[i]);
+      return -1;
+    }
+  }
+  if (comment != 0) {
+    snprintf(err, err_size, "unterminated comment");
+    return -1;
+  }
+  return 0;
+}
+
+/* Phase 1: check one referenced file */
+static void check_file (check_t *c, uint32_t i) {
+  file_t           *f = &UTIL_VEC_AT(&c->file, file_t, i);
+  util_file_t       file;
+  svd_peripheral_t *per;
+  svd_t            *svd;
+
+  if (access(f->path, R_OK) != 0) {
+    snprintf(f->err, sizeof(f->err), "file not found");
+    return;
+  }
+  switch (f->kind) {
+    case FILE_FLM:
+      f->flm = malloc(sizeof(flashdev_t));
+      if (f->flm == NULL) {
+        snprintf(f->err, sizeof(f->err), "out of memory");
+      } else if (flashdev_read(f->path, f->flm, f->err, sizeof(f->err)) == 0) {
+        f->ok = 1;
+      }
+      break;
+    case FILE_SVD:
+      svd = svd_open(f->path);
+      if (svd == NULL) {
+        snprintf(f->err, sizeof(f->err), "cannot parse SVD file");
+        break;
+      }
+      for (per = svd_next(svd, NULL); per != NULL; per = svd_next(svd, per)) {
+        (void)svd_peripheral_base(svd, per);
+      }
+      if (svd_error(svd) != 0) {
+        snprintf(f->err, sizeof(f->err), "SVD file is not well-formed");
+      } else {
+        f->ok = 1;
+      }
+      svd_close(svd);
+      break;
+    default:
+      if (util_file_map(f->path, &file) != 0) {
+        snprintf(f->err, sizeof(f->err), "cannot read file");
+        break;
+      }
+      if (parse_dbgconf(file.data, file.size, &f->names, f->err, sizeof(f->err)) == 0) {
+        f->ok = 1;
+      }
+      util_file_unmap(&file);
+      break;
+  }
+}
+
+/* Add message of a device ("E" error or "W" warning prefix) */
+static void report (util_vec_t *out, char type, const char *fmt, ...) {
+  char    buf[320];
+  va_list ap;
+  int     len;
+
+  buf[0] = type;
+  va_start(ap, fmt);
+  len = vsnprintf(&buf[1], sizeof(buf) - 1U, fmt, ap);
+  va_end(ap);
+  if (len < 0) {
+    return;
+  }
+  if ((size_t)len >= (sizeof(buf) - 1U)) {
+    len = (int)sizeof(buf) - 2;
+  }
+  util_vec_append(out, buf, (size_t)len + 1U);
+  util_vec_append(out, "", 1U);
+}
+
+/* Processor name match ("" matches all) */
+static int pname_match (const pdidx_t *idx, uint32_t a, uint32_t b) {
+  return (idx->string[a] == '\0') || (idx->string[b] == '\0') || (strcmp(PDIDX_STR(idx, a), PDIDX_STR(idx, b)) == 0);
+}
+
+/* Writable memory region (access attribute, or legacy id IRAMx) */
+static int mem_writable (const pdidx_t *idx, const pdidx_memory_t *m) {
+  const char *access = PDIDX_STR(idx, m->access);
+
+  if (access[0] == '\0') {
+    return strncmp(PDIDX_STR(idx, m->name), "IRAM", 4U) == 0;
+  }
+  return strchr(access, 'w') != NULL;
+}
+
+/* Check that [start, start + size) lies within adjacent writable regions */
+static int ram_covered (const pdidx_t *idx, const pdidx_device_t *dev, uint32_t pname, uint32_t start, uint32_t size) {
+  const pdidx_memory_t *m;
+  uint64_t              addr = start, end = (uint64_t)start + size;
+  uint32_t              i;
+  int                   found = 1;
+
+  while ((addr < end) && (found != 0)) {
+    found = 0;
+    for (i = 0U; i < dev->memory.num; i++) {
+      m = PDIDX_MEMORY(idx, dev, i);
+      if (mem_writable(idx, m) && pname_match(idx, m->pname, pname) &&
+          (addr >= m->start) && (addr < ((uint64_t)m->start + m->size))) {
+        addr  = (uint64_t)m->start + m->size;
+        found = 1;
+        break;
+      }
+    }
+  }
+  return addr >= end;
+}
+
+/* Check algorithm against FlashDevice content and the memory map */
+static void check_algorithm (check_t *c, const pdidx_device_t *dev, const pdidx_algorithm_t *a,
+                             const flashdev_t *fd, util_vec_t *out) {
+  const pdidx_t        *idx  = c->idx;
+  const char           *name = PDIDX_STR(idx, a->name);
+  const pdidx_memory_t *m, *ram = NULL;
+  const flashdev_sector_t *s;
+  uint32_t              i, end, ram_size, need;
+
+  if (a->start != fd->dev_adr) {
+    report(out, 'E', "algorithm %s: start 0x%08X does not match FlashDevice DevAdr 0x%08X", name, a->start, fd->dev_adr);
+  }
+  if (a->size > fd->sz_dev) {
+    report(out, 'E', "algorithm %s: size 0x%X exceeds FlashDevice szDev 0x%X", name, a->size, fd->sz_dev);
+  }
+  if (fd->sz_page == 0U) {
+    report(out, 'E', "algorithm %s: FlashDevice szPage is 0", name);
+  }
+
+  // Sector groups: start at offset 0, ascending, each tiling up to the next group and szDev
+  if (fd->sector_num == 0U) {
+    report(out, 'E', "algorithm %s: FlashDevice has no sectors", name);
+  } else if (fd->sector[0].addr != 0U) {
+    report(out, 'E', "algorithm %s: first sector group at offset 0x%X (expected 0)", name, fd->sector[0].addr);
+  }
+  for (i = 0U; i < fd->sector_num; i++) {
+    s   = &fd->sector[i];
+    end = ((i + 1U) < fd->sector_num) ? fd->sector[i + 1U].addr : fd->sz_dev;
+    if (s->size == 0U) {
+      report(out, 'E', "algorithm %s: sector group at offset 0x%X has size 0", name, s->addr);
+    } else if (end <= s->addr) {
+      report(out, 'E', "algorithm %s: sector group at offset 0x%X not below 0x%X", name, s->addr, end);
+    } else if (((end - s->addr) % s->size) != 0U) {
+      report(out, ((i + 1U) < fd->sector_num) ? 'E' : 'W',
+             "algorithm %s: sectors of 0x%X bytes from offset 0x%X do not end at 0x%X", name, s->size, s->addr, end);
+    }
+  }
+
+  // RAM window: within writable regions, large enough for code, data and one page buffer
+  if (a->ram_size != 0U) {
+    ram_size = a->ram_size;
+    if (!ram_covered(idx, dev, a->pname, a->ram_start, a->ram_size)) {
+      report(out, 'E', "algorithm %s: RAM 0x%08X..0x%08X not within writable memory", name,
+             a->ram_start, (uint32_t)(a->ram_start + a->ram_size - 1U));
+      return;
+    }
+  } else {
+    for (i = 0U; i < dev->memory.num; i++) {
+      m = PDIDX_MEMORY(idx, dev, i);
+      if (((m->flags & PDIDX_MEM_DEFAULT) != 0U) && mem_writable(idx, m) && pname_match(idx, m->pname, a->pname)) {
+        ram = m;
+        break;
+      }
+    }
+    if (ram == NULL) {
+      report(out, 'E', "algorithm %s: no RAMstart/RAMsize and no default RAM region", name);
+      return;
+    }
+    ram_size = ram->size;
+  }
+  need = ALGO_HEADER + fd->code_size + fd->data_size + fd->sz_page;
+  if (ram_size < need) {
+    report(out, 'E', "algorithm %s: RAM size 0x%X below code, data and page buffer (0x%X)", name, ram_size, need);
+  }
+}
+
+/* Check that a default read-only region is covered by the device algorithms */
+static void check_coverage (check_t *c, const pdidx_device_t *dev, const pdidx_memory_t *m, util_vec_t *out) {
+  const pdidx_t           *idx = c->idx;
+  const pdidx_algorithm_t *a;
+  uint64_t                 addr = m->start, end = (uint64_t)m->start + m->size;
+  uint32_t                 i;
+  int                      found = 1;
+
+  while ((addr < end) && (found != 0)) {
+    found = 0;
+    for (i = 0U; i < dev->algorithm.num; i++) {
+      a = PDIDX_ALGORITHM(idx, dev, i);
+      if (pname_match(idx, a->pname, m->pname) && (addr >= a->start) && (addr < ((uint64_t)a->start + a->size))) {
+        addr  = (uint64_t)a->start + a->size;
+        found = 1;
+        break;
+      }
+    }
+  }
+  if (addr < end) {
+    report(out, 'W', "memory %s: 0x%08X..0x%08X not covered by a flash algorithm", PDIDX_STR(idx, m->name),
+           (uint32_t)addr, (uint32_t)(end - 1U));
+  }
+}
+
+/* Check if variable is declared with __var in the debugvars text */
+static int var_declared (const char *text, size_t len, const char *name) {
+  size_t n = strlen(name);
+  size_t i, k;
+
+  for (i = 0U; (i + 5U) < len; i++) {
+    if ((memcmp(&text[i], "__var", 5U) != 0) || ((i != 0U) && is_ident(text[i - 1U], 0))) {
+      continue;
+    }
+    k = i + 5U;
+    if ((k >= len) || ((text[k] != ' ') && (text[k] != '\t'))) {
+      continue;
+    }
+    while ((k < len) && ((text[k] == ' ') || (text[k] == '\t'))) {
+      k++;
+    }
+    if (((k + n) <= len) && (memcmp(&text[k], name, n) == 0) && (((k + n) == len) || !is_ident(text[k + n], 0))) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Check debugvars element against its dbgconf file */
+static void check_debugvars (check_t *c, const pdidx_device_t *dev, const pdidx_element_t *e, util_vec_t *out) {
+  const util_file_t *pdsc = &c->pack[dev->pack];
+  const char        *rel  = PDIDX_STR(c->idx, e->name);
+  const file_t      *f;
+  const char        *var;
+  size_t             off;
+
+  if (rel[0] == '\0') {
+    return;
+  }
+  f = file_find(c, dev->pack, rel);
+  if ((f == NULL) || (f->ok == 0)) {
+    report(out, 'E', "dbgconf %s: %s", rel, (f != NULL) ? f->err : "not resolved");
+    return;
+  }
+  if ((pdsc->data == NULL) || (((uint64_t)e->offset + e->length) > pdsc->size)) {
+    return;
+  }
+  for (off = 0U; off < f->names.num; off += strlen(var) + 1U) {
+    var = &UTIL_VEC_AT(&f->names, char, off);
+    if (!var_declared(&pdsc->data[e->offset], e->length, var)) {
+      report(out, 'E', "dbgconf %s: variable %s not declared in <debugvars>", rel, var);
+    }
+  }
+}
+
+/* Phase 2: check one device */
+static void check_device (check_t *c, uint32_t i) {
+  const pdidx_t           *idx = c->idx;
+  const pdidx_device_t    *dev = &idx->device[i];
+  const pdidx_processor_t *p;
+  const pdidx_algorithm_t *a;
+  const pdidx_memory_t    *m;
+  const pdidx_element_t   *e;
+  const file_t            *f;
+  util_vec_t              *out = &c->out[i];
+  uint32_t                 k;
+
+  if (dev->algorithm.num == 0U) {
+    report(out, 'W', "no flash algorithm");
+  }
+  for (k = 0U; k < dev->algorithm.num; k++) {
+    a = PDIDX_ALGORITHM(idx, dev, k);
+    f = file_find(c, dev->pack, PDIDX_STR(idx, a->name));
+    if ((f == NULL) || (f->ok == 0)) {
+      report(out, 'E', "algorithm %s: %s", PDIDX_STR(idx, a->name), (f != NULL) ? f->err : "no name");
+    } else {
+      check_algorithm(c, dev, a, f->flm, out);
+    }
+  }
+  for (k = 0U; k < dev->memory.num; k++) {
+    m = PDIDX_MEMORY(idx, dev, k);
+    if (((m->flags & PDIDX_MEM_DEFAULT) != 0U) && !mem_writable(idx, m)) {
+      check_coverage(c, dev, m, out);
+    }
+  }
+  for (k = 0U; k < dev->processor.num; k++) {
+    p = PDIDX_PROCESSOR(idx, dev, k);
+    if (idx->string[p->svd] == '\0') {
+      report(out, 'W', "processor %s: no <debug svd>", PDIDX_STR(idx, p->pname));
+      continue;
+    }
+    f = file_find(c, dev->pack, PDIDX_STR(idx, p->svd));
+    if ((f != NULL) && (f->ok == 0)) {
+      report(out, 'E', "svd %s: %s", PDIDX_STR(idx, p->svd), f->err);
+    }
+  }
+  for (k = 0U; k < dev->element.num; k++) {
+    e = PDIDX_ELEMENT(idx, dev, k);
+    if (e->kind == PDIDX_ELEM_DEBUGVARS) {
+      check_debugvars(c, dev, e, out);
+    }
+  }
+}
+
+typedef struct {
+  const util_vec_t     *group;
+  const char           *text;
+} group_key_t;
+
+static int group_eq (void *ctx, uint32_t index) {
+  const group_key_t *k = ctx;
+  return strcmp(UTIL_VEC_AT(k->group, group_t, index).text, k->text) == 0;
+}
+
+/* Merge identical messages of all devices and print them (errors first) */
+static void print_messages (const check_t *c, int verbose, pdchk_result_t *res) {
+  const pdidx_t *idx = c->idx;
+  util_vec_t     group;
+  util_hindex_t  hidx;
+  group_key_t    key;
+  group_t       *g;
+  const char    *msg;
+  uint32_t       i, j, k, n;
+  size_t         off;
+  char           type;
+
+  util_vec_init(&group, sizeof(group_t));
+  util_hindex_init(&hidx);
+  key.group = &group;
+  for (i = 0U; i < idx->hdr->device_num; i++) {
+    for (off = 0U; off < c->out[i].num; off += strlen(msg) + 1U) {
+      msg = &UTIL_VEC_AT(&c->out[i], char, off);
+      if (msg[0] == 'E') {
+        res->errors++;
+      } else {
+        res->warnings++;
+      }
+      key.text = msg;
+      j = util_hindex_find(&hidx, util_hash(msg, strlen(msg)), group_eq, &key);
+      if (j == UINT32_MAX) {
+        g = util_vec_push(&group);
+        g->text = msg;
+        util_vec_init(&g->device, sizeof(uint32_t));
+        j = (uint32_t)(group.num - 1U);
+        util_hindex_add(&hidx, util_hash(msg, strlen(msg)), j);
+      }
+      *(uint32_t *)util_vec_push(&UTIL_VEC_AT(&group, group_t, j).device) = i;
+    }
+  }
+  res->unique = (uint32_t)group.num;
+
+  for (type = 'E'; type != '\0'; type = (type == 'E') ? 'W' : '\0') {
+    for (j = 0U; j < group.num; j++) {
+      g = &UTIL_VEC_AT(&group, group_t, j);
+      if (g->text[0] != type) {
+        continue;
+      }
+      n = (uint32_t)g->device.num;
+      printf("%s: %s\n  ", (type == 'E') ? "error" : "warning", &g->text[1]);
+      for (k = 0U; k < n; k++) {
+        if ((verbose == 0) && (k == DEVICES_SHOWN) && (n > (DEVICES_SHOWN + 1U))) {
+          printf(" and %u more", n - k);
+          break;
+        }
+        printf("%s%s", (k != 0U) ? ", " : "", PDIDX_STR(idx, idx->device[UTIL_VEC_AT(&g->device, uint32_t, k)].name));
+      }
+      printf("\n");
+    }
+  }
+
+  for (j = 0U; j < group.num; j++) {
+    util_vec_free(&UTIL_VEC_AT(&group, group_t, j).device);
+  }
+  util_vec_free(&group);
+  util_hindex_free(&hidx);
+}
+
+/**
+  Check all devices of a pack device index against the referenced files.
+  \param[in]    idx     opened or loaded device index
+  \param[in]    opt     options
+  \param[out]   res     result counters
+  \return       0 on success (messages printed), or -1 on error.
+*/
+int pdchk_run (const pdidx_t *idx, const pdchk_options_t *opt, pdchk_result_t *res) {
+  const pdidx_device_t *dev;
+  check_t               c;
+  file_t               *f;
+  uint32_t              i, k, pack_num = idx->hdr->pack_num, dev_num = idx->hdr->device_num;
+  int                   rc = 0;
+
+  memset(res, 0, sizeof(*res));
+  memset(&c, 0, sizeof(c));
+  c.idx = idx;
+  util_arena_init(&c.arena);
+  util_vec_init(&c.file, sizeof(file_t));
+  util_hindex_init(&c.file_idx);
+  pthread_mutex_init(&c.lock, NULL);
+  c.pack = calloc((pack_num != 0U) ? pack_num : 1U, sizeof(util_file_t));
+  c.out  = calloc((dev_num  != 0U) ? dev_num  : 1U, sizeof(util_vec_t));
+  if ((c.pack == NULL) || (c.out == NULL)) {
+    fprintf(stderr, "pdchk: error: out of memory\n");
+    rc = -1;
+  }
+
+  // pdsc content is needed for <debugvars>; a stale index would point to wrong offsets
+  for (i = 0U; (rc == 0) && (i < pack_num); i++) {
+    const char *path = PDIDX_STR(idx, idx->pack[i].path);
+    if (util_file_map(path, &c.pack[i]) != 0) {
+      fprintf(stderr, "%s: error: cannot read pdsc file\n", path);
+      rc = -1;
+    } else if ((c.pack[i].size != idx->pack[i].size) ||
+               (util_hash(c.pack[i].data, c.pack[i].size) != idx->pack[i].hash)) {
+      fprintf(stderr, "%s: error: pdsc file changed since the index was built\n", path);
+      rc = -1;
+    }
+  }
+
+  if (rc == 0) {
+    // Collect referenced files (serial: registration order defines the file table)
+    for (i = 0U; i < dev_num; i++) {
+      dev = &idx->device[i];
+      util_vec_init(&c.out[i], 1U);
+      res->algorithms += dev->algorithm.num;
+      for (k = 0U; k < dev->algorithm.num; k++) {
+        file_add(&c, dev->pack, PDIDX_STR(idx, PDIDX_ALGORITHM(idx, dev, k)->name), FILE_FLM);
+      }
+      for (k = 0U; k < dev->processor.num; k++) {
+        file_add(&c, dev->pack, PDIDX_STR(idx, PDIDX_PROCESSOR(idx, dev, k)->svd), FILE_SVD);
+      }
+      for (k = 0U; k < dev->element.num; k++) {
+        if (PDIDX_ELEMENT(idx, dev, k)->kind == PDIDX_ELEM_DEBUGVARS) {
+          file_add(&c, dev->pack, PDIDX_STR(idx, PDIDX_ELEMENT(idx, dev, k)->name), FILE_DBGCONF);
+        }
+      }
+    }
+    res->devices = dev_num;
+    res->files   = (uint32_t)c.file.num;
+
+    parallel(&c, (uint32_t)c.file.num, opt->jobs, check_file);
+    parallel(&c, dev_num, opt->jobs, check_device);
+    print_messages(&c, opt->verbose, res);
+  }
+
+  for (i = 0U; i < c.file.num; i++) {
+    f = &UTIL_VEC_AT(&c.file, file_t, i);
+    free(f->flm);
+    util_vec_free(&f->names);
+  }
+  for (i = 0U; (c.out != NULL) && (i < dev_num); i++) {
+    util_vec_free(&c.out[i]);
+  }
+  for (i = 0U; (c.pack != NULL) && (i < pack_num); i++) {
+    if (c.pack[i].data != NULL) {
+      util_file_unmap(&c.pack[i]);
+    }
+  }
+  free(c.out);
+  free(c.pack);
+  pthread_mutex_destroy(&c.lock);
+  util_hindex_free(&c.file_idx);
+  util_vec_free(&c.file);
+  util_arena_free(&c.arena);
+  return rc;
+}
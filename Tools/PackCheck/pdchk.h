@@ -0,0 +1,74 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Pack consistency checker
+ * -------------------------------------------------------------------------- */
+
+#ifndef PDCHK_H
+#define PDCHK_H
+
+#include <stdint.h>
+
+#include "pdidx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Checks
+ *
+ * Per device (flattened by the pack device index):
+ *   - <algorithm> start/size against FlashDevice DevAdr/szDev of the FLM,
+ *     sector table layout, RAMstart/RAMsize against writable <memory>
+ *     regions and against the FLM RAM footprint (code, data, one page)
+ *   - default read-only <memory> regions covered by an algorithm
+ *   - <debug svd> files exist and parse
+ *   - <debugvars configfile> files exist and parse, and assign only
+ *     variables declared in <debugvars>
+ *
+ * Referenced files are checked once in a first parallel pass, devices in a
+ * second pass. Identical messages of several devices are reported once.
+ */
+
+/* Options */
+typedef struct {
+  uint32_t              jobs;           // Worker threads
+  int                   verbose;        // List all devices of a message
+} pdchk_options_t;
+
+/* Result */
+typedef struct {
+  uint32_t              devices;        // Checked devices
+  uint32_t              algorithms;     // Checked device algorithms
+  uint32_t              files;          // Checked files (FLM, SVD, dbgconf)
+  uint32_t              errors;         // Errors (device, message)
+  uint32_t              warnings;       // Warnings (device, message)
+  uint32_t              unique;         // Distinct messages
+} pdchk_result_t;
+
+extern int pdchk_run (const pdidx_t *idx, const pdchk_options_t *opt, pdchk_result_t *res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PDCHK_H */
@@ -0,0 +1,273 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Pack device index command line tool
+ * -------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pdidx.h"
+#include "util.h"
+
+#ifdef PDIDX_BENCH_LIBXML2
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+#endif
+
+#define BENCH_RUNS      5U              // Runs per XML measurement (best is reported)
+#define BENCH_OPENS     1000U           // Index open/close cycles
+#define BENCH_LOOKUPS   1000000U        // Device lookups
+
+static void usage (void) {
+  fprintf(stderr,
+    "usage: pdidx build [-v] <index> <pdsc>...\n"
+    "       pdidx show <index> <device>\n"
+    "       pdidx list <index>\n"
+    "       pdidx bench <index> <pdsc>...\n");
+}
+
+/* String or "-" when empty */
+static const char *str_or_dash (const pdidx_t *idx, uint32_t offs) {
+  return (offs != 0U) ? PDIDX_STR(idx, offs) : "-";
+}
+
+static int cmd_show (int argc, char **argv) {
+  const pdidx_device_t *dev;
+  pdidx_t  idx;
+  uint32_t i;
+
+  if (argc != 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (pdidx_open(argv[0], &idx) != 0) {
+    fprintf(stderr, "%s: error: cannot open index\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  dev = pdidx_device(&idx, argv[1]);
+  if (dev == NULL) {
+    fprintf(stderr, "%s: error: device '%s' not found\n", argv[0], argv[1]);
+    pdidx_close(&idx);
+    return EXIT_FAILURE;
+  }
+
+  printf("%s", PDIDX_STR(&idx, dev->name));
+  if (dev->parent != 0U) {
+    printf(" (variant of %s)", PDIDX_STR(&idx, dev->parent));
+  }
+  printf("\n  family:     %s / %s (%s)\n  pack:       %s\n", str_or_dash(&idx, dev->family),
+         str_or_dash(&idx, dev->sub_family), str_or_dash(&idx, dev->vendor),
+         PDIDX_STR(&idx, idx.pack[dev->pack].path));
+  for (i = 0U; i < dev->processor.num; i++) {
+    const pdidx_processor_t *p = PDIDX_PROCESSOR(&idx, dev, i);
+    printf("  processor:  %-4s %s %s %s %u Hz, svd %s, ap %u\n", str_or_dash(&idx, p->pname),
+           str_or_dash(&idx, p->core), str_or_dash(&idx, p->fpu), str_or_dash(&idx, p->mpu),
+           p->clock, str_or_dash(&idx, p->svd), p->ap);
+  }
+  for (i = 0U; i < dev->memory.num; i++) {
+    const pdidx_memory_t *m = PDIDX_MEMORY(&idx, dev, i);
+    printf("  memory:     0x%08X %08X %-4s %-12s %-4s%s%s\n", m->start, m->size,
+           str_or_dash(&idx, m->pname), str_or_dash(&idx, m->name), str_or_dash(&idx, m->access),
+           ((m->flags & PDIDX_MEM_DEFAULT) != 0U) ? " default" : "",
+           ((m->flags & PDIDX_MEM_STARTUP) != 0U) ? " startup" : "");
+  }
+  for (i = 0U; i < dev->algorithm.num; i++) {
+    const pdidx_algorithm_t *a = PDIDX_ALGORITHM(&idx, dev, i);
+    printf("  algorithm:  0x%08X %08X %-4s %s (RAM 0x%08X %X)%s\n", a->start, a->size,
+           str_or_dash(&idx, a->pname), str_or_dash(&idx, a->name), a->ram_start, a->ram_size,
+           ((a->flags & PDIDX_ALGO_DEFAULT) != 0U) ? " default" : "");
+  }
+  for (i = 0U; i < dev->element.num; i++) {
+    const pdidx_element_t *e = PDIDX_ELEMENT(&idx, dev, i);
+    if (e->kind == PDIDX_ELEM_DEBUGVARS) {
+      printf("  debugvars:  %-4s %s %s (offset %u, %u bytes)\n", str_or_dash(&idx, e->pname),
+             str_or_dash(&idx, e->name), str_or_dash(&idx, e->version), e->offset, e->length);
+    } else {
+      printf("  sequence:   %-4s %s (offset %u, %u bytes)\n", str_or_dash(&idx, e->pname),
+             str_or_dash(&idx, e->name), e->offset, e->length);
+    }
+  }
+  pdidx_close(&idx);
+  return EXIT_SUCCESS;
+}
+
+static int cmd_list (int argc, char **argv) {
+  const pdidx_device_t *dev;
+  pdidx_t  idx;
+  uint32_t i;
+
+  if (argc != 1) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (pdidx_open(argv[0], &idx) != 0) {
+    fprintf(stderr, "%s: error: cannot open index\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  for (i = 0U; i < idx.hdr->device_num; i++) {
+    dev = &idx.device[i];
+    printf("%-20s %-12s %u memories, %u algorithms\n", PDIDX_STR(&idx, dev->name),
+           str_or_dash(&idx, dev->sub_family), dev->memory.num, dev->algorithm.num);
+  }
+  pdidx_close(&idx);
+  return EXIT_SUCCESS;
+}
+
+#ifdef PDIDX_BENCH_LIBXML2
+/* libxml2 DOM: parse and free documents */
+static double bench_dom (const char * const *pdsc, uint32_t num) {
+  util_file_t file;
+  xmlDocPtr   doc;
+  uint32_t    run, i;
+  double      t0, t, best = 0.0;
+
+  for (run = 0U; run < BENCH_RUNS; run++) {
+    t0 = util_time_ms();
+    for (i = 0U; i < num; i++) {
+      if (util_file_map(pdsc[i], &file) != 0) {
+        return -1.0;
+      }
+      doc = xmlReadMemory(file.data, (int)file.size, pdsc[i], NULL, XML_PARSE_NONET);
+      if (doc == NULL) {
+        util_file_unmap(&file);
+        return -1.0;
+      }
+      xmlFreeDoc(doc);
+      util_file_unmap(&file);
+    }
+    t = util_time_ms() - t0;
+    if ((run == 0U) || (t < best)) {
+      best = t;
+    }
+  }
+  return best;
+}
+#endif
+
+/* Compare index lookups with parsing the pdsc files */
+static int cmd_bench (int argc, char **argv) {
+  const pdidx_device_t *dev;
+  const pdidx_memory_t *mem;
+  pdidx_t  idx;
+  uint32_t run, i, n, hit = 0U;
+  double   t0, t, t_parse = 0.0, t_open, t_lookup;
+
+  if (argc < 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  // Without index: every query parses all pdsc files and flattens the device tree
+  for (run = 0U; run < BENCH_RUNS; run++) {
+    t0 = util_time_ms();
+    if (pdidx_build(NULL, (const char * const *)&argv[1], (uint32_t)(argc - 1), 0) != 0) {
+      return EXIT_FAILURE;
+    }
+    t = util_time_ms() - t0;
+    if ((run == 0U) || (t < t_parse)) {
+      t_parse = t;
+    }
+  }
+
+  t0 = util_time_ms();
+  for (i = 0U; i < BENCH_OPENS; i++) {
+    if (pdidx_open(argv[0], &idx) != 0) {
+      fprintf(stderr, "%s: error: cannot open index\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+    pdidx_close(&idx);
+  }
+  t_open = (util_time_ms() - t0) / BENCH_OPENS;
+
+  // Lookup of each device by name, then memory lookup at its startup address
+  if (pdidx_open(argv[0], &idx) != 0) {
+    return EXIT_FAILURE;
+  }
+  n  = idx.hdr->device_num;
+  t0 = util_time_ms();
+  for (i = 0U; i < BENCH_LOOKUPS; i++) {
+    dev = pdidx_device(&idx, PDIDX_STR(&idx, idx.device[(i * 7919U) % n].name));
+    if ((dev != NULL) && (dev->memory.num != 0U)) {
+      mem = pdidx_memory_at(&idx, dev, NULL, PDIDX_MEMORY(&idx, dev, dev->memory.num - 1U)->start);
+      if (mem != NULL) {
+        hit++;
+      }
+    }
+  }
+  t_lookup = util_time_ms() - t0;
+
+  printf("pdsc parse:  %.3f ms (%d files, full parse and flatten, best of %u)\n", t_parse, argc - 1, BENCH_RUNS);
+#ifdef PDIDX_BENCH_LIBXML2
+  t = bench_dom((const char * const *)&argv[1], (uint32_t)(argc - 1));
+  if (t >= 0.0) {
+    printf("libxml2 DOM: %.3f ms (parse only, best of %u)\n", t, BENCH_RUNS);
+  }
+#endif
+  printf("index open:  %.1f us\n", t_open * 1000.0);
+  printf("lookup:      %u lookups over %u devices, %.1f ns/lookup, %u hits\n",
+         BENCH_LOOKUPS, n, (t_lookup * 1000000.0) / BENCH_LOOKUPS, hit);
+  pdidx_close(&idx);
+  return EXIT_SUCCESS;
+}
+
+int main (int argc, char **argv) {
+  double t0;
+  int    verbose = 0;
+  int    rc;
+
+  if (argc < 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (strcmp(argv[1], "build") == 0) {
+    argc -= 2;
+    argv += 2;
+    if ((argc != 0) && (strcmp(argv[0], "-v") == 0)) {
+      verbose = 1;
+      argc--;
+      argv++;
+    }
+    if (argc < 2) {
+      usage();
+      return EXIT_FAILURE;
+    }
+    t0 = util_time_ms();
+    rc = pdidx_build(argv[0], (const char * const *)&argv[1], (uint32_t)(argc - 1), verbose);
+    if ((rc == 0) && (verbose != 0)) {
+      printf("build time:  %.1f ms\n", util_time_ms() - t0);
+    }
+    return (rc == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (strcmp(argv[1], "show") == 0) {
+    return cmd_show(argc - 2, &argv[2]);
+  }
+  if (strcmp(argv[1], "list") == 0) {
+    return cmd_list(argc - 2, &argv[2]);
+  }
+  if (strcmp(argv[1], "bench") == 0) {
+    return cmd_bench(argc - 2, &argv[2]);
+  }
+  usage();
+  return EXIT_FAILURE;
+}
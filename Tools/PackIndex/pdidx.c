@@ -0,0 +1,208 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Pack device index (query interface)
+ * -------------------------------------------------------------------------- */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pdidx.h"
+#include "util.h"
+
+/* Check that table lies within the file */
+static int table_valid (const pdidx_header_t *hdr, uint32_t off, uint32_t num, size_t elem) {
+  return ((off & 7U) == 0U) && ((uint64_t)off + ((uint64_t)num * elem) <= hdr->file_size);
+}
+
+/* Check that list lies within its table */
+static int list_valid (pdidx_list_t list, uint32_t num) {
+  return ((uint64_t)list.first + list.num) <= num;
+}
+
+/**
+  Open index image in memory (validates the image, data is used in place).
+  \param[in]    data   index image (8-byte aligned)
+  \param[in]    size   image size in bytes
+  \param[out]   idx    opened index
+  \return       0 on success, or -1 on error.
+*/
+int pdidx_open_mem (const void *data, size_t size, pdidx_t *idx) {
+  const uint8_t        *base = data;
+  const pdidx_header_t *hdr  = data;
+  const pdidx_device_t *dev;
+  uint32_t              i;
+
+  memset(idx, 0, sizeof(*idx));
+  if ((size < sizeof(pdidx_header_t))                                                         ||
+      (hdr->magic != PDIDX_MAGIC) || (hdr->version != PDIDX_VERSION)                          ||
+      (hdr->file_size != size)                                                                ||
+      !table_valid(hdr, hdr->pack_off,      hdr->pack_num,      sizeof(pdidx_pack_t))          ||
+      !table_valid(hdr, hdr->device_off,    hdr->device_num,    sizeof(pdidx_device_t))        ||
+      !table_valid(hdr, hdr->processor_off, hdr->processor_num, sizeof(pdidx_processor_t))     ||
+      !table_valid(hdr, hdr->memory_off,    hdr->memory_num,    sizeof(pdidx_memory_t))        ||
+      !table_valid(hdr, hdr->algorithm_off, hdr->algorithm_num, sizeof(pdidx_algorithm_t))     ||
+      !table_valid(hdr, hdr->element_off,   hdr->element_num,   sizeof(pdidx_element_t))       ||
+      !table_valid(hdr, hdr->string_off,    hdr->string_size,   1U)                            ||
+      (hdr->string_size == 0U) || (base[hdr->string_off + hdr->string_size - 1U] != '\0')) {
+    return -1;
+  }
+
+  // Device lists are used without further checks
+  dev = (const pdidx_device_t *)(const void *)(base + hdr->device_off);
+  for (i = 0U; i < hdr->device_num; i++, dev++) {
+    if (!list_valid(dev->processor, hdr->processor_num) || !list_valid(dev->memory,  hdr->memory_num) ||
+        !list_valid(dev->algorithm, hdr->algorithm_num) || !list_valid(dev->element, hdr->element_num) ||
+        (dev->pack >= hdr->pack_num)) {
+      return -1;
+    }
+  }
+
+  idx->base      = base;
+  idx->size      = size;
+  idx->hdr       = hdr;
+  idx->pack      = (const pdidx_pack_t      *)(const void *)(base + hdr->pack_off);
+  idx->device    = (const pdidx_device_t    *)(const void *)(base + hdr->device_off);
+  idx->processor = (const pdidx_processor_t *)(const void *)(base + hdr->processor_off);
+  idx->memory    = (const pdidx_memory_t    *)(const void *)(base + hdr->memory_off);
+  idx->algorithm = (const pdidx_algorithm_t *)(const void *)(base + hdr->algorithm_off);
+  idx->element   = (const pdidx_element_t   *)(const void *)(base + hdr->element_off);
+  idx->string    = (const char              *)(const void *)(base + hdr->string_off);
+  return 0;
+}
+
+/**
+  Open index (memory-mapped, no parsing).
+  \param[in]    path   index file
+  \param[out]   idx    opened index
+  \return       0 on success, or -1 on error.
+*/
+int pdidx_open (const char *path, pdidx_t *idx) {
+  util_file_t file;
+
+  memset(idx, 0, sizeof(*idx));
+  if (util_file_map(path, &file) != 0) {
+    return -1;
+  }
+  if (pdidx_open_mem(file.data, file.size, idx) != 0) {
+    util_file_unmap(&file);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+  Close index.
+  \param[in]    idx    index
+*/
+void pdidx_close (pdidx_t *idx) {
+  util_file_t file;
+
+  if (idx->heap != NULL) {
+    free(idx->heap);
+  } else if (idx->base != NULL) {
+    file.data = (const char *)idx->base;
+    file.size = idx->size;
+    util_file_unmap(&file);
+  }
+  memset(idx, 0, sizeof(*idx));
+}
+
+/**
+  Find device or variant by name (binary search).
+  \param[in]    idx    index
+  \param[in]    name   Dname or Dvariant
+  \return       device, or NULL when not found
+*/
+const pdidx_device_t *pdidx_device (const pdidx_t *idx, const char *name) {
+  uint32_t lo = 0U;
+  uint32_t hi = idx->hdr->device_num;
+
+  while (lo < hi) {
+    uint32_t mid = lo + ((hi - lo) / 2U);
+    int cmp = strcmp(PDIDX_STR(idx, idx->device[mid].name), name);
+
+    if (cmp == 0) {
+      return &idx->device[mid];
+    }
+    if (cmp < 0) {
+      lo = mid + 1U;
+    } else {
+      hi = mid;
+    }
+  }
+  return NULL;
+}
+
+/* Check whether a record with Pname offset applies to processor pname (NULL = any) */
+static int pname_match (const pdidx_t *idx, uint32_t rec, const char *pname) {
+  return (pname == NULL) || (rec == 0U) || (strcmp(PDIDX_STR(idx, rec), pname) == 0);
+}
+
+/**
+  Find memory region containing an address.
+  \param[in]    idx    index
+  \param[in]    dev    device
+  \param[in]    pname  processor name (NULL = any processor)
+  \param[in]    addr   address
+  \return       memory region, or NULL when not found
+*/
+const pdidx_memory_t *pdidx_memory_at (const pdidx_t *idx, const pdidx_device_t *dev, const char *pname, uint32_t addr) {
+  const pdidx_memory_t *mem;
+  uint32_t i;
+
+  for (i = 0U; i < dev->memory.num; i++) {
+    mem = PDIDX_MEMORY(idx, dev, i);
+    if ((addr >= mem->start) && ((uint64_t)addr < ((uint64_t)mem->start + mem->size)) &&
+        pname_match(idx, mem->pname, pname)) {
+      return mem;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Find flash algorithm covering an address (default algorithms first).
+  \param[in]    idx    index
+  \param[in]    dev    device
+  \param[in]    pname  processor name (NULL = any processor)
+  \param[in]    addr   address
+  \return       algorithm, or NULL when not found
+*/
+const pdidx_algorithm_t *pdidx_algorithm_at (const pdidx_t *idx, const pdidx_device_t *dev, const char *pname, uint32_t addr) {
+  const pdidx_algorithm_t *algo, *found = NULL;
+  uint32_t i;
+
+  for (i = 0U; i < dev->algorithm.num; i++) {
+    algo = PDIDX_ALGORITHM(idx, dev, i);
+    if ((addr >= algo->start) && ((uint64_t)addr < ((uint64_t)algo->start + algo->size)) &&
+        pname_match(idx, algo->pname, pname)) {
+      if ((algo->flags & PDIDX_ALGO_DEFAULT) != 0U) {
+        return algo;
+      }
+      if (found == NULL) {
+        found = algo;
+      }
+    }
+  }
+  return found;
+}
@@ -0,0 +1,190 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Pack device index (file format and query interface)
+ * -------------------------------------------------------------------------- */
+
+#ifndef PDIDX_H
+#define PDIDX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* File format
+ *
+ * Like the SVD database, the index is a single little-endian file used in
+ * place after mmap(). Tables are 8-byte aligned and referenced by file
+ * offset from the header, strings by offset into the string table.
+ *
+ *   header
+ *   pack[]        pdsc files (path, size, content hash)
+ *   device[]      devices and variants, sorted by name
+ *   processor[]   processor lists (content-addressed)
+ *   memory[]      memory lists (content-addressed)
+ *   algorithm[]   algorithm lists (content-addressed)
+ *   element[]     sequence and debugvars lists (content-addressed)
+ *   string[]      unique NUL terminated strings
+ *
+ * Each device record holds the flattened result of the family, subFamily,
+ * device and variant levels, so no inheritance is evaluated at lookup
+ * time. Identical lists (for example the RAM map of all devices of a
+ * subFamily) are stored once. Sequence and debugvars content is not copied:
+ * the records hold the byte range of the element in the pdsc file.
+ */
+
+#define PDIDX_MAGIC             0x58494450U     // "PDIX"
+#define PDIDX_VERSION           1U
+
+/* Memory flags */
+#define PDIDX_MEM_DEFAULT       (1U << 0)       // default="1"
+#define PDIDX_MEM_STARTUP       (1U << 1)       // startup="1"
+#define PDIDX_MEM_INIT          (1U << 2)       // init="1"
+#define PDIDX_MEM_UNINIT        (1U << 3)       // uninit="1"
+
+/* Algorithm flags */
+#define PDIDX_ALGO_DEFAULT      (1U << 0)       // default="1"
+
+/* Element kinds */
+#define PDIDX_ELEM_SEQUENCE     0U              // <sequence>
+#define PDIDX_ELEM_DEBUGVARS    1U              // <debugvars>
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t file_size;
+  uint32_t reserved;
+  uint32_t pack_num,       pack_off;
+  uint32_t device_num,     device_off;
+  uint32_t processor_num,  processor_off;
+  uint32_t memory_num,     memory_off;
+  uint32_t algorithm_num,  algorithm_off;
+  uint32_t element_num,    element_off;
+  uint32_t string_size,    string_off;
+} pdidx_header_t;
+
+typedef struct {
+  uint32_t path;                        // pdsc file path
+  uint32_t size;                        // pdsc file size (staleness check)
+  uint64_t hash;                        // pdsc content hash (FNV-1a)
+} pdidx_pack_t;
+
+/* List reference */
+typedef struct {
+  uint32_t first;                       // First record
+  uint32_t num;                         // Number of records
+} pdidx_list_t;
+
+typedef struct {
+  uint32_t     name;                    // Dname or Dvariant
+  uint32_t     parent;                  // Dname of the device of a variant ("" for devices)
+  uint32_t     family;                  // Dfamily
+  uint32_t     sub_family;              // DsubFamily ("" if none)
+  uint32_t     vendor;                  // Dvendor
+  uint32_t     pack;                    // Pack index
+  pdidx_list_t processor;
+  pdidx_list_t memory;
+  pdidx_list_t algorithm;
+  pdidx_list_t element;
+} pdidx_device_t;
+
+typedef struct {
+  uint32_t pname;                       // Pname ("" for single core)
+  uint32_t core;                        // Dcore
+  uint32_t fpu;                         // Dfpu
+  uint32_t mpu;                         // Dmpu
+  uint32_t endian;                      // Dendian
+  uint32_t clock;                       // Dclock in Hz
+  uint32_t svd;                         // <debug svd> path
+  uint32_t ap;                          // <debug __ap>
+} pdidx_processor_t;
+
+typedef struct {
+  uint32_t name;                        // name (or legacy id)
+  uint32_t pname;                       // Pname ("" = all processors)
+  uint32_t access;                      // access attribute
+  uint32_t start;                       // Start address
+  uint32_t size;                        // Size in bytes
+  uint32_t flags;                       // PDIDX_MEM_x
+} pdidx_memory_t;
+
+typedef struct {
+  uint32_t name;                        // FLM path
+  uint32_t pname;                       // Pname ("" = all processors)
+  uint32_t start;                       // Flash start address
+  uint32_t size;                        // Flash size in bytes
+  uint32_t ram_start;                   // RAMstart (0 if not specified)
+  uint32_t ram_size;                    // RAMsize (0 if not specified)
+  uint32_t flags;                       // PDIDX_ALGO_x
+  uint32_t reserved;
+} pdidx_algorithm_t;
+
+typedef struct {
+  uint32_t kind;                        // PDIDX_ELEM_x
+  uint32_t name;                        // Sequence name, or dbgconf path of debugvars
+  uint32_t pname;                       // Pname ("" = all processors)
+  uint32_t version;                     // debugvars version ("" for sequences)
+  uint32_t offset;                      // Element offset in pdsc file
+  uint32_t length;                      // Element length in bytes
+} pdidx_element_t;
+
+/* Opened index */
+typedef struct {
+  const uint8_t            *base;       // Mapped file
+  size_t                    size;       // Mapped size
+  const pdidx_header_t     *hdr;
+  const pdidx_pack_t       *pack;
+  const pdidx_device_t     *device;
+  const pdidx_processor_t  *processor;
+  const pdidx_memory_t     *memory;
+  const pdidx_algorithm_t  *algorithm;
+  const pdidx_element_t    *element;
+  const char               *string;
+  void                     *heap;       // Image built by pdidx_load (NULL when mapped)
+} pdidx_t;
+
+extern int                      pdidx_open         (const char *path, pdidx_t *idx);
+extern int                      pdidx_open_mem     (const void *data, size_t size, pdidx_t *idx);
+extern void                     pdidx_close        (pdidx_t *idx);
+extern const pdidx_device_t    *pdidx_device       (const pdidx_t *idx, const char *name);
+extern const pdidx_memory_t    *pdidx_memory_at    (const pdidx_t *idx, const pdidx_device_t *dev, const char *pname, uint32_t addr);
+extern const pdidx_algorithm_t *pdidx_algorithm_at (const pdidx_t *idx, const pdidx_device_t *dev, const char *pname, uint32_t addr);
+
+/* Table access */
+#define PDIDX_STR(idx, offs)            (&(idx)->string[offs])
+#define PDIDX_PROCESSOR(idx, dev, i)    (&(idx)->processor[(dev)->processor.first + (i)])
+#define PDIDX_MEMORY(idx, dev, i)       (&(idx)->memory[(dev)->memory.first + (i)])
+#define PDIDX_ALGORITHM(idx, dev, i)    (&(idx)->algorithm[(dev)->algorithm.first + (i)])
+#define PDIDX_ELEMENT(idx, dev, i)      (&(idx)->element[(dev)->element.first + (i)])
+
+/* Builder (pdidx_build.c) */
+extern int                      pdidx_build        (const char *out, const char * const *pdsc, uint32_t pdsc_num, int verbose);
+extern int                      pdidx_load         (const char * const *pdsc, uint32_t pdsc_num, pdidx_t *idx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PDIDX_H */
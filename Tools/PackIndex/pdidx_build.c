@@ -0,0 +1,693 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Pack device index (builder)
+ * -------------------------------------------------------------------------- */
+
+/*
+ * The pdsc is tokenized once. Elements outside <devices> and the content of
+ * <sequence>, <debugvars> and <description> are skipped without tokenizing.
+ * Properties are collected per level (family, subFamily, device, variant);
+ * at the end of a device without variants, or of a variant, the levels are
+ * merged from family down:
+ *  - processor: attributes merged per Pname, <debug> adds svd and __ap
+ *  - memory:    accumulated, same name and Pname on a lower level replaces
+ *  - algorithm: accumulated, same name, Pname and start replaces
+ *  - sequence:  accumulated, same name and Pname replaces
+ *  - debugvars: same Pname replaces
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pdidx.h"
+#include "util.h"
+#include "xml.h"
+
+#define LEVEL_FAMILY    0U
+#define LEVEL_SUB       1U
+#define LEVEL_DEVICE    2U
+#define LEVEL_VARIANT   3U
+#define LEVEL_NUM       4U
+#define AP_UNSET        UINT32_MAX      // <debug> without __ap
+
+/* Properties defined on one level */
+typedef struct {
+  uint32_t              name;           // Dfamily, DsubFamily, Dname or Dvariant
+  uint32_t              vendor;         // Dvendor
+  uint32_t              depth;          // Element depth
+  int                   variants;       // Device has variants
+  util_vec_t            processor;      // pdidx_processor_t
+  util_vec_t            debug;          // pdidx_processor_t (pname, svd, ap)
+  util_vec_t            memory;         // pdidx_memory_t
+  util_vec_t            algorithm;      // pdidx_algorithm_t
+  util_vec_t            element;        // pdidx_element_t
+} level_t;
+
+/* Output table with content-addressed lists */
+typedef struct {
+  util_vec_t            rec;            // Records
+  util_vec_t            list;           // pdidx_list_t of stored lists
+  util_hindex_t         idx;            // Hash index of lists
+  uint32_t              total;          // Records referenced by devices (statistics)
+} table_t;
+
+/* Builder state */
+typedef struct {
+  util_vec_t            pack;           // pdidx_pack_t
+  util_vec_t            device;         // pdidx_device_t
+  table_t               processor;
+  table_t               memory;
+  table_t               algorithm;
+  table_t               element;
+  util_strpool_t        str;
+
+  // Current pdsc
+  const char           *path;
+  const char           *data;
+  xml_parser_t         *xml;
+  uint32_t              pack_idx;
+  uint32_t              depth;          // Element depth
+  uint32_t              devices_depth;  // Depth of <devices> (0 = outside)
+  int                   level;          // Current level (-1 = none)
+  level_t               lv[LEVEL_NUM];
+  util_vec_t            text;           // Unescape buffer
+  int                   error;
+} build_t;
+
+/* Dedup lookup context */
+typedef struct {
+  const table_t        *t;
+  const void           *data;
+  uint32_t              num;
+} dedup_key_t;
+
+/* Report problem at current document position */
+static void warn (build_t *b, const char *msg, xml_str_t what) {
+  fprintf(stderr, "%s:%u: warning: %s '%.*s'\n", b->path,
+          xml_line(b->data, (size_t)(b->xml->tag - b->data)), msg, (int)what.len, what.ptr);
+}
+
+/* Attribute as string pool offset (0 when missing) */
+static uint32_t attr_str (build_t *b, const xml_attr_t *attr, uint32_t num, const char *name) {
+  const xml_str_t *v = xml_attr_find(attr, num, name);
+  size_t len;
+
+  if ((v == NULL) || (v->len == 0U)) {
+    return 0U;
+  }
+  b->text.num = 0U;
+  util_vec_append(&b->text, NULL, v->len + 1U);
+  len = xml_unescape(b->text.data, *v);
+  return util_strpool_add(&b->str, b->text.data, len);
+}
+
+/* Numeric attribute (dflt when missing) */
+static uint32_t attr_num (build_t *b, const xml_attr_t *attr, uint32_t num, const char *name, uint32_t dflt) {
+  const xml_str_t *v = xml_attr_find(attr, num, name);
+  uint64_t val;
+
+  if (v == NULL) {
+    return dflt;
+  }
+  if ((util_parse_number(v->ptr, v->len, &val) != 0) || (val > UINT32_MAX)) {
+    warn(b, "invalid number", *v);
+    return dflt;
+  }
+  return (uint32_t)val;
+}
+
+/* Boolean attribute ("1" or "true") */
+static int attr_bool (const xml_attr_t *attr, uint32_t num, const char *name) {
+  const xml_str_t *v = xml_attr_find(attr, num, name);
+
+  return (v != NULL) && (xml_eq(*v, "1") || xml_eq(*v, "true"));
+}
+
+/* Dedup callback */
+static int list_eq (void *ctx, uint32_t index) {
+  const dedup_key_t  *key = (const dedup_key_t *)ctx;
+  const pdidx_list_t *l   = &UTIL_VEC_AT(&key->t->list, pdidx_list_t, index);
+
+  return (l->num == key->num) &&
+         (memcmp((const uint8_t *)key->t->rec.data + (l->first * key->t->rec.elem), key->data,
+                 key->num * key->t->rec.elem) == 0);
+}
+
+/* Store list of records (deduplicated) */
+static pdidx_list_t add_list (table_t *t, const util_vec_t *items) {
+  pdidx_list_t l = { 0U, 0U };
+  dedup_key_t  key;
+  uint64_t     hash;
+  uint32_t     idx;
+
+  t->total += (uint32_t)items->num;
+  if (items->num == 0U) {
+    return l;
+  }
+  key.t    = t;
+  key.data = items->data;
+  key.num  = (uint32_t)items->num;
+  hash = util_hash(items->data, items->num * items->elem);
+  idx  = util_hindex_find(&t->idx, hash, list_eq, &key);
+  if (idx == UINT32_MAX) {
+    idx = (uint32_t)t->list.num;
+    l.first = (uint32_t)t->rec.num;
+    l.num   = key.num;
+    *(pdidx_list_t *)util_vec_push(&t->list) = l;
+    util_vec_append(&t->rec, items->data, items->num);
+    util_hindex_add(&t->idx, hash, idx);
+  }
+  return UTIL_VEC_AT(&t->list, pdidx_list_t, idx);
+}
+
+static void table_init (table_t *t, size_t elem) {
+  util_vec_init(&t->rec,  elem);
+  util_vec_init(&t->list, sizeof(pdidx_list_t));
+  util_hindex_init(&t->idx);
+  t->total = 0U;
+}
+
+static void table_free (table_t *t) {
+  util_vec_free(&t->rec);
+  util_vec_free(&t->list);
+  util_hindex_free(&t->idx);
+}
+
+/* Clear properties of a level */
+static void level_clear (build_t *b, uint32_t level) {
+  level_t *lv = &b->lv[level];
+
+  lv->name          = 0U;
+  lv->vendor        = 0U;
+  lv->depth         = 0U;
+  lv->variants      = 0;
+  lv->processor.num = 0U;
+  lv->debug.num     = 0U;
+  lv->memory.num    = 0U;
+  lv->algorithm.num = 0U;
+  lv->element.num   = 0U;
+}
+
+/* Enter level element */
+static void level_enter (build_t *b, uint32_t level) {
+  uint32_t l;
+
+  for (l = level; l < LEVEL_NUM; l++) {
+    level_clear(b, l);
+  }
+  b->lv[level].depth = b->depth;
+  b->level = (int)level;
+}
+
+/* Merge processors of all levels into out, then apply <debug> */
+static void merge_processors (build_t *b, uint32_t last, util_vec_t *out) {
+  pdidx_processor_t *r, *p;
+  uint32_t l;
+  size_t   i, j;
+
+  for (l = 0U; l <= last; l++) {
+    for (i = 0U; i < b->lv[l].processor.num; i++) {
+      p = &UTIL_VEC_AT(&b->lv[l].processor, pdidx_processor_t, i);
+      for (j = 0U; j < out->num; j++) {
+        if (UTIL_VEC_AT(out, pdidx_processor_t, j).pname == p->pname) {
+          break;
+        }
+      }
+      if (j == out->num) {
+        r = util_vec_push(out);
+        r->pname = p->pname;
+        r->ap    = AP_UNSET;
+      }
+      r = &UTIL_VEC_AT(out, pdidx_processor_t, j);
+      if (p->core   != 0U) { r->core   = p->core;   }
+      if (p->fpu    != 0U) { r->fpu    = p->fpu;    }
+      if (p->mpu    != 0U) { r->mpu    = p->mpu;    }
+      if (p->endian != 0U) { r->endian = p->endian; }
+      if (p->clock  != 0U) { r->clock  = p->clock;  }
+    }
+  }
+  for (l = 0U; l <= last; l++) {
+    for (i = 0U; i < b->lv[l].debug.num; i++) {
+      p = &UTIL_VEC_AT(&b->lv[l].debug, pdidx_processor_t, i);
+      for (j = 0U; j < out->num; j++) {
+        r = &UTIL_VEC_AT(out, pdidx_processor_t, j);
+        if ((p->pname == 0U) || (p->pname == r->pname)) {
+          if (p->svd != 0U)      { r->svd = p->svd; }
+          if (p->ap != AP_UNSET) { r->ap  = p->ap;  }
+        }
+      }
+    }
+  }
+  for (j = 0U; j < out->num; j++) {
+    r = &UTIL_VEC_AT(out, pdidx_processor_t, j);
+    if (r->ap == AP_UNSET) {
+      r->ap = 0U;
+    }
+  }
+}
+
+/* Record identity (a record on a lower level replaces an inherited one with equal identity) */
+typedef int (*same_t) (const void *a, const void *b);
+
+static int memory_same (const void *a, const void *b) {
+  const pdidx_memory_t *x = a, *y = b;
+  return (x->name == y->name) && (x->pname == y->pname);
+}
+
+static int algorithm_same (const void *a, const void *b) {
+  const pdidx_algorithm_t *x = a, *y = b;
+  return (x->name == y->name) && (x->pname == y->pname) && (x->start == y->start);
+}
+
+static int element_same (const void *a, const void *b) {
+  const pdidx_element_t *x = a, *y = b;
+  return (x->kind == y->kind) && (x->pname == y->pname) &&
+         ((x->kind == PDIDX_ELEM_DEBUGVARS) || (x->name == y->name));
+}
+
+/* Accumulate records of all levels into out */
+static void merge_records (build_t *b, size_t offs, uint32_t last, same_t same, util_vec_t *out) {
+  const util_vec_t *src;
+  const uint8_t    *p;
+  uint32_t l;
+  size_t   i, j;
+
+  for (l = 0U; l <= last; l++) {
+    src = (const util_vec_t *)(const void *)((const uint8_t *)&b->lv[l] + offs);
+    for (i = 0U; i < src->num; i++) {
+      p = (const uint8_t *)src->data + (i * src->elem);
+      for (j = 0U; j < out->num; j++) {
+        if (same((uint8_t *)out->data + (j * out->elem), p) != 0) {
+          break;
+        }
+      }
+      if (j == out->num) {
+        util_vec_push(out);
+      }
+      memcpy((uint8_t *)out->data + (j * out->elem), p, out->elem);
+    }
+  }
+}
+
+/* Flatten levels into a device record */
+static void add_device (build_t *b, uint32_t last) {
+  pdidx_device_t *dev;
+  util_vec_t      tmp;
+
+  dev = util_vec_push(&b->device);
+  dev->name       = b->lv[last].name;
+  dev->parent     = (last == LEVEL_VARIANT) ? b->lv[LEVEL_DEVICE].name : 0U;
+  dev->family     = b->lv[LEVEL_FAMILY].name;
+  dev->sub_family = b->lv[LEVEL_SUB].name;
+  dev->vendor     = b->lv[LEVEL_FAMILY].vendor;
+  dev->pack       = b->pack_idx;
+
+  util_vec_init(&tmp, sizeof(pdidx_processor_t));
+  merge_processors(b, last, &tmp);
+  dev->processor = add_list(&b->processor, &tmp);
+  util_vec_free(&tmp);
+  util_vec_init(&tmp, sizeof(pdidx_memory_t));
+  merge_records(b, offsetof(level_t, memory), last, memory_same, &tmp);
+  dev->memory = add_list(&b->memory, &tmp);
+  util_vec_free(&tmp);
+  util_vec_init(&tmp, sizeof(pdidx_algorithm_t));
+  merge_records(b, offsetof(level_t, algorithm), last, algorithm_same, &tmp);
+  dev->algorithm = add_list(&b->algorithm, &tmp);
+  util_vec_free(&tmp);
+  util_vec_init(&tmp, sizeof(pdidx_element_t));
+  merge_records(b, offsetof(level_t, element), last, element_same, &tmp);
+  dev->element = add_list(&b->element, &tmp);
+  util_vec_free(&tmp);
+}
+
+/* Skip content of the current element (no end event), returns element length */
+static uint32_t skip (build_t *b, size_t start) {
+  if (xml_skip(b->xml) != XML_OK) {
+    b->error = 1;
+  }
+  return (uint32_t)((size_t)(b->xml->p - b->data) - start);
+}
+
+/* Start of element */
+static int on_start (void *ctx, xml_str_t name, const xml_attr_t *attr, uint32_t num) {
+  build_t *b = (build_t *)ctx;
+  level_t *lv;
+  size_t   start = (size_t)(b->xml->tag - b->data);
+  uint32_t rel;
+
+  b->depth++;
+  if (b->devices_depth == 0U) {
+    if (xml_eq(name, "devices") && (b->depth == 2U)) {
+      b->devices_depth = b->depth;
+    } else if (b->depth == 2U) {
+      // Other package content (components, conditions, ...) is not indexed
+      skip(b, start);
+      b->depth--;
+    }
+    return 0;
+  }
+
+  if      (xml_eq(name, "family"))    { level_enter(b, LEVEL_FAMILY);  }
+  else if (xml_eq(name, "subFamily")) { level_enter(b, LEVEL_SUB);     }
+  else if (xml_eq(name, "device"))    { level_enter(b, LEVEL_DEVICE);  }
+  else if (xml_eq(name, "variant"))   { level_enter(b, LEVEL_VARIANT); b->lv[LEVEL_DEVICE].variants = 1; }
+  else {
+    if (b->level < 0) {
+      return 0;
+    }
+    lv  = &b->lv[b->level];
+    rel = b->depth - lv->depth;
+    if ((rel == 1U) && xml_eq(name, "processor")) {
+      pdidx_processor_t *p = util_vec_push(&lv->processor);
+      p->pname  = attr_str(b, attr, num, "Pname");
+      p->core   = attr_str(b, attr, num, "Dcore");
+      p->fpu    = attr_str(b, attr, num, "Dfpu");
+      p->mpu    = attr_str(b, attr, num, "Dmpu");
+      p->endian = attr_str(b, attr, num, "Dendian");
+      p->clock  = attr_num(b, attr, num, "Dclock", 0U);
+    } else if ((rel == 1U) && xml_eq(name, "debug")) {
+      pdidx_processor_t *p = util_vec_push(&lv->debug);
+      p->pname = attr_str(b, attr, num, "Pname");
+      p->svd   = attr_str(b, attr, num, "svd");
+      p->ap    = attr_num(b, attr, num, "__ap", AP_UNSET);
+    } else if ((rel == 1U) && xml_eq(name, "memory")) {
+      pdidx_memory_t *m = util_vec_push(&lv->memory);
+      m->name   = attr_str(b, attr, num, "name");
+      if (m->name == 0U) {
+        m->name = attr_str(b, attr, num, "id");
+      }
+      m->pname  = attr_str(b, attr, num, "Pname");
+      m->access = attr_str(b, attr, num, "access");
+      m->start  = attr_num(b, attr, num, "start", 0U);
+      m->size   = attr_num(b, attr, num, "size",  0U);
+      m->flags  = (attr_bool(attr, num, "default") ? PDIDX_MEM_DEFAULT : 0U) |
+                  (attr_bool(attr, num, "startup") ? PDIDX_MEM_STARTUP : 0U) |
+                  (attr_bool(attr, num, "init")    ? PDIDX_MEM_INIT    : 0U) |
+                  (attr_bool(attr, num, "uninit")  ? PDIDX_MEM_UNINIT  : 0U);
+    } else if ((rel == 1U) && xml_eq(name, "algorithm")) {
+      pdidx_algorithm_t *a = util_vec_push(&lv->algorithm);
+      a->name      = attr_str(b, attr, num, "name");
+      a->pname     = attr_str(b, attr, num, "Pname");
+      a->start     = attr_num(b, attr, num, "start",    0U);
+      a->size      = attr_num(b, attr, num, "size",     0U);
+      a->ram_start = attr_num(b, attr, num, "RAMstart", 0U);
+      a->ram_size  = attr_num(b, attr, num, "RAMsize",  0U);
+      a->flags     = attr_bool(attr, num, "default") ? PDIDX_ALGO_DEFAULT : 0U;
+    } else if ((rel == 2U) && xml_eq(name, "sequence")) {
+      pdidx_element_t *e = util_vec_push(&lv->element);
+      e->kind   = PDIDX_ELEM_SEQUENCE;
+      e->name   = attr_str(b, attr, num, "name");
+      e->pname  = attr_str(b, attr, num, "Pname");
+      e->offset = (uint32_t)start;
+      e->length = skip(b, start);
+      b->depth--;
+    } else if ((rel == 1U) && xml_eq(name, "debugvars")) {
+      pdidx_element_t *e = util_vec_push(&lv->element);
+      e->kind    = PDIDX_ELEM_DEBUGVARS;
+      e->pname   = attr_str(b, attr, num, "Pname");
+      e->name    = attr_str(b, attr, num, "configfile");
+      e->version = attr_str(b, attr, num, "version");
+      e->offset  = (uint32_t)start;
+      e->length  = skip(b, start);
+      b->depth--;
+    } else if (xml_eq(name, "description") || xml_eq(name, "book") || xml_eq(name, "feature")) {
+      skip(b, start);
+      b->depth--;
+    }
+    return 0;
+  }
+
+  // Level element attributes
+  lv = &b->lv[b->level];
+  switch (b->level) {
+    case LEVEL_FAMILY:
+      lv->name   = attr_str(b, attr, num, "Dfamily");
+      lv->vendor = attr_str(b, attr, num, "Dvendor");
+      break;
+    case LEVEL_SUB:
+      lv->name   = attr_str(b, attr, num, "DsubFamily");
+      break;
+    case LEVEL_DEVICE:
+      lv->name   = attr_str(b, attr, num, "Dname");
+      break;
+    default:
+      lv->name   = attr_str(b, attr, num, "Dvariant");
+      break;
+  }
+  if (lv->name == 0U) {
+    warn(b, "missing name attribute of", name);
+  }
+  return 0;
+}
+
+/* End of element */
+static int on_end (void *ctx, xml_str_t name) {
+  build_t *b = (build_t *)ctx;
+
+  if ((b->devices_depth != 0U) && (b->level >= 0) && (b->depth == b->lv[b->level].depth)) {
+    if (xml_eq(name, "variant")) {
+      add_device(b, LEVEL_VARIANT);
+      level_clear(b, LEVEL_VARIANT);
+      b->level = (int)LEVEL_DEVICE;
+    } else if (xml_eq(name, "device")) {
+      if (b->lv[LEVEL_DEVICE].variants == 0) {
+        add_device(b, LEVEL_DEVICE);
+      }
+      level_clear(b, LEVEL_DEVICE);
+      // Devices may be placed directly in a family
+      b->level = (b->lv[LEVEL_SUB].depth != 0U) ? (int)LEVEL_SUB : (int)LEVEL_FAMILY;
+    } else if (xml_eq(name, "subFamily")) {
+      level_clear(b, LEVEL_SUB);
+      b->level = (int)LEVEL_FAMILY;
+    } else {
+      level_clear(b, LEVEL_FAMILY);
+      b->level = -1;
+    }
+  }
+  if (b->depth == b->devices_depth) {
+    b->devices_depth = 0U;
+  }
+  b->depth--;
+  return 0;
+}
+
+/* Index one pdsc file */
+static int parse_file (build_t *b, const char *path) {
+  static const xml_handler_t handler = { on_start, on_end, NULL };
+  xml_parser_t  xml;
+  util_file_t   file;
+  pdidx_pack_t *pack;
+  uint32_t      first = (uint32_t)b->device.num;
+  int           rc;
+
+  if (util_file_map(path, &file) != 0) {
+    fprintf(stderr, "%s: error: cannot open file\n", path);
+    return -1;
+  }
+  b->path          = path;
+  b->data          = file.data;
+  b->xml           = &xml;
+  b->pack_idx      = (uint32_t)b->pack.num;
+  b->depth         = 0U;
+  b->devices_depth = 0U;
+  b->level         = -1;
+  b->error         = 0;
+
+  pack = util_vec_push(&b->pack);
+  pack->path = util_strpool_add(&b->str, path, strlen(path));
+  pack->size = (uint32_t)file.size;
+  pack->hash = util_hash(file.data, file.size);
+
+  xml_init(&xml, file.data, file.size);
+  rc = xml_run(&xml, &handler, b);
+  if ((rc != XML_OK) || (b->error != 0)) {
+    fprintf(stderr, "%s:%u: error: malformed XML\n", path, xml_line(file.data, (size_t)(xml.p - file.data)));
+    util_file_unmap(&file);
+    return -1;
+  }
+  util_file_unmap(&file);
+  if (b->device.num == first) {
+    fprintf(stderr, "%s: warning: no devices\n", path);
+  }
+  return 0;
+}
+
+/* Device sort (qsort has no context, string table is set before sorting) */
+static const char *sort_str;
+
+static int cmp_device (const void *a, const void *b) {
+  return strcmp(&sort_str[((const pdidx_device_t *)a)->name], &sort_str[((const pdidx_device_t *)b)->name]);
+}
+
+/* Append table to output image (8-byte aligned), returns table offset */
+static uint32_t emit (util_vec_t *out, const void *data, size_t size) {
+  uint32_t offs;
+
+  while ((out->num & 7U) != 0U) {
+    util_vec_push(out);
+  }
+  offs = (uint32_t)out->num;
+  if (size != 0U) {
+    util_vec_append(out, data, size);
+  }
+  return offs;
+}
+
+/* Build index image (img == NULL: parse only) */
+static int build (util_vec_t *img, const char * const *pdsc, uint32_t pdsc_num, int verbose) {
+  pdidx_header_t hdr;
+  build_t        b;
+  uint32_t       i;
+  int            err = 0;
+
+  memset(&b, 0, sizeof(b));
+  util_vec_init(&b.pack,   sizeof(pdidx_pack_t));
+  util_vec_init(&b.device, sizeof(pdidx_device_t));
+  table_init(&b.processor, sizeof(pdidx_processor_t));
+  table_init(&b.memory,    sizeof(pdidx_memory_t));
+  table_init(&b.algorithm, sizeof(pdidx_algorithm_t));
+  table_init(&b.element,   sizeof(pdidx_element_t));
+  util_strpool_init(&b.str);
+  util_vec_init(&b.text, 1U);
+  for (i = 0U; i < LEVEL_NUM; i++) {
+    util_vec_init(&b.lv[i].processor, sizeof(pdidx_processor_t));
+    util_vec_init(&b.lv[i].debug,     sizeof(pdidx_processor_t));
+    util_vec_init(&b.lv[i].memory,    sizeof(pdidx_memory_t));
+    util_vec_init(&b.lv[i].algorithm, sizeof(pdidx_algorithm_t));
+    util_vec_init(&b.lv[i].element,   sizeof(pdidx_element_t));
+  }
+
+  for (i = 0U; (i < pdsc_num) && (err == 0); i++) {
+    err = parse_file(&b, pdsc[i]);
+  }
+
+  if (err == 0) {
+    // Device table sorted by name for binary search
+    sort_str = (const char *)b.str.buf.data;
+    qsort(b.device.data, b.device.num, sizeof(pdidx_device_t), cmp_device);
+    for (i = 1U; i < b.device.num; i++) {
+      if (cmp_device(&UTIL_VEC_AT(&b.device, pdidx_device_t, i - 1U), &UTIL_VEC_AT(&b.device, pdidx_device_t, i)) == 0) {
+        fprintf(stderr, "error: duplicate device '%s'\n", &sort_str[UTIL_VEC_AT(&b.device, pdidx_device_t, i).name]);
+        err = -1;
+      }
+    }
+  }
+
+  if ((err == 0) && (img != NULL)) {
+    memset(&hdr, 0, sizeof(hdr));
+    util_vec_append(img, NULL, sizeof(hdr));
+    hdr.magic         = PDIDX_MAGIC;
+    hdr.version       = PDIDX_VERSION;
+    hdr.pack_num      = (uint32_t)b.pack.num;
+    hdr.pack_off      = emit(img, b.pack.data,          b.pack.num          * sizeof(pdidx_pack_t));
+    hdr.device_num    = (uint32_t)b.device.num;
+    hdr.device_off    = emit(img, b.device.data,        b.device.num        * sizeof(pdidx_device_t));
+    hdr.processor_num = (uint32_t)b.processor.rec.num;
+    hdr.processor_off = emit(img, b.processor.rec.data, b.processor.rec.num * sizeof(pdidx_processor_t));
+    hdr.memory_num    = (uint32_t)b.memory.rec.num;
+    hdr.memory_off    = emit(img, b.memory.rec.data,    b.memory.rec.num    * sizeof(pdidx_memory_t));
+    hdr.algorithm_num = (uint32_t)b.algorithm.rec.num;
+    hdr.algorithm_off = emit(img, b.algorithm.rec.data, b.algorithm.rec.num * sizeof(pdidx_algorithm_t));
+    hdr.element_num   = (uint32_t)b.element.rec.num;
+    hdr.element_off   = emit(img, b.element.rec.data,   b.element.rec.num   * sizeof(pdidx_element_t));
+    hdr.string_size   = (uint32_t)b.str.buf.num;
+    hdr.string_off    = emit(img, b.str.buf.data,       b.str.buf.num);
+    emit(img, NULL, 0U);
+    hdr.file_size     = (uint32_t)img->num;
+    memcpy(img->data, &hdr, sizeof(hdr));
+
+    if (verbose != 0) {
+      printf("packs:       %u\n", hdr.pack_num);
+      printf("devices:     %u\n", hdr.device_num);
+      printf("processors:  %u total, %u stored\n", b.processor.total, hdr.processor_num);
+      printf("memories:    %u total, %u stored\n", b.memory.total,    hdr.memory_num);
+      printf("algorithms:  %u total, %u stored\n", b.algorithm.total, hdr.algorithm_num);
+      printf("elements:    %u total, %u stored\n", b.element.total,   hdr.element_num);
+      printf("strings:     %u bytes\n", hdr.string_size);
+      printf("index:       %u bytes\n", hdr.file_size);
+    }
+  }
+
+  for (i = 0U; i < LEVEL_NUM; i++) {
+    util_vec_free(&b.lv[i].processor);
+    util_vec_free(&b.lv[i].debug);
+    util_vec_free(&b.lv[i].memory);
+    util_vec_free(&b.lv[i].algorithm);
+    util_vec_free(&b.lv[i].element);
+  }
+  util_vec_free(&b.pack);
+  util_vec_free(&b.device);
+  table_free(&b.processor);
+  table_free(&b.memory);
+  table_free(&b.algorithm);
+  table_free(&b.element);
+  util_strpool_free(&b.str);
+  util_vec_free(&b.text);
+  return err;
+}
+
+/**
+  Build device index from pdsc files.
+  \param[in]    out       index file (NULL = parse only, used for benchmarks)
+  \param[in]    pdsc      pdsc file paths
+  \param[in]    pdsc_num  number of pdsc files
+  \param[in]    verbose   print statistics
+  \return       0 on success, or -1 on error.
+*/
+int pdidx_build (const char *out, const char * const *pdsc, uint32_t pdsc_num, int verbose) {
+  util_vec_t img;
+  int        err;
+
+  if (out == NULL) {
+    return build(NULL, pdsc, pdsc_num, verbose);
+  }
+  util_vec_init(&img, 1U);
+  err = build(&img, pdsc, pdsc_num, verbose);
+  if ((err == 0) && (util_file_write(out, img.data, img.num) != 0)) {
+    fprintf(stderr, "%s: error: cannot write file\n", out);
+    err = -1;
+  }
+  util_vec_free(&img);
+  return err;
+}
+
+/**
+  Build device index from pdsc files in memory (no index file).
+  \param[in]    pdsc      pdsc file paths
+  \param[in]    pdsc_num  number of pdsc files
+  \param[out]   idx       opened index, release with pdidx_close
+  \return       0 on success, or -1 on error.
+*/
+int pdidx_load (const char * const *pdsc, uint32_t pdsc_num, pdidx_t *idx) {
+  util_vec_t img;
+
+  memset(idx, 0, sizeof(*idx));
+  util_vec_init(&img, 1U);
+  if ((build(&img, pdsc, pdsc_num, 0) != 0) || (pdidx_open_mem(img.data, img.num, idx) != 0)) {
+    util_vec_free(&img);
+    return -1;
+  }
+  idx->heap = img.data;
+  return 0;
+}
@@ -0,0 +1,235 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      svddb command line tool
+ * -------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "svddb.h"
+#include "util.h"
+
+#define BENCH_LOOKUPS   1000000U        // Lookups per benchmark run
+
+static const char * const access_name[] = { "", "RO", "WO", "RW", "W1", "RW1" };
+
+static void usage (void) {
+  fprintf(stderr,
+    "usage: svddb build [-v] <database> <svd>...\n"
+    "       svddb lookup <database> <device> <address>...\n"
+    "       svddb list <database> [<device>]\n"
+    "       svddb bench <database> <device>\n");
+}
+
+/* Print lookup result */
+static void print_result (const svddb_t *db, uint32_t addr, int rc, const svddb_result_t *res) {
+  uint32_t i;
+
+  if (rc < 0) {
+    printf("0x%08X: -\n", addr);
+    return;
+  }
+  if (rc > 0) {
+    printf("0x%08X: %s+0x%X\n", addr, SVDDB_STR(db, res->instance->name), addr - res->instance->base);
+    return;
+  }
+  printf("0x%08X: %s.%s (%s, reset 0x%08X) %s\n", addr,
+         SVDDB_STR(db, res->instance->name), SVDDB_STR(db, res->reg->name),
+         access_name[res->reg->access], res->reg->reset_value, SVDDB_STR(db, res->reg->description));
+  for (i = 0U; i < res->field_num; i++) {
+    const svddb_field_t *f = &res->field[i];
+    char bits[16];
+    if (f->width == 1U) {
+      snprintf(bits, sizeof(bits), "[%u]", f->lsb);
+    } else {
+      snprintf(bits, sizeof(bits), "[%u:%u]", f->lsb + f->width - 1U, f->lsb);
+    }
+    printf("  %-7s %-16s %-3s %s\n", bits, SVDDB_STR(db, f->name), access_name[f->access], SVDDB_STR(db, f->description));
+  }
+}
+
+/* Open database and device, report errors */
+static const svddb_device_t *open_device (svddb_t *db, const char *path, const char *device) {
+  const svddb_device_t *dev;
+
+  if (svddb_open(path, db) != 0) {
+    fprintf(stderr, "%s: error: cannot open database\n", path);
+    return NULL;
+  }
+  dev = svddb_device(db, device);
+  if (dev == NULL) {
+    fprintf(stderr, "%s: error: device '%s' not found\n", path, device);
+  }
+  return dev;
+}
+
+static int cmd_lookup (int argc, char **argv) {
+  const svddb_device_t *dev;
+  svddb_result_t res;
+  svddb_t db;
+  int i, rc;
+
+  if (argc < 3) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  dev = open_device(&db, argv[0], argv[1]);
+  if (dev != NULL) {
+    for (i = 2; i < argc; i++) {
+      uint32_t addr = (uint32_t)strtoul(argv[i], NULL, 0);
+      rc = svddb_lookup(&db, dev, addr, &res);
+      print_result(&db, addr, rc, &res);
+    }
+  }
+  svddb_close(&db);
+  return (dev != NULL) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int cmd_list (int argc, char **argv) {
+  const svddb_device_t *dev;
+  svddb_t  db;
+  uint32_t i;
+
+  if (argc < 1) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (argc == 1) {
+    if (svddb_open(argv[0], &db) != 0) {
+      fprintf(stderr, "%s: error: cannot open database\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+    for (i = 0U; i < db.hdr->device_num; i++) {
+      printf("%-16s %4u peripherals\n", SVDDB_STR(&db, db.device[i].name), db.device[i].instance_num);
+    }
+    svddb_close(&db);
+    return EXIT_SUCCESS;
+  }
+  dev = open_device(&db, argv[0], argv[1]);
+  if (dev != NULL) {
+    for (i = 0U; i < dev->instance_num; i++) {
+      const svddb_instance_t *inst = &db.instance[dev->instance_first + i];
+      printf("0x%08X %8X %-16s %u registers\n", inst->base, inst->size, SVDDB_STR(&db, inst->name),
+             db.peripheral[inst->peripheral].regref_num);
+    }
+  }
+  svddb_close(&db);
+  return (dev != NULL) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Time open and lookups over all register addresses of a device */
+static int cmd_bench (int argc, char **argv) {
+  const svddb_device_t *dev;
+  svddb_result_t res;
+  svddb_t  db;
+  uint32_t *addr;
+  uint32_t i, j, n = 0U, hit = 0U;
+  double   t0, t_open, t_lookup;
+
+  if (argc < 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  t0  = util_time_ms();
+  dev = open_device(&db, argv[0], argv[1]);
+  t_open = util_time_ms() - t0;
+  if (dev == NULL) {
+    svddb_close(&db);
+    return EXIT_FAILURE;
+  }
+
+  // Collect all register addresses of the device
+  for (i = 0U; i < dev->instance_num; i++) {
+    n += db.peripheral[db.instance[dev->instance_first + i].peripheral].regref_num;
+  }
+  addr = malloc(((size_t)n + 1U) * sizeof(uint32_t));
+  if (addr == NULL) {
+    svddb_close(&db);
+    return EXIT_FAILURE;
+  }
+  n = 0U;
+  for (i = 0U; i < dev->instance_num; i++) {
+    const svddb_instance_t   *inst = &db.instance[dev->instance_first + i];
+    const svddb_peripheral_t *per  = &db.peripheral[inst->peripheral];
+    for (j = 0U; j < per->regref_num; j++) {
+      addr[n++] = inst->base + db.reg[db.regref[per->regref_first + j]].offset;
+    }
+  }
+
+  t0 = util_time_ms();
+  for (i = 0U; i < BENCH_LOOKUPS; i++) {
+    if (svddb_lookup(&db, dev, addr[(i * 7919U) % n], &res) == 0) {
+      hit++;
+    }
+  }
+  t_lookup = util_time_ms() - t0;
+
+  printf("open:    %.3f ms\n", t_open);
+  printf("lookup:  %u lookups over %u registers, %.1f ns/lookup, %u hits\n",
+         BENCH_LOOKUPS, n, (t_lookup * 1000000.0) / BENCH_LOOKUPS, hit);
+  free(addr);
+  svddb_close(&db);
+  return EXIT_SUCCESS;
+}
+
+int main (int argc, char **argv) {
+  double t0;
+  int    verbose = 0;
+  int    rc;
+
+  if (argc < 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (strcmp(argv[1], "build") == 0) {
+    argc -= 2;
+    argv += 2;
+    if ((argc != 0) && (strcmp(argv[0], "-v") == 0)) {
+      verbose = 1;
+      argc--;
+      argv++;
+    }
+    if (argc < 2) {
+      usage();
+      return EXIT_FAILURE;
+    }
+    t0 = util_time_ms();
+    rc = svddb_build(argv[0], (const char * const *)&argv[1], (uint32_t)(argc - 1), verbose);
+    if ((rc == 0) && (verbose != 0)) {
+      printf("build time:  %.1f ms\n", util_time_ms() - t0);
+    }
+    return (rc == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (strcmp(argv[1], "lookup") == 0) {
+    return cmd_lookup(argc - 2, &argv[2]);
+  }
+  if (strcmp(argv[1], "list") == 0) {
+    return cmd_list(argc - 2, &argv[2]);
+  }
+  if (strcmp(argv[1], "bench") == 0) {
+    return cmd_bench(argc - 2, &argv[2]);
+  }
+  usage();
+  return EXIT_FAILURE;
+}
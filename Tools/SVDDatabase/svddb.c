@@ -0,0 +1,206 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Binary SVD database (query interface)
+ * -------------------------------------------------------------------------- */
+
+#include <string.h>
+
+#include "svddb.h"
+#include "util.h"
+
+#define OVERLAP_MAX     4U              // Preceding instances checked for overlapping blocks
+
+/* Check that table lies within the file */
+static int table_valid (const svddb_header_t *hdr, uint32_t off, uint32_t num, size_t elem) {
+  return ((off & 7U) == 0U) && ((uint64_t)off + ((uint64_t)num * elem) <= hdr->file_size);
+}
+
+/**
+  Open database (memory-mapped, no parsing).
+  \param[in]    path   database file
+  \param[out]   db     opened database
+  \return       0 on success, or -1 on error.
+*/
+int svddb_open (const char *path, svddb_t *db) {
+  const svddb_header_t *hdr;
+  util_file_t file;
+
+  memset(db, 0, sizeof(*db));
+  if (util_file_map(path, &file) != 0) {
+    return -1;
+  }
+  hdr = (const svddb_header_t *)(const void *)file.data;
+  if ((file.size < sizeof(svddb_header_t))                                                   ||
+      (hdr->magic != SVDDB_MAGIC) || (hdr->version != SVDDB_VERSION)                         ||
+      (hdr->file_size != file.size)                                                          ||
+      !table_valid(hdr, hdr->device_off,     hdr->device_num,     sizeof(svddb_device_t))     ||
+      !table_valid(hdr, hdr->instance_off,   hdr->instance_num,   sizeof(svddb_instance_t))   ||
+      !table_valid(hdr, hdr->peripheral_off, hdr->peripheral_num, sizeof(svddb_peripheral_t)) ||
+      !table_valid(hdr, hdr->regref_off,     hdr->regref_num,     sizeof(uint32_t))           ||
+      !table_valid(hdr, hdr->register_off,   hdr->register_num,   sizeof(svddb_register_t))   ||
+      !table_valid(hdr, hdr->field_off,      hdr->field_num,      sizeof(svddb_field_t))      ||
+      !table_valid(hdr, hdr->string_off,     hdr->string_size,    1U)                         ||
+      (hdr->string_size == 0U) || (file.data[hdr->string_off + hdr->string_size - 1U] != '\0')) {
+    util_file_unmap(&file);
+    return -1;
+  }
+
+  db->base       = (const uint8_t *)file.data;
+  db->size       = file.size;
+  db->hdr        = hdr;
+  db->device     = (const svddb_device_t     *)(const void *)(db->base + hdr->device_off);
+  db->instance   = (const svddb_instance_t   *)(const void *)(db->base + hdr->instance_off);
+  db->peripheral = (const svddb_peripheral_t *)(const void *)(db->base + hdr->peripheral_off);
+  db->regref     = (const uint32_t           *)(const void *)(db->base + hdr->regref_off);
+  db->reg        = (const svddb_register_t   *)(const void *)(db->base + hdr->register_off);
+  db->field      = (const svddb_field_t      *)(const void *)(db->base + hdr->field_off);
+  db->string     = (const char               *)(const void *)(db->base + hdr->string_off);
+  return 0;
+}
+
+/**
+  Close database.
+  \param[in]    db     database
+*/
+void svddb_close (svddb_t *db) {
+  util_file_t file;
+
+  if (db->base != NULL) {
+    file.data = (const char *)db->base;
+    file.size = db->size;
+    util_file_unmap(&file);
+  }
+  memset(db, 0, sizeof(*db));
+}
+
+/**
+  Find device by name (binary search).
+  \param[in]    db     database
+  \param[in]    name   device name as in SVD <device><name>
+  \return       device, or NULL when not found
+*/
+const svddb_device_t *svddb_device (const svddb_t *db, const char *name) {
+  uint32_t lo = 0U;
+  uint32_t hi = db->hdr->device_num;
+
+  while (lo < hi) {
+    uint32_t mid = lo + ((hi - lo) / 2U);
+    int cmp = strcmp(SVDDB_STR(db, db->device[mid].name), name);
+
+    if (cmp == 0) {
+      return &db->device[mid];
+    }
+    if (cmp < 0) {
+      lo = mid + 1U;
+    } else {
+      hi = mid;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Find peripheral instance by name.
+  \param[in]    db     database
+  \param[in]    dev    device
+  \param[in]    name   peripheral name
+  \return       peripheral instance, or NULL when not found
+*/
+const svddb_instance_t *svddb_peripheral (const svddb_t *db, const svddb_device_t *dev, const char *name) {
+  uint32_t i;
+
+  for (i = 0U; i < dev->instance_num; i++) {
+    const svddb_instance_t *inst = &db->instance[dev->instance_first + i];
+    if (strcmp(SVDDB_STR(db, inst->name), name) == 0) {
+      return inst;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Look up peripheral, register and fields for an address.
+  Both the peripheral instance table and the register table are sorted by
+  address, so the lookup is two binary searches.
+  \param[in]    db      database
+  \param[in]    dev     device
+  \param[in]    addr    address
+  \param[out]   result  lookup result
+  \return       0 when a register matches, 1 when only the peripheral matches, or -1 when nothing matches.
+*/
+int svddb_lookup (const svddb_t *db, const svddb_device_t *dev, uint32_t addr, svddb_result_t *result) {
+  const svddb_instance_t   *inst = &db->instance[dev->instance_first];
+  const svddb_peripheral_t *per;
+  const svddb_register_t   *reg;
+  uint32_t lo, hi, mid, i, offs;
+
+  memset(result, 0, sizeof(*result));
+
+  // Last instance with base <= addr
+  lo = 0U;
+  hi = dev->instance_num;
+  while (lo < hi) {
+    mid = lo + ((hi - lo) / 2U);
+    if (inst[mid].base <= addr) {
+      lo = mid + 1U;
+    } else {
+      hi = mid;
+    }
+  }
+  // Candidate may be preceded by a larger, overlapping address block
+  for (i = lo; (i != 0U) && ((lo - i) < OVERLAP_MAX); i--) {
+    if ((addr - inst[i - 1U].base) < inst[i - 1U].size) {
+      break;
+    }
+  }
+  if ((i == 0U) || ((lo - i) == OVERLAP_MAX)) {
+    return -1;
+  }
+  inst = &inst[i - 1U];
+  result->instance = inst;
+
+  // Last register with offset <= addr - base
+  per  = &db->peripheral[inst->peripheral];
+  offs = addr - inst->base;
+  lo = 0U;
+  hi = per->regref_num;
+  while (lo < hi) {
+    mid = lo + ((hi - lo) / 2U);
+    if (db->reg[db->regref[per->regref_first + mid]].offset <= offs) {
+      lo = mid + 1U;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == 0U) {
+    return 1;
+  }
+  reg = &db->reg[db->regref[per->regref_first + lo - 1U]];
+  if ((offs - reg->offset) >= ((uint32_t)reg->size / 8U)) {
+    return 1;
+  }
+  result->reg       = reg;
+  result->field     = &db->field[reg->field_first];
+  result->field_num = reg->field_num;
+  return 0;
+}
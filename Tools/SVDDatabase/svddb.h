@@ -0,0 +1,161 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Binary SVD database (file format and query interface)
+ * -------------------------------------------------------------------------- */
+
+#ifndef SVDDB_H
+#define SVDDB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* File format
+ *
+ * The database is a single little-endian file that is used in place after
+ * mmap(). All tables are 8-byte aligned and referenced by file offset from
+ * the header. Strings are referenced by offset into the string table.
+ *
+ *   header
+ *   device[]      sorted by name
+ *   instance[]    per device, sorted by base address
+ *   peripheral[]  unique register maps (content-addressed)
+ *   regref[]      register indices per peripheral, sorted by address offset
+ *   register[]    unique registers (content-addressed)
+ *   field[]       unique field lists (content-addressed), sorted by LSB
+ *   string[]      unique NUL terminated strings
+ *
+ * Peripheral instances that share a register map (derivedFrom, or identical
+ * content in another device) reference the same peripheral record; equal
+ * registers and field lists are stored once across all devices.
+ */
+
+#define SVDDB_MAGIC             0x42445653U     // "SVDB"
+#define SVDDB_VERSION           1U
+
+/* Access rights (SVD access) */
+#define SVDDB_ACCESS_UNDEF      0U
+#define SVDDB_ACCESS_RO         1U              // read-only
+#define SVDDB_ACCESS_WO         2U              // write-only
+#define SVDDB_ACCESS_RW         3U              // read-write
+#define SVDDB_ACCESS_WONCE      4U              // writeOnce
+#define SVDDB_ACCESS_RWONCE     5U              // read-writeOnce
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t file_size;
+  uint32_t reserved;
+  uint32_t device_num,     device_off;
+  uint32_t instance_num,   instance_off;
+  uint32_t peripheral_num, peripheral_off;
+  uint32_t regref_num,     regref_off;
+  uint32_t register_num,   register_off;
+  uint32_t field_num,      field_off;
+  uint32_t string_size,    string_off;
+} svddb_header_t;
+
+typedef struct {
+  uint32_t name;                        // Device name
+  uint32_t instance_first;              // First peripheral instance
+  uint32_t instance_num;                // Number of peripheral instances
+  uint32_t reserved;
+} svddb_device_t;
+
+typedef struct {
+  uint32_t name;                        // Peripheral instance name
+  uint32_t description;                 // Description
+  uint32_t base;                        // Base address
+  uint32_t size;                        // Address block size in bytes
+  uint32_t peripheral;                  // Register map
+  uint32_t reserved;
+} svddb_instance_t;
+
+typedef struct {
+  uint32_t regref_first;                // First register reference
+  uint32_t regref_num;                  // Number of registers
+} svddb_peripheral_t;
+
+typedef struct {
+  uint32_t name;                        // Register name
+  uint32_t description;                 // Description
+  uint32_t offset;                      // Address offset within peripheral
+  uint32_t reset_value;                 // Reset value
+  uint32_t reset_mask;                  // Reset mask
+  uint32_t field_first;                 // First field
+  uint16_t field_num;                   // Number of fields
+  uint8_t  size;                        // Size in bits
+  uint8_t  access;                      // SVDDB_ACCESS_x
+} svddb_register_t;
+
+typedef struct {
+  uint32_t name;                        // Field name
+  uint32_t description;                 // Description
+  uint8_t  lsb;                         // Least significant bit
+  uint8_t  width;                       // Width in bits
+  uint8_t  access;                      // SVDDB_ACCESS_x
+  uint8_t  reserved;
+} svddb_field_t;
+
+/* Opened database */
+typedef struct {
+  const uint8_t            *base;       // Mapped file
+  size_t                    size;       // Mapped size
+  const svddb_header_t     *hdr;
+  const svddb_device_t     *device;
+  const svddb_instance_t   *instance;
+  const svddb_peripheral_t *peripheral;
+  const uint32_t           *regref;
+  const svddb_register_t   *reg;
+  const svddb_field_t      *field;
+  const char               *string;
+} svddb_t;
+
+/* Address lookup result */
+typedef struct {
+  const svddb_instance_t   *instance;   // Peripheral instance (NULL if none)
+  const svddb_register_t   *reg;        // Register (NULL if none)
+  const svddb_field_t      *field;      // Register fields
+  uint32_t                  field_num;  // Number of register fields
+} svddb_result_t;
+
+extern int                     svddb_open       (const char *path, svddb_t *db);
+extern void                    svddb_close      (svddb_t *db);
+extern const svddb_device_t   *svddb_device     (const svddb_t *db, const char *name);
+extern int                     svddb_lookup     (const svddb_t *db, const svddb_device_t *dev, uint32_t addr, svddb_result_t *result);
+extern const svddb_instance_t *svddb_peripheral (const svddb_t *db, const svddb_device_t *dev, const char *name);
+
+/* String table access */
+#define SVDDB_STR(db, offs)     (&(db)->string[offs])
+
+/* Builder (svddb_build.c) */
+extern int                     svddb_build      (const char *out, const char * const *svd, uint32_t svd_num, int verbose);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVDDB_H */
@@ -0,0 +1,437 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Binary SVD database (builder)
+ * -------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "svd.h"
+#include "svddb.h"
+#include "util.h"
+
+/* Field list (deduplication key) */
+typedef struct {
+  uint32_t              first;
+  uint32_t              num;
+} range_t;
+
+/* Builder state */
+typedef struct {
+  // Output tables
+  util_vec_t            device;         // svddb_device_t
+  util_vec_t            instance;       // svddb_instance_t
+  util_vec_t            peripheral;     // svddb_peripheral_t
+  util_vec_t            regref;         // uint32_t
+  util_vec_t            reg;            // svddb_register_t
+  util_vec_t            field;          // svddb_field_t
+  util_vec_t            field_list;     // range_t
+  util_strpool_t        str;
+  util_hindex_t         reg_idx;
+  util_hindex_t         field_idx;
+  util_hindex_t         periph_idx;
+
+  // Peripheral being converted
+  util_vec_t            regs;           // Register indices (uint32_t)
+  util_vec_t            fields;         // svddb_field_t
+  uint32_t              size;           // End of register map
+
+  // Statistics
+  uint32_t              reg_total;
+  uint32_t              periph_total;
+  uint32_t              field_total;
+  int                   verbose;
+} build_t;
+
+/* Deduplication lookup context */
+typedef struct {
+  build_t              *b;
+  const void           *data;
+  uint32_t              num;
+} dedup_key_t;
+
+/* Add NUL terminated string (NULL = empty) to string pool */
+static uint32_t add_string (build_t *b, const char *str) {
+  return (str != NULL) ? util_strpool_add(&b->str, str, strlen(str)) : 0U;
+}
+
+/* Dedup callbacks */
+static int field_list_eq (void *ctx, uint32_t index) {
+  const dedup_key_t *key = (const dedup_key_t *)ctx;
+  const range_t     *r   = &UTIL_VEC_AT(&key->b->field_list, range_t, index);
+
+  return (r->num == key->num) &&
+         (memcmp(&UTIL_VEC_AT(&key->b->field, svddb_field_t, r->first), key->data, key->num * sizeof(svddb_field_t)) == 0);
+}
+
+static int reg_eq (void *ctx, uint32_t index) {
+  const dedup_key_t *key = (const dedup_key_t *)ctx;
+
+  return memcmp(&UTIL_VEC_AT(&key->b->reg, svddb_register_t, index), key->data, sizeof(svddb_register_t)) == 0;
+}
+
+static int periph_eq (void *ctx, uint32_t index) {
+  const dedup_key_t        *key = (const dedup_key_t *)ctx;
+  const svddb_peripheral_t *p   = &UTIL_VEC_AT(&key->b->peripheral, svddb_peripheral_t, index);
+
+  return (p->regref_num == key->num) &&
+         (memcmp(&UTIL_VEC_AT(&key->b->regref, uint32_t, p->regref_first), key->data, key->num * sizeof(uint32_t)) == 0);
+}
+
+static int cmp_field (const void *a, const void *b) {
+  const svddb_field_t *fa = (const svddb_field_t *)a;
+  const svddb_field_t *fb = (const svddb_field_t *)b;
+
+  if (fa->lsb != fb->lsb) {
+    return (int)fa->lsb - (int)fb->lsb;
+  }
+  return (fa->name < fb->name) ? -1 : ((fa->name > fb->name) ? 1 : 0);
+}
+
+/* Register offset sort (qsort has no context, register table is set before sorting) */
+static const svddb_register_t *sort_reg;
+
+static int cmp_regref (const void *a, const void *b) {
+  uint32_t oa = sort_reg[*(const uint32_t *)a].offset;
+  uint32_t ob = sort_reg[*(const uint32_t *)b].offset;
+
+  if (oa != ob) {
+    return (oa < ob) ? -1 : 1;
+  }
+  return (*(const uint32_t *)a < *(const uint32_t *)b) ? -1 : 1;
+}
+
+static int cmp_instance (const void *a, const void *b) {
+  const svddb_instance_t *ia = (const svddb_instance_t *)a;
+  const svddb_instance_t *ib = (const svddb_instance_t *)b;
+
+  if (ia->base != ib->base) {
+    return (ia->base < ib->base) ? -1 : 1;
+  }
+  return (ia->name < ib->name) ? -1 : ((ia->name > ib->name) ? 1 : 0);
+}
+
+static const char *sort_str;
+
+static int cmp_device (const void *a, const void *b) {
+  return strcmp(&sort_str[((const svddb_device_t *)a)->name], &sort_str[((const svddb_device_t *)b)->name]);
+}
+
+/* Store field list of a register (deduplicated), returns first field */
+static uint32_t add_field_list (build_t *b, const svd_field_t *f) {
+  dedup_key_t    key;
+  svddb_field_t *df;
+  uint64_t hash;
+  uint32_t idx;
+  range_t *r;
+
+  b->fields.num = 0U;
+  for (; f != NULL; f = f->next) {
+    df = util_vec_push(&b->fields);
+    df->name        = add_string(b, f->name);
+    df->description = add_string(b, f->description);
+    df->lsb         = (uint8_t)f->lsb;
+    df->width       = (uint8_t)f->width;
+    df->access      = (uint8_t)f->access;
+  }
+  if (b->fields.num == 0U) {
+    return 0U;
+  }
+  qsort(b->fields.data, b->fields.num, sizeof(svddb_field_t), cmp_field);
+  b->field_total += (uint32_t)b->fields.num;
+
+  key.b    = b;
+  key.data = b->fields.data;
+  key.num  = (uint32_t)b->fields.num;
+  hash = util_hash(key.data, key.num * sizeof(svddb_field_t));
+  idx  = util_hindex_find(&b->field_idx, hash, field_list_eq, &key);
+  if (idx == UINT32_MAX) {
+    idx = (uint32_t)b->field_list.num;
+    r = util_vec_push(&b->field_list);
+    r->first = (uint32_t)b->field.num;
+    r->num   = key.num;
+    util_vec_append(&b->field, key.data, key.num);
+    util_hindex_add(&b->field_idx, hash, idx);
+  }
+  return UTIL_VEC_AT(&b->field_list, range_t, idx).first;
+}
+
+/* Store register (deduplicated), returns register index */
+static uint32_t add_register (build_t *b, const svddb_register_t *r) {
+  dedup_key_t key;
+  uint64_t    hash;
+  uint32_t    idx;
+
+  key.b    = b;
+  key.data = r;
+  key.num  = 1U;
+  hash = util_hash(r, sizeof(*r));
+  idx  = util_hindex_find(&b->reg_idx, hash, reg_eq, &key);
+  if (idx == UINT32_MAX) {
+    idx = (uint32_t)b->reg.num;
+    *(svddb_register_t *)util_vec_push(&b->reg) = *r;
+    util_hindex_add(&b->reg_idx, hash, idx);
+  }
+  b->reg_total++;
+  return idx;
+}
+
+/* Add (dim expanded) registers and clusters of a register map */
+static void add_registers (build_t *b, svd_t *svd, svd_peripheral_t *per, const svd_register_t *reg,
+                           svd_cluster_t *cl, uint32_t offset, const char *prefix) {
+  svddb_register_t r;
+  char     name[256], full[512];
+  uint32_t i, n;
+
+  for (; reg != NULL; reg = reg->next) {
+    memset(&r, 0, sizeof(r));
+    r.description = add_string(b, reg->description);
+    r.reset_value = reg->props.reset_value;
+    r.reset_mask  = reg->props.reset_mask;
+    r.size        = (uint8_t)reg->props.size;
+    r.access      = (uint8_t)((reg->props.access != SVD_ACCESS_UNDEF) ? reg->props.access : SVD_ACCESS_RW);
+    r.field_first = add_field_list(b, reg->fields);
+    r.field_num   = (uint16_t)reg->field_num;
+    n = svd_dim_num(svd, &reg->dim, reg->name);
+    for (i = 0U; i < n; i++) {
+      svd_dim_name(reg->name, &reg->dim, i, name, sizeof(name));
+      snprintf(full, sizeof(full), "%s%s", prefix, name);
+      r.name   = add_string(b, full);
+      r.offset = offset + reg->offset + (i * reg->dim.increment);
+      if ((r.offset + (r.size / 8U)) > b->size) {
+        b->size = r.offset + (r.size / 8U);
+      }
+      *(uint32_t *)util_vec_push(&b->regs) = add_register(b, &r);
+    }
+  }
+
+  for (; cl != NULL; cl = cl->next) {
+    const svd_cluster_t *src = cl;
+
+    if ((cl->registers == NULL) && (cl->clusters == NULL) && (cl->derived_from != NULL)) {
+      const svd_cluster_t *base = svd_cluster_base(svd, per, cl);
+      if (base != NULL) {
+        src = base;
+      }
+    }
+    n = svd_dim_num(svd, &cl->dim, cl->name);
+    for (i = 0U; i < n; i++) {
+      svd_dim_name(cl->name, &cl->dim, i, name, sizeof(name));
+      snprintf(full, sizeof(full), "%s%s.", prefix, name);
+      add_registers(b, svd, per, src->registers, src->clusters, offset + cl->offset + (i * cl->dim.increment), full);
+    }
+  }
+}
+
+/* Store register map of current peripheral (deduplicated), returns map index */
+static uint32_t add_peripheral (build_t *b) {
+  svddb_peripheral_t *p;
+  dedup_key_t key;
+  uint64_t    hash;
+  uint32_t    idx;
+
+  sort_reg = (const svddb_register_t *)b->reg.data;
+  if (b->regs.num != 0U) {
+    qsort(b->regs.data, b->regs.num, sizeof(uint32_t), cmp_regref);
+  }
+  key.b    = b;
+  key.data = b->regs.data;
+  key.num  = (uint32_t)b->regs.num;
+  hash = util_hash(key.data, key.num * sizeof(uint32_t));
+  idx  = util_hindex_find(&b->periph_idx, hash, periph_eq, &key);
+  if (idx == UINT32_MAX) {
+    idx = (uint32_t)b->peripheral.num;
+    p = util_vec_push(&b->peripheral);
+    p->regref_first = (uint32_t)b->regref.num;
+    p->regref_num   = key.num;
+    if (key.num != 0U) {
+      util_vec_append(&b->regref, key.data, key.num);
+    }
+    util_hindex_add(&b->periph_idx, hash, idx);
+  }
+  b->periph_total++;
+  return idx;
+}
+
+/* Convert one SVD file into the builder tables */
+static int parse_file (build_t *b, const char *path) {
+  svd_peripheral_t *per, *src;
+  svddb_instance_t *inst;
+  svddb_device_t   *dev;
+  svd_t   *svd;
+  uint32_t first = (uint32_t)b->instance.num;
+  int      err;
+
+  svd = svd_open(path);
+  if (svd == NULL) {
+    return -1;
+  }
+  for (per = svd_next(svd, NULL); per != NULL; per = svd_next(svd, per)) {
+    // derivedFrom without own content uses the register map of the base
+    src = svd_peripheral_content(svd, per);
+    b->regs.num = 0U;
+    b->size     = 0U;
+    add_registers(b, svd, src, src->registers, src->clusters, 0U, "");
+
+    inst = util_vec_push(&b->instance);
+    inst->name        = add_string(b, per->name);
+    inst->description = add_string(b, (per->description != NULL) ? per->description : src->description);
+    inst->base        = per->base_address;
+    inst->peripheral  = add_peripheral(b);
+    // Cover the register map also when address blocks are missing or too small
+    inst->size        = (per->size != 0U) ? per->size : src->size;
+    if (b->size > inst->size) {
+      inst->size = b->size;
+    }
+  }
+  qsort(&UTIL_VEC_AT(&b->instance, svddb_instance_t, first), b->instance.num - first,
+        sizeof(svddb_instance_t), cmp_instance);
+
+  dev = util_vec_push(&b->device);
+  dev->name           = add_string(b, svd_device_name(svd));
+  dev->instance_first = first;
+  dev->instance_num   = (uint32_t)b->instance.num - first;
+  if (b->verbose != 0) {
+    printf("  %-16s %4u peripherals\n", svd_device_name(svd), dev->instance_num);
+  }
+  err = svd_error(svd);
+  svd_close(svd);
+  return (err == 0) ? 0 : -1;
+}
+
+/* Append table to output image (8-byte aligned), returns table offset */
+static uint32_t emit (util_vec_t *out, const void *data, size_t size) {
+  uint32_t offs;
+
+  while ((out->num & 7U) != 0U) {
+    util_vec_push(out);
+  }
+  offs = (uint32_t)out->num;
+  if (size != 0U) {
+    util_vec_append(out, data, size);
+  }
+  return offs;
+}
+
+/**
+  Build database from SVD files.
+  \param[in]    out      database file
+  \param[in]    svd      SVD file paths
+  \param[in]    svd_num  number of SVD files
+  \param[in]    verbose  print statistics
+  \return       0 on success, or -1 on error.
+*/
+int svddb_build (const char *out, const char * const *svd, uint32_t svd_num, int verbose) {
+  svddb_header_t hdr;
+  util_vec_t     img;
+  build_t        b;
+  uint32_t       i;
+  int            err = 0;
+
+  memset(&b, 0, sizeof(b));
+  b.verbose = verbose;
+  util_vec_init(&b.device,     sizeof(svddb_device_t));
+  util_vec_init(&b.instance,   sizeof(svddb_instance_t));
+  util_vec_init(&b.peripheral, sizeof(svddb_peripheral_t));
+  util_vec_init(&b.regref,     sizeof(uint32_t));
+  util_vec_init(&b.reg,        sizeof(svddb_register_t));
+  util_vec_init(&b.field,      sizeof(svddb_field_t));
+  util_vec_init(&b.field_list, sizeof(range_t));
+  util_vec_init(&b.regs,       sizeof(uint32_t));
+  util_vec_init(&b.fields,     sizeof(svddb_field_t));
+  util_strpool_init(&b.str);
+  util_hindex_init(&b.reg_idx);
+  util_hindex_init(&b.field_idx);
+  util_hindex_init(&b.periph_idx);
+
+  for (i = 0U; (i < svd_num) && (err == 0); i++) {
+    err = parse_file(&b, svd[i]);
+  }
+
+  if (err == 0) {
+    // Device table sorted by name for binary search
+    sort_str = (const char *)b.str.buf.data;
+    qsort(b.device.data, b.device.num, sizeof(svddb_device_t), cmp_device);
+    for (i = 1U; i < b.device.num; i++) {
+      if (cmp_device(&UTIL_VEC_AT(&b.device, svddb_device_t, i - 1U), &UTIL_VEC_AT(&b.device, svddb_device_t, i)) == 0) {
+        fprintf(stderr, "error: duplicate device '%s'\n", &sort_str[UTIL_VEC_AT(&b.device, svddb_device_t, i).name]);
+        err = -1;
+      }
+    }
+  }
+
+  if (err == 0) {
+    memset(&hdr, 0, sizeof(hdr));
+    util_vec_init(&img, 1U);
+    util_vec_append(&img, NULL, sizeof(hdr));
+    hdr.magic          = SVDDB_MAGIC;
+    hdr.version        = SVDDB_VERSION;
+    hdr.device_num     = (uint32_t)b.device.num;
+    hdr.device_off     = emit(&img, b.device.data,     b.device.num     * sizeof(svddb_device_t));
+    hdr.instance_num   = (uint32_t)b.instance.num;
+    hdr.instance_off   = emit(&img, b.instance.data,   b.instance.num   * sizeof(svddb_instance_t));
+    hdr.peripheral_num = (uint32_t)b.peripheral.num;
+    hdr.peripheral_off = emit(&img, b.peripheral.data, b.peripheral.num * sizeof(svddb_peripheral_t));
+    hdr.regref_num     = (uint32_t)b.regref.num;
+    hdr.regref_off     = emit(&img, b.regref.data,     b.regref.num     * sizeof(uint32_t));
+    hdr.register_num   = (uint32_t)b.reg.num;
+    hdr.register_off   = emit(&img, b.reg.data,        b.reg.num        * sizeof(svddb_register_t));
+    hdr.field_num      = (uint32_t)b.field.num;
+    hdr.field_off      = emit(&img, b.field.data,      b.field.num      * sizeof(svddb_field_t));
+    hdr.string_size    = (uint32_t)b.str.buf.num;
+    hdr.string_off     = emit(&img, b.str.buf.data,    b.str.buf.num);
+    emit(&img, NULL, 0U);
+    hdr.file_size      = (uint32_t)img.num;
+    memcpy(img.data, &hdr, sizeof(hdr));
+
+    if (util_file_write(out, img.data, img.num) != 0) {
+      fprintf(stderr, "%s: error: cannot write file\n", out);
+      err = -1;
+    }
+    if ((err == 0) && (verbose != 0)) {
+      printf("devices:     %u\n", hdr.device_num);
+      printf("peripherals: %u instances, %u unique register maps\n", b.periph_total, hdr.peripheral_num);
+      printf("registers:   %u total, %u unique\n", b.reg_total, hdr.register_num);
+      printf("fields:      %u total, %u stored in %u unique lists\n", b.field_total, hdr.field_num, (uint32_t)b.field_list.num);
+      printf("strings:     %u bytes\n", hdr.string_size);
+      printf("database:    %u bytes\n", hdr.file_size);
+    }
+    util_vec_free(&img);
+  }
+
+  util_vec_free(&b.device);
+  util_vec_free(&b.instance);
+  util_vec_free(&b.peripheral);
+  util_vec_free(&b.regref);
+  util_vec_free(&b.reg);
+  util_vec_free(&b.field);
+  util_vec_free(&b.field_list);
+  util_vec_free(&b.regs);
+  util_vec_free(&b.fields);
+  util_strpool_free(&b.str);
+  util_hindex_free(&b.reg_idx);
+  util_hindex_free(&b.field_idx);
+  util_hindex_free(&b.periph_idx);
+  return err;
+}
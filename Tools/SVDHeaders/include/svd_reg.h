@@ -0,0 +1,77 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Register access macros for C headers generated by svdgen
+ * -------------------------------------------------------------------------- */
+
+/*
+ * C fallback of svd_reg.hpp. Generated headers define for each register
+ * <REG> (an lvalue, const for read-only registers), <REG>_ADDR and
+ * <REG>_RESET, and for each field <FIELD>_Pos, <FIELD>_Msk and <FIELD>_Max.
+ * The macros below take the field name without suffix:
+ *
+ *   SVD_MODIFY2(FLASH_CR1, FLASH_CR1_PSIZE1, 3U, FLASH_CR1_PG1, 1U);
+ *
+ * is one read-modify-write with constant mask. SVD_VAL() checks at compile
+ * time that a constant fits into the field.
+ */
+
+#ifndef SVD_REG_H
+#define SVD_REG_H
+
+#include <stdint.h>
+
+/* Register access */
+#define SVD_REG8(addr)          (*(volatile       uint8_t  *)(addr))
+#define SVD_REG16(addr)         (*(volatile       uint16_t *)(addr))
+#define SVD_REG32(addr)         (*(volatile       uint32_t *)(addr))
+#define SVD_REG64(addr)         (*(volatile       uint64_t *)(addr))
+#define SVD_REG8_RO(addr)       (*(volatile const uint8_t  *)(addr))
+#define SVD_REG16_RO(addr)      (*(volatile const uint16_t *)(addr))
+#define SVD_REG32_RO(addr)      (*(volatile const uint32_t *)(addr))
+#define SVD_REG64_RO(addr)      (*(volatile const uint64_t *)(addr))
+
+/* Shifted field value (run-time value, excess bits are masked off) */
+#define SVD_FIELD(f, v)         ((((uint32_t)(v)) << f##_Pos) & f##_Msk)
+
+/* Shifted field value of a constant (compile error when it exceeds the field) */
+#define SVD_VAL(f, v)           (SVD_FIELD(f, v) + \
+                                 (0U * sizeof(char[((uint32_t)(v) <= f##_Max) ? 1 : -1])))
+
+/* Extract field from register value */
+#define SVD_GET(f, r)           ((((uint32_t)(r)) & f##_Msk) >> f##_Pos)
+
+/* Read-modify-write of up to three fields as one register access */
+#define SVD_MODIFY(r, f, v)     ((r) = ((r) & ~f##_Msk) | SVD_FIELD(f, v))
+#define SVD_MODIFY2(r, f1, v1, f2, v2) \
+                                ((r) = ((r) & ~(f1##_Msk | f2##_Msk)) | SVD_FIELD(f1, v1) | SVD_FIELD(f2, v2))
+#define SVD_MODIFY3(r, f1, v1, f2, v2, f3, v3) \
+                                ((r) = ((r) & ~(f1##_Msk | f2##_Msk | f3##_Msk)) | \
+                                       SVD_FIELD(f1, v1) | SVD_FIELD(f2, v2) | SVD_FIELD(f3, v3))
+
+/* Update bits with a precomputed mask and value (any number of fields) */
+#define SVD_UPDATE(r, mask, val) ((r) = ((r) & ~(mask)) | (val))
+
+/* Write fields, all other bits get their reset value */
+#define SVD_WRITE(r, mask, val) ((r) = (r##_RESET & ~(mask)) | (val))
+
+#endif /* SVD_REG_H */
@@ -0,0 +1,181 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Register access templates for headers generated by svdgen
+ * -------------------------------------------------------------------------- */
+
+/*
+ * Registers and fields are types: address, width, reset value, bit position
+ * and access rights are template parameters, so masks and shifts are
+ * computed at compile time and no descriptor data exists at run time.
+ *
+ * Field values are tagged with their register type. Passing a field of
+ * another register to reg::write/modify/test does not compile. modify()
+ * merges any number of field values into one read-modify-write:
+ *
+ *   Flash::CR1::modify(Flash::CR1::PSIZE1::val<3>(), Flash::CR1::PG1::set());
+ *
+ * compiles to one load, one AND/OR with constants and one store.
+ * Requires C++11.
+ */
+
+#ifndef SVD_REG_HPP
+#define SVD_REG_HPP
+
+#include <stdint.h>
+
+namespace svd {
+
+/// Access rights (SVD writeOnce maps to wo, read-writeOnce to rw)
+enum class access { ro, wo, rw };
+
+/// Value of one or more fields of register Reg (mask and shifted value)
+template <typename Reg, typename T>
+struct field_value {
+  T mask;
+  T value;
+
+  constexpr field_value (T m, T v) : mask(m), value(v) {}
+
+  /// Combine with other field values of the same register
+  constexpr field_value operator| (field_value other) const {
+    return field_value(mask | other.mask, value | other.value);
+  }
+};
+
+/// Register at address Addr of type T (Self is the register type itself)
+template <typename Self, uint32_t Addr, typename T, T Reset, access A>
+struct reg {
+  using value_type = T;
+  using fv_type    = field_value<Self, T>;
+
+  static constexpr uint32_t address = Addr;
+  static constexpr T        reset   = Reset;
+  static constexpr access   rights  = A;
+
+  /// Register reference (volatile)
+  static volatile T &ref () {
+    return *reinterpret_cast<volatile T *>(Addr);
+  }
+
+  /// Read register
+  static T read () {
+    static_assert(A != access::wo, "register is write-only");
+    return ref();
+  }
+
+  /// Write raw value
+  static void write (T v) {
+    static_assert(A != access::ro, "register is read-only");
+    ref() = v;
+  }
+
+  /// Write field values, all other bits get their reset value
+  template <typename... F>
+  static void write (fv_type f, F... fs) {
+    static_assert(A != access::ro, "register is read-only");
+    ref() = static_cast<T>((Reset & ~mask_of(f, fs...)) | value_of(f, fs...));
+  }
+
+  /// Update field values with a single read-modify-write
+  template <typename... F>
+  static void modify (fv_type f, F... fs) {
+    static_assert(A == access::rw, "read-modify-write requires a read-write register");
+    ref() = static_cast<T>((ref() & ~mask_of(f, fs...)) | value_of(f, fs...));
+  }
+
+  /// Check whether all given fields have the given values
+  template <typename... F>
+  static bool test (fv_type f, F... fs) {
+    return (read() & mask_of(f, fs...)) == value_of(f, fs...);
+  }
+
+  /// Combined mask of field values (fails to compile for fields of other registers)
+  static constexpr T mask_of () { return 0U; }
+  template <typename... F>
+  static constexpr T mask_of (fv_type f, F... fs) { return static_cast<T>(f.mask | mask_of(fs...)); }
+
+  /// Combined value of field values
+  static constexpr T value_of () { return 0U; }
+  template <typename... F>
+  static constexpr T value_of (fv_type f, F... fs) { return static_cast<T>(f.value | value_of(fs...)); }
+};
+
+/// Field of register Reg at bit position Lsb with Width bits
+template <typename Reg, unsigned Lsb, unsigned Width, access A>
+struct field {
+  using value_type = typename Reg::value_type;
+  using fv_type    = field_value<Reg, value_type>;
+
+  static_assert((Width != 0U) && ((Lsb + Width) <= (8U * sizeof(value_type))), "field exceeds register");
+
+  static constexpr unsigned   shift = Lsb;
+  static constexpr unsigned   width = Width;
+  static constexpr value_type max   = static_cast<value_type>((Width >= (8U * sizeof(value_type))) ?
+                                        ~value_type(0) : ((value_type(1) << Width) - 1U));
+  static constexpr value_type mask  = static_cast<value_type>(max << Lsb);
+
+  /// Field value from run-time value (excess bits are masked off)
+  static constexpr fv_type value (value_type v) {
+    static_assert(A != access::ro, "field is read-only");
+    return fv_type(mask, static_cast<value_type>((v << Lsb) & mask));
+  }
+
+  /// Field value from constant (range checked at compile time)
+  template <value_type V>
+  static constexpr fv_type val () {
+    static_assert(A != access::ro, "field is read-only");
+    static_assert(V <= max, "value exceeds field width");
+    return fv_type(mask, static_cast<value_type>(V << Lsb));
+  }
+
+  /// All field bits set (single-bit fields: flag set)
+  static constexpr fv_type set () {
+    static_assert(A != access::ro, "field is read-only");
+    return fv_type(mask, mask);
+  }
+
+  /// All field bits cleared
+  static constexpr fv_type clear () {
+    static_assert(A != access::ro, "field is read-only");
+    return fv_type(mask, 0U);
+  }
+
+  /// Expected value for reg::test (no access restriction)
+  static constexpr fv_type is (value_type v) {
+    return fv_type(mask, static_cast<value_type>((v << Lsb) & mask));
+  }
+
+  /// Read field
+  static value_type read () {
+    return static_cast<value_type>((Reg::read() & mask) >> Lsb);
+  }
+
+  /// Write field (read-modify-write of the register)
+  static void write (value_type v) {
+    Reg::modify(value(v));
+  }
+};
+
+} // namespace svd
+
+#endif /* SVD_REG_HPP */
@@ -0,0 +1,444 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      Register access header generator (C++ and C)
+ * -------------------------------------------------------------------------- */
+
+/*
+ * Generates from one SVD file:
+ *  - <device>_regs.hpp: per register map a class template over the base
+ *    address with one type per register (svd::reg) and per field
+ *    (svd::field), see include/svd_reg.hpp. Peripherals with derivedFrom
+ *    instantiate the template of their base peripheral.
+ *  - <device>_regs.h: C fallback with register lvalues and field
+ *    _Pos/_Msk/_Max macros for include/svd_reg.h.
+ * Register and cluster arrays (dim) are expanded, clusters are flattened
+ * into <CLUSTER>_<REGISTER> names.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "svd.h"
+#include "util.h"
+
+#define NAME_MAX_LEN    128U            // Maximum identifier length
+#define COMMENT_MAX     100U            // Description length in comments
+
+/* Register of a flattened register map */
+typedef struct {
+  char                  name[NAME_MAX_LEN];
+  uint32_t              offset;         // Offset from peripheral base
+  const svd_register_t *reg;
+} item_t;
+
+/* Generator state */
+typedef struct {
+  FILE                 *hpp;            // C++ header
+  FILE                 *h;              // C header
+  const char           *ns;             // C++ namespace
+  const char           *prefix;         // C macro prefix
+  svd_t                *svd;
+  util_vec_t            items;          // item_t of current register map
+  util_vec_t            maps;           // Peripherals with emitted C++ template (svd_peripheral_t *)
+  uint32_t              peripherals;
+  uint32_t              registers;
+  uint32_t              fields;
+} gen_t;
+
+static void usage (void) {
+  fprintf(stderr,
+    "usage: svdgen [-o <dir>] [-n <namespace>] [-p <prefix>] <svd> [<peripheral>...]\n");
+}
+
+/* Copy name as C identifier */
+static void ident (char *buf, size_t size, const char *name) {
+  size_t i = 0U;
+
+  if (isdigit((unsigned char)*name)) {
+    buf[i++] = '_';
+  }
+  for (; (*name != '\0') && (i < (size - 1U)); name++) {
+    buf[i++] = isalnum((unsigned char)*name) ? *name : '_';
+  }
+  buf[i] = '\0';
+}
+
+/* Copy name as upper case C identifier */
+static void ident_upper (char *buf, size_t size, const char *name) {
+  ident(buf, size, name);
+  for (; *buf != '\0'; buf++) {
+    *buf = (char)toupper((unsigned char)*buf);
+  }
+}
+
+/* Print description as single line comment (shortened) */
+static void comment (FILE *f, const char *str) {
+  size_t i;
+
+  if (str == NULL) {
+    return;
+  }
+  fputs("  // ", f);
+  for (i = 0U; (str[i] != '\0') && (i < COMMENT_MAX); i++) {
+    fputc(((str[i] == '\\') || (str[i] == '\n') || (str[i] == '\r')) ? ' ' : str[i], f);
+  }
+  if (str[i] != '\0') {
+    fputs("...", f);
+  }
+}
+
+/* Register value type by size in bits */
+static const char *reg_type (uint32_t size) {
+  switch (size) {
+    case 8U:  return "uint8_t";
+    case 16U: return "uint16_t";
+    case 64U: return "uint64_t";
+    default:  return "uint32_t";
+  }
+}
+
+/* C++ access rights */
+static const char *reg_access (uint32_t access) {
+  switch (access) {
+    case SVD_ACCESS_RO:    return "svd::access::ro";
+    case SVD_ACCESS_WO:
+    case SVD_ACCESS_WONCE: return "svd::access::wo";
+    default:               return "svd::access::rw";
+  }
+}
+
+/* Check whether a name was already used in the current register map */
+static int item_exists (const gen_t *g, const char *name) {
+  size_t i;
+
+  for (i = 0U; i < g->items.num; i++) {
+    if (strcmp(UTIL_VEC_AT(&g->items, item_t, i).name, name) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Flatten (dim expanded) registers and clusters into item list */
+static void flatten (gen_t *g, svd_peripheral_t *per, const svd_register_t *reg,
+                     svd_cluster_t *cl, uint32_t offset, const char *prefix) {
+  item_t  *it;
+  char     name[NAME_MAX_LEN], full[NAME_MAX_LEN];
+  int      len;
+  uint32_t i, n;
+
+  for (; reg != NULL; reg = reg->next) {
+    n = svd_dim_num(g->svd, &reg->dim, reg->name);
+    for (i = 0U; i < n; i++) {
+      svd_dim_name(reg->name, &reg->dim, i, name, sizeof(name));
+      snprintf(full, sizeof(full), "%s%s", prefix, name);
+      ident(name, sizeof(name), full);
+      if (item_exists(g, name) != 0) {
+        fprintf(stderr, "%s: warning: duplicate register '%s.%s' skipped\n",
+                svd_device_name(g->svd), per->name, name);
+        continue;
+      }
+      it = util_vec_push(&g->items);
+      snprintf(it->name, sizeof(it->name), "%s", name);
+      it->offset = offset + reg->offset + (i * reg->dim.increment);
+      it->reg    = reg;
+    }
+  }
+
+  for (; cl != NULL; cl = cl->next) {
+    const svd_cluster_t *src = cl;
+
+    if ((cl->registers == NULL) && (cl->clusters == NULL) && (cl->derived_from != NULL)) {
+      const svd_cluster_t *base = svd_cluster_base(g->svd, per, cl);
+      if (base != NULL) {
+        src = base;
+      }
+    }
+    n = svd_dim_num(g->svd, &cl->dim, cl->name);
+    for (i = 0U; i < n; i++) {
+      svd_dim_name(cl->name, &cl->dim, i, name, sizeof(name));
+      len = snprintf(full, sizeof(full), "%s%s_", prefix, name);
+      if ((len < 0) || ((size_t)len >= sizeof(full))) {
+        fprintf(stderr, "%s: warning: register name '%s.%s%s' too long, skipped\n",
+                svd_device_name(g->svd), per->name, prefix, name);
+        continue;
+      }
+      flatten(g, per, src->registers, src->clusters, offset + cl->offset + (i * cl->dim.increment), full);
+    }
+  }
+}
+
+/* Collect register map of a peripheral, returns peripheral providing the content */
+static svd_peripheral_t *collect (gen_t *g, svd_peripheral_t *per) {
+  svd_peripheral_t *src = svd_peripheral_content(g->svd, per);
+
+  g->items.num = 0U;
+  flatten(g, src, src->registers, src->clusters, 0U, "");
+  return src;
+}
+
+/* Emit C++ class template of a register map */
+static void emit_map (gen_t *g, const svd_peripheral_t *src) {
+  const svd_field_t *f;
+  const item_t *it;
+  char     map[NAME_MAX_LEN], fname[NAME_MAX_LEN];
+  size_t   i;
+
+  ident(map, sizeof(map), src->name);
+  fprintf(g->hpp, "\ntemplate <uint32_t Base>\nstruct %s_map {\n", map);
+  for (i = 0U; i < g->items.num; i++) {
+    it = &UTIL_VEC_AT(&g->items, item_t, i);
+    if ((it->reg->description != NULL) && (it->reg->description[0] != '\0')) {
+      comment(g->hpp, it->reg->description);
+      fputc('\n', g->hpp);
+    }
+    fprintf(g->hpp, "  struct %s : svd::reg<%s, Base + 0x%03XU, %s, 0x%08XU, %s> {\n",
+            it->name, it->name, it->offset, reg_type(it->reg->props.size),
+            it->reg->props.reset_value, reg_access(it->reg->props.access));
+    for (f = it->reg->fields; f != NULL; f = f->next) {
+      ident(fname, sizeof(fname), f->name);
+      if (strcmp(fname, it->name) == 0) {
+        // Member must not have the name of its class
+        strcat(fname, "_");
+      }
+      fprintf(g->hpp, "    using %-16s = svd::field<%s, %2uU, %2uU, %s>;",
+              fname, it->name, f->lsb, f->width, reg_access(f->access));
+      comment(g->hpp, f->description);
+      fputc('\n', g->hpp);
+    }
+    fprintf(g->hpp, "  };\n");
+  }
+  fprintf(g->hpp, "};\n");
+}
+
+/* Emit C macros of a peripheral instance */
+static void emit_c (gen_t *g, const svd_peripheral_t *per) {
+  const svd_field_t *f;
+  const item_t *it;
+  char     pname[NAME_MAX_LEN], rname[2U * NAME_MAX_LEN], fname[NAME_MAX_LEN], macro[4U * NAME_MAX_LEN];
+  uint32_t addr, size;
+  uint64_t max;
+  size_t   i;
+
+  ident_upper(pname, sizeof(pname), per->name);
+  fprintf(g->h, "\n/* %s */\n", per->name);
+  snprintf(macro, sizeof(macro), "%s%s_BASE", g->prefix, pname);
+  fprintf(g->h, "#define %-48s 0x%08XUL\n", macro, per->base_address);
+  for (i = 0U; i < g->items.num; i++) {
+    it   = &UTIL_VEC_AT(&g->items, item_t, i);
+    addr = per->base_address + it->offset;
+    size = it->reg->props.size;
+    if ((size != 8U) && (size != 16U) && (size != 64U)) {
+      size = 32U;
+    }
+    ident_upper(fname, sizeof(fname), it->name);
+    snprintf(rname, sizeof(rname), "%s%s_%s", g->prefix, pname, fname);
+    fprintf(g->h, "#define %-48s SVD_REG%u%s(0x%08XUL)\n", rname, size,
+            (it->reg->props.access == SVD_ACCESS_RO) ? "_RO" : "", addr);
+    snprintf(macro, sizeof(macro), "%s_ADDR", rname);
+    fprintf(g->h, "#define %-48s 0x%08XUL\n", macro, addr);
+    snprintf(macro, sizeof(macro), "%s_RESET", rname);
+    fprintf(g->h, "#define %-48s 0x%08XUL\n", macro, it->reg->props.reset_value);
+    for (f = it->reg->fields; f != NULL; f = f->next) {
+      ident_upper(fname, sizeof(fname), f->name);
+      max = (f->width >= 64U) ? UINT64_MAX : ((1ULL << f->width) - 1U);
+      snprintf(macro, sizeof(macro), "%s_%s_Pos", rname, fname);
+      fprintf(g->h, "#define %-48s %uU\n", macro, f->lsb);
+      snprintf(macro, sizeof(macro), "%s_%s_Msk", rname, fname);
+      fprintf(g->h, "#define %-48s 0x%08llXUL\n", macro, (unsigned long long)((max << f->lsb) & 0xFFFFFFFFU));
+      snprintf(macro, sizeof(macro), "%s_%s_Max", rname, fname);
+      fprintf(g->h, "#define %-48s 0x%llXUL\n", macro, (unsigned long long)(max & 0xFFFFFFFFU));
+    }
+  }
+}
+
+/* Process one peripheral */
+static void generate (gen_t *g, svd_peripheral_t *per) {
+  svd_peripheral_t *src;
+  char   name[NAME_MAX_LEN], map[NAME_MAX_LEN];
+  size_t i;
+
+  src = collect(g, per);
+  for (i = 0U; i < g->maps.num; i++) {
+    if (UTIL_VEC_AT(&g->maps, svd_peripheral_t *, i) == src) {
+      break;
+    }
+  }
+  if (i == g->maps.num) {
+    emit_map(g, src);
+    *(svd_peripheral_t **)util_vec_push(&g->maps) = src;
+  }
+  ident(name, sizeof(name), per->name);
+  ident(map, sizeof(map), src->name);
+  if ((per->description != NULL) && (per->description[0] != '\0')) {
+    comment(g->hpp, per->description);
+    fputc('\n', g->hpp);
+  }
+  fprintf(g->hpp, "using %s = %s_map<0x%08XU>;\n", name, map, per->base_address);
+
+  emit_c(g, per);
+
+  g->peripherals++;
+  g->registers += (uint32_t)g->items.num;
+  for (i = 0U; i < g->items.num; i++) {
+    g->fields += UTIL_VEC_AT(&g->items, item_t, i).reg->field_num;
+  }
+}
+
+/* Open output file <dir>/<device>_regs.<ext> */
+static FILE *open_output (const char *dir, const char *device, const char *ext, char *path, size_t size) {
+  char  name[NAME_MAX_LEN];
+  char *p;
+  FILE *f;
+
+  ident(name, sizeof(name), device);
+  for (p = name; *p != '\0'; p++) {
+    *p = (char)tolower((unsigned char)*p);
+  }
+  snprintf(path, size, "%s/%s_regs.%s", dir, name, ext);
+  f = fopen(path, "w");
+  if (f == NULL) {
+    fprintf(stderr, "%s: error: cannot create file\n", path);
+  }
+  return f;
+}
+
+/* Print file header */
+static void header (FILE *f, const char *svd_path, const char *guard, const char *include) {
+  const char *file = strrchr(svd_path, '/');
+
+  fprintf(f,
+    "/*\n"
+    " * Register access definitions generated by svdgen from %s.\n"
+    " * Do not edit.\n"
+    " */\n\n"
+    "#ifndef %s\n"
+    "#define %s\n\n"
+    "#include \"%s\"\n",
+    (file != NULL) ? (file + 1) : svd_path, guard, guard, include);
+}
+
+int main (int argc, char **argv) {
+  const char *dir = ".";
+  const char *ns  = NULL;
+  const char *prefix = NULL;
+  svd_peripheral_t *per;
+  gen_t   g;
+  char    path_hpp[512], path_h[512], name[NAME_MAX_LEN], dev[NAME_MAX_LEN], guard[NAME_MAX_LEN + 16U];
+  char    buf[NAME_MAX_LEN + 1U];
+  char   *p;
+  int     i, rc = EXIT_SUCCESS;
+
+  for (i = 1; (i < argc) && (argv[i][0] == '-'); i += 2) {
+    if (i + 1 >= argc) {
+      usage();
+      return EXIT_FAILURE;
+    }
+    if      (strcmp(argv[i], "-o") == 0) { dir    = argv[i + 1]; }
+    else if (strcmp(argv[i], "-n") == 0) { ns     = argv[i + 1]; }
+    else if (strcmp(argv[i], "-p") == 0) { prefix = argv[i + 1]; }
+    else {
+      usage();
+      return EXIT_FAILURE;
+    }
+  }
+  if (i >= argc) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  memset(&g, 0, sizeof(g));
+  g.svd = svd_open(argv[i]);
+  if (g.svd == NULL) {
+    return EXIT_FAILURE;
+  }
+  util_vec_init(&g.items, sizeof(item_t));
+  util_vec_init(&g.maps,  sizeof(svd_peripheral_t *));
+
+  // Default namespace: device name in lower case, default prefix: device name
+  ident(name, sizeof(name), svd_device_name(g.svd));
+  ident_upper(dev, sizeof(dev), svd_device_name(g.svd));
+  if (ns == NULL) {
+    for (p = name; *p != '\0'; p++) {
+      *p = (char)tolower((unsigned char)*p);
+    }
+    ns = name;
+  }
+  if (prefix == NULL) {
+    snprintf(buf, sizeof(buf), "%s_", dev);
+    prefix = buf;
+  }
+  g.ns     = ns;
+  g.prefix = prefix;
+
+  g.hpp = open_output(dir, svd_device_name(g.svd), "hpp", path_hpp, sizeof(path_hpp));
+  g.h   = open_output(dir, svd_device_name(g.svd), "h",   path_h,   sizeof(path_h));
+  if ((g.hpp == NULL) || (g.h == NULL)) {
+    rc = EXIT_FAILURE;
+  } else {
+    snprintf(guard, sizeof(guard), "%s_REGS_HPP", dev);
+    header(g.hpp, argv[i], guard, "svd_reg.hpp");
+    fprintf(g.hpp, "\nnamespace %s {\n", g.ns);
+    snprintf(guard, sizeof(guard), "%s_REGS_H", dev);
+    header(g.h, argv[i], guard, "svd_reg.h");
+
+    if (i + 1 == argc) {
+      for (per = svd_next(g.svd, NULL); per != NULL; per = svd_next(g.svd, per)) {
+        generate(&g, per);
+      }
+    }
+    for (i++; i < argc; i++) {
+      per = svd_peripheral(g.svd, argv[i]);
+      if (per == NULL) {
+        fprintf(stderr, "%s: error: peripheral '%s' not found\n", svd_device_name(g.svd), argv[i]);
+        rc = EXIT_FAILURE;
+        continue;
+      }
+      generate(&g, per);
+    }
+
+    fprintf(g.hpp, "\n} // namespace %s\n\n#endif\n", g.ns);
+    fprintf(g.h, "\n#endif\n");
+    if (svd_error(g.svd) != 0) {
+      rc = EXIT_FAILURE;
+    }
+    printf("%s: %u peripherals (%u register maps), %u registers, %u fields\n",
+           svd_device_name(g.svd), g.peripherals, (uint32_t)g.maps.num, g.registers, g.fields);
+  }
+  if (g.hpp != NULL) {
+    fclose(g.hpp);
+  }
+  if (g.h != NULL) {
+    fclose(g.h);
+  }
+  if (rc != EXIT_SUCCESS) {
+    remove(path_hpp);
+    remove(path_h);
+  }
+  util_vec_free(&g.items);
+  util_vec_free(&g.maps);
+  svd_close(g.svd);
+  return rc;
+}
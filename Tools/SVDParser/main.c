@@ -0,0 +1,432 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.0
+ *
+ * Project:      svdparse command line tool (streaming parser and benchmark)
+ * -------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "svd.h"
+#include "util.h"
+
+#ifdef SVD_BENCH_LIBXML2
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+#endif
+
+#define BENCH_RUNS      5U              // Runs per measurement (best is reported)
+
+/* Measurement result */
+typedef struct {
+  double                time;           // Best time in ms
+  size_t                memory;         // Heap memory in bytes
+  uint32_t              registers;      // Registers found
+  uint32_t              fields;         // Fields found
+} result_t;
+
+static void usage (void) {
+  fprintf(stderr,
+    "usage: svdparse show <svd> <peripheral>\n"
+    "       svdparse bench [-p <peripheral>] <svd>...\n");
+}
+
+/* Count registers and fields of a cluster tree */
+static void count_registers (const svd_register_t *reg, const svd_cluster_t *cl, result_t *res) {
+  for (; reg != NULL; reg = reg->next) {
+    res->registers++;
+    res->fields += reg->field_num;
+  }
+  for (; cl != NULL; cl = cl->next) {
+    count_registers(cl->registers, cl->clusters, res);
+  }
+}
+
+/* Print registers of a cluster tree */
+static void print_registers (const svd_register_t *reg, const svd_cluster_t *cl, uint32_t base, const char *prefix) {
+  const svd_field_t *f;
+  char name[256];
+
+  for (; reg != NULL; reg = reg->next) {
+    printf("  0x%08X %s%-20s %s\n", base + reg->offset, prefix, reg->name, (reg->description != NULL) ? reg->description : "");
+    for (f = reg->fields; f != NULL; f = f->next) {
+      printf("               [%2u:%2u] %s\n", f->lsb + f->width - 1U, f->lsb, f->name);
+    }
+  }
+  for (; cl != NULL; cl = cl->next) {
+    snprintf(name, sizeof(name), "%s%s.", prefix, cl->name);
+    print_registers(cl->registers, cl->clusters, base + cl->offset, name);
+  }
+}
+
+static int cmd_show (int argc, char **argv) {
+  const svd_peripheral_t *base;
+  svd_peripheral_t *per;
+  svd_stats_t stats;
+  svd_t  *svd;
+  double  t0;
+
+  if (argc != 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  t0  = util_time_ms();
+  svd = svd_open(argv[0]);
+  if (svd == NULL) {
+    return EXIT_FAILURE;
+  }
+  per = svd_peripheral(svd, argv[1]);
+  if (per == NULL) {
+    fprintf(stderr, "%s: error: peripheral '%s' not found\n", argv[0], argv[1]);
+    svd_close(svd);
+    return EXIT_FAILURE;
+  }
+  base = svd_peripheral_base(svd, per);
+  printf("%s 0x%08X %s", per->name, per->base_address, (per->description != NULL) ? per->description : "");
+  if (base != NULL) {
+    printf(" (derived from %s)", base->name);
+  }
+  printf("\n");
+  if ((per->registers == NULL) && (per->clusters == NULL) && (base != NULL)) {
+    print_registers(base->registers, base->clusters, per->base_address, "");
+  } else {
+    print_registers(per->registers, per->clusters, per->base_address, "");
+  }
+  svd_stats(svd, &stats);
+  printf("%.3f ms, %u peripherals parsed, %u skipped, %zu bytes\n", util_time_ms() - t0,
+         stats.parsed, stats.skipped, stats.memory);
+  svd_close(svd);
+  return EXIT_SUCCESS;
+}
+
+/* Streaming parser: all peripherals (full parse) or one peripheral */
+static int bench_stream (const char *path, const char *name, result_t *res) {
+  svd_peripheral_t *per;
+  svd_stats_t stats;
+  svd_t   *svd;
+  uint32_t run;
+  double   t0, t, best = 0.0;
+
+  for (run = 0U; run < BENCH_RUNS; run++) {
+    memset(res, 0, sizeof(*res));
+    t0  = util_time_ms();
+    svd = svd_open(path);
+    if (svd == NULL) {
+      return -1;
+    }
+    if (name == NULL) {
+      for (per = svd_next(svd, NULL); per != NULL; per = svd_next(svd, per)) {
+        count_registers(per->registers, per->clusters, res);
+      }
+    } else {
+      per = svd_peripheral(svd, name);
+      if (per != NULL) {
+        const svd_peripheral_t *base = svd_peripheral_base(svd, per);
+        if ((per->registers == NULL) && (base != NULL)) {
+          count_registers(base->registers, base->clusters, res);
+        } else {
+          count_registers(per->registers, per->clusters, res);
+        }
+      }
+    }
+    t = util_time_ms() - t0;
+    if ((run == 0U) || (t < best)) {
+      best = t;
+    }
+    res->time = best;
+    svd_stats(svd, &stats);
+    res->memory = stats.memory;
+    if (svd_error(svd) != 0) {
+      svd_close(svd);
+      return -1;
+    }
+    svd_close(svd);
+  }
+  return 0;
+}
+
+#ifdef SVD_BENCH_LIBXML2
+
+/* Heap accounting for libxml2 */
+static size_t dom_mem_cur;
+static size_t dom_mem_peak;
+
+static void *dom_malloc (size_t size) {
+  size_t *p = malloc(size + sizeof(size_t) * 2U);
+  if (p == NULL) {
+    return NULL;
+  }
+  p[0] = size;
+  dom_mem_cur += size;
+  if (dom_mem_cur > dom_mem_peak) {
+    dom_mem_peak = dom_mem_cur;
+  }
+  return &p[2];
+}
+
+static void dom_free (void *ptr) {
+  if (ptr != NULL) {
+    size_t *p = (size_t *)ptr - 2;
+    dom_mem_cur -= p[0];
+    free(p);
+  }
+}
+
+static void *dom_realloc (void *ptr, size_t size) {
+  size_t *p, old = 0U;
+
+  if (ptr == NULL) {
+    return dom_malloc(size);
+  }
+  old = ((size_t *)ptr)[-2];
+  p = realloc((size_t *)ptr - 2, size + sizeof(size_t) * 2U);
+  if (p == NULL) {
+    return NULL;
+  }
+  p[0] = size;
+  dom_mem_cur = dom_mem_cur - old + size;
+  if (dom_mem_cur > dom_mem_peak) {
+    dom_mem_peak = dom_mem_cur;
+  }
+  return &p[2];
+}
+
+static char *dom_strdup (const char *str) {
+  size_t len = strlen(str) + 1U;
+  char  *s = dom_malloc(len);
+  if (s != NULL) {
+    memcpy(s, str, len);
+  }
+  return s;
+}
+
+/* Child element by name */
+static xmlNodePtr dom_child (xmlNodePtr node, const char *name) {
+  for (node = node->children; node != NULL; node = node->next) {
+    if ((node->type == XML_ELEMENT_NODE) && (strcmp((const char *)node->name, name) == 0)) {
+      return node;
+    }
+  }
+  return NULL;
+}
+
+/* Count registers and fields below node */
+static void dom_count (xmlNodePtr node, result_t *res) {
+  for (node = node->children; node != NULL; node = node->next) {
+    if (node->type != XML_ELEMENT_NODE) {
+      continue;
+    }
+    if (strcmp((const char *)node->name, "register") == 0) {
+      xmlNodePtr fields = dom_child(node, "fields");
+      res->registers++;
+      if (fields != NULL) {
+        xmlNodePtr f;
+        for (f = fields->children; f != NULL; f = f->next) {
+          if ((f->type == XML_ELEMENT_NODE) && (strcmp((const char *)f->name, "field") == 0)) {
+            res->fields++;
+          }
+        }
+      }
+    } else if ((strcmp((const char *)node->name, "registers") == 0) || (strcmp((const char *)node->name, "cluster") == 0)) {
+      dom_count(node, res);
+    }
+  }
+}
+
+/* Find peripheral element by name */
+static xmlNodePtr dom_peripheral (xmlNodePtr periphs, const char *name) {
+  xmlNodePtr p, n;
+
+  for (p = periphs->children; p != NULL; p = p->next) {
+    if (p->type != XML_ELEMENT_NODE) {
+      continue;
+    }
+    n = dom_child(p, "name");
+    if (n != NULL) {
+      xmlChar *s = xmlNodeGetContent(n);
+      int match = (strcmp((const char *)s, name) == 0);
+      xmlFree(s);
+      if (match) {
+        return p;
+      }
+    }
+  }
+  return NULL;
+}
+
+/* DOM parser (libxml2): full document, then search */
+static int bench_dom (const char *path, const char *name, result_t *res) {
+  util_file_t file;
+  xmlDocPtr   doc;
+  xmlNodePtr  periphs, p;
+  uint32_t    run;
+  double      t0, t, best = 0.0;
+
+  if (util_file_map(path, &file) != 0) {
+    return -1;
+  }
+  for (run = 0U; run < BENCH_RUNS; run++) {
+    memset(res, 0, sizeof(*res));
+    dom_mem_cur  = 0U;
+    dom_mem_peak = 0U;
+    t0  = util_time_ms();
+    doc = xmlReadMemory(file.data, (int)file.size, path, NULL, XML_PARSE_NONET | XML_PARSE_HUGE);
+    if (doc == NULL) {
+      util_file_unmap(&file);
+      return -1;
+    }
+    periphs = dom_child(xmlDocGetRootElement(doc), "peripherals");
+    if (periphs != NULL) {
+      if (name == NULL) {
+        for (p = periphs->children; p != NULL; p = p->next) {
+          if (p->type == XML_ELEMENT_NODE) {
+            xmlNodePtr regs = dom_child(p, "registers");
+            if (regs != NULL) {
+              dom_count(regs, res);
+            }
+          }
+        }
+      } else {
+        p = dom_peripheral(periphs, name);
+        if (p != NULL) {
+          xmlNodePtr regs = dom_child(p, "registers");
+          xmlChar   *derived = xmlGetProp(p, (const xmlChar *)"derivedFrom");
+          if ((regs == NULL) && (derived != NULL)) {
+            p = dom_peripheral(periphs, (const char *)derived);
+            regs = (p != NULL) ? dom_child(p, "registers") : NULL;
+          }
+          xmlFree(derived);
+          if (regs != NULL) {
+            dom_count(regs, res);
+          }
+        }
+      }
+    }
+    t = util_time_ms() - t0;
+    if ((run == 0U) || (t < best)) {
+      best = t;
+    }
+    res->time = best;
+    res->memory = dom_mem_peak;
+    xmlFreeDoc(doc);
+  }
+  util_file_unmap(&file);
+  return 0;
+}
+
+#endif
+
+static int cmd_bench (int argc, char **argv) {
+  const char *name = "RCC";
+  result_t s_all, s_one, total_all, total_one;
+#ifdef SVD_BENCH_LIBXML2
+  result_t d_all, d_one, total_dall, total_done;
+#endif
+  int i, err = 0;
+
+  if ((argc >= 2) && (strcmp(argv[0], "-p") == 0)) {
+    name  = argv[1];
+    argc -= 2;
+    argv += 2;
+  }
+  if (argc < 1) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+#ifdef SVD_BENCH_LIBXML2
+  xmlMemSetup(dom_free, dom_malloc, dom_realloc, dom_strdup);
+  xmlInitParser();
+  memset(&total_dall, 0, sizeof(total_dall));
+  memset(&total_done, 0, sizeof(total_done));
+  printf("%-24s %9s %10s | %9s %10s | %9s %10s | %9s %10s | %s\n", "file",
+         "dom[ms]", "dom[kB]", "all[ms]", "all[kB]", "dom1[ms]", "dom1[kB]", "one[ms]", "one[kB]", "registers/fields");
+#else
+  printf("%-24s %9s %10s | %9s %10s | %s\n", "file",
+         "all[ms]", "all[kB]", "one[ms]", "one[kB]", "registers/fields");
+#endif
+  memset(&total_all, 0, sizeof(total_all));
+  memset(&total_one, 0, sizeof(total_one));
+
+  for (i = 0; i < argc; i++) {
+    const char *file = strrchr(argv[i], '/');
+    file = (file != NULL) ? (file + 1) : argv[i];
+
+    if ((bench_stream(argv[i], NULL, &s_all) != 0) || (bench_stream(argv[i], name, &s_one) != 0)) {
+      fprintf(stderr, "%s: error: streaming parser failed\n", argv[i]);
+      err = 1;
+      continue;
+    }
+    total_all.time += s_all.time;  total_all.memory += s_all.memory;
+    total_one.time += s_one.time;  total_one.memory += s_one.memory;
+#ifdef SVD_BENCH_LIBXML2
+    if ((bench_dom(argv[i], NULL, &d_all) != 0) || (bench_dom(argv[i], name, &d_one) != 0)) {
+      fprintf(stderr, "%s: error: DOM parser failed\n", argv[i]);
+      err = 1;
+      continue;
+    }
+    total_dall.time += d_all.time;  total_dall.memory += d_all.memory;
+    total_done.time += d_one.time;  total_done.memory += d_one.memory;
+    if ((d_all.registers != s_all.registers) || (d_all.fields != s_all.fields) ||
+        (d_one.registers != s_one.registers) || (d_one.fields != s_one.fields)) {
+      fprintf(stderr, "%s: error: parser results differ\n", argv[i]);
+      err = 1;
+    }
+    printf("%-24s %9.2f %10zu | %9.2f %10zu | %9.2f %10zu | %9.3f %10zu | %u/%u\n", file,
+           d_all.time, d_all.memory / 1024U, s_all.time, s_all.memory / 1024U,
+           d_one.time, d_one.memory / 1024U, s_one.time, s_one.memory / 1024U,
+           s_all.registers, s_all.fields);
+#else
+    printf("%-24s %9.2f %10zu | %9.3f %10zu | %u/%u\n", file,
+           s_all.time, s_all.memory / 1024U, s_one.time, s_one.memory / 1024U,
+           s_all.registers, s_all.fields);
+#endif
+  }
+
+#ifdef SVD_BENCH_LIBXML2
+  printf("%-24s %9.2f %10zu | %9.2f %10zu | %9.2f %10zu | %9.3f %10zu |\n", "total",
+         total_dall.time, total_dall.memory / 1024U, total_all.time, total_all.memory / 1024U,
+         total_done.time, total_done.memory / 1024U, total_one.time, total_one.memory / 1024U);
+  xmlCleanupParser();
+#else
+  printf("%-24s %9.2f %10zu | %9.3f %10zu |\n", "total",
+         total_all.time, total_all.memory / 1024U, total_one.time, total_one.memory / 1024U);
+#endif
+  printf("all: all peripherals, one: peripheral %s only, memory excludes the mapped file\n", name);
+  return (err != 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main (int argc, char **argv) {
+  if (argc < 2) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  if (strcmp(argv[1], "show") == 0) {
+    return cmd_show(argc - 2, &argv[2]);
+  }
+  if (strcmp(argv[1], "bench") == 0) {
+    return cmd_bench(argc - 2, &argv[2]);
+  }
+  usage();
+  return EXIT_FAILURE;
+}
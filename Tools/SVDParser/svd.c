@@ -0,0 +1,781 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Streaming SVD parser
+ * -------------------------------------------------------------------------- */
+
+/* The parser never builds a DOM. It streams over the memory-mapped SVD file
+ * and stops as soon as the requested peripheral is complete. Peripherals
+ * passed on the way are recorded with their header (name, base address,
+ * derivedFrom) and document range only; their register bodies are skipped
+ * without tokenizing. A skipped peripheral is parsed from its recorded range
+ * when it is requested later, for example when it is the base of a derivedFrom
+ * peripheral or cluster. derivedFrom references are resolved on first access.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "svd.h"
+
+#define PATH_DEPTH      16U             // Tracked element nesting
+#define CLUSTER_MAX     8U              // Maximum cluster nesting
+
+/* Peripheral parse state */
+#define PER_HEADER      0U              // Header being parsed
+#define PER_SKIPPED     1U              // Header known, body skipped
+#define PER_PARSED      2U              // Parsed completely
+
+struct svd {
+  const char           *path;
+  util_file_t           file;
+  xml_parser_t          xml;            // Document stream
+  xml_parser_t         *cur;            // Active parser (stream or reparse)
+  util_arena_t          arena;          // Parsed content
+  char                 *device_name;
+  svd_props_t           dev_props;
+  svd_peripheral_t     *first;          // Peripherals seen so far
+  svd_peripheral_t     *last;
+  int                   eof;            // All peripherals seen
+  int                   error;
+
+  // Request
+  const char           *target;         // Peripheral to parse (NULL = next)
+  svd_peripheral_t     *reparse;        // Skipped peripheral being parsed
+  svd_peripheral_t     *found;          // Completed requested peripheral
+
+  // Element context
+  xml_str_t             stack[PATH_DEPTH];  // Element names
+  uint32_t              depth;
+  util_vec_t            text;
+  svd_peripheral_t     *per;
+  svd_register_t       *per_reg_last;
+  svd_cluster_t        *per_cl_last;
+  svd_cluster_t        *cluster[CLUSTER_MAX];
+  svd_register_t       *cl_reg_last[CLUSTER_MAX];
+  svd_cluster_t        *cl_cl_last[CLUSTER_MAX];
+  uint32_t              cluster_num;
+  uint32_t              cluster_skip;
+  svd_register_t       *reg;
+  svd_field_t          *field_last;
+  svd_field_t          *field;
+  uint32_t              field_msb;
+  int                   field_msb_set;
+  uint32_t              block_offset;
+
+  // Statistics
+  uint32_t              parsed;
+  uint32_t              skipped;
+};
+
+/* Report problem at current document position */
+static void warn (svd_t *svd, const char *msg, xml_str_t what) {
+  fprintf(stderr, "%s:%u: warning: %s '%.*s'\n", svd->path,
+          xml_line(svd->file.data, (size_t)(svd->cur->tag - svd->file.data)), msg, (int)what.len, what.ptr);
+}
+
+/* Current element text, trimmed */
+static xml_str_t text (const svd_t *svd) {
+  xml_str_t s;
+
+  s.ptr = (const char *)svd->text.data;
+  s.len = svd->text.num;
+  return xml_trim(s);
+}
+
+/* Copy element text (name, identifier) */
+static char *text_copy (svd_t *svd) {
+  xml_str_t s = text(svd);
+
+  return util_arena_strdup(&svd->arena, s.ptr, s.len);
+}
+
+/* Copy element text with entities decoded and white space collapsed */
+static char *text_description (svd_t *svd) {
+  xml_str_t s = text(svd);
+  char     *d = util_arena_alloc(&svd->arena, s.len + 1U);
+
+  d[xml_unescape(d, s)] = '\0';
+  return d;
+}
+
+/* Parse element text as number */
+static uint32_t text_number (svd_t *svd) {
+  uint64_t v = 0U;
+
+  if (util_parse_number(svd->text.data, svd->text.num, &v) != 0) {
+    warn(svd, "invalid number", text(svd));
+  }
+  return (uint32_t)v;
+}
+
+/* Parse SVD access type */
+static uint32_t text_access (svd_t *svd) {
+  static const char * const access[] = {
+    "", "read-only", "write-only", "read-write", "writeOnce", "read-writeOnce"
+  };
+  xml_str_t s = text(svd);
+  uint32_t  i;
+
+  for (i = 1U; i < (sizeof(access) / sizeof(access[0])); i++) {
+    if (xml_eq(s, access[i])) {
+      return i;
+    }
+  }
+  warn(svd, "unknown access", s);
+  return SVD_ACCESS_UNDEF;
+}
+
+/* Copy attribute value */
+static const char *attr_copy (svd_t *svd, const xml_attr_t *attr, uint32_t attr_num, const char *name) {
+  const xml_str_t *v = xml_attr_find(attr, attr_num, name);
+
+  if (v == NULL) {
+    return NULL;
+  }
+  return util_arena_strdup(&svd->arena, v->ptr, v->len);
+}
+
+/* Register property element of device, peripheral, cluster or register */
+static int props_element (svd_t *svd, svd_props_t *props, xml_str_t name) {
+  if      (xml_eq(name, "size"))       { props->size        = text_number(svd); }
+  else if (xml_eq(name, "access"))     { props->access      = text_access(svd); }
+  else if (xml_eq(name, "resetValue")) { props->reset_value = text_number(svd); }
+  else if (xml_eq(name, "resetMask"))  { props->reset_mask  = text_number(svd); }
+  else { return 0; }
+  return 1;
+}
+
+/* Dim element of register or cluster */
+static void dim_element (svd_t *svd, svd_dim_t *dim, xml_str_t name) {
+  if      (xml_eq(name, "dim"))          { dim->dim       = text_number(svd); }
+  else if (xml_eq(name, "dimIncrement")) { dim->increment = text_number(svd); }
+  else if (xml_eq(name, "dimIndex"))     { dim->index     = text_copy(svd); }
+}
+
+/* Check whether body of current peripheral is wanted */
+static int wanted (const svd_t *svd) {
+  return (svd->reparse != NULL) || (svd->target == NULL) ||
+         ((svd->per->name != NULL) && (strcmp(svd->per->name, svd->target) == 0));
+}
+
+static int on_start (void *ctx, xml_str_t name, const xml_attr_t *attr, uint32_t attr_num) {
+  svd_t    *svd = (svd_t *)ctx;
+  xml_str_t parent = { "", 0U };
+
+  if (svd->depth != 0U) {
+    parent = svd->stack[((svd->depth < PATH_DEPTH) ? svd->depth : PATH_DEPTH) - 1U];
+  }
+  if (svd->depth < PATH_DEPTH) {
+    svd->stack[svd->depth] = name;
+  }
+  svd->depth++;
+  svd->text.num = 0U;
+
+  if (svd->cluster_skip != 0U) {
+    if (xml_eq(name, "cluster")) {
+      svd->cluster_skip++;
+    }
+    return 0;
+  }
+
+  if (xml_eq(name, "peripherals")) {
+    // Device header complete
+    return (svd->per == NULL) ? 1 : 0;
+  }
+  if (xml_eq(name, "peripheral") && xml_eq(parent, "peripherals")) {
+    svd_peripheral_t *per = svd->reparse;
+
+    if (per == NULL) {
+      per = util_arena_alloc(&svd->arena, sizeof(svd_peripheral_t));
+      per->start = (size_t)(svd->cur->tag - svd->file.data);
+      if (svd->last != NULL) {
+        svd->last->next = per;
+      } else {
+        svd->first = per;
+      }
+      svd->last = per;
+    }
+    per->derived_from = attr_copy(svd, attr, attr_num, "derivedFrom");
+    per->props        = svd->dev_props;
+    per->registers    = NULL;
+    per->clusters     = NULL;
+    per->size         = 0U;
+    per->state        = PER_HEADER;
+    svd->per          = per;
+    svd->per_reg_last = NULL;
+    svd->per_cl_last  = NULL;
+    svd->cluster_num  = 0U;
+    return 0;
+  }
+  if (svd->per == NULL) {
+    if (xml_eq(name, "cpu")) {
+      xml_skip(svd->cur);
+      svd->depth--;
+    }
+    return 0;
+  }
+
+  if (xml_eq(name, "registers") && xml_eq(parent, "peripheral")) {
+    if (!wanted(svd)) {
+      xml_skip(svd->cur);
+      svd->depth--;
+      svd->per->state = PER_SKIPPED;
+    }
+  } else if (xml_eq(name, "cluster")) {
+    svd_cluster_t *cl;
+
+    if (svd->cluster_num == CLUSTER_MAX) {
+      warn(svd, "cluster nesting too deep, skipped", name);
+      svd->cluster_skip = 1U;
+      return 0;
+    }
+    cl = util_arena_alloc(&svd->arena, sizeof(svd_cluster_t));
+    cl->derived_from = attr_copy(svd, attr, attr_num, "derivedFrom");
+    if (svd->cluster_num == 0U) {
+      cl->props = svd->per->props;
+      if (svd->per_cl_last != NULL) { svd->per_cl_last->next = cl; } else { svd->per->clusters = cl; }
+      svd->per_cl_last = cl;
+    } else {
+      svd_cluster_t *parent_cl = svd->cluster[svd->cluster_num - 1U];
+      cl->props = parent_cl->props;
+      if (svd->cl_cl_last[svd->cluster_num - 1U] != NULL) {
+        svd->cl_cl_last[svd->cluster_num - 1U]->next = cl;
+      } else {
+        parent_cl->clusters = cl;
+      }
+      svd->cl_cl_last[svd->cluster_num - 1U] = cl;
+    }
+    svd->cluster[svd->cluster_num]     = cl;
+    svd->cl_reg_last[svd->cluster_num] = NULL;
+    svd->cl_cl_last[svd->cluster_num]  = NULL;
+    svd->cluster_num++;
+  } else if (xml_eq(name, "register")) {
+    svd_register_t *reg = util_arena_alloc(&svd->arena, sizeof(svd_register_t));
+
+    if (svd->cluster_num == 0U) {
+      reg->props = svd->per->props;
+      if (svd->per_reg_last != NULL) { svd->per_reg_last->next = reg; } else { svd->per->registers = reg; }
+      svd->per_reg_last = reg;
+    } else {
+      svd_cluster_t *cl = svd->cluster[svd->cluster_num - 1U];
+      reg->props = cl->props;
+      if (svd->cl_reg_last[svd->cluster_num - 1U] != NULL) {
+        svd->cl_reg_last[svd->cluster_num - 1U]->next = reg;
+      } else {
+        cl->registers = reg;
+      }
+      svd->cl_reg_last[svd->cluster_num - 1U] = reg;
+    }
+    svd->reg        = reg;
+    svd->field_last = NULL;
+    if (xml_attr_find(attr, attr_num, "derivedFrom") != NULL) {
+      warn(svd, "register derivedFrom not supported", name);
+    }
+  } else if (xml_eq(name, "field") && (svd->reg != NULL)) {
+    svd->field = util_arena_alloc(&svd->arena, sizeof(svd_field_t));
+    svd->field_msb_set = 0;
+  } else if (xml_eq(name, "enumeratedValues") || xml_eq(name, "writeConstraint") ||
+             xml_eq(name, "dimArrayIndex")) {
+    // Not represented
+    xml_skip(svd->cur);
+    svd->depth--;
+  }
+  return 0;
+}
+
+static int on_text (void *ctx, xml_str_t str) {
+  svd_t *svd = (svd_t *)ctx;
+
+  util_vec_append(&svd->text, str.ptr, str.len);
+  return 0;
+}
+
+static int on_end (void *ctx, xml_str_t name) {
+  svd_t            *svd = (svd_t *)ctx;
+  svd_peripheral_t *per = svd->per;
+  xml_str_t         parent = { "", 0U };
+  int               stop = 0;
+
+  svd->depth--;
+  if ((svd->depth != 0U) && (svd->depth <= PATH_DEPTH)) {
+    parent = svd->stack[svd->depth - 1U];
+  }
+
+  if (svd->cluster_skip != 0U) {
+    if (xml_eq(name, "cluster")) {
+      svd->cluster_skip--;
+    }
+  } else if (per == NULL) {
+    // Device level
+    if (xml_eq(parent, "device")) {
+      if (xml_eq(name, "name")) {
+        svd->device_name = text_copy(svd);
+      } else {
+        props_element(svd, &svd->dev_props, name);
+      }
+    }
+  } else if ((svd->field != NULL) && xml_eq(parent, "field")) {
+    svd_field_t *f = svd->field;
+    if      (xml_eq(name, "name"))        { f->name = text_copy(svd); }
+    else if (xml_eq(name, "description")) { f->description = text_description(svd); }
+    else if (xml_eq(name, "bitOffset"))   { f->lsb = text_number(svd); }
+    else if (xml_eq(name, "lsb"))         { f->lsb = text_number(svd); }
+    else if (xml_eq(name, "bitWidth"))    { f->width = text_number(svd); }
+    else if (xml_eq(name, "msb"))         { svd->field_msb = text_number(svd); svd->field_msb_set = 1; }
+    else if (xml_eq(name, "access"))      { f->access = text_access(svd); }
+    else if (xml_eq(name, "bitRange")) {
+      xml_str_t t = text(svd);
+      unsigned  msb, lsb;
+      if ((t.len < 32U) && (sscanf(t.ptr, "[%u:%u]", &msb, &lsb) == 2) && (msb >= lsb)) {
+        f->lsb   = lsb;
+        f->width = msb - lsb + 1U;
+      } else {
+        warn(svd, "invalid bitRange", t);
+      }
+    }
+  } else if ((svd->field != NULL) && xml_eq(name, "field")) {
+    svd_field_t *f = svd->field;
+    if (svd->field_msb_set != 0) {
+      f->width = svd->field_msb - f->lsb + 1U;
+    }
+    if (f->access == SVD_ACCESS_UNDEF) {
+      f->access = svd->reg->props.access;
+    }
+    if (svd->field_last != NULL) { svd->field_last->next = f; } else { svd->reg->fields = f; }
+    svd->field_last = f;
+    svd->reg->field_num++;
+    svd->field = NULL;
+  } else if ((svd->reg != NULL) && xml_eq(parent, "register")) {
+    svd_register_t *reg = svd->reg;
+    if      (xml_eq(name, "name"))          { reg->name = text_copy(svd); }
+    else if (xml_eq(name, "description"))   { reg->description = text_description(svd); }
+    else if (xml_eq(name, "addressOffset")) { reg->offset = text_number(svd); }
+    else if (!props_element(svd, &reg->props, name)) {
+      dim_element(svd, &reg->dim, name);
+    }
+  } else if (xml_eq(name, "register")) {
+    svd->reg = NULL;
+  } else if ((svd->cluster_num != 0U) && xml_eq(parent, "cluster")) {
+    svd_cluster_t *cl = svd->cluster[svd->cluster_num - 1U];
+    if      (xml_eq(name, "name"))          { cl->name = text_copy(svd); }
+    else if (xml_eq(name, "description"))   { cl->description = text_description(svd); }
+    else if (xml_eq(name, "addressOffset")) { cl->offset = text_number(svd); }
+    else if (!props_element(svd, &cl->props, name)) {
+      dim_element(svd, &cl->dim, name);
+    }
+  } else if (xml_eq(name, "cluster")) {
+    svd->cluster_num--;
+  } else if (xml_eq(parent, "addressBlock")) {
+    // Peripheral size covers all address blocks
+    if (xml_eq(name, "offset")) {
+      svd->block_offset = text_number(svd);
+    } else if (xml_eq(name, "size")) {
+      uint32_t end = svd->block_offset + text_number(svd);
+      if (end > per->size) {
+        per->size = end;
+      }
+    }
+  } else if (xml_eq(parent, "peripheral")) {
+    if      (xml_eq(name, "name"))        { per->name = text_copy(svd); }
+    else if (xml_eq(name, "description")) { per->description = text_description(svd); }
+    else if (xml_eq(name, "groupName"))   { per->group = text_copy(svd); }
+    else if (xml_eq(name, "baseAddress")) { per->base_address = text_number(svd); }
+    else { props_element(svd, &per->props, name); }
+  } else if (xml_eq(name, "peripheral")) {
+    if (per->state == PER_SKIPPED) {
+      svd->skipped++;
+    } else {
+      per->state = PER_PARSED;
+      svd->parsed++;
+    }
+    if (svd->reparse == NULL) {
+      per->end = (size_t)(svd->cur->p - svd->file.data);
+      if ((svd->target == NULL) || ((per->name != NULL) && (strcmp(per->name, svd->target) == 0))) {
+        svd->found = per;
+        stop = 1;
+      }
+    }
+    svd->per = NULL;
+  } else if (xml_eq(name, "peripherals")) {
+    svd->eof = 1;
+  }
+  svd->text.num = 0U;
+  return stop;
+}
+
+static const xml_handler_t handler = { on_start, on_end, on_text };
+
+/* Report parse error */
+static void parse_error (svd_t *svd) {
+  svd->error = 1;
+  svd->eof   = 1;
+  fprintf(stderr, "%s:%u: error: malformed XML\n", svd->path,
+          xml_line(svd->file.data, (size_t)(svd->cur->p - svd->file.data)));
+}
+
+/* Parse body of a skipped peripheral from its recorded document range */
+static void reparse (svd_t *svd, svd_peripheral_t *per) {
+  static const xml_str_t parent[2] = { { "device", 6U }, { "peripherals", 11U } };
+  xml_parser_t xml;
+  xml_str_t    path[PATH_DEPTH];
+  uint32_t     depth = svd->depth;
+
+  if (per->state != PER_SKIPPED) {
+    return;
+  }
+  svd->skipped--;
+  memcpy(path, svd->stack, sizeof(path));
+  memcpy(svd->stack, parent, sizeof(parent));
+  svd->depth   = 2U;
+  svd->reparse = per;
+  xml_init(&xml, svd->file.data + per->start, per->end - per->start);
+  svd->cur = &xml;
+  if (xml_run(&xml, &handler, svd) != XML_OK) {
+    parse_error(svd);
+  }
+  svd->cur     = &svd->xml;
+  svd->reparse = NULL;
+  svd->per     = NULL;
+  svd->depth   = depth;
+  memcpy(svd->stack, path, sizeof(path));
+}
+
+/* Continue streaming until requested peripheral is complete */
+static svd_peripheral_t *stream (svd_t *svd, const char *target) {
+  int rc;
+
+  if (svd->eof != 0) {
+    return NULL;
+  }
+  svd->target = target;
+  svd->found  = NULL;
+  rc = xml_run(&svd->xml, &handler, svd);
+  if (rc == XML_ERROR) {
+    parse_error(svd);
+  } else if (rc == XML_OK) {
+    svd->eof = 1;
+  }
+  return svd->found;
+}
+
+/**
+  Open SVD file and parse device header.
+  \param[in]    path   SVD file
+  \return       parser instance, or NULL on error
+*/
+svd_t *svd_open (const char *path) {
+  svd_t *svd = calloc(1U, sizeof(svd_t));
+
+  if (svd == NULL) {
+    return NULL;
+  }
+  svd->path = path;
+  if (util_file_map(path, &svd->file) != 0) {
+    fprintf(stderr, "%s: error: cannot read file\n", path);
+    free(svd);
+    return NULL;
+  }
+  util_arena_init(&svd->arena);
+  util_vec_init(&svd->text, 1U);
+  xml_init(&svd->xml, svd->file.data, svd->file.size);
+  svd->cur = &svd->xml;
+  svd->dev_props.size       = 32U;
+  svd->dev_props.access     = SVD_ACCESS_RW;
+  svd->dev_props.reset_mask = 0xFFFFFFFFU;
+
+  // Runs until <peripherals>
+  if ((xml_run(&svd->xml, &handler, svd) != XML_STOP) || (svd->device_name == NULL)) {
+    parse_error(svd);
+    svd_close(svd);
+    return NULL;
+  }
+  return svd;
+}
+
+/**
+  Close SVD file and release all parsed content.
+  \param[in]    svd    parser instance
+*/
+void svd_close (svd_t *svd) {
+  if (svd != NULL) {
+    util_file_unmap(&svd->file);
+    util_arena_free(&svd->arena);
+    util_vec_free(&svd->text);
+    free(svd);
+  }
+}
+
+/**
+  Get device name.
+  \param[in]    svd    parser instance
+  \return       device name
+*/
+const char *svd_device_name (const svd_t *svd) {
+  return svd->device_name;
+}
+
+/**
+  Get device level register properties.
+  \param[in]    svd    parser instance
+  \return       register properties
+*/
+const svd_props_t *svd_device_props (const svd_t *svd) {
+  return &svd->dev_props;
+}
+
+/**
+  Get peripheral by name. Streaming stops when the peripheral is complete.
+  \param[in]    svd    parser instance
+  \param[in]    name   peripheral name
+  \return       parsed peripheral, or NULL when not found
+*/
+svd_peripheral_t *svd_peripheral (svd_t *svd, const char *name) {
+  svd_peripheral_t *per;
+
+  for (per = svd->first; per != NULL; per = per->next) {
+    if ((per->name != NULL) && (strcmp(per->name, name) == 0)) {
+      reparse(svd, per);
+      return per;
+    }
+  }
+  return stream(svd, name);
+}
+
+/**
+  Get peripherals in document order.
+  \param[in]    svd    parser instance
+  \param[in]    prev   previous peripheral (NULL = get first)
+  \return       parsed peripheral, or NULL at end of document
+*/
+svd_peripheral_t *svd_next (svd_t *svd, const svd_peripheral_t *prev) {
+  svd_peripheral_t *per = (prev != NULL) ? prev->next : svd->first;
+
+  if (per != NULL) {
+    reparse(svd, per);
+    return per;
+  }
+  return stream(svd, NULL);
+}
+
+/**
+  Resolve derivedFrom of a peripheral (on first access).
+  \param[in]    svd    parser instance
+  \param[in]    per    peripheral
+  \return       parsed base peripheral, or NULL when not derived or not found
+*/
+svd_peripheral_t *svd_peripheral_base (svd_t *svd, svd_peripheral_t *per) {
+  if ((per->base == NULL) && (per->derived_from != NULL)) {
+    per->base = svd_peripheral(svd, per->derived_from);
+    if (per->base == NULL) {
+      fprintf(stderr, "%s: warning: derivedFrom peripheral '%s' of '%s' not found\n",
+              svd->path, per->derived_from, per->name);
+    }
+  }
+  return per->base;
+}
+
+/**
+  Follow the derivedFrom chain of a peripheral without own registers or
+  clusters to the peripheral providing the register map. A chain longer
+  than SVD_DERIVE_MAX (including cycles) is reported as error.
+  \param[in]    svd    parser instance
+  \param[in]    per    peripheral
+  \return       peripheral providing the content (per when not resolvable)
+*/
+svd_peripheral_t *svd_peripheral_content (svd_t *svd, svd_peripheral_t *per) {
+  svd_peripheral_t *src = per;
+  uint32_t          depth;
+
+  for (depth = 0U; (src->registers == NULL) && (src->clusters == NULL) && (src->derived_from != NULL); depth++) {
+    svd_peripheral_t *base = svd_peripheral_base(svd, src);
+    if (base == NULL) {
+      break;
+    }
+    if ((base == per) || (depth >= SVD_DERIVE_MAX)) {
+      svd->error = 1;
+      fprintf(stderr, "%s: error: derivedFrom chain of '%s' is cyclic or too deep\n", svd->path, per->name);
+      return per;
+    }
+    src = base;
+  }
+  return src;
+}
+
+/* Find cluster by name in cluster tree */
+static const svd_cluster_t *find_cluster (const svd_cluster_t *cl, const char *name, size_t len) {
+  const svd_cluster_t *found;
+
+  for (; cl != NULL; cl = cl->next) {
+    if ((cl->name != NULL) && (strncmp(cl->name, name, len) == 0) && (cl->name[len] == '\0')) {
+      return cl;
+    }
+    found = find_cluster(cl->clusters, name, len);
+    if (found != NULL) {
+      return found;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Resolve derivedFrom of a cluster (on first access). The reference is
+  either a cluster name in the same peripheral or "<peripheral>.<cluster>".
+  \param[in]    svd      parser instance
+  \param[in]    per      peripheral containing the cluster
+  \param[in]    cluster  cluster
+  \return       base cluster, or NULL when not derived or not found
+*/
+const svd_cluster_t *svd_cluster_base (svd_t *svd, svd_peripheral_t *per, svd_cluster_t *cluster) {
+  const char       *ref = cluster->derived_from;
+  const char       *dot, *last;
+  svd_peripheral_t *scope = per;
+
+  if ((cluster->base != NULL) || (ref == NULL)) {
+    return cluster->base;
+  }
+  last = strrchr(ref, '.');
+  last = (last != NULL) ? (last + 1) : ref;
+  dot  = strchr(ref, '.');
+  if (dot != NULL) {
+    char name[128];
+    snprintf(name, sizeof(name), "%.*s", (int)(dot - ref), ref);
+    if (strcmp(name, per->name) != 0) {
+      scope = svd_peripheral(svd, name);
+    }
+  }
+  if (scope != NULL) {
+    cluster->base = find_cluster(scope->clusters, last, strlen(last));
+  }
+  if (cluster->base == NULL) {
+    fprintf(stderr, "%s: warning: derivedFrom cluster '%s' not found\n", svd->path, ref);
+  }
+  return cluster->base;
+}
+
+/* Get dim index string of element i */
+static void dim_index (const svd_dim_t *dim, uint32_t i, char *buf, size_t size) {
+  const char *p = dim->index;
+  const char *sep, *end;
+  uint64_t    lo, hi;
+
+  if (p == NULL) {
+    snprintf(buf, size, "%u", i);
+    return;
+  }
+  end = p + strlen(p);
+  sep = strchr(p, '-');
+  if ((sep != NULL) && (strchr(p, ',') == NULL)) {
+    // Numeric ("0-7") or letter ("A-D") range
+    if ((util_parse_number(p, (size_t)(sep - p), &lo) == 0) &&
+        (util_parse_number(sep + 1, (size_t)(end - sep - 1), &hi) == 0) && (hi >= lo)) {
+      snprintf(buf, size, "%u", (uint32_t)lo + i);
+    } else {
+      snprintf(buf, size, "%c", (char)(*p + (char)i));
+    }
+    return;
+  }
+  // Comma separated list
+  for (; i != 0U; i--) {
+    sep = strchr(p, ',');
+    if (sep == NULL) {
+      snprintf(buf, size, "%u", i);
+      return;
+    }
+    p = sep + 1;
+  }
+  while (*p == ' ') {
+    p++;
+  }
+  sep = strchr(p, ',');
+  if (sep == NULL) {
+    sep = end;
+  }
+  while ((sep > p) && (sep[-1] == ' ')) {
+    sep--;
+  }
+  snprintf(buf, size, "%.*s", (int)(sep - p), p);
+}
+
+/**
+  Get name of a dim array element.
+  \param[in]    name   element name ("%s" is replaced by the index, appended when missing)
+  \param[in]    dim    array description (dim 0 = no array)
+  \param[in]    i      element index
+  \param[out]   buf    name buffer
+  \param[in]    size   size of name buffer
+*/
+void svd_dim_name (const char *name, const svd_dim_t *dim, uint32_t i, char *buf, size_t size) {
+  const char *s;
+  char index[32];
+
+  if (dim->dim == 0U) {
+    snprintf(buf, size, "%s", name);
+    return;
+  }
+  dim_index(dim, i, index, sizeof(index));
+  s = strstr(name, "%s");
+  if (s == NULL) {
+    snprintf(buf, size, "%s%s", name, index);
+  } else {
+    snprintf(buf, size, "%.*s%s%s", (int)(s - name), name, index, s + 2);
+  }
+}
+
+/**
+  Get number of elements of a dim array (limited to SVD_DIM_MAX).
+  \param[in]    svd    parser instance
+  \param[in]    dim    array description
+  \param[in]    name   element name (for warning)
+  \return       number of elements (1 = no array)
+*/
+uint32_t svd_dim_num (const svd_t *svd, const svd_dim_t *dim, const char *name) {
+  if (dim->dim == 0U) {
+    return 1U;
+  }
+  if (dim->dim > SVD_DIM_MAX) {
+    fprintf(stderr, "%s: warning: dim %u of '%s' truncated\n", svd->path, dim->dim, name);
+    return SVD_DIM_MAX;
+  }
+  return dim->dim;
+}
+
+/**
+  Get error status.
+  \param[in]    svd    parser instance
+  \return       0 when no error occurred, 1 after malformed XML or cyclic derivedFrom
+*/
+int svd_error (const svd_t *svd) {
+  return svd->error;
+}
+
+/**
+  Get parser statistics.
+  \param[in]    svd    parser instance
+  \param[out]   stats  statistics
+*/
+void svd_stats (const svd_t *svd, svd_stats_t *stats) {
+  stats->parsed  = svd->parsed;
+  stats->skipped = svd->skipped;
+  stats->memory  = svd->arena.reserved + svd->text.cap + sizeof(svd_t);
+}
@@ -0,0 +1,144 @@
+/* -----------------------------------------------------------------------------
+ * Copyright (c) 2024 Arm Limited (or its affiliates).
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * $Date:        18. October 2024
+ * $Revision:    V1.1
+ *
+ * Project:      Streaming SVD parser
+ * -------------------------------------------------------------------------- */
+
+#ifndef SVD_H
+#define SVD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util.h"
+#include "xml.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Access rights (SVD access) */
+#define SVD_ACCESS_UNDEF        0U
+#define SVD_ACCESS_RO           1U      // read-only
+#define SVD_ACCESS_WO           2U      // write-only
+#define SVD_ACCESS_RW           3U      // read-write
+#define SVD_ACCESS_WONCE        4U      // writeOnce
+#define SVD_ACCESS_RWONCE       5U      // read-writeOnce
+
+#define SVD_DIM_MAX             1024U   // Maximum number of dim array elements
+#define SVD_DERIVE_MAX          16U     // Maximum peripheral derivedFrom chain length
+
+/* Register properties inherited from device, peripheral and cluster */
+typedef struct {
+  uint32_t              size;           // Register size in bits
+  uint32_t              access;         // SVD_ACCESS_x
+  uint32_t              reset_value;
+  uint32_t              reset_mask;
+} svd_props_t;
+
+/* Array description (dim element group) */
+typedef struct {
+  uint32_t              dim;            // Number of elements (0 = no array)
+  uint32_t              increment;      // Address increment
+  const char           *index;          // dimIndex (NULL = 0..dim-1)
+} svd_dim_t;
+
+typedef struct svd_field {
+  const char           *name;
+  const char           *description;
+  uint32_t              lsb;            // Least significant bit
+  uint32_t              width;          // Width in bits
+  uint32_t              access;         // SVD_ACCESS_x (inherited from register)
+  struct svd_field     *next;
+} svd_field_t;
+
+typedef struct svd_register {
+  const char           *name;
+  const char           *description;
+  uint32_t              offset;         // Address offset within parent
+  svd_props_t           props;
+  svd_dim_t             dim;
+  svd_field_t          *fields;         // Fields in document order
+  uint32_t              field_num;
+  struct svd_register  *next;
+} svd_register_t;
+
+typedef struct svd_cluster {
+  const char           *name;
+  const char           *description;
+  const char           *derived_from;   // derivedFrom (NULL = none)
+  uint32_t              offset;         // Address offset within parent
+  svd_props_t           props;
+  svd_dim_t             dim;
+  svd_register_t       *registers;      // Own registers
+  struct svd_cluster   *clusters;       // Own nested clusters
+  const struct svd_cluster *base;       // Resolved derivedFrom (see svd_cluster_base)
+  struct svd_cluster   *next;
+} svd_cluster_t;
+
+typedef struct svd_peripheral {
+  const char           *name;
+  const char           *description;
+  const char           *group;
+  const char           *derived_from;   // derivedFrom (NULL = none)
+  uint32_t              base_address;
+  uint32_t              size;           // End of last address block
+  svd_props_t           props;
+  svd_register_t       *registers;      // Own registers
+  svd_cluster_t        *clusters;       // Own clusters
+  struct svd_peripheral *base;          // Resolved derivedFrom (see svd_peripheral_base)
+  struct svd_peripheral *next;          // Next peripheral in document order
+  // Parser internal
+  size_t                start;          // Element offset in document
+  size_t                end;            // Element end offset in document
+  uint32_t              state;          // Parse state
+} svd_peripheral_t;
+
+/* Parser statistics */
+typedef struct {
+  uint32_t              parsed;         // Peripherals parsed completely
+  uint32_t              skipped;        // Peripherals skipped (body not tokenized)
+  size_t                memory;         // Heap memory reserved for parsed content
+} svd_stats_t;
+
+/* Parser instance (opaque content) */
+typedef struct svd svd_t;
+
+extern svd_t                  *svd_open             (const char *path);
+extern void                    svd_close            (svd_t *svd);
+extern const char             *svd_device_name      (const svd_t *svd);
+extern const svd_props_t      *svd_device_props     (const svd_t *svd);
+extern svd_peripheral_t       *svd_peripheral       (svd_t *svd, const char *name);
+extern svd_peripheral_t       *svd_next             (svd_t *svd, const svd_peripheral_t *prev);
+extern svd_peripheral_t       *svd_peripheral_base  (svd_t *svd, svd_peripheral_t *per);
+extern svd_peripheral_t       *svd_peripheral_content (svd_t *svd, svd_peripheral_t *per);
+extern const svd_cluster_t    *svd_cluster_base     (svd_t *svd, svd_peripheral_t *per, svd_cluster_t *cluster);
+extern uint32_t                svd_dim_num          (const svd_t *svd, const svd_dim_t *dim, const char *name);
+extern void                    svd_dim_name         (const char *name, const svd_dim_t *dim, uint32_t i, char *buf, size_t size);
+extern int                     svd_error            (const svd_t *svd);
+extern void                    svd_stats            (const svd_t *svd, svd_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SVD_H */